@@ -0,0 +1,543 @@
+// =============================================================================
+// AcHost - HostApi::Host поверх ACAPI и запись трассы вызовов
+// =============================================================================
+
+#include "AcHost.hpp"
+#include "ACAPinc.h"
+#include "APICommon.h"
+#include "FileIO.hpp"
+
+#include <cstring>
+#include <memory>
+
+namespace AcHost {
+
+using HostApi::ErrCode;
+
+static_assert(sizeof(API_Guid) == sizeof(HostApi::Guid), "API_Guid is stored as 16 bytes");
+
+// =============================================================================
+// Преобразования
+// =============================================================================
+
+static HostApi::Guid FromApiGuid(const API_Guid& guid)
+{
+    HostApi::Guid result;
+    std::memcpy(result.bytes, &guid, sizeof(result.bytes));
+    return result;
+}
+
+static API_Guid ToApiGuid(const HostApi::Guid& guid)
+{
+    API_Guid result;
+    std::memcpy(&result, guid.bytes, sizeof(result));
+    return result;
+}
+
+static HostApi::ElemType FromApiType(API_ElemTypeID typeID)
+{
+    switch (typeID) {
+        case API_WallID:   return HostApi::ElemType::Wall;
+        case API_WindowID: return HostApi::ElemType::Window;
+        case API_DoorID:   return HostApi::ElemType::Door;
+        case API_ObjectID: return HostApi::ElemType::Object;
+        default:           return HostApi::ElemType::Other;
+    }
+}
+
+static API_ElemTypeID ToApiType(HostApi::ElemType type)
+{
+    switch (type) {
+        case HostApi::ElemType::Wall:   return API_WallID;
+        case HostApi::ElemType::Window: return API_WindowID;
+        case HostApi::ElemType::Door:   return API_DoorID;
+        case HostApi::ElemType::Object: return API_ObjectID;
+        default:                        return API_ZombieElemID;
+    }
+}
+
+static void ToGuids(const GS::Array<API_Guid>& source, std::vector<HostApi::Guid>& target)
+{
+    target.clear();
+    target.reserve(source.GetSize());
+    for (const API_Guid& guid : source) {
+        target.push_back(FromApiGuid(guid));
+    }
+}
+
+// =============================================================================
+// LiveHost - вызовы ACAPI
+// =============================================================================
+
+class LiveHost : public HostApi::Host {
+public:
+    LiveHost() :
+        lastElement(),
+        inUndoable(false)
+    {
+    }
+
+    ErrCode GetSelection(std::vector<HostApi::Guid>& elements) override
+    {
+        elements.clear();
+
+        API_SelectionInfo selectionInfo;
+        GS::Array<API_Neig> selNeigs;
+        const GSErrCode err = ACAPI_Selection_Get(&selectionInfo, &selNeigs, false);
+        if (err != NoError || selectionInfo.typeID == API_SelEmpty) {
+            return err;
+        }
+
+        elements.reserve(selNeigs.GetSize());
+        for (const API_Neig& neig : selNeigs) {
+            elements.push_back(FromApiGuid(neig.guid));
+        }
+        return NoError;
+    }
+
+    ErrCode SelectElements(const std::vector<HostApi::Guid>& elements) override
+    {
+        GSErrCode err = ACAPI_Selection_DeselectAll();
+        if (err != NoError || elements.empty()) {
+            return err;
+        }
+
+        GS::Array<API_Neig> neigs;
+        neigs.EnsureCapacity(static_cast<USize>(elements.size()));
+        for (const HostApi::Guid& guid : elements) {
+            neigs.Push(API_Neig(ToApiGuid(guid)));
+        }
+        return ACAPI_Selection_Select(neigs, true);
+    }
+
+    ErrCode GetElemList(HostApi::ElemType type, std::vector<HostApi::Guid>& elements) override
+    {
+        GS::Array<API_Guid> guids;
+        const GSErrCode err = ACAPI_Element_GetElemList(ToApiType(type), &guids);
+        ToGuids(guids, elements);
+        return err;
+    }
+
+    ErrCode GetElement(const HostApi::Guid& guid, HostApi::Element& element) override
+    {
+        element = HostApi::Element();
+        element.guid = guid;
+
+        API_Element apiElement = {};
+        apiElement.header.guid = ToApiGuid(guid);
+        const GSErrCode err = ACAPI_Element_Get(&apiElement);
+        if (err != NoError) {
+            return err;
+        }
+        lastElement = apiElement;       // Для OpenParameters/CommitParameters того же элемента
+
+        const API_ElemTypeID typeID = apiElement.header.type.typeID;
+        element.guid = FromApiGuid(apiElement.header.guid);
+        element.type = FromApiType(typeID);
+        element.floorInd = apiElement.header.floorInd;
+        if (typeID == API_WindowID) {
+            element.openingWidth = apiElement.window.openingBase.width;
+            element.openingHeight = apiElement.window.openingBase.height;
+            element.lower = apiElement.window.lower;
+            element.owner = FromApiGuid(apiElement.window.owner);
+            element.objLoc = apiElement.window.objLoc;
+        } else if (typeID == API_DoorID) {
+            element.openingWidth = apiElement.door.openingBase.width;
+            element.openingHeight = apiElement.door.openingBase.height;
+            element.lower = apiElement.door.lower;
+            element.owner = FromApiGuid(apiElement.door.owner);
+            element.objLoc = apiElement.door.objLoc;
+        } else if (typeID == API_WallID) {
+            element.wallHeight = apiElement.wall.height;
+            element.begX = apiElement.wall.begC.x;
+            element.begY = apiElement.wall.begC.y;
+            element.endX = apiElement.wall.endC.x;
+            element.endY = apiElement.wall.endC.y;
+            element.arcAngle = apiElement.wall.angle;
+            element.flipped = apiElement.wall.flipped;
+        } else if (typeID == API_ObjectID) {
+            element.libInd = apiElement.object.libInd;
+        }
+        return NoError;
+    }
+
+    ErrCode GetLibPartName(int32_t libInd, std::string& name) override
+    {
+        name.clear();
+        API_LibPart libPart = {};
+        libPart.index = libInd;
+        const GSErrCode err = ACAPI_LibraryPart_Get(&libPart);
+        if (err == NoError) {
+            name = FileIO::ToUtf8(GS::UniString(libPart.docu_UName));
+        }
+        return err;
+    }
+
+    ErrCode GetPropertyDefinitions(const HostApi::Guid& element, HostApi::PropertyFilter filter, std::vector<HostApi::PropertyDefinition>& definitions) override
+    {
+        GS::Array<API_PropertyDefinition> apiDefinitions;
+        const GSErrCode err = ACAPI_Element_GetPropertyDefinitions(ToApiGuid(element),
+            filter == HostApi::PropertyFilter::UserDefined ? API_PropertyDefinitionFilter_UserDefined : API_PropertyDefinitionFilter_All,
+            apiDefinitions);
+
+        definitions.clear();
+        definitions.reserve(apiDefinitions.GetSize());
+        for (const API_PropertyDefinition& def : apiDefinitions) {
+            HostApi::PropertyDefinition item;
+            item.guid = FromApiGuid(def.guid);
+            item.name = FileIO::ToUtf8(def.name);
+            definitions.push_back(item);
+        }
+        return err;
+    }
+
+    ErrCode GetPropertyValue(const HostApi::Guid& element, const HostApi::Guid& definition, HostApi::PropertyValue& value) override
+    {
+        value.isDefault = true;
+        value.isString = false;
+        value.text.clear();
+
+        API_Property property;
+        const GSErrCode err = ACAPI_Element_GetPropertyValue(ToApiGuid(element), ToApiGuid(definition), property);
+        if (err != NoError) {
+            return err;
+        }
+        value.isDefault = property.isDefault;
+        value.isString = property.value.singleVariant.variant.type == API_PropertyStringValueType;
+        if (value.isString) {
+            value.text = FileIO::ToUtf8(property.value.singleVariant.variant.uniStringValue);
+        }
+        return NoError;
+    }
+
+    ErrCode OpenParameters(const HostApi::Guid& element, HostApi::ElemType type) override
+    {
+        API_ParamOwnerType paramOwner = {};
+        paramOwner.guid = ToApiGuid(element);   // GUID размещённого элемента
+        paramOwner.libInd = 0;                  // 0 для размещённого элемента
+        paramOwner.type = LastElementIs(element) ? lastElement.header.type : API_ElemType(ToApiType(type));
+        return ACAPI_LibraryPart_OpenParameters(&paramOwner);
+    }
+
+    ErrCode GetParameters(std::vector<HostApi::Parameter>& parameters) override
+    {
+        parameters.clear();
+
+        API_GetParamsType getParams = {};
+        const GSErrCode err = ACAPI_LibraryPart_GetActParameters(&getParams);
+        if (err != NoError || getParams.params == nullptr) {
+            return err != NoError ? err : APIERR_GENERAL;
+        }
+
+        const Int32 count = BMGetHandleSize((GSHandle)getParams.params) / sizeof(API_AddParType);
+        parameters.reserve(count);
+        for (Int32 i = 0; i < count; i++) {
+            const API_AddParType& par = (*getParams.params)[i];
+            HostApi::Parameter item;
+            item.name = par.name;
+            item.index = par.index;
+            item.typeID = par.typeID;
+            parameters.push_back(item);
+        }
+        ACAPI_DisposeAddParHdl(&getParams.params);
+        return NoError;
+    }
+
+    ErrCode ChangeParameter(int32_t index, const std::string& value) override
+    {
+        GS::UniString text(value.c_str(), CC_UTF8);
+        if (text.GetLength() >= API_UAddParStrLen) {
+            text = text.GetSubstring(0, API_UAddParStrLen - 1);
+            WriteReport("    ⚠ ВНИМАНИЕ: строка обрезана до %d символов", API_UAddParStrLen - 1);
+        }
+
+        GS::uchar_t* uStrBuffer = (GS::uchar_t*)BMAllocatePtr((API_UAddParStrLen + 1) * sizeof(GS::uchar_t), ALLOCATE_CLEAR, 0);
+        if (uStrBuffer == nullptr) {
+            return APIERR_GENERAL;
+        }
+        GS::ucscpy(uStrBuffer, text.ToUStr());
+
+        // Параметр по индексу, а не по имени - надёжнее
+        API_ChangeParamType changeParam = {};
+        changeParam.name[0] = '\0';
+        changeParam.index = index;
+        changeParam.ind1 = 0;
+        changeParam.ind2 = 0;
+        changeParam.uStrValue = uStrBuffer;
+        const GSErrCode err = ACAPI_LibraryPart_ChangeAParameter(&changeParam);
+
+        BMKillPtr((GSPtr*)&uStrBuffer);
+        return err;
+    }
+
+    ErrCode CommitParameters(const HostApi::Guid& element, bool apply) override
+    {
+        API_GetParamsType getParams = {};
+        GSErrCode err = ACAPI_LibraryPart_GetActParameters(&getParams);
+        if (err != NoError) {
+            ACAPI_LibraryPart_CloseParameters();
+            return err;
+        }
+        ACAPI_LibraryPart_CloseParameters();
+
+        if (apply && getParams.params != nullptr) {
+            API_Element apiElement = {};
+            if (LastElementIs(element)) {
+                apiElement = lastElement;
+            } else {
+                apiElement.header.guid = ToApiGuid(element);
+            }
+
+            auto change = [&]() -> GSErrCode {
+                API_ElementMemo memo = {};
+                memo.params = getParams.params;     // Принадлежат getParams, освобождаются ниже
+
+                API_Element mask = {};
+                ACAPI_ELEMENT_MASK_CLEAR(mask);
+                return ACAPI_Element_Change(&apiElement, &mask, &memo, APIMemoMask_AddPars, true);
+            };
+            // Внутри RunUndoable команда отмены уже открыта
+            err = inUndoable ? change() : ACAPI_CallUndoableCommand("Change Cassette Parameters", change);
+        }
+
+        if (getParams.params != nullptr) {
+            ACAPI_DisposeAddParHdl(&getParams.params);
+        }
+        return err;
+    }
+
+    void CloseParameters() override
+    {
+        ACAPI_LibraryPart_CloseParameters();
+    }
+
+    ErrCode RunUndoable(const std::string& name, const std::function<ErrCode()>& action) override
+    {
+        if (inUndoable) {
+            return action();
+        }
+        inUndoable = true;
+        const GSErrCode err = ACAPI_CallUndoableCommand(GS::UniString(name.c_str(), CC_UTF8), [&]() -> GSErrCode {
+            return action();
+        });
+        inUndoable = false;
+        return err;
+    }
+
+    ErrCode FindLibPart(const std::string& name, int32_t& libInd) override
+    {
+        libInd = 0;
+        API_LibPart libPart = {};
+        GS::ucscpy(libPart.docu_UName, GS::UniString(name.c_str(), CC_UTF8).ToUStr());
+        const GSErrCode err = ACAPI_LibraryPart_Search(&libPart, false);
+        if (libPart.location != nullptr) {
+            delete libPart.location;
+        }
+        if (err == NoError) {
+            libInd = libPart.index;
+        }
+        return err;
+    }
+
+    ErrCode CreateObjects(int32_t libInd, const std::string& textParam,
+                          const std::vector<HostApi::PlacedObject>& objects, std::vector<HostApi::Guid>& created) override
+    {
+        created.clear();
+        created.reserve(objects.size());
+
+        // Элемент по умолчанию и параметры библиотечного элемента - один раз на все экземпляры
+        API_Element element = {};
+        element.header.type = API_ObjectID;
+        GSErrCode err = ACAPI_Element_GetDefaults(&element, nullptr);
+        if (err != NoError) {
+            return err;
+        }
+
+        double a = 0.0;
+        double b = 0.0;
+        Int32 addParNum = 0;
+        API_AddParType** addPars = nullptr;
+        err = ACAPI_LibraryPart_GetParams(libInd, &a, &b, &addParNum, &addPars);
+        if (err != NoError) {
+            return err;
+        }
+
+        Int32 textIndex = -1;
+        for (Int32 i = 0; i < addParNum && !textParam.empty(); i++) {
+            if ((*addPars)[i].typeID == APIParT_CString && textParam == (*addPars)[i].name) {
+                textIndex = i;
+                break;
+            }
+        }
+        if (!textParam.empty() && textIndex < 0) {
+            WriteReport("    ⚠ Строковый параметр %s не найден, маркировка не пишется", textParam.c_str());
+        }
+
+        // ACAPI_Element_Create копирует параметры из memo, поэтому один handle
+        // меняется на месте от экземпляра к экземпляру, а не открывается заново
+        element.object.libInd = libInd;
+        API_ElementMemo memo = {};
+        memo.params = addPars;
+
+        auto create = [&]() -> GSErrCode {
+            for (const HostApi::PlacedObject& object : objects) {
+                element.header.guid = APINULLGuid;
+                element.header.floorInd = object.floorInd;
+                element.object.pos.x = object.x;
+                element.object.pos.y = object.y;
+                element.object.level = object.level;
+                element.object.angle = object.angle;
+                element.object.xRatio = object.a;
+                element.object.yRatio = object.b;
+                if (textIndex >= 0) {
+                    GS::UniString text(object.text.c_str(), CC_UTF8);
+                    if (text.GetLength() >= API_UAddParStrLen) {
+                        text = text.GetSubstring(0, API_UAddParStrLen - 1);
+                    }
+                    GS::ucscpy((*addPars)[textIndex].value.uStr, text.ToUStr());
+                }
+
+                const GSErrCode createErr = ACAPI_Element_Create(&element, &memo);
+                if (createErr != NoError) {
+                    return createErr;
+                }
+                created.push_back(FromApiGuid(element.header.guid));
+            }
+            return NoError;
+        };
+        // Внутри RunUndoable команда отмены уже открыта
+        err = inUndoable ? create() : ACAPI_CallUndoableCommand("Place Cassette Objects", create);
+
+        ACAPI_DisposeAddParHdl(&addPars);
+        return err;
+    }
+
+    void WatchElement(const HostApi::Guid& guid) override
+    {
+        ACAPI_Element_AttachObserver(ToApiGuid(guid));
+    }
+
+    void Report(const char* text) override
+    {
+        WriteReport("%s", text);
+    }
+
+private:
+    bool LastElementIs(const HostApi::Guid& guid) const
+    {
+        return std::memcmp(&lastElement.header.guid, guid.bytes, sizeof(guid.bytes)) == 0;
+    }
+
+    API_Element lastElement;
+    bool inUndoable;                    // Идёт RunUndoable
+};
+
+// =============================================================================
+// Запись трассы
+// =============================================================================
+
+static LiveHost s_liveHost;
+static std::unique_ptr<HostTrace::Recorder> s_recorder;
+
+HostApi::Host& Get()
+{
+    if (s_recorder != nullptr) {
+        return *s_recorder;
+    }
+    return s_liveHost;
+}
+
+HostTrace::Recorder* GetRecorder()
+{
+    return s_recorder.get();
+}
+
+void StartRecording()
+{
+    s_recorder.reset(new HostTrace::Recorder(s_liveHost));
+}
+
+bool IsRecording()
+{
+    return s_recorder != nullptr;
+}
+
+bool StopRecording(const GS::UniString& path, UInt64& calls, UInt64& bytes, GS::UniString& errorMessage)
+{
+    calls = 0;
+    bytes = 0;
+    if (s_recorder == nullptr) {
+        errorMessage = "Запись трассы не идёт";
+        return false;
+    }
+
+    const std::string& data = s_recorder->GetData();
+    FileIO::Writer out;
+    if (!out.Open(path)) {
+        errorMessage = "Не удалось создать файл: " + path;
+        return false;
+    }
+    out.Write(data.data(), data.size());
+    if (!out.Close()) {
+        errorMessage = "Ошибка записи файла: " + path;
+        return false;
+    }
+
+    calls = s_recorder->GetCallCount();
+    bytes = data.size();
+    s_recorder.reset();
+    return true;
+}
+
+// =============================================================================
+// Кэш стен и уведомления
+// =============================================================================
+
+static WallCache::Cache s_wallCache;
+
+// Без уведомлений кэш не узнает об изменениях - тогда им не пользуемся
+static bool s_notificationsInstalled = false;
+
+WallCache::Cache* GetWallCache()
+{
+    return (s_recorder != nullptr || !s_notificationsInstalled) ? nullptr : &s_wallCache;
+}
+
+// Элементы, на которые подписан WatchElement, и новые стены
+static GSErrCode __ACENV_CALL ElementEventHandler(const API_NotifyElementType* elemType)
+{
+    if (elemType->notifID != APINotifyElement_New) {
+        s_wallCache.OnElementChanged(FromApiGuid(elemType->elemHead.guid));
+    }
+
+    // Новая, удалённая или восстановленная стена меняет список стен
+    const bool isWall = elemType->elemHead.type.typeID == API_WallID;
+    if (isWall && elemType->notifID != APINotifyElement_Change && elemType->notifID != APINotifyElement_Edit) {
+        s_wallCache.OnWallListChanged();
+    }
+    return NoError;
+}
+
+static GSErrCode __ACENV_CALL ProjectEventHandler(API_NotifyEventID, Int32)
+{
+    s_wallCache.Clear();
+    return NoError;
+}
+
+GSErrCode InstallNotifications()
+{
+    GSErrCode err = ACAPI_Element_InstallElementObserver(ElementEventHandler);
+    if (err == NoError) {
+        API_ToolBoxItem wallTool = {};
+        wallTool.type = API_WallID;
+        err = ACAPI_Element_CatchNewElement(&wallTool, ElementEventHandler);
+    }
+    if (err == NoError) {
+        err = ACAPI_ProjectOperation_CatchProjectEvent(APINotify_New | APINotify_NewAndReset | APINotify_Open | APINotify_Close,
+                                                       ProjectEventHandler);
+    }
+    s_notificationsInstalled = err == NoError;
+    return err;
+}
+
+} // namespace AcHost
@@ -0,0 +1,42 @@
+#ifndef ACHOST_HPP
+#define ACHOST_HPP
+
+// =============================================================================
+// AcHost - HostApi::Host поверх ACAPI и запись трассы вызовов
+// =============================================================================
+// Get() - хост для HostWorkload: сам Archicad или, пока идёт запись, Recorder
+// над ним (см. HostTrace.hpp). Трасса сохраняется в файл .castrace и
+// повторяется без Archicad программой cassette-replay.
+
+#include "GSRoot.hpp"
+#include "UniString.hpp"
+#include "HostTrace.hpp"
+#include "WallCache.hpp"
+
+namespace AcHost {
+
+// Хост для текущего вызова
+HostApi::Host& Get();
+
+// Recorder, если идёт запись (для маркеров операций), иначе nullptr
+HostTrace::Recorder* GetRecorder();
+
+// Начать запись (прежняя незавершённая запись сбрасывается)
+void StartRecording();
+bool IsRecording();
+
+// Остановить запись и сохранить трассу в файл
+bool StopRecording(const GS::UniString& path, UInt64& calls, UInt64& bytes, GS::UniString& errorMessage);
+
+// Кэш стен для HostWorkload; nullptr, пока идёт запись трассы (в трассу должны
+// попасть все чтения стен, иначе cassette-replay их не повторит) и если
+// уведомления не установлены (HostWorkload тогда читает стены без кэша)
+WallCache::Cache* GetWallCache();
+
+// Уведомления Archicad, по которым обновляется кэш стен (из Initialize;
+// ошибка не мешает загрузке аддона)
+GSErrCode InstallNotifications();
+
+} // namespace AcHost
+
+#endif // ACHOST_HPP
@@ -0,0 +1,166 @@
+// =============================================================================
+// BridgeStats - Замеры времени вызовов JS моста
+// =============================================================================
+
+#include "BridgeStats.hpp"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace BridgeStats {
+
+// =============================================================================
+// Хранилище замеров
+// =============================================================================
+
+// Размер скользящего окна на функцию
+static const size_t WindowSize = 256;
+
+struct Sample {
+    float decodeMs;
+    float nativeMs;
+    float encodeMs;
+};
+
+struct FunctionSamples {
+    std::vector<Sample> ring;   // Кольцевой буфер замеров
+    size_t next = 0;            // Позиция следующей записи
+    UInt32 calls = 0;
+};
+
+// Ключ - имя функции (строковый литерал из BrowserRepl, копируем в std::string)
+static std::map<std::string, FunctionSamples> s_functions;
+
+static void AddSample(const char* name, const Sample& sample)
+{
+    FunctionSamples& f = s_functions[name];
+    if (f.ring.size() < WindowSize) {
+        f.ring.push_back(sample);
+    } else {
+        f.ring[f.next] = sample;
+    }
+    f.next = (f.next + 1) % WindowSize;
+    f.calls++;
+}
+
+static double ToMs(std::chrono::steady_clock::duration d)
+{
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+// p50 и p95 по значениям (values переупорядочивается)
+static PhaseStats ComputePercentiles(std::vector<float>& values)
+{
+    PhaseStats stats = { 0.0, 0.0 };
+    if (values.empty()) {
+        return stats;
+    }
+
+    auto percentile = [&values](double q) -> double {
+        size_t k = static_cast<size_t>(q * (values.size() - 1) + 0.5);
+        std::nth_element(values.begin(), values.begin() + k, values.end());
+        return values[k];
+    };
+
+    stats.p50Ms = percentile(0.50);
+    stats.p95Ms = percentile(0.95);
+    return stats;
+}
+
+// =============================================================================
+// CallTimer
+// =============================================================================
+
+CallTimer::CallTimer(const char* functionName) :
+    name(functionName),
+    start(Clock::now()),
+    decodeMarked(false),
+    nativeMarked(false)
+{
+    decodeEnd = start;
+    nativeEnd = start;
+}
+
+CallTimer::~CallTimer()
+{
+    const Clock::time_point end = Clock::now();
+
+    // Неотмеченные фазы: decode считается нулевым, native длится до конца вызова
+    const Clock::time_point decodeMark = decodeMarked ? decodeEnd : start;
+    const Clock::time_point nativeMark = nativeMarked ? nativeEnd : end;
+
+    Sample sample;
+    sample.decodeMs = static_cast<float>(ToMs(decodeMark - start));
+    sample.nativeMs = static_cast<float>(ToMs(nativeMark - decodeMark));
+    sample.encodeMs = static_cast<float>(ToMs(end - nativeMark));
+    AddSample(name, sample);
+}
+
+void CallTimer::DecodeDone()
+{
+    decodeEnd = Clock::now();
+    decodeMarked = true;
+}
+
+void CallTimer::NativeDone()
+{
+    nativeEnd = Clock::now();
+    nativeMarked = true;
+    if (!decodeMarked) {
+        decodeEnd = start;
+        decodeMarked = true;
+    }
+}
+
+double CallTimer::NativeMs() const
+{
+    const Clock::time_point decodeMark = decodeMarked ? decodeEnd : start;
+    const Clock::time_point nativeMark = nativeMarked ? nativeEnd : Clock::now();
+    return ToMs(nativeMark - decodeMark);
+}
+
+// =============================================================================
+// Статистика
+// =============================================================================
+
+GS::Array<FunctionStats> GetStats()
+{
+    GS::Array<FunctionStats> result;
+
+    std::vector<float> decode, native, encode, total;
+    for (const auto& pair : s_functions) {
+        const FunctionSamples& f = pair.second;
+
+        decode.clear();
+        native.clear();
+        encode.clear();
+        total.clear();
+        for (const Sample& s : f.ring) {
+            decode.push_back(s.decodeMs);
+            native.push_back(s.nativeMs);
+            encode.push_back(s.encodeMs);
+            total.push_back(s.decodeMs + s.nativeMs + s.encodeMs);
+        }
+
+        FunctionStats stats;
+        stats.name = GS::UniString(pair.first.c_str());
+        stats.calls = f.calls;
+        stats.samples = static_cast<UInt32>(f.ring.size());
+        stats.decode = ComputePercentiles(decode);
+        stats.native = ComputePercentiles(native);
+        stats.encode = ComputePercentiles(encode);
+        stats.total = ComputePercentiles(total);
+        result.Push(stats);
+    }
+
+    return result;
+}
+
+void Reset()
+{
+    s_functions.clear();
+}
+
+} // namespace BridgeStats
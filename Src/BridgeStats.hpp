@@ -0,0 +1,78 @@
+#ifndef BRIDGESTATS_HPP
+#define BRIDGESTATS_HPP
+
+// =============================================================================
+// BridgeStats - Замеры времени вызовов JS моста (window.ACAPI)
+// =============================================================================
+// Каждый вызов делится на три фазы:
+//   decode - разбор аргументов JS -> C++
+//   native - работа с Archicad API / расчёт
+//   encode - сборка объекта результата C++
+// Преобразование результата в значения JS и передача между процессами здесь
+// не видны: их палитра меряет сама (время вызова в JS минус nativeMs ответа).
+// По каждой функции хранится скользящее окно последних замеров, из которого
+// считаются p50/p95.
+
+#include "GSRoot.hpp"
+#include "UniString.hpp"
+
+#include <chrono>
+
+namespace BridgeStats {
+
+// Замер одного вызова. Создаётся в начале обработчика, фиксирует
+// результат в деструкторе (после сборки ответа).
+class CallTimer {
+public:
+    explicit CallTimer(const char* functionName);
+    ~CallTimer();
+
+    CallTimer(const CallTimer&) = delete;
+    CallTimer& operator=(const CallTimer&) = delete;
+
+    // Конец разбора аргументов
+    void DecodeDone();
+    // Конец нативной работы (дальше идёт сборка результата)
+    void NativeDone();
+
+    // Длительность нативной фазы, мс (без отметки NativeDone - до текущего момента).
+    // Палитра вычитает её из времени вызова, замеренного в JS
+    double NativeMs() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    const char* name;
+    Clock::time_point start;
+    Clock::time_point decodeEnd;
+    Clock::time_point nativeEnd;
+    bool decodeMarked;
+    bool nativeMarked;
+};
+
+// Процентили одной фазы в миллисекундах
+struct PhaseStats {
+    double p50Ms;
+    double p95Ms;
+};
+
+// Статистика одной функции моста
+struct FunctionStats {
+    GS::UniString name;      // Имя функции ACAPI
+    UInt32 calls;            // Всего вызовов с момента сброса
+    UInt32 samples;          // Замеров в скользящем окне
+    PhaseStats decode;
+    PhaseStats native;
+    PhaseStats encode;
+    PhaseStats total;
+};
+
+// Статистика по всем функциям, вызывавшимся с момента сброса
+GS::Array<FunctionStats> GetStats();
+
+// Сбросить все замеры
+void Reset();
+
+} // namespace BridgeStats
+
+#endif // BRIDGESTATS_HPP
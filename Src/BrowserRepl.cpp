@@ -7,6 +7,21 @@
 #include "DGBrowser.hpp"
 #include "CassetteHelper.hpp"
 #include "CassetteSettings.hpp"
+#include "SelectionSnapshot.hpp"
+#include "BridgeStats.hpp"
+#include "JsDecode.hpp"
+#include "ResultStore.hpp"
+#include "CalcCache.hpp"
+#include "CassetteCsv.hpp"
+#include "FileDialogs.hpp"
+#include "SendXlsHelper.hpp"
+#include "SnapshotDump.hpp"
+#include "TsprgImport.hpp"
+#include "FileIO.hpp"
+#include "AcHost.hpp"
+#include "CuttingStock.hpp"
+#include "SheetNesting.hpp"
+#include "SizeClustering.hpp"
 
 #include <cmath>
 #include <cstdio>
@@ -16,69 +31,94 @@
 // JS Helper Functions
 // =============================================================================
 
-// Extract string from JS::Base
-static GS::UniString GetStringFromJs(GS::Ref<JS::Base> p)
+// Обёртка JS::Function с замером времени вызова (см. BridgeStats).
+// Обработчик отмечает timer.DecodeDone() после разбора аргументов и
+// timer.NativeDone() после нативной работы; остаток до возврата - сборка результата.
+// В ответ-объект добавляется nativeMs: палитра вычитает его из времени вызова в JS
+template <typename Handler>
+static JS::Function* TimedFunction(const char* name, Handler handler)
 {
-    if (p == nullptr) return GS::UniString();
-    
-    if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(p)) {
-        if (v->GetType() == JS::Value::STRING) {
-            return v->GetString();
+    return new JS::Function(name, [name, handler](GS::Ref<JS::Base> param) -> GS::Ref<JS::Base> {
+        BridgeStats::CallTimer timer(name);
+        GS::Ref<JS::Base> result = handler(param, timer);
+        if (GS::Ref<JS::Object> jsResult = GS::DynamicCast<JS::Object>(result)) {
+            jsResult->AddItem("nativeMs", new JS::Value(timer.NativeMs()));
         }
-    }
-    return GS::UniString();
-}
-
-// Extract double from JS::Base
-static double GetDoubleFromJs(GS::Ref<JS::Base> p, double def = 0.0)
-{
-    if (p == nullptr) return def;
-
-	if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(p)) {
-		const auto t = v->GetType();
-        if (t == JS::Value::DOUBLE) return v->GetDouble();
-        if (t == JS::Value::INTEGER) return static_cast<double>(v->GetInteger());
-		if (t == JS::Value::STRING) {
-			GS::UniString s = v->GetString();
-            for (UIndex i = 0; i < s.GetLength(); ++i) 
-                if (s[i] == ',') s[i] = '.';
-			double out = def;
-			std::sscanf(s.ToCStr().Get(), "%lf", &out);
-			return out;
-		}
-	}
-	return def;
+        return result;
+    });
 }
 
-// Extract integer from JS::Base
-static Int32 GetIntFromJs(GS::Ref<JS::Base> p, Int32 def = 0)
+// Списки результата расчёта (cassettes, planks, leftSlopes, rightSlopes)
+static void AddResultLists(GS::Ref<JS::Object>& target, const CassetteHelper::CalculationResult& calcResult)
 {
-    if (p == nullptr) return def;
-
-	if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(p)) {
-		const auto t = v->GetType();
-        if (t == JS::Value::INTEGER) return v->GetInteger();
-        if (t == JS::Value::DOUBLE) return static_cast<Int32>(v->GetDouble());
-		if (t == JS::Value::STRING) {
-			Int32 out = def;
-            std::sscanf(v->GetString().ToCStr().Get(), "%d", &out);
-			return out;
-		}
-	}
-	return def;
+    // Кассеты
+    GS::Ref<JS::Array> jsCassettes = new JS::Array();
+    for (const CassetteHelper::CassetteSize& cs : calcResult.cassettes) {
+        GS::Ref<JS::Object> jsCs = new JS::Object();
+        jsCs->AddItem("x", new JS::Value(cs.x));
+        jsCs->AddItem("y", new JS::Value(cs.y));
+        jsCs->AddItem("count", new JS::Value(cs.count));
+        jsCassettes->AddItem(jsCs);
+    }
+    target->AddItem("cassettes", jsCassettes);
+    
+    // Планки
+    GS::Ref<JS::Array> jsPlanks = new JS::Array();
+    for (const CassetteHelper::PlankSize& ps : calcResult.planks) {
+        GS::Ref<JS::Object> jsPs = new JS::Object();
+        jsPs->AddItem("width", new JS::Value(ps.width));
+        jsPs->AddItem("length", new JS::Value(ps.length));
+        jsPs->AddItem("count", new JS::Value(ps.count));
+        jsPs->AddItem("calcType", new JS::Value(ps.calcType));
+        jsPlanks->AddItem(jsPs);
+    }
+    target->AddItem("planks", jsPlanks);
+    
+    // Левые откосы
+    GS::Ref<JS::Array> jsLeftSlopes = new JS::Array();
+    for (const CassetteHelper::PlankSize& ps : calcResult.leftSlopes) {
+        GS::Ref<JS::Object> jsPs = new JS::Object();
+        jsPs->AddItem("width", new JS::Value(ps.width));
+        jsPs->AddItem("length", new JS::Value(ps.length));
+        jsPs->AddItem("count", new JS::Value(ps.count));
+        jsPs->AddItem("calcType", new JS::Value(ps.calcType));
+        jsLeftSlopes->AddItem(jsPs);
+    }
+    target->AddItem("leftSlopes", jsLeftSlopes);
+    
+    // Правые откосы
+    GS::Ref<JS::Array> jsRightSlopes = new JS::Array();
+    for (const CassetteHelper::PlankSize& ps : calcResult.rightSlopes) {
+        GS::Ref<JS::Object> jsPs = new JS::Object();
+        jsPs->AddItem("width", new JS::Value(ps.width));
+        jsPs->AddItem("length", new JS::Value(ps.length));
+        jsPs->AddItem("count", new JS::Value(ps.count));
+        jsPs->AddItem("calcType", new JS::Value(ps.calcType));
+        jsRightSlopes->AddItem(jsPs);
+    }
+    target->AddItem("rightSlopes", jsRightSlopes);
 }
 
-// Extract bool from JS::Base
-static bool GetBoolFromJs(GS::Ref<JS::Base> p, bool def = false)
+// Результат расчёта из параметров вызова: по дескриптору handle из ResultStore,
+// а если его нет (или он уже вытеснен) - из переданного объекта result
+static const CassetteHelper::CalculationResult* ResolveResult(
+    const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& itemTable,
+    CassetteHelper::CalculationResult& decoded)
 {
-    if (p == nullptr) return def;
-    
-    if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(p)) {
-        if (v->GetType() == JS::Value::BOOL) {
-            return v->GetBool();
+    GS::Ref<JS::Base> handleBase;
+    if (itemTable.Get("handle", &handleBase)) {
+        const CassetteHelper::CalculationResult* stored =
+            ResultStore::Get(JsDecode::GetInt(handleBase, ResultStore::InvalidHandle));
+        if (stored != nullptr) {
+            return stored;
         }
     }
-    return def;
+
+    GS::Ref<JS::Base> resultBase;
+    if (itemTable.Get("result", &resultBase) && JsDecode::DecodeResult(resultBase, decoded)) {
+        return &decoded;
+    }
+    return nullptr;
 }
 
 // =============================================================================
@@ -94,7 +134,7 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& browser)
     // Ping - тестовая функция
     // ------------------------------------------------------------
     
-    jsACAPI->AddItem(new JS::Function("Ping", [](GS::Ref<JS::Base>) -> GS::Ref<JS::Base> {
+    jsACAPI->AddItem(TimedFunction("Ping", [](GS::Ref<JS::Base>, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
         return new JS::Value("Pong from Cassette Panel!");
     }));
 
@@ -102,52 +142,152 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& browser)
     // GetCassetteSelection - получить выделенные окна/двери
     // ------------------------------------------------------------
     
-    jsACAPI->AddItem(new JS::Function("GetCassetteSelection", [](GS::Ref<JS::Base>) -> GS::Ref<JS::Base> {
+    jsACAPI->AddItem(TimedFunction("GetCassetteSelection", [](GS::Ref<JS::Base>, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
         GS::Ref<JS::Object> result = new JS::Object();
         
-        // Получаем окна/двери
-        GS::Array<CassetteHelper::WindowDoorInfo> windows = 
-            CassetteHelper::GetSelectedWindowsDoors();
-        
-        // Конвертируем в JS массив
-        GS::Ref<JS::Array> jsWindows = new JS::Array();
-        for (const CassetteHelper::WindowDoorInfo& w : windows) {
-            GS::Ref<JS::Object> jsWindow = new JS::Object();
-            jsWindow->AddItem("id", new JS::Value(w.id));
-            jsWindow->AddItem("elemType", new JS::Value(w.elemType));
-            jsWindow->AddItem("width", new JS::Value(w.width));
-            jsWindow->AddItem("height", new JS::Value(w.height));
-            jsWindow->AddItem("sillHeight", new JS::Value(w.sillHeight));
-            jsWindow->AddItem("x", new JS::Value(w.x));
-            jsWindow->AddItem("y", new JS::Value(w.y));
-            jsWindow->AddItem("angle", new JS::Value(w.angle));
-            jsWindow->AddItem("calcType", new JS::Value(static_cast<Int32>(w.calcType)));
-            jsWindows->AddItem(jsWindow);
-        }
-        result->AddItem("windows", jsWindows);
-        
-        // Дубликаты
-        GS::Array<GS::UniString> duplicates = CassetteHelper::FindDuplicateIds(windows);
+        // Обновляем снимок выделения на стороне C++; строки таблицы палитра
+        // запрашивает постранично через GetCassetteSelectionPage
+        SelectionSnapshot::Refresh();
+        timer.NativeDone();
+        
+        // Дубликаты: ID и группы (номер группы - индекс в duplicateGroups,
+        // по нему палитра подсвечивает строки и выделяет элементы)
         GS::Ref<JS::Array> jsDuplicates = new JS::Array();
-        for (const GS::UniString& dup : duplicates) {
-            jsDuplicates->AddItem(new JS::Value(dup));
+        GS::Ref<JS::Array> jsGroups = new JS::Array();
+        for (const CassetteHelper::DuplicateGroup& group : SelectionSnapshot::GetDuplicateGroups()) {
+            jsDuplicates->AddItem(new JS::Value(IdPool::Get(group.id)));
+            GS::Ref<JS::Object> jsGroup = new JS::Object();
+            jsGroup->AddItem("id", new JS::Value(IdPool::Get(group.id)));
+            jsGroup->AddItem("count", new JS::Value(static_cast<Int32>(group.indices.GetSize())));
+            jsGroups->AddItem(jsGroup);
         }
         result->AddItem("duplicates", jsDuplicates);
-        result->AddItem("count", new JS::Value(static_cast<Int32>(windows.GetSize())));
+        result->AddItem("duplicateGroups", jsGroups);
+        result->AddItem("count", new JS::Value(static_cast<Int32>(SelectionSnapshot::GetCount())));
+        result->AddItem("success", new JS::Value(true));
+        
+        return result;
+    }));
+
+    // ------------------------------------------------------------
+    // GetCassetteSelectionPage - страница снимка выделения
+    // Параметр: { offset, count, sortKey, descending, idFilter, calcType, duplicatesOnly,
+    //             region: { minX, minY, maxX, maxY } (м), wall: "GUID", facade: 0...7 }
+    // ------------------------------------------------------------
+    
+    jsACAPI->AddItem(TimedFunction("GetCassetteSelectionPage", [](GS::Ref<JS::Base> param, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
+        Int32 offset = 0;
+        Int32 count = 100;
+        SelectionSnapshot::ViewQuery query = SelectionSnapshot::GetDefaultQuery();
+        
+        if (GS::Ref<JS::Object> jsParam = GS::DynamicCast<JS::Object>(param)) {
+            const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& itemTable = jsParam->GetItemTable();
+            GS::Ref<JS::Base> item;
+            if (itemTable.Get("offset", &item)) offset = JsDecode::GetInt(item, 0);
+            if (itemTable.Get("count", &item)) count = JsDecode::GetInt(item, 100);
+            if (itemTable.Get("sortKey", &item)) query.sortKey = SelectionSnapshot::SortKeyFromString(JsDecode::GetString(item));
+            if (itemTable.Get("descending", &item)) query.descending = JsDecode::GetBool(item);
+            if (itemTable.Get("idFilter", &item)) query.idFilter = JsDecode::GetString(item);
+            if (itemTable.Get("calcType", &item)) query.calcTypeFilter = JsDecode::GetInt(item, -2);
+            if (itemTable.Get("duplicatesOnly", &item)) query.duplicatesOnly = JsDecode::GetBool(item);
+            if (itemTable.Get("region", &item)) {
+                if (GS::Ref<JS::Object> jsRegion = GS::DynamicCast<JS::Object>(item)) {
+                    const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& regionTable = jsRegion->GetItemTable();
+                    GS::Ref<JS::Base> bound;
+                    query.regionFilter = true;
+                    if (regionTable.Get("minX", &bound)) query.regionMinX = JsDecode::GetDouble(bound);
+                    if (regionTable.Get("minY", &bound)) query.regionMinY = JsDecode::GetDouble(bound);
+                    if (regionTable.Get("maxX", &bound)) query.regionMaxX = JsDecode::GetDouble(bound);
+                    if (regionTable.Get("maxY", &bound)) query.regionMaxY = JsDecode::GetDouble(bound);
+                }
+            }
+            if (itemTable.Get("wall", &item)) {
+                const GS::UniString wall = JsDecode::GetString(item);
+                if (!wall.IsEmpty()) query.wallFilter = APIGuidFromString(wall.ToCStr().Get());
+            }
+            if (itemTable.Get("facade", &item)) query.facadeFilter = JsDecode::GetInt(item, -1);
+        }
+        if (offset < 0) offset = 0;
+        if (count < 0) count = 0;
+        timer.DecodeDone();
+        
+        const USize total = SelectionSnapshot::ApplyQuery(query);
+        const GS::Array<UIndex> page = SelectionSnapshot::GetPage(static_cast<UIndex>(offset), static_cast<USize>(count));
+        timer.NativeDone();
+        const GS::Array<CassetteHelper::WindowDoorInfo>& windows = SelectionSnapshot::GetWindows();
+        
+        GS::Ref<JS::Array> jsRows = new JS::Array();
+        for (UIndex index : page) {
+            const CassetteHelper::WindowDoorInfo& w = windows[index];
+            GS::Ref<JS::Object> jsRow = new JS::Object();
+            jsRow->AddItem("index", new JS::Value(static_cast<Int32>(index)));
+            jsRow->AddItem("id", new JS::Value(IdPool::Get(w.id)));
+            jsRow->AddItem("elemType", new JS::Value(GS::UniString(CassetteHelper::GetElemTypeName(w.elemType))));
+            jsRow->AddItem("width", new JS::Value(Mm::ToMetres(w.width)));
+            jsRow->AddItem("height", new JS::Value(Mm::ToMetres(w.height)));
+            jsRow->AddItem("sillHeight", new JS::Value(Mm::ToMetres(w.sillHeight)));
+            jsRow->AddItem("calcType", new JS::Value(static_cast<Int32>(w.calcType)));
+            jsRow->AddItem("duplicate", new JS::Value(SelectionSnapshot::IsDuplicate(index)));
+            jsRow->AddItem("duplicateGroup", new JS::Value(SelectionSnapshot::GetDuplicateGroup(index)));
+            jsRow->AddItem("x", new JS::Value(w.x));
+            jsRow->AddItem("y", new JS::Value(w.y));
+            jsRow->AddItem("angle", new JS::Value(w.angle));
+            jsRow->AddItem("normal", new JS::Value(w.normal));
+            jsRow->AddItem("wall", new JS::Value(w.wall == APINULLGuid ? GS::UniString() : APIGuidToString(w.wall)));
+            jsRow->AddItem("facade", new JS::Value(SelectionSnapshot::GetFacade(index)));
+            jsRows->AddItem(jsRow);
+        }
+        
+        GS::Ref<JS::Object> result = new JS::Object();
+        result->AddItem("total", new JS::Value(static_cast<Int32>(total)));
+        result->AddItem("offset", new JS::Value(offset));
+        result->AddItem("rows", jsRows);
         result->AddItem("success", new JS::Value(true));
         
         return result;
     }));
 
+    // ------------------------------------------------------------
+    // SelectCassetteDuplicates - выделить в модели элементы с повторяющимся ID
+    // Параметр: { group } - номер группы из GetCassetteSelection.duplicateGroups;
+    // без него или -1 - все группы. GUID берутся из снимка, без нового поиска.
+    // ------------------------------------------------------------
+    
+    jsACAPI->AddItem(TimedFunction("SelectCassetteDuplicates", [](GS::Ref<JS::Base> param, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
+        Int32 group = -1;
+        if (GS::Ref<JS::Object> jsParam = GS::DynamicCast<JS::Object>(param)) {
+            GS::Ref<JS::Base> item;
+            if (jsParam->GetItemTable().Get("group", &item)) group = JsDecode::GetInt(item, -1);
+        }
+        timer.DecodeDone();
+        
+        const GS::Array<CassetteHelper::DuplicateGroup>& groups = SelectionSnapshot::GetDuplicateGroups();
+        GS::Array<API_Guid> guids;
+        for (UIndex g = 0; g < groups.GetSize(); ++g) {
+            if (group < 0 || static_cast<UIndex>(group) == g) {
+                guids.Append(groups[g].guids);
+            }
+        }
+        const bool success = !guids.IsEmpty() && CassetteHelper::SelectElements(guids);
+        timer.NativeDone();
+        
+        GS::Ref<JS::Object> result = new JS::Object();
+        result->AddItem("success", new JS::Value(success));
+        result->AddItem("count", new JS::Value(static_cast<Int32>(guids.GetSize())));
+        return result;
+    }));
+
     // ------------------------------------------------------------
     // GetFloorHeightFromWall - получить высоту этажа из стены
     // ------------------------------------------------------------
     
-    jsACAPI->AddItem(new JS::Function("GetFloorHeightFromWall", [](GS::Ref<JS::Base> param) -> GS::Ref<JS::Base> {
-        GS::UniString wallId = GetStringFromJs(param);
+    jsACAPI->AddItem(TimedFunction("GetFloorHeightFromWall", [](GS::Ref<JS::Base> param, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
+        GS::UniString wallId = JsDecode::GetString(param);
         if (wallId.IsEmpty()) wallId = "СН-МД1";
+        timer.DecodeDone();
         
         double height = CassetteHelper::GetFloorHeightFromWall(wallId);
+        timer.NativeDone();
         
         GS::Ref<JS::Object> result = new JS::Object();
         result->AddItem("height", new JS::Value(height));
@@ -156,24 +296,27 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& browser)
         return result;
     }));
 
-    // ------------------------------------------------------------
-    // CalculateCassettes и WriteCassetteResults - временно отключены
-    // Требуется исправление API для работы с JS::Object/JS::Array
-    // TODO: Найти правильный способ доступа к свойствам JS::Object
-    // ------------------------------------------------------------
-
     // ------------------------------------------------------------
     // GetCassetteSettings - получить настройки
     // ------------------------------------------------------------
     
-    jsACAPI->AddItem(new JS::Function("GetCassetteSettings", [](GS::Ref<JS::Base>) -> GS::Ref<JS::Base> {
+    jsACAPI->AddItem(TimedFunction("GetCassetteSettings", [](GS::Ref<JS::Base>, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
         CassetteSettings::Settings settings;
         CassetteSettings::LoadSettings(settings);
+        // Коды типов ID из файла; при ошибке в файле остаются прежние правила
+        const bool idTypesValid = CassetteSettings::ApplyIdTypes(settings);
+        GS::UniString typeDefinitionsError;
+        CassetteSettings::ApplyTypeDefinitions(settings, typeDefinitionsError);
+        timer.NativeDone();
         
         GS::Ref<JS::Object> result = new JS::Object();
         result->AddItem("defaultType", new JS::Value(settings.defaultType));
         result->AddItem("wallIdForFloorHeight", new JS::Value(settings.wallIdForFloorHeight));
         result->AddItem("showDuplicateWarning", new JS::Value(settings.showDuplicateWarning));
+        result->AddItem("idTypeCodes", new JS::Value(settings.idTypeCodes));
+        result->AddItem("idPrefixes", new JS::Value(settings.idPrefixes));
+        result->AddItem("idTypesValid", new JS::Value(idTypesValid));
+        result->AddItem("typeDefinitionsError", new JS::Value(typeDefinitionsError));
         
         // Тип 0
         GS::Ref<JS::Object> type0 = new JS::Object();
@@ -227,7 +370,7 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& browser)
     // SaveCassetteSettings - сохранить настройки
     // ------------------------------------------------------------
 
-    jsACAPI->AddItem(new JS::Function("SaveCassetteSettings", [](GS::Ref<JS::Base> param) -> GS::Ref<JS::Base> {
+    jsACAPI->AddItem(TimedFunction("SaveCassetteSettings", [](GS::Ref<JS::Base> param, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
         GS::Ref<JS::Object> result = new JS::Object();
         bool success = false;
         GS::UniString errorMessage;
@@ -238,23 +381,25 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& browser)
             const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& itemTable = jsParam->GetItemTable();
             GS::Ref<JS::Base> item;
 
-            if (itemTable.Get("defaultType", &item)) settings.defaultType = GetIntFromJs(item);
-            if (itemTable.Get("wallIdForFloorHeight", &item)) settings.wallIdForFloorHeight = GetStringFromJs(item);
-            if (itemTable.Get("showDuplicateWarning", &item)) settings.showDuplicateWarning = GetBoolFromJs(item);
+            if (itemTable.Get("defaultType", &item)) settings.defaultType = JsDecode::GetInt(item);
+            if (itemTable.Get("wallIdForFloorHeight", &item)) settings.wallIdForFloorHeight = JsDecode::GetString(item);
+            if (itemTable.Get("showDuplicateWarning", &item)) settings.showDuplicateWarning = JsDecode::GetBool(item);
+            if (itemTable.Get("idTypeCodes", &item)) settings.idTypeCodes = JsDecode::GetString(item);
+            if (itemTable.Get("idPrefixes", &item)) settings.idPrefixes = JsDecode::GetString(item);
 
             GS::Ref<JS::Base> type0Base;
             if (itemTable.Get("type0", &type0Base)) {
                 if (GS::Ref<JS::Object> type0Obj = GS::DynamicCast<JS::Object>(type0Base)) {
                     const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& type0Table = type0Obj->GetItemTable();
-                    if (type0Table.Get("plankWidth", &item)) settings.type0.plankWidth = GetIntFromJs(item);
-                    if (type0Table.Get("slopeWidth", &item)) settings.type0.slopeWidth = GetIntFromJs(item);
-                    if (type0Table.Get("offsetX", &item)) settings.type0.offsetX = GetIntFromJs(item);
-                    if (type0Table.Get("offsetY", &item)) settings.type0.offsetY = GetIntFromJs(item);
-                    if (type0Table.Get("x2Coeff", &item)) settings.type0.x2Coeff = GetIntFromJs(item);
-                    if (type0Table.Get("cassetteId", &item)) settings.type0.cassetteId = GetStringFromJs(item);
-                    if (type0Table.Get("plankId", &item)) settings.type0.plankId = GetStringFromJs(item);
-                    if (type0Table.Get("leftSlopeId", &item)) settings.type0.leftSlopeId = GetStringFromJs(item);
-                    if (type0Table.Get("rightSlopeId", &item)) settings.type0.rightSlopeId = GetStringFromJs(item);
+                    if (type0Table.Get("plankWidth", &item)) settings.type0.plankWidth = JsDecode::GetInt(item);
+                    if (type0Table.Get("slopeWidth", &item)) settings.type0.slopeWidth = JsDecode::GetInt(item);
+                    if (type0Table.Get("offsetX", &item)) settings.type0.offsetX = JsDecode::GetInt(item);
+                    if (type0Table.Get("offsetY", &item)) settings.type0.offsetY = JsDecode::GetInt(item);
+                    if (type0Table.Get("x2Coeff", &item)) settings.type0.x2Coeff = JsDecode::GetInt(item);
+                    if (type0Table.Get("cassetteId", &item)) settings.type0.cassetteId = JsDecode::GetString(item);
+                    if (type0Table.Get("plankId", &item)) settings.type0.plankId = JsDecode::GetString(item);
+                    if (type0Table.Get("leftSlopeId", &item)) settings.type0.leftSlopeId = JsDecode::GetString(item);
+                    if (type0Table.Get("rightSlopeId", &item)) settings.type0.rightSlopeId = JsDecode::GetString(item);
                 }
             }
 
@@ -265,27 +410,43 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& browser)
             if (type12Base != nullptr) {
                 if (GS::Ref<JS::Object> type12Obj = GS::DynamicCast<JS::Object>(type12Base)) {
                     const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& type12Table = type12Obj->GetItemTable();
-                    if (type12Table.Get("plankWidth", &item)) settings.type1_2.plankWidth = GetIntFromJs(item);
-                    if (type12Table.Get("slopeWidth", &item)) settings.type1_2.slopeWidth = GetIntFromJs(item);
-                    if (type12Table.Get("offsetX", &item)) settings.type1_2.offsetX = GetIntFromJs(item);
-                    if (type12Table.Get("offsetY", &item)) settings.type1_2.offsetY = GetIntFromJs(item);
-                    if (type12Table.Get("x2Coeff", &item)) settings.type1_2.x2Coeff = GetIntFromJs(item);
-                    if (type12Table.Get("cassetteId", &item)) settings.type1_2.cassetteId = GetStringFromJs(item);
-                    if (type12Table.Get("plankId", &item)) settings.type1_2.plankId = GetStringFromJs(item);
-                    if (type12Table.Get("leftSlopeId", &item)) settings.type1_2.leftSlopeId = GetStringFromJs(item);
-                    if (type12Table.Get("rightSlopeId", &item)) settings.type1_2.rightSlopeId = GetStringFromJs(item);
+                    if (type12Table.Get("plankWidth", &item)) settings.type1_2.plankWidth = JsDecode::GetInt(item);
+                    if (type12Table.Get("slopeWidth", &item)) settings.type1_2.slopeWidth = JsDecode::GetInt(item);
+                    if (type12Table.Get("offsetX", &item)) settings.type1_2.offsetX = JsDecode::GetInt(item);
+                    if (type12Table.Get("offsetY", &item)) settings.type1_2.offsetY = JsDecode::GetInt(item);
+                    if (type12Table.Get("x2Coeff", &item)) settings.type1_2.x2Coeff = JsDecode::GetInt(item);
+                    if (type12Table.Get("cassetteId", &item)) settings.type1_2.cassetteId = JsDecode::GetString(item);
+                    if (type12Table.Get("plankId", &item)) settings.type1_2.plankId = JsDecode::GetString(item);
+                    if (type12Table.Get("leftSlopeId", &item)) settings.type1_2.leftSlopeId = JsDecode::GetString(item);
+                    if (type12Table.Get("rightSlopeId", &item)) settings.type1_2.rightSlopeId = JsDecode::GetString(item);
                 }
             }
         } else {
             errorMessage = "Неверные параметры";
         }
 
+        timer.DecodeDone();
+
+        // Определения типов палитра не передаёт - сохраняются из файла
+        CassetteSettings::Settings stored;
+        CassetteSettings::LoadSettings(stored);
+        settings.typeDefinitions = stored.typeDefinitions;
+
+        // Коды типов ID проверяются до записи: неверная строка не сохраняется
+        if (errorMessage.IsEmpty() && !CassetteSettings::ApplyIdTypes(settings)) {
+            errorMessage = "Неверные коды типов ID (формат: 0=0,1=1,2=2) или префиксы (ОК-,ДВ-)";
+        }
+        GS::UniString typeDefinitionsError;
+        if (errorMessage.IsEmpty() && !CassetteSettings::ApplyTypeDefinitions(settings, typeDefinitionsError)) {
+            errorMessage = "Неверное определение типа: " + typeDefinitionsError;
+        }
         if (errorMessage.IsEmpty()) {
             success = CassetteSettings::SaveSettings(settings);
             if (!success) {
                 errorMessage = "Не удалось сохранить настройки";
             }
         }
+        timer.NativeDone();
 
         result->AddItem("success", new JS::Value(success));
         result->AddItem("errorMessage", new JS::Value(errorMessage));
@@ -295,9 +456,10 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& browser)
 
     // ------------------------------------------------------------
     // CalculateCassettes - выполнить расчёт кассет
+    // Параметр: { windows (иначе снимок выделения), params, groupBy: "facade" | "wall" | "storey" }
     // ------------------------------------------------------------
     
-    jsACAPI->AddItem(new JS::Function("CalculateCassettes", [](GS::Ref<JS::Base> param) -> GS::Ref<JS::Base> {
+    jsACAPI->AddItem(TimedFunction("CalculateCassettes", [](GS::Ref<JS::Base> param, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
         GS::Ref<JS::Object> result = new JS::Object();
         
         // Парсим параметры из JS объекта
@@ -305,110 +467,56 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& browser)
             // Получаем хеш-таблицу элементов объекта
             const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& itemTable = jsParam->GetItemTable();
             
-            // Получаем окна
+            // Получаем окна: из переданного массива или из снимка выделения
             GS::Array<CassetteHelper::WindowDoorInfo> windows;
             GS::Ref<JS::Base> windowsBase;
-            if (itemTable.Get("windows", &windowsBase)) {
+            const bool hasWindows = itemTable.Get("windows", &windowsBase);
+            if (hasWindows) {
                 if (GS::Ref<JS::Array> jsWindows = GS::DynamicCast<JS::Array>(windowsBase)) {
                     const GS::Array<GS::Ref<JS::Base>>& windowItems = jsWindows->GetItemArray();
+                    windows.EnsureCapacity(windowItems.GetSize());
                     for (UIndex i = 0; i < windowItems.GetSize(); ++i) {
-                        if (GS::Ref<JS::Object> jsWindow = GS::DynamicCast<JS::Object>(windowItems[i])) {
-                            const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& windowTable = jsWindow->GetItemTable();
-                            CassetteHelper::WindowDoorInfo w;
-                            
-                            GS::Ref<JS::Base> item;
-                            if (windowTable.Get("id", &item)) w.id = GetStringFromJs(item);
-                            if (windowTable.Get("elemType", &item)) w.elemType = GetStringFromJs(item);
-                            if (windowTable.Get("width", &item)) w.width = GetDoubleFromJs(item);
-                            if (windowTable.Get("height", &item)) w.height = GetDoubleFromJs(item);
-                            if (windowTable.Get("sillHeight", &item)) w.sillHeight = GetDoubleFromJs(item);
-                            if (windowTable.Get("x", &item)) w.x = GetDoubleFromJs(item);
-                            if (windowTable.Get("y", &item)) w.y = GetDoubleFromJs(item);
-                            if (windowTable.Get("angle", &item)) w.angle = GetDoubleFromJs(item);
-                            if (windowTable.Get("calcType", &item)) w.calcType = GetIntFromJs(item);
-                            
+                        CassetteHelper::WindowDoorInfo w;
+                        if (JsDecode::DecodeWindow(windowItems[i], w)) {
                             windows.Push(w);
                         }
                     }
                 }
             }
             
+            const GS::Array<CassetteHelper::WindowDoorInfo>& calcWindows = 
+                hasWindows ? windows : SelectionSnapshot::GetWindows();
+            
             // Получаем параметры расчёта (инициализируем значениями по умолчанию)
             CassetteHelper::CalcParams params = CassetteHelper::GetDefaultParams(CassetteHelper::CalcType::Type1And2);
             GS::Ref<JS::Base> paramsBase;
             if (itemTable.Get("params", &paramsBase)) {
-                if (GS::Ref<JS::Object> jsParams = GS::DynamicCast<JS::Object>(paramsBase)) {
-                    const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& paramsTable = jsParams->GetItemTable();
-                    GS::Ref<JS::Base> item;
-                    if (paramsTable.Get("type", &item)) params.type = static_cast<CassetteHelper::CalcType>(GetIntFromJs(item));
-                    if (paramsTable.Get("floorHeight", &item)) params.floorHeight = GetDoubleFromJs(item, 2.99);
-                    // Параметры для типа 0
-                    if (paramsTable.Get("plankWidth0", &item)) params.plankWidth0 = GetIntFromJs(item, 285);
-                    if (paramsTable.Get("slopeWidth0", &item)) params.slopeWidth0 = GetIntFromJs(item, 285);
-                    // Параметры для типов 1-2
-                    if (paramsTable.Get("plankWidth12", &item)) params.plankWidth12 = GetIntFromJs(item, 160);
-                    if (paramsTable.Get("slopeWidth12", &item)) params.slopeWidth12 = GetIntFromJs(item, 225);
-                    // Общие параметры
-                    if (paramsTable.Get("offsetX", &item)) params.offsetX = GetIntFromJs(item, 165);
-                    if (paramsTable.Get("offsetY", &item)) params.offsetY = GetIntFromJs(item, 50);
-                    if (paramsTable.Get("offsetTop", &item)) params.offsetTop = GetIntFromJs(item, 745);
-                }
+                JsDecode::DecodeCalcParams(paramsBase, params);
+            }
+            
+            // Разбивка по фасадам/стенам/этажам (общий результат считается в том же проходе)
+            CassetteHelper::GroupBy groupBy = CassetteHelper::GroupBy::None;
+            GS::Ref<JS::Base> groupByBase;
+            if (itemTable.Get("groupBy", &groupByBase)) {
+                groupBy = CassetteHelper::GroupByFromString(JsDecode::GetString(groupByBase));
             }
             
-            // Выполняем расчёт
-            CassetteHelper::CalculationResult calcResult = 
-                CassetteHelper::Calculate(windows, params);
+            timer.DecodeDone();
+            
+            // Выполняем расчёт (повтор с теми же окнами и параметрами - из кэша)
+            bool cached = false;
+            const CalcCache::Entry& entry = CalcCache::Calculate(calcWindows, params, groupBy, cached);
+            const CassetteHelper::CalculationResult& calcResult = entry.result;
+            const GS::Array<CassetteHelper::CalculationGroup>& groups = entry.groups;
+            timer.NativeDone();
             
             // Конвертируем результат в JS
             result->AddItem("success", new JS::Value(calcResult.success));
             result->AddItem("errorMessage", new JS::Value(calcResult.errorMessage));
+            result->AddItem("handle", new JS::Value(entry.handle));
+            result->AddItem("cached", new JS::Value(cached));
             
-            // Кассеты
-            GS::Ref<JS::Array> jsCassettes = new JS::Array();
-            for (const CassetteHelper::CassetteSize& cs : calcResult.cassettes) {
-                GS::Ref<JS::Object> jsCs = new JS::Object();
-                jsCs->AddItem("x", new JS::Value(cs.x));
-                jsCs->AddItem("y", new JS::Value(cs.y));
-                jsCs->AddItem("count", new JS::Value(cs.count));
-                jsCassettes->AddItem(jsCs);
-            }
-            result->AddItem("cassettes", jsCassettes);
-            
-            // Планки
-            GS::Ref<JS::Array> jsPlanks = new JS::Array();
-            for (const CassetteHelper::PlankSize& ps : calcResult.planks) {
-                GS::Ref<JS::Object> jsPs = new JS::Object();
-                jsPs->AddItem("width", new JS::Value(ps.width));
-                jsPs->AddItem("length", new JS::Value(ps.length));
-                jsPs->AddItem("count", new JS::Value(ps.count));
-                jsPs->AddItem("calcType", new JS::Value(ps.calcType));
-                jsPlanks->AddItem(jsPs);
-            }
-            result->AddItem("planks", jsPlanks);
-            
-            // Левые откосы
-            GS::Ref<JS::Array> jsLeftSlopes = new JS::Array();
-            for (const CassetteHelper::PlankSize& ps : calcResult.leftSlopes) {
-                GS::Ref<JS::Object> jsPs = new JS::Object();
-                jsPs->AddItem("width", new JS::Value(ps.width));
-                jsPs->AddItem("length", new JS::Value(ps.length));
-                jsPs->AddItem("count", new JS::Value(ps.count));
-                jsPs->AddItem("calcType", new JS::Value(ps.calcType));
-                jsLeftSlopes->AddItem(jsPs);
-            }
-            result->AddItem("leftSlopes", jsLeftSlopes);
-            
-            // Правые откосы
-            GS::Ref<JS::Array> jsRightSlopes = new JS::Array();
-            for (const CassetteHelper::PlankSize& ps : calcResult.rightSlopes) {
-                GS::Ref<JS::Object> jsPs = new JS::Object();
-                jsPs->AddItem("width", new JS::Value(ps.width));
-                jsPs->AddItem("length", new JS::Value(ps.length));
-                jsPs->AddItem("count", new JS::Value(ps.count));
-                jsPs->AddItem("calcType", new JS::Value(ps.calcType));
-                jsRightSlopes->AddItem(jsPs);
-            }
-            result->AddItem("rightSlopes", jsRightSlopes);
+            AddResultLists(result, calcResult);
             
             // Дубликаты
             GS::Ref<JS::Array> jsDuplicates = new JS::Array();
@@ -416,6 +524,20 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& browser)
                 jsDuplicates->AddItem(new JS::Value(dup));
             }
             result->AddItem("duplicates", jsDuplicates);
+            
+            // Группы: строки каждой группы (без дескрипторов - групп может быть больше, чем хранит ResultStore)
+            if (groupBy != CassetteHelper::GroupBy::None) {
+                GS::Ref<JS::Array> jsGroups = new JS::Array();
+                for (const CassetteHelper::CalculationGroup& group : groups) {
+                    GS::Ref<JS::Object> jsGroup = new JS::Object();
+                    jsGroup->AddItem("key", new JS::Value(group.key));
+                    jsGroup->AddItem("label", new JS::Value(group.label));
+                    jsGroup->AddItem("windows", new JS::Value(static_cast<Int32>(group.windowCount)));
+                    AddResultLists(jsGroup, group.result);
+                    jsGroups->AddItem(jsGroup);
+                }
+                result->AddItem("groups", jsGroups);
+            }
         }
         
         return result;
@@ -425,7 +547,7 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& browser)
     // WriteCassetteResults - записать результаты в GDL объекты
     // ------------------------------------------------------------
     
-    jsACAPI->AddItem(new JS::Function("WriteCassetteResults", [](GS::Ref<JS::Base> param) -> GS::Ref<JS::Base> {
+    jsACAPI->AddItem(TimedFunction("WriteCassetteResults", [](GS::Ref<JS::Base> param, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
         GS::Ref<JS::Object> result = new JS::Object();
         bool success = false;
         GS::UniString errorMessage;
@@ -433,153 +555,859 @@ void BrowserRepl::RegisterACAPIJavaScriptObject(DG::Browser& browser)
         if (GS::Ref<JS::Object> jsParam = GS::DynamicCast<JS::Object>(param)) {
             const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& itemTable = jsParam->GetItemTable();
             
-            // Парсим результат расчёта
-            CassetteHelper::CalculationResult calcResult;
-            calcResult.success = true;
-            
-            // Получаем вложенный объект result
-            GS::Ref<JS::Base> resultBase;
-            if (!itemTable.Get("result", &resultBase)) {
-                errorMessage = "Отсутствует объект result";
+            // Результат расчёта: по дескриптору или из переданного объекта
+            CassetteHelper::CalculationResult decodedResult;
+            const CassetteHelper::CalculationResult* calcResult = ResolveResult(itemTable, decodedResult);
+            if (calcResult == nullptr) {
+                timer.DecodeDone();
+                timer.NativeDone();
+                errorMessage = "Отсутствует результат расчёта (handle или result)";
                 result->AddItem("success", new JS::Value(false));
                 result->AddItem("errorMessage", new JS::Value(errorMessage));
                 return result;
             }
             
-            GS::Ref<JS::Object> jsResultObj = GS::DynamicCast<JS::Object>(resultBase);
-            if (!jsResultObj) {
-                errorMessage = "result не является объектом";
-                result->AddItem("success", new JS::Value(false));
-                result->AddItem("errorMessage", new JS::Value(errorMessage));
-                return result;
+            // Парсим целевые объекты
+            CassetteHelper::TargetObjects targets;
+            targets.overflowPages = false;
+            GS::Ref<JS::Base> targetsBase;
+            if (itemTable.Get("targets", &targetsBase)) {
+                JsDecode::DecodeTargets(targetsBase, targets);
             }
             
-            const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& resultTable = jsResultObj->GetItemTable();
-            
-            // Парсим кассеты
-            GS::Ref<JS::Base> cassettesBase;
-            if (resultTable.Get("cassettes", &cassettesBase)) {
-                if (GS::Ref<JS::Array> jsCassettes = GS::DynamicCast<JS::Array>(cassettesBase)) {
-                    const GS::Array<GS::Ref<JS::Base>>& items = jsCassettes->GetItemArray();
-                    for (UIndex i = 0; i < items.GetSize(); ++i) {
-                        if (GS::Ref<JS::Object> jsCs = GS::DynamicCast<JS::Object>(items[i])) {
-                            const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& csTable = jsCs->GetItemTable();
-                            CassetteHelper::CassetteSize cs;
-                            GS::Ref<JS::Base> item;
-                            if (csTable.Get("x", &item)) cs.x = GetIntFromJs(item);
-                            if (csTable.Get("y", &item)) cs.y = GetIntFromJs(item);
-                            if (csTable.Get("count", &item)) cs.count = GetIntFromJs(item);
-                            calcResult.cassettes.Push(cs);
-                        }
+            // Парсим параметры для определения типа
+            CassetteHelper::CalcParams params = CassetteHelper::GetDefaultParams(CassetteHelper::CalcType::Type1And2);
+            GS::Ref<JS::Base> paramsBase;
+            if (itemTable.Get("params", &paramsBase)) {
+                JsDecode::DecodeCalcParams(paramsBase, params);
+            } else {
+                // Пытаемся определить тип из результата (если есть кассеты, то тип 1-2)
+                params.type = (calcResult->cassettes.GetSize() > 0) 
+                    ? CassetteHelper::CalcType::Type1And2 
+                    : CassetteHelper::CalcType::Type0;
+            }
+            
+            timer.DecodeDone();
+            
+            // Записываем результаты
+            success = CassetteHelper::WriteToTargetObjects(*calcResult, targets, params);
+            timer.NativeDone();
+            if (!success) {
+                errorMessage = "Не удалось записать результаты в объекты";
+            }
+        } else {
+            errorMessage = "Неверные параметры";
+        }
+        
+        result->AddItem("success", new JS::Value(success));
+        result->AddItem("errorMessage", new JS::Value(errorMessage));
+        
+        return result;
+    }));
+
+    // ------------------------------------------------------------
+    // PlaceFacadeObjects - разместить кассеты, планки и откосы у проёмов
+    // { params?, parts: { cassette?, plank?, slope?, textParam? } }
+    // Проёмы - из снимка выделения; все объекты - одной командой отмены
+    // ------------------------------------------------------------
+    
+    jsACAPI->AddItem(TimedFunction("PlaceFacadeObjects", [](GS::Ref<JS::Base> param, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
+        GS::Ref<JS::Object> result = new JS::Object();
+        bool success = false;
+        GS::UniString errorMessage;
+        UInt32 pieces = 0;
+        UInt32 created = 0;
+        
+        if (GS::Ref<JS::Object> jsParam = GS::DynamicCast<JS::Object>(param)) {
+            const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& itemTable = jsParam->GetItemTable();
+            
+            CassetteHelper::CalcParams params = CassetteHelper::GetDefaultParams(CassetteHelper::CalcType::Type1And2);
+            GS::Ref<JS::Base> item;
+            if (itemTable.Get("params", &item)) {
+                JsDecode::DecodeCalcParams(item, params);
+            }
+            
+            CassetteHelper::PlacementParts parts;
+            if (itemTable.Get("parts", &item)) {
+                if (GS::Ref<JS::Object> jsParts = GS::DynamicCast<JS::Object>(item)) {
+                    const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& partsTable = jsParts->GetItemTable();
+                    GS::Ref<JS::Base> part;
+                    if (partsTable.Get("cassette", &part)) {
+                        parts.cassette = JsDecode::GetString(part);
+                    }
+                    if (partsTable.Get("plank", &part)) {
+                        parts.plank = JsDecode::GetString(part);
+                    }
+                    if (partsTable.Get("slope", &part)) {
+                        parts.slope = JsDecode::GetString(part);
+                    }
+                    if (partsTable.Get("textParam", &part)) {
+                        parts.textParam = JsDecode::GetString(part);
                     }
                 }
             }
+            timer.DecodeDone();
             
-            // Парсим планки
-            GS::Ref<JS::Base> planksBase;
-            if (resultTable.Get("planks", &planksBase)) {
-                if (GS::Ref<JS::Array> jsPlanks = GS::DynamicCast<JS::Array>(planksBase)) {
-                    const GS::Array<GS::Ref<JS::Base>>& items = jsPlanks->GetItemArray();
-                    for (UIndex i = 0; i < items.GetSize(); ++i) {
-                        if (GS::Ref<JS::Object> jsPs = GS::DynamicCast<JS::Object>(items[i])) {
-                            const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& psTable = jsPs->GetItemTable();
-                            CassetteHelper::PlankSize ps;
-                            GS::Ref<JS::Base> item;
-                            if (psTable.Get("width", &item)) ps.width = GetIntFromJs(item);
-                            if (psTable.Get("length", &item)) ps.length = GetIntFromJs(item);
-                            if (psTable.Get("count", &item)) ps.count = GetIntFromJs(item);
-                            if (psTable.Get("calcType", &item)) ps.calcType = GetIntFromJs(item); else ps.calcType = 0;
-                            calcResult.planks.Push(ps);
-                        }
-                    }
+            if (SelectionSnapshot::GetCount() == 0) {
+                errorMessage = "Нет окон в снимке выделения";
+            } else if (parts.cassette.IsEmpty() && parts.plank.IsEmpty() && parts.slope.IsEmpty()) {
+                errorMessage = "Не задан ни один библиотечный элемент";
+            } else {
+                success = CassetteHelper::PlaceFacadeObjects(SelectionSnapshot::GetWindows(), params, parts, pieces, created);
+                if (!success) {
+                    errorMessage = "Не удалось разместить объекты (подробности в отчёте)";
                 }
             }
+            timer.NativeDone();
+        } else {
+            errorMessage = "Неверные параметры";
+        }
+        
+        result->AddItem("success", new JS::Value(success));
+        result->AddItem("errorMessage", new JS::Value(errorMessage));
+        result->AddItem("pieces", new JS::Value(static_cast<Int32>(pieces)));
+        result->AddItem("created", new JS::Value(static_cast<Int32>(created)));
+        
+        return result;
+    }));
+
+    // ------------------------------------------------------------
+    // ExportResultsCsv - экспорт результата расчёта в CSV
+    // { handle | result, path? } - без path показывается диалог сохранения
+    // ------------------------------------------------------------
+    
+    jsACAPI->AddItem(TimedFunction("ExportResultsCsv", [](GS::Ref<JS::Base> param, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
+        GS::Ref<JS::Object> result = new JS::Object();
+        bool success = false;
+        bool cancelled = false;
+        GS::UniString errorMessage;
+        GS::UniString path;
+        CassetteCsv::ExportStats stats = { 0, 0 };
+        
+        if (GS::Ref<JS::Object> jsParam = GS::DynamicCast<JS::Object>(param)) {
+            const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& itemTable = jsParam->GetItemTable();
             
-            // Парсим левые откосы
-            GS::Ref<JS::Base> leftSlopesBase;
-            if (resultTable.Get("leftSlopes", &leftSlopesBase)) {
-                if (GS::Ref<JS::Array> jsLeftSlopes = GS::DynamicCast<JS::Array>(leftSlopesBase)) {
-                    const GS::Array<GS::Ref<JS::Base>>& items = jsLeftSlopes->GetItemArray();
-                    for (UIndex i = 0; i < items.GetSize(); ++i) {
-                        if (GS::Ref<JS::Object> jsPs = GS::DynamicCast<JS::Object>(items[i])) {
-                            const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& psTable = jsPs->GetItemTable();
-                            CassetteHelper::PlankSize ps;
-                            GS::Ref<JS::Base> item;
-                            if (psTable.Get("width", &item)) ps.width = GetIntFromJs(item);
-                            if (psTable.Get("length", &item)) ps.length = GetIntFromJs(item);
-                            if (psTable.Get("count", &item)) ps.count = GetIntFromJs(item);
-                            if (psTable.Get("calcType", &item)) ps.calcType = GetIntFromJs(item); else ps.calcType = 0;
-                            calcResult.leftSlopes.Push(ps);
+            CassetteHelper::CalculationResult decodedResult;
+            const CassetteHelper::CalculationResult* calcResult = ResolveResult(itemTable, decodedResult);
+            
+            GS::Ref<JS::Base> pathBase;
+            if (itemTable.Get("path", &pathBase)) {
+                path = JsDecode::GetString(pathBase);
+            }
+            timer.DecodeDone();
+            
+            if (calcResult == nullptr) {
+                errorMessage = "Отсутствует результат расчёта (handle или result)";
+            } else {
+                if (path.IsEmpty()) {
+                    const FileDialogs::FileType csvType = { "CSV файлы", "csv" };
+                    cancelled = !FileDialogs::AskSavePath("Экспорт CSV", csvType,
+                        FileDialogs::MakeDatedFileName("cassettes_export", "csv"), path);
+                }
+                if (!cancelled) {
+                    success = CassetteCsv::ExportResult(path, *calcResult, stats, errorMessage);
+                }
+            }
+            timer.NativeDone();
+        } else {
+            errorMessage = "Неверные параметры";
+        }
+        
+        result->AddItem("success", new JS::Value(success));
+        result->AddItem("cancelled", new JS::Value(cancelled));
+        result->AddItem("path", new JS::Value(path));
+        result->AddItem("rows", new JS::Value(static_cast<Int32>(stats.rows)));
+        result->AddItem("bytes", new JS::Value(static_cast<double>(stats.bytes)));
+        result->AddItem("errorMessage", new JS::Value(errorMessage));
+        
+        return result;
+    }));
+
+    // ------------------------------------------------------------
+    // ImportResultsCsv - импорт результата из CSV в ResultStore
+    // { path? } - без path показывается диалог открытия
+    // ------------------------------------------------------------
+    
+    jsACAPI->AddItem(TimedFunction("ImportResultsCsv", [](GS::Ref<JS::Base> param, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
+        GS::Ref<JS::Object> result = new JS::Object();
+        bool success = false;
+        bool cancelled = false;
+        GS::UniString errorMessage;
+        GS::UniString path;
+        
+        if (GS::Ref<JS::Object> jsParam = GS::DynamicCast<JS::Object>(param)) {
+            GS::Ref<JS::Base> pathBase;
+            if (jsParam->GetItemTable().Get("path", &pathBase)) {
+                path = JsDecode::GetString(pathBase);
+            }
+        }
+        timer.DecodeDone();
+        
+        if (path.IsEmpty()) {
+            const FileDialogs::FileType csvType = { "CSV файлы", "csv" };
+            cancelled = !FileDialogs::AskOpenPath("Импорт CSV", csvType, path);
+        }
+        
+        CassetteHelper::CalculationResult imported;
+        CassetteCsv::ImportStats stats = { 0, 0, 0, 0 };
+        Int32 handle = ResultStore::InvalidHandle;
+        if (!cancelled) {
+            success = CassetteCsv::ImportResult(path, imported, stats, errorMessage);
+            if (success) {
+                handle = ResultStore::Put(imported);
+            }
+        }
+        timer.NativeDone();
+        
+        result->AddItem("success", new JS::Value(success));
+        result->AddItem("cancelled", new JS::Value(cancelled));
+        result->AddItem("path", new JS::Value(path));
+        result->AddItem("errorMessage", new JS::Value(errorMessage));
+        result->AddItem("handle", new JS::Value(handle));
+        result->AddItem("rows", new JS::Value(static_cast<Int32>(stats.rows)));
+        result->AddItem("imported", new JS::Value(static_cast<Int32>(stats.imported)));
+        result->AddItem("skipped", new JS::Value(static_cast<Int32>(stats.skipped)));
+        result->AddItem("firstSkippedLine", new JS::Value(static_cast<Int32>(stats.firstSkippedLine)));
+        if (success) {
+            AddResultLists(result, imported);
+        }
+        
+        return result;
+    }));
+
+    // ------------------------------------------------------------
+    // ImportTsprgWorkbooks - расчёт по книгам Excel старых скриптов tsprg
+    // { paths?, params? } - без paths показывается диалог (можно выбрать несколько)
+    // Каждая книга считается со своей высотой этажа (I2), результаты суммируются
+    // ------------------------------------------------------------
+    
+    jsACAPI->AddItem(TimedFunction("ImportTsprgWorkbooks", [](GS::Ref<JS::Base> param, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
+        GS::Ref<JS::Object> result = new JS::Object();
+        bool cancelled = false;
+        GS::UniString errorMessage;
+        GS::Array<GS::UniString> paths;
+        CassetteHelper::CalcParams params = CassetteHelper::GetDefaultParams(CassetteHelper::CalcType::Type1And2);
+        
+        if (GS::Ref<JS::Object> jsParam = GS::DynamicCast<JS::Object>(param)) {
+            const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& itemTable = jsParam->GetItemTable();
+        
+            GS::Ref<JS::Base> item;
+            if (itemTable.Get("paths", &item)) {
+                if (GS::Ref<JS::Array> jsPaths = GS::DynamicCast<JS::Array>(item)) {
+                    for (const GS::Ref<JS::Base>& pathItem : jsPaths->GetItemArray()) {
+                        const GS::UniString path = JsDecode::GetString(pathItem);
+                        if (!path.IsEmpty()) {
+                            paths.Push(path);
                         }
                     }
                 }
             }
+            if (itemTable.Get("params", &item)) {
+                JsDecode::DecodeCalcParams(item, params);
+            }
+        }
+        timer.DecodeDone();
+        
+        if (paths.IsEmpty()) {
+            const FileDialogs::FileType xlsxType = { "Книга Excel", "xlsx" };
+            cancelled = !FileDialogs::AskOpenPaths("Импорт книг tsprg", xlsxType, paths);
+        }
+        
+        // Книги читаются по очереди; в памяти одна отображённая книга и сумма результатов
+        const CassetteCore::Params baseParams = CassetteHelper::ToCoreParams(params);
+        CassetteCore::Result total;
+        CassetteCore::Result single;
+        TsprgImport::Workbook book;
+        UInt32 loaded = 0;
+        UInt32 windowCount = 0;
+        GS::Ref<JS::Array> jsBooks = new JS::Array();
+        for (const GS::UniString& path : paths) {
+            bool ok = false;
+            GS::UniString bookError;
+        
+            FileIO::MappedFile file;
+            if (!file.Open(path)) {
+                bookError = "Не удалось открыть файл";
+            } else {
+                std::string parseError;
+                ok = TsprgImport::Parse(file.GetData(), static_cast<size_t>(file.GetSize()), book, parseError);
+                if (ok) {
+                    CassetteCore::Calculate(book.windows, TsprgImport::ParamsFor(book, baseParams), single);
+                    CassetteCore::Merge(total, single);
+                    loaded++;
+                    windowCount += static_cast<UInt32>(book.windows.Size());
+                } else {
+                    bookError = GS::UniString(parseError.c_str(), CC_UTF8);
+                }
+            }
+        
+            GS::Ref<JS::Object> jsBook = new JS::Object();
+            jsBook->AddItem("path", new JS::Value(path));
+            jsBook->AddItem("success", new JS::Value(ok));
+            jsBook->AddItem("errorMessage", new JS::Value(bookError));
+            if (ok) {
+                jsBook->AddItem("windows", new JS::Value(static_cast<Int32>(book.windows.Size())));
+                jsBook->AddItem("type0", new JS::Value(static_cast<Int32>(book.windowsByType[0])));
+                jsBook->AddItem("type1", new JS::Value(static_cast<Int32>(book.windowsByType[1])));
+                jsBook->AddItem("type2", new JS::Value(static_cast<Int32>(book.windowsByType[2])));
+                jsBook->AddItem("floorHeight", new JS::Value(book.hasFloorHeight ? book.floorHeight : params.floorHeight));
+                jsBook->AddItem("hasFloorHeight", new JS::Value(book.hasFloorHeight));
+                jsBook->AddItem("skipped", new JS::Value(static_cast<Int32>(book.skippedRows)));
+            }
+            jsBooks->AddItem(jsBook);
+        
+            if (!ok && errorMessage.IsEmpty()) {
+                errorMessage = bookError;
+            }
+        }
+        
+        const bool success = loaded > 0;
+        CassetteHelper::CalculationResult merged;
+        Int32 handle = ResultStore::InvalidHandle;
+        if (success) {
+            merged = CassetteHelper::FromCoreResult(total);
+            handle = ResultStore::Put(merged);
+        }
+        timer.NativeDone();
+        
+        result->AddItem("success", new JS::Value(success));
+        result->AddItem("cancelled", new JS::Value(cancelled));
+        result->AddItem("errorMessage", new JS::Value(errorMessage));
+        result->AddItem("handle", new JS::Value(handle));
+        result->AddItem("workbooks", jsBooks);
+        result->AddItem("loaded", new JS::Value(static_cast<Int32>(loaded)));
+        result->AddItem("windows", new JS::Value(static_cast<Int32>(windowCount)));
+        if (success) {
+            AddResultLists(result, merged);
+        }
+        
+        return result;
+    }));
+
+    // ------------------------------------------------------------
+    // OptimizeCutting - раскрой планок и откосов из хлыстов
+    // { handle | result, stockLengths?, kerf?, trim?, timeLimitMs? } - длины в мм
+    // ------------------------------------------------------------
+    
+    jsACAPI->AddItem(TimedFunction("OptimizeCutting", [](GS::Ref<JS::Base> param, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
+        GS::Ref<JS::Object> result = new JS::Object();
+        bool success = false;
+        GS::UniString errorMessage;
+        CuttingStock::Plan plan = { {}, 0, 0, 0.0 };
+        
+        if (GS::Ref<JS::Object> jsParam = GS::DynamicCast<JS::Object>(param)) {
+            const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& itemTable = jsParam->GetItemTable();
             
-            // Парсим правые откосы
-            GS::Ref<JS::Base> rightSlopesBase;
-            if (resultTable.Get("rightSlopes", &rightSlopesBase)) {
-                if (GS::Ref<JS::Array> jsRightSlopes = GS::DynamicCast<JS::Array>(rightSlopesBase)) {
-                    const GS::Array<GS::Ref<JS::Base>>& items = jsRightSlopes->GetItemArray();
-                    for (UIndex i = 0; i < items.GetSize(); ++i) {
-                        if (GS::Ref<JS::Object> jsPs = GS::DynamicCast<JS::Object>(items[i])) {
-                            const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& psTable = jsPs->GetItemTable();
-                            CassetteHelper::PlankSize ps;
-                            GS::Ref<JS::Base> item;
-                            if (psTable.Get("width", &item)) ps.width = GetIntFromJs(item);
-                            if (psTable.Get("length", &item)) ps.length = GetIntFromJs(item);
-                            if (psTable.Get("count", &item)) ps.count = GetIntFromJs(item);
-                            if (psTable.Get("calcType", &item)) ps.calcType = GetIntFromJs(item); else ps.calcType = 0;
-                            calcResult.rightSlopes.Push(ps);
-                        }
+            CassetteHelper::CalculationResult decodedResult;
+            const CassetteHelper::CalculationResult* calcResult = ResolveResult(itemTable, decodedResult);
+            
+            CuttingStock::Params cutParams = CuttingStock::GetDefaultParams();
+            GS::Ref<JS::Base> item;
+            if (itemTable.Get("stockLengths", &item)) {
+                if (GS::Ref<JS::Array> jsLengths = GS::DynamicCast<JS::Array>(item)) {
+                    cutParams.stockLengths.clear();
+                    for (const GS::Ref<JS::Base>& lengthItem : jsLengths->GetItemArray()) {
+                        cutParams.stockLengths.push_back(JsDecode::GetInt(lengthItem));
                     }
                 }
             }
+            if (itemTable.Get("kerf", &item)) {
+                cutParams.kerf = JsDecode::GetInt(item, cutParams.kerf);
+            }
+            if (itemTable.Get("trim", &item)) {
+                cutParams.trim = JsDecode::GetInt(item, cutParams.trim);
+            }
+            if (itemTable.Get("timeLimitMs", &item)) {
+                cutParams.timeLimitMs = JsDecode::GetInt(item, cutParams.timeLimitMs);
+            }
+            timer.DecodeDone();
             
-            // Парсим целевые объекты
-            CassetteHelper::TargetObjects targets;
-            GS::Ref<JS::Base> targetsBase;
-            if (itemTable.Get("targets", &targetsBase)) {
-                if (GS::Ref<JS::Object> jsTargets = GS::DynamicCast<JS::Object>(targetsBase)) {
-                    const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& targetsTable = jsTargets->GetItemTable();
-                    GS::Ref<JS::Base> item;
-                    // Объекты для типа 0
-                    if (targetsTable.Get("plankId0", &item)) targets.plankId0 = GetStringFromJs(item);
-                    if (targetsTable.Get("leftSlopeId0", &item)) targets.leftSlopeId0 = GetStringFromJs(item);
-                    if (targetsTable.Get("rightSlopeId0", &item)) targets.rightSlopeId0 = GetStringFromJs(item);
-                    // Объекты для типов 1-2
-                    if (targetsTable.Get("cassetteId12", &item)) targets.cassetteId12 = GetStringFromJs(item);
-                    if (targetsTable.Get("plankId12", &item)) targets.plankId12 = GetStringFromJs(item);
-                    if (targetsTable.Get("leftSlopeId12", &item)) targets.leftSlopeId12 = GetStringFromJs(item);
-                    if (targetsTable.Get("rightSlopeId12", &item)) targets.rightSlopeId12 = GetStringFromJs(item);
+            if (calcResult == nullptr) {
+                errorMessage = "Отсутствует результат расчёта (handle или result)";
+            } else {
+                // Планки и откосы одной ширины режутся из одного профиля
+                const CassetteCore::Result core = CassetteHelper::ToCoreResult(*calcResult);
+                std::vector<CassetteCore::PlankRow> pieces(core.planks);
+                pieces.insert(pieces.end(), core.leftSlopes.begin(), core.leftSlopes.end());
+                pieces.insert(pieces.end(), core.rightSlopes.begin(), core.rightSlopes.end());
+                success = CuttingStock::Optimize(pieces, cutParams, plan);
+                if (!success) {
+                    errorMessage = "Не задана длина хлыста (больше обрезки торцов)";
                 }
             }
-            
-            // Парсим параметры для определения типа
-            CassetteHelper::CalcParams params;
-            GS::Ref<JS::Base> paramsBase;
-            if (itemTable.Get("params", &paramsBase)) {
-                if (GS::Ref<JS::Object> jsParams = GS::DynamicCast<JS::Object>(paramsBase)) {
-                    const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& paramsTable = jsParams->GetItemTable();
-                    GS::Ref<JS::Base> item;
-                    if (paramsTable.Get("type", &item)) params.type = static_cast<CassetteHelper::CalcType>(GetIntFromJs(item));
+            timer.NativeDone();
+        } else {
+            errorMessage = "Неверные параметры";
+        }
+        
+        GS::Ref<JS::Array> jsProfiles = new JS::Array();
+        for (const CuttingStock::Profile& profile : plan.profiles) {
+            GS::Ref<JS::Object> jsProfile = new JS::Object();
+            jsProfile->AddItem("width", new JS::Value(profile.width));
+            jsProfile->AddItem("pieces", new JS::Value(static_cast<double>(profile.pieces)));
+            jsProfile->AddItem("bars", new JS::Value(static_cast<double>(profile.bars)));
+            jsProfile->AddItem("lowerBound", new JS::Value(static_cast<double>(profile.lowerBound)));
+            jsProfile->AddItem("stockTotal", new JS::Value(static_cast<double>(profile.stockTotal)));
+            jsProfile->AddItem("pieceTotal", new JS::Value(static_cast<double>(profile.pieceTotal)));
+            jsProfile->AddItem("wastePercent", new JS::Value(profile.wastePercent));
+        
+            GS::Ref<JS::Array> jsPatterns = new JS::Array();
+            for (const CuttingStock::Pattern& pattern : profile.patterns) {
+                GS::Ref<JS::Object> jsPattern = new JS::Object();
+                jsPattern->AddItem("stockLength", new JS::Value(pattern.stockLength));
+                jsPattern->AddItem("repeat", new JS::Value(pattern.repeat));
+                jsPattern->AddItem("waste", new JS::Value(pattern.waste));
+                GS::Ref<JS::Array> jsCuts = new JS::Array();
+                for (int cut : pattern.cuts) {
+                    jsCuts->AddItem(new JS::Value(cut));
                 }
+                jsPattern->AddItem("cuts", jsCuts);
+                jsPatterns->AddItem(jsPattern);
+            }
+            jsProfile->AddItem("patterns", jsPatterns);
+        
+            GS::Ref<JS::Array> jsOversize = new JS::Array();
+            for (const CuttingStock::Piece& piece : profile.oversize) {
+                GS::Ref<JS::Object> jsPiece = new JS::Object();
+                jsPiece->AddItem("length", new JS::Value(piece.length));
+                jsPiece->AddItem("count", new JS::Value(piece.count));
+                jsOversize->AddItem(jsPiece);
+            }
+            jsProfile->AddItem("oversize", jsOversize);
+            jsProfiles->AddItem(jsProfile);
+        }
+        
+        result->AddItem("success", new JS::Value(success));
+        result->AddItem("errorMessage", new JS::Value(errorMessage));
+        result->AddItem("profiles", jsProfiles);
+        result->AddItem("starts", new JS::Value(static_cast<double>(plan.starts)));
+        result->AddItem("threads", new JS::Value(static_cast<Int32>(plan.threads)));
+        result->AddItem("elapsedMs", new JS::Value(plan.elapsedMs));
+        
+        return result;
+    }));
+
+    // ------------------------------------------------------------
+    // NestCassettes - раскладка заготовок кассет на листы
+    // { handle | result, sheetWidth?, sheetHeight?, foldAllowance?, gap?, margin?,
+    //   allowRotation?, guillotine?, timeLimitMs? } - размеры в мм
+    // ------------------------------------------------------------
+    
+    jsACAPI->AddItem(TimedFunction("NestCassettes", [](GS::Ref<JS::Base> param, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
+        GS::Ref<JS::Object> result = new JS::Object();
+        bool success = false;
+        GS::UniString errorMessage;
+        SheetNesting::Params nestParams = SheetNesting::GetDefaultParams();
+        SheetNesting::Plan plan = { {}, {}, 0, 0, 0, 0.0, 0, 0, 0.0 };
+        
+        if (GS::Ref<JS::Object> jsParam = GS::DynamicCast<JS::Object>(param)) {
+            const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& itemTable = jsParam->GetItemTable();
+            
+            CassetteHelper::CalculationResult decodedResult;
+            const CassetteHelper::CalculationResult* calcResult = ResolveResult(itemTable, decodedResult);
+            
+            GS::Ref<JS::Base> item;
+            if (itemTable.Get("sheetWidth", &item)) {
+                nestParams.sheetWidth = JsDecode::GetInt(item, nestParams.sheetWidth);
+            }
+            if (itemTable.Get("sheetHeight", &item)) {
+                nestParams.sheetHeight = JsDecode::GetInt(item, nestParams.sheetHeight);
+            }
+            if (itemTable.Get("foldAllowance", &item)) {
+                nestParams.foldAllowance = JsDecode::GetInt(item, nestParams.foldAllowance);
+            }
+            if (itemTable.Get("gap", &item)) {
+                nestParams.gap = JsDecode::GetInt(item, nestParams.gap);
+            }
+            if (itemTable.Get("margin", &item)) {
+                nestParams.margin = JsDecode::GetInt(item, nestParams.margin);
+            }
+            if (itemTable.Get("allowRotation", &item)) {
+                nestParams.allowRotation = JsDecode::GetBool(item, nestParams.allowRotation);
+            }
+            if (itemTable.Get("guillotine", &item)) {
+                nestParams.guillotine = JsDecode::GetBool(item, nestParams.guillotine);
+            }
+            if (itemTable.Get("timeLimitMs", &item)) {
+                nestParams.timeLimitMs = JsDecode::GetInt(item, nestParams.timeLimitMs);
+            }
+            timer.DecodeDone();
+            
+            if (calcResult == nullptr) {
+                errorMessage = "Отсутствует результат расчёта (handle или result)";
             } else {
-                // Пытаемся определить тип из результата (если есть кассеты, то тип 1-2)
-                params.type = (calcResult.cassettes.GetSize() > 0) 
-                    ? CassetteHelper::CalcType::Type1And2 
-                    : CassetteHelper::CalcType::Type0;
+                const CassetteCore::Result core = CassetteHelper::ToCoreResult(*calcResult);
+                success = SheetNesting::Nest(core.cassettes, nestParams, plan);
+                if (!success) {
+                    errorMessage = "Лист меньше двух полей";
+                }
             }
+            timer.NativeDone();
+        } else {
+            errorMessage = "Неверные параметры";
+        }
+        
+        GS::Ref<JS::Array> jsLayouts = new JS::Array();
+        for (const SheetNesting::Layout& layout : plan.layouts) {
+            GS::Ref<JS::Object> jsLayout = new JS::Object();
+            jsLayout->AddItem("repeat", new JS::Value(layout.repeat));
+            jsLayout->AddItem("utilisation", new JS::Value(layout.utilisation));
+            GS::Ref<JS::Array> jsParts = new JS::Array();
+            for (const SheetNesting::Placement& part : layout.parts) {
+                GS::Ref<JS::Object> jsPart = new JS::Object();
+                jsPart->AddItem("x", new JS::Value(part.x));
+                jsPart->AddItem("y", new JS::Value(part.y));
+                jsPart->AddItem("width", new JS::Value(part.width));
+                jsPart->AddItem("height", new JS::Value(part.height));
+                jsPart->AddItem("rotated", new JS::Value(part.rotated));
+                jsPart->AddItem("cassetteX", new JS::Value(part.cassetteX));
+                jsPart->AddItem("cassetteY", new JS::Value(part.cassetteY));
+                jsParts->AddItem(jsPart);
+            }
+            jsLayout->AddItem("parts", jsParts);
+            jsLayouts->AddItem(jsLayout);
+        }
+        
+        GS::Ref<JS::Array> jsOversize = new JS::Array();
+        for (const SheetNesting::Oversize& oversize : plan.oversize) {
+            GS::Ref<JS::Object> jsCassette = new JS::Object();
+            jsCassette->AddItem("x", new JS::Value(oversize.x));
+            jsCassette->AddItem("y", new JS::Value(oversize.y));
+            jsCassette->AddItem("count", new JS::Value(oversize.count));
+            jsOversize->AddItem(jsCassette);
+        }
+        
+        result->AddItem("success", new JS::Value(success));
+        result->AddItem("errorMessage", new JS::Value(errorMessage));
+        result->AddItem("sheetWidth", new JS::Value(nestParams.sheetWidth));
+        result->AddItem("sheetHeight", new JS::Value(nestParams.sheetHeight));
+        result->AddItem("layouts", jsLayouts);
+        result->AddItem("oversize", jsOversize);
+        result->AddItem("parts", new JS::Value(static_cast<double>(plan.parts)));
+        result->AddItem("sheets", new JS::Value(static_cast<double>(plan.sheets)));
+        result->AddItem("lowerBound", new JS::Value(static_cast<double>(plan.lowerBound)));
+        result->AddItem("utilisation", new JS::Value(plan.utilisation));
+        result->AddItem("starts", new JS::Value(static_cast<double>(plan.starts)));
+        result->AddItem("threads", new JS::Value(static_cast<Int32>(plan.threads)));
+        result->AddItem("elapsedMs", new JS::Value(plan.elapsedMs));
+        
+        return result;
+    }));
+
+    // ------------------------------------------------------------
+    // ClusterCassettes - сокращение числа типоразмеров кассет
+    // { handle | result, toleranceX?, toleranceY?, maxRows? } - допуски в мм
+    // Близкие размеры изготавливаются по наибольшему; новый результат
+    // сохраняется под новым handle, исходный не меняется
+    // ------------------------------------------------------------
+    
+    jsACAPI->AddItem(TimedFunction("ClusterCassettes", [](GS::Ref<JS::Base> param, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
+        GS::Ref<JS::Object> result = new JS::Object();
+        bool success = false;
+        GS::UniString errorMessage;
+        SizeClustering::Params clusterParams = SizeClustering::GetDefaultParams();
+        SizeClustering::Report report = { {}, 0, 0, 0, 0, true };
+        CassetteHelper::CalculationResult clustered;
+        Int32 handle = ResultStore::InvalidHandle;
+        
+        if (GS::Ref<JS::Object> jsParam = GS::DynamicCast<JS::Object>(param)) {
+            const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& itemTable = jsParam->GetItemTable();
             
-            // Записываем результаты
-            success = CassetteHelper::WriteToTargetObjects(calcResult, targets, params);
-            if (!success) {
-                errorMessage = "Не удалось записать результаты в объекты";
+            CassetteHelper::CalculationResult decodedResult;
+            const CassetteHelper::CalculationResult* calcResult = ResolveResult(itemTable, decodedResult);
+            
+            GS::Ref<JS::Base> item;
+            if (itemTable.Get("toleranceX", &item)) {
+                clusterParams.toleranceX = JsDecode::GetInt(item, clusterParams.toleranceX);
+            }
+            if (itemTable.Get("toleranceY", &item)) {
+                clusterParams.toleranceY = JsDecode::GetInt(item, clusterParams.toleranceY);
+            }
+            if (itemTable.Get("maxRows", &item)) {
+                clusterParams.maxRows = JsDecode::GetInt(item, clusterParams.maxRows);
+            }
+            timer.DecodeDone();
+            
+            if (calcResult == nullptr) {
+                errorMessage = "Отсутствует результат расчёта (handle или result)";
+            } else if (clusterParams.toleranceX < 0 || clusterParams.toleranceY < 0) {
+                errorMessage = "Допуск не может быть отрицательным";
+            } else {
+                CassetteCore::Result core = CassetteHelper::ToCoreResult(*calcResult);
+                SizeClustering::ClusterSizes(core.cassettes, clusterParams, report);
+                SizeClustering::ToRows(report, core.cassettes);
+                clustered = CassetteHelper::FromCoreResult(core);
+                clustered.duplicateIds = calcResult->duplicateIds;
+                handle = ResultStore::Put(clustered);
+                success = true;
             }
+            timer.NativeDone();
         } else {
             errorMessage = "Неверные параметры";
         }
         
+        GS::Ref<JS::Array> jsGroups = new JS::Array();
+        for (const SizeClustering::Group& group : report.groups) {
+            GS::Ref<JS::Object> jsGroup = new JS::Object();
+            jsGroup->AddItem("x", new JS::Value(group.x));
+            jsGroup->AddItem("y", new JS::Value(group.y));
+            jsGroup->AddItem("count", new JS::Value(group.count));
+            jsGroup->AddItem("extraArea", new JS::Value(static_cast<double>(group.extraArea) / 1e6));
+            GS::Ref<JS::Array> jsMembers = new JS::Array();
+            for (const SizeClustering::Member& member : group.members) {
+                GS::Ref<JS::Object> jsMember = new JS::Object();
+                jsMember->AddItem("x", new JS::Value(member.x));
+                jsMember->AddItem("y", new JS::Value(member.y));
+                jsMember->AddItem("count", new JS::Value(member.count));
+                jsMember->AddItem("extraArea", new JS::Value(static_cast<double>(member.extraArea) / 1e6));
+                jsMembers->AddItem(jsMember);
+            }
+            jsGroup->AddItem("members", jsMembers);
+            jsGroups->AddItem(jsGroup);
+        }
+        
+        result->AddItem("success", new JS::Value(success));
+        result->AddItem("errorMessage", new JS::Value(errorMessage));
+        result->AddItem("handle", new JS::Value(handle));
+        result->AddItem("rowsBefore", new JS::Value(static_cast<Int32>(report.rowsBefore)));
+        result->AddItem("rows", new JS::Value(static_cast<Int32>(report.groups.size())));
+        result->AddItem("merges", new JS::Value(static_cast<double>(report.merges)));
+        result->AddItem("maxRows", new JS::Value(clusterParams.maxRows));
+        result->AddItem("withinLimit", new JS::Value(report.withinLimit));
+        result->AddItem("cassetteArea", new JS::Value(static_cast<double>(report.cassetteArea) / 1e6));
+        result->AddItem("extraArea", new JS::Value(static_cast<double>(report.extraArea) / 1e6));
+        result->AddItem("groups", jsGroups);
+        if (success) {
+            AddResultLists(result, clustered);
+        }
+        
+        return result;
+    }));
+
+    // ------------------------------------------------------------
+    // SaveSendXls - выгрузка в Excel (.xlsx)
+    // { path?, rows, columns?, sheet? } - таблица из JS
+    // { path?, handle }                 - результат расчёта
+    // { path? }                         - выделенные окна/двери (снимок выделения)
+    // Без path показывается диалог сохранения
+    // ------------------------------------------------------------
+    
+    jsACAPI->AddItem(TimedFunction("SaveSendXls", [](GS::Ref<JS::Base> param, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
+        GS::Ref<JS::Object> result = new JS::Object();
+        bool success = false;
+        bool cancelled = false;
+        GS::UniString errorMessage;
+        GS::UniString path;
+        GS::UniString sheetName;
+        UInt32 rowCount = 0;
+        
+        GS::Ref<JS::Base> rowsBase;
+        GS::Ref<JS::Base> columnsBase;
+        const CassetteHelper::CalculationResult* calcResult = nullptr;
+        
+        if (GS::Ref<JS::Object> jsParam = GS::DynamicCast<JS::Object>(param)) {
+            const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& itemTable = jsParam->GetItemTable();
+            
+            GS::Ref<JS::Base> item;
+            if (itemTable.Get("path", &item)) {
+                path = JsDecode::GetString(item);
+            }
+            if (itemTable.Get("sheet", &item)) {
+                sheetName = JsDecode::GetString(item);
+            }
+            itemTable.Get("rows", &rowsBase);
+            itemTable.Get("columns", &columnsBase);
+            if (rowsBase == nullptr && itemTable.Get("handle", &item)) {
+                calcResult = ResultStore::Get(JsDecode::GetInt(item, ResultStore::InvalidHandle));
+                if (calcResult == nullptr) {
+                    errorMessage = "Результат расчёта не найден, выполните расчёт заново";
+                }
+            }
+        }
+        timer.DecodeDone();
+        
+        if (errorMessage.IsEmpty()) {
+            if (path.IsEmpty()) {
+                const FileDialogs::FileType xlsxType = { "Книга Excel", "xlsx" };
+                cancelled = !FileDialogs::AskSavePath("Отправить в Excel", xlsxType,
+                    FileDialogs::MakeDatedFileName(calcResult != nullptr ? "cassettes_export" : "send_xls", "xlsx"), path);
+            }
+            if (!cancelled) {
+                if (rowsBase != nullptr) {
+                    success = SendXlsHelper::SaveJsTable(path, sheetName, columnsBase, rowsBase, rowCount, errorMessage);
+                } else if (calcResult != nullptr) {
+                    success = SendXlsHelper::SaveResult(path, *calcResult, rowCount, errorMessage);
+                } else {
+                    success = SendXlsHelper::SaveSelection(path, rowCount, errorMessage);
+                }
+            }
+        }
+        timer.NativeDone();
+        
+        result->AddItem("success", new JS::Value(success));
+        result->AddItem("cancelled", new JS::Value(cancelled));
+        result->AddItem("path", new JS::Value(path));
+        result->AddItem("rows", new JS::Value(static_cast<Int32>(rowCount)));
+        result->AddItem("errorMessage", new JS::Value(errorMessage));
+        
+        return result;
+    }));
+
+    // ------------------------------------------------------------
+    // SaveWindowSnapshot - двоичный снимок выделенных окон (.cassnap)
+    // { path?, floorHeight? } - без path показывается диалог сохранения
+    // Снимок повторяет расчёт без Archicad (cassette-batch)
+    // ------------------------------------------------------------
+    
+    jsACAPI->AddItem(TimedFunction("SaveWindowSnapshot", [](GS::Ref<JS::Base> param, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
+        GS::Ref<JS::Object> result = new JS::Object();
+        bool success = false;
+        bool cancelled = false;
+        GS::UniString errorMessage;
+        GS::UniString path;
+        double floorHeight = 0.0;
+        UInt64 bytes = 0;
+        
+        if (GS::Ref<JS::Object> jsParam = GS::DynamicCast<JS::Object>(param)) {
+            const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& itemTable = jsParam->GetItemTable();
+            
+            GS::Ref<JS::Base> item;
+            if (itemTable.Get("path", &item)) {
+                path = JsDecode::GetString(item);
+            }
+            if (itemTable.Get("floorHeight", &item)) {
+                floorHeight = JsDecode::GetDouble(item);
+            }
+        }
+        timer.DecodeDone();
+        
+        const GS::Array<CassetteHelper::WindowDoorInfo>& windows = SelectionSnapshot::GetWindows();
+        if (windows.IsEmpty()) {
+            errorMessage = "Нет выделенных окон или дверей";
+        } else {
+            if (path.IsEmpty()) {
+                const FileDialogs::FileType snapshotType = { "Снимок окон", "cassnap" };
+                cancelled = !FileDialogs::AskSavePath("Снимок окон", snapshotType,
+                    FileDialogs::MakeDatedFileName("windows_snapshot", "cassnap"), path);
+            }
+            if (!cancelled) {
+                success = SnapshotDump::SaveWindows(path, windows, floorHeight, bytes, errorMessage);
+            }
+        }
+        timer.NativeDone();
+        
+        result->AddItem("success", new JS::Value(success));
+        result->AddItem("cancelled", new JS::Value(cancelled));
+        result->AddItem("path", new JS::Value(path));
+        result->AddItem("windows", new JS::Value(static_cast<Int32>(success ? windows.GetSize() : 0)));
+        result->AddItem("bytes", new JS::Value(static_cast<double>(bytes)));
+        result->AddItem("errorMessage", new JS::Value(errorMessage));
+        
+        return result;
+    }));
+
+    // ------------------------------------------------------------
+    // GetBridgeStats - p50/p95 по фазам вызовов моста (панель диагностики)
+    // ------------------------------------------------------------
+    
+    jsACAPI->AddItem(TimedFunction("GetBridgeStats", [](GS::Ref<JS::Base>, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
+        GS::Array<BridgeStats::FunctionStats> stats = BridgeStats::GetStats();
+        timer.NativeDone();
+        
+        auto phaseToJs = [](const BridgeStats::PhaseStats& phase) -> GS::Ref<JS::Base> {
+            GS::Ref<JS::Object> jsPhase = new JS::Object();
+            jsPhase->AddItem("p50", new JS::Value(phase.p50Ms));
+            jsPhase->AddItem("p95", new JS::Value(phase.p95Ms));
+            return jsPhase;
+        };
+        
+        GS::Ref<JS::Array> jsFunctions = new JS::Array();
+        for (const BridgeStats::FunctionStats& f : stats) {
+            GS::Ref<JS::Object> jsF = new JS::Object();
+            jsF->AddItem("name", new JS::Value(f.name));
+            jsF->AddItem("calls", new JS::Value(static_cast<Int32>(f.calls)));
+            jsF->AddItem("samples", new JS::Value(static_cast<Int32>(f.samples)));
+            jsF->AddItem("decode", phaseToJs(f.decode));
+            jsF->AddItem("native", phaseToJs(f.native));
+            jsF->AddItem("encode", phaseToJs(f.encode));
+            jsF->AddItem("total", phaseToJs(f.total));
+            jsFunctions->AddItem(jsF);
+        }
+        
+        GS::Ref<JS::Object> result = new JS::Object();
+        result->AddItem("functions", jsFunctions);
+        result->AddItem("success", new JS::Value(true));
+        return result;
+    }));
+
+    // ------------------------------------------------------------
+    // ResetBridgeStats - сбросить замеры
+    // ------------------------------------------------------------
+    
+    jsACAPI->AddItem(TimedFunction("ResetBridgeStats", [](GS::Ref<JS::Base>, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
+        BridgeStats::Reset();
+        GS::Ref<JS::Object> result = new JS::Object();
+        result->AddItem("success", new JS::Value(true));
+        return result;
+    }));
+
+    // ------------------------------------------------------------
+    // StartHostTrace - начать запись вызовов Archicad (трасса .castrace)
+    // ------------------------------------------------------------
+    
+    jsACAPI->AddItem(TimedFunction("StartHostTrace", [](GS::Ref<JS::Base>, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
+        AcHost::StartRecording();
+        timer.NativeDone();
+        
+        GS::Ref<JS::Object> result = new JS::Object();
+        result->AddItem("success", new JS::Value(true));
+        result->AddItem("recording", new JS::Value(true));
+        return result;
+    }));
+
+    // ------------------------------------------------------------
+    // StopHostTrace - остановить запись и сохранить трассу
+    // { path? } - без path показывается диалог сохранения; при отмене запись продолжается
+    // Трасса повторяется без Archicad программой cassette-replay
+    // ------------------------------------------------------------
+    
+    jsACAPI->AddItem(TimedFunction("StopHostTrace", [](GS::Ref<JS::Base> param, BridgeStats::CallTimer& timer) -> GS::Ref<JS::Base> {
+        GS::Ref<JS::Object> result = new JS::Object();
+        bool success = false;
+        bool cancelled = false;
+        GS::UniString errorMessage;
+        GS::UniString path;
+        UInt64 calls = 0;
+        UInt64 bytes = 0;
+        
+        if (GS::Ref<JS::Object> jsParam = GS::DynamicCast<JS::Object>(param)) {
+            GS::Ref<JS::Base> item;
+            if (jsParam->GetItemTable().Get("path", &item)) {
+                path = JsDecode::GetString(item);
+            }
+        }
+        timer.DecodeDone();
+        
+        if (!AcHost::IsRecording()) {
+            errorMessage = "Запись трассы не идёт";
+        } else {
+            if (path.IsEmpty()) {
+                const FileDialogs::FileType traceType = { "Трасса вызовов", "castrace" };
+                cancelled = !FileDialogs::AskSavePath("Трасса вызовов Archicad", traceType,
+                    FileDialogs::MakeDatedFileName("host_trace", "castrace"), path);
+            }
+            if (!cancelled) {
+                success = AcHost::StopRecording(path, calls, bytes, errorMessage);
+            }
+        }
+        timer.NativeDone();
+        
         result->AddItem("success", new JS::Value(success));
+        result->AddItem("cancelled", new JS::Value(cancelled));
+        result->AddItem("recording", new JS::Value(AcHost::IsRecording()));
+        result->AddItem("path", new JS::Value(path));
+        result->AddItem("calls", new JS::Value(static_cast<double>(calls)));
+        result->AddItem("bytes", new JS::Value(static_cast<double>(bytes)));
         result->AddItem("errorMessage", new JS::Value(errorMessage));
         
         return result;
@@ -0,0 +1,164 @@
+// =============================================================================
+// CalcCache - Кэш результатов расчёта по отпечатку набора окон
+// =============================================================================
+
+#include "CalcCache.hpp"
+#include "OpeningIndex.hpp"
+#include "ResultStore.hpp"
+#include "TypeRegistry.hpp"
+
+#include <cstring>
+#include <list>
+#include <unordered_map>
+
+namespace CalcCache {
+
+// Не больше записей и байт (одна запись остаётся всегда - текущий результат)
+static const size_t MaxEntries = 32;
+static const size_t MaxBytes = 64 * 1024 * 1024;
+
+// Начало списка - последний использованный результат
+static std::list<Entry> s_entries;
+static std::unordered_map<Key, std::list<Entry>::iterator> s_index;
+static size_t s_bytes = 0;
+
+// =============================================================================
+// Отпечаток
+// =============================================================================
+
+// Перемешивание splitmix64: каждый бит входа влияет на все биты результата
+static uint64_t Mix(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+static uint64_t Combine(uint64_t hash, uint64_t value)
+{
+    return Mix(hash + 0x9e3779b97f4a7c15ULL + value);
+}
+
+static uint64_t Pack(int32_t high, int32_t low)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(high)) << 32) | static_cast<uint32_t>(low);
+}
+
+static uint64_t CombineGuid(uint64_t hash, const API_Guid& guid)
+{
+    uint64_t words[2];
+    static_assert(sizeof(words) == sizeof(API_Guid), "API_Guid - 16 байт");
+    std::memcpy(words, &guid, sizeof(words));
+    return Combine(Combine(hash, words[0]), words[1]);
+}
+
+Key Fingerprint(
+    const GS::Array<CassetteHelper::WindowDoorInfo>& windows,
+    const CassetteHelper::CalcParams& params,
+    CassetteHelper::GroupBy groupBy)
+{
+    // Окна - суммой отпечатков (не зависит от порядка)
+    const bool byFacade = groupBy == CassetteHelper::GroupBy::Facade;
+    uint64_t sum = 0;
+    for (const CassetteHelper::WindowDoorInfo& w : windows) {
+        uint64_t hash = CombineGuid(0, w.guid);
+        hash = Combine(hash, Pack(w.width, w.height));
+        hash = Combine(hash, Pack(w.sillHeight, w.calcType));
+        hash = Combine(hash, Pack(static_cast<int32_t>(w.id), w.storey));
+        hash = CombineGuid(hash, w.wall);
+        if (byFacade) {
+            hash = Combine(hash, static_cast<uint64_t>(OpeningIndex::FacadeOf(w.normal)));
+        }
+        sum += hash;
+    }
+
+    // Параметры - в тех единицах, в которых их видит расчёт
+    uint64_t key = Combine(sum, windows.GetSize());
+    key = Combine(key, Pack(Mm::FromMetres(params.floorHeight), static_cast<int32_t>(groupBy)));
+    key = Combine(key, Pack(params.plankWidth0, params.slopeWidth0));
+    key = Combine(key, Pack(params.plankWidth12, params.slopeWidth12));
+    key = Combine(key, Pack(params.offsetX, params.offsetY));
+    key = Combine(key, static_cast<uint64_t>(static_cast<uint32_t>(params.offsetTop)));
+    return Combine(key, TypeRegistry::GetRevision());
+}
+
+// =============================================================================
+// Записи
+// =============================================================================
+
+static size_t EstimateBytes(const CassetteHelper::CalculationResult& result)
+{
+    size_t bytes = sizeof(result);
+    bytes += result.cassettes.GetSize() * sizeof(CassetteHelper::CassetteSize);
+    bytes += (result.planks.GetSize() + result.leftSlopes.GetSize() + result.rightSlopes.GetSize()) * sizeof(CassetteHelper::PlankSize);
+    for (const GS::UniString& id : result.duplicateIds) {
+        bytes += sizeof(id) + id.GetLength() * sizeof(GS::UniChar);
+    }
+    return bytes;
+}
+
+static size_t EstimateBytes(const Entry& entry)
+{
+    size_t bytes = EstimateBytes(entry.result);
+    for (const CassetteHelper::CalculationGroup& group : entry.groups) {
+        bytes += EstimateBytes(group.result) + (group.key.GetLength() + group.label.GetLength()) * sizeof(GS::UniChar);
+    }
+    return bytes;
+}
+
+// Вытеснить давно не использованные записи сверх лимитов
+static void Evict()
+{
+    while (s_entries.size() > 1 && (s_entries.size() > MaxEntries || s_bytes > MaxBytes)) {
+        const Entry& oldest = s_entries.back();
+        s_bytes -= oldest.bytes;
+        s_index.erase(oldest.key);
+        s_entries.pop_back();
+    }
+}
+
+const Entry& Calculate(
+    const GS::Array<CassetteHelper::WindowDoorInfo>& windows,
+    const CassetteHelper::CalcParams& params,
+    CassetteHelper::GroupBy groupBy,
+    bool& hit)
+{
+    const Key key = Fingerprint(windows, params, groupBy);
+    auto found = s_index.find(key);
+    hit = found != s_index.end();
+    if (hit) {
+        s_entries.splice(s_entries.begin(), s_entries, found->second);
+    } else {
+        s_entries.emplace_front();
+        Entry& entry = s_entries.front();
+        entry.key = key;
+        entry.result = CassetteHelper::CalculateGrouped(windows, params, groupBy, entry.groups);
+        entry.handle = ResultStore::InvalidHandle;
+        entry.bytes = EstimateBytes(entry);
+        if (entry.result.success) {
+            entry.bytes += EstimateBytes(entry.result);     // Копия в ResultStore (ниже)
+        }
+        s_index[key] = s_entries.begin();
+        s_bytes += entry.bytes;
+        Evict();
+    }
+
+    // Дескриптор - прежний, пока ResultStore его не вытеснил
+    Entry& entry = s_entries.front();
+    if (entry.result.success && ResultStore::Get(entry.handle) == nullptr) {
+        entry.handle = ResultStore::Put(entry.result);
+    }
+    return entry;
+}
+
+void Clear()
+{
+    s_entries.clear();
+    s_index.clear();
+    s_bytes = 0;
+}
+
+} // namespace CalcCache
@@ -0,0 +1,54 @@
+#ifndef CALCCACHE_HPP
+#define CALCCACHE_HPP
+
+// =============================================================================
+// CalcCache - Кэш результатов расчёта по отпечатку набора окон
+// =============================================================================
+// Повторный "Рассчитать" с тем же выделением и параметрами не считает заново:
+// ключ - 64-битный отпечаток окон (GUID, размеры в мм, тип, ID, стена,
+// этаж, фасад при разбивке по фасадам), параметров, разбивки и версии реестра
+// типов. Отпечаток окна складывается в сумму, поэтому порядок окон (сортировка
+// таблицы выделения) на ключ не влияет. Записи вытесняются по давности
+// использования, общий размер ограничен. Результат записи сразу лежит в
+// ResultStore, и запись/выгрузка получают его по тому же дескриптору.
+
+#include "CassetteHelper.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CalcCache {
+
+typedef uint64_t Key;
+
+struct Entry {
+    Key key;
+    CassetteHelper::CalculationResult result;
+    GS::Array<CassetteHelper::CalculationGroup> groups;
+    Int32 handle;            // Дескриптор ResultStore (InvalidHandle - при ошибке)
+    size_t bytes;            // Оценка занятой памяти (с копией результата в ResultStore)
+};
+
+// Отпечаток окон и параметров расчёта
+Key Fingerprint(
+    const GS::Array<CassetteHelper::WindowDoorInfo>& windows,
+    const CassetteHelper::CalcParams& params,
+    CassetteHelper::GroupBy groupBy
+);
+
+// Результат из кэша (hit = true) или новый расчёт CalculateGrouped. Ссылка
+// действительна до следующего вызова Calculate или Clear. Список дубликатов
+// при попадании - из первого расчёта (те же ID, порядок - как тогда).
+const Entry& Calculate(
+    const GS::Array<CassetteHelper::WindowDoorInfo>& windows,
+    const CassetteHelper::CalcParams& params,
+    CassetteHelper::GroupBy groupBy,
+    bool& hit
+);
+
+// Удалить все записи
+void Clear();
+
+} // namespace CalcCache
+
+#endif // CALCCACHE_HPP
@@ -0,0 +1,253 @@
+// =============================================================================
+// CassetteCore - Расчёт кассет, планок и откосов без Archicad API
+// =============================================================================
+
+#include "CassetteCore.hpp"
+#include "IdClassifier.hpp"
+#include "TypeRegistry.hpp"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+namespace CassetteCore {
+
+// =============================================================================
+// Параметры и пакет окон
+// =============================================================================
+
+Params GetDefaultParams()
+{
+    Params p;
+    p.floorHeight = 2.99;
+    p.plankWidth0 = 285;
+    p.slopeWidth0 = 285;
+    p.plankWidth12 = 160;
+    p.slopeWidth12 = 225;
+    p.offsetX = 165;
+    p.offsetY = 50;
+    p.offsetTop = 745;
+    return p;
+}
+
+void WindowBatch::Reserve(size_t count)
+{
+    width.reserve(count);
+    height.reserve(count);
+    sillHeight.reserve(count);
+    calcType.reserve(count);
+}
+
+void WindowBatch::Clear()
+{
+    width.clear();
+    height.clear();
+    sillHeight.clear();
+    calcType.clear();
+}
+
+void WindowBatch::Add(Mm::Length w, Mm::Length h, Mm::Length sill, int type)
+{
+    width.push_back(w);
+    height.push_back(h);
+    sillHeight.push_back(sill);
+    calcType.push_back(static_cast<int8_t>(type));
+}
+
+void Result::Clear()
+{
+    cassettes.clear();
+    planks.clear();
+    leftSlopes.clear();
+    rightSlopes.clear();
+}
+
+int CalcTypeFromId(const char* id, size_t length)
+{
+    return IdClassifier::GetTable().Classify(std::string_view(id, length));
+}
+
+// =============================================================================
+// Calculate
+// =============================================================================
+
+typedef std::map<std::pair<int, int>, int> Groups;     // (a, b) -> count
+
+static void AppendPlanks(const Groups& groups, int calcType, std::vector<PlankRow>& target)
+{
+    for (const auto& pair : groups) {
+        PlankRow row;
+        row.width = pair.first.second;
+        row.length = pair.first.first;
+        row.count = pair.second;
+        row.calcType = calcType;
+        target.push_back(row);
+    }
+}
+
+// Гистограммы одного расчёта по целям ядра: [0] - кассеты (X, Y), затем
+// планки, левые и правые откосы (длина, ширина) по группам 0 и 1
+struct Accumulator {
+    Groups groups[TypeRegistry::TargetCount];
+
+    void Flush(Result& result) const
+    {
+        result.Clear();
+        for (const auto& pair : groups[0]) {
+            CassetteRow row;
+            row.x = pair.first.first;
+            row.y = pair.first.second;
+            row.count = pair.second;
+            result.cassettes.push_back(row);
+        }
+
+        AppendPlanks(groups[1], 0, result.planks);
+        AppendPlanks(groups[2], 1, result.planks);
+        AppendPlanks(groups[3], 0, result.leftSlopes);
+        AppendPlanks(groups[4], 1, result.leftSlopes);
+        AppendPlanks(groups[5], 0, result.rightSlopes);
+        AppendPlanks(groups[6], 1, result.rightSlopes);
+    }
+};
+
+static TypeRegistry::Values ToValues(const Params& params)
+{
+    TypeRegistry::Values values;
+    values.floorHeight = Mm::FromMetres(params.floorHeight);
+    values.offsetX = params.offsetX;
+    values.offsetY = params.offsetY;
+    values.offsetTop = params.offsetTop;
+    values.plankWidth[0] = params.plankWidth0;
+    values.plankWidth[1] = params.plankWidth12;
+    values.slopeWidth[0] = params.slopeWidth0;
+    values.slopeWidth[1] = params.slopeWidth12;
+    return values;
+}
+
+// Окна пакета (первые count) в target: по слотам ядра, блоками до
+// SizeExpr::BlockSize окон. Окно i попадает в groups[groupOf[i]], если
+// группа задана и меньше groupCount, и всегда в total.
+static void AddWindows(const WindowBatch& batch, size_t count, const TypeRegistry::Kernel& kernel,
+                       const std::vector<uint32_t>* groupOf, std::vector<Accumulator>* groups, Accumulator& total)
+{
+    // Индексы окон по слотам (подсчётом)
+    const size_t slotCount = kernel.SlotCount();
+    std::vector<uint32_t> slotStart(slotCount + 1, 0);
+    for (size_t i = 0; i < count; ++i) {
+        ++slotStart[kernel.SlotOf(batch.calcType[i]) + 1];
+    }
+    for (size_t slot = 0; slot < slotCount; ++slot) {
+        slotStart[slot + 1] += slotStart[slot];
+    }
+    std::vector<uint32_t> order(count);
+    std::vector<uint32_t> next(slotStart.begin(), slotStart.end() - 1);
+    for (size_t i = 0; i < count; ++i) {
+        order[next[kernel.SlotOf(batch.calcType[i])]++] = static_cast<uint32_t>(i);
+    }
+
+    const size_t groupCount = groups != nullptr ? groups->size() : 0;
+    int32_t window[TypeRegistry::WindowVarCount][SizeExpr::BlockSize];
+    const int32_t* columns[TypeRegistry::WindowVarCount] = { window[0], window[1], window[2] };
+    int32_t sizeA[SizeExpr::BlockSize];
+    int32_t sizeB[SizeExpr::BlockSize];
+    std::vector<int32_t> stack;
+
+    for (size_t slot = 0; slot < slotCount; ++slot) {
+        const TypeRegistry::BoundPart* begin = kernel.Begin(slot);
+        const TypeRegistry::BoundPart* end = kernel.End(slot);
+        if (begin == end) {
+            continue;
+        }
+
+        for (size_t first = slotStart[slot]; first < slotStart[slot + 1]; first += SizeExpr::BlockSize) {
+            const size_t n = std::min<size_t>(SizeExpr::BlockSize, slotStart[slot + 1] - first);
+            const uint32_t* block = order.data() + first;
+            for (size_t j = 0; j < n; ++j) {
+                window[TypeRegistry::VarB][j] = batch.width[block[j]];
+                window[TypeRegistry::VarC][j] = batch.height[block[j]];
+                window[TypeRegistry::VarD][j] = batch.sillHeight[block[j]];
+            }
+
+            for (const TypeRegistry::BoundPart* part = begin; part != end; ++part) {
+                kernel.Evaluate(*part, columns, n, sizeA, sizeB, stack);
+                for (size_t j = 0; j < n; ++j) {
+                    const std::pair<int, int> size(sizeA[j], sizeB[j]);
+                    total.groups[part->target][size] += part->count;
+                    if (groupOf != nullptr && (*groupOf)[block[j]] < groupCount) {
+                        (*groups)[(*groupOf)[block[j]]].groups[part->target][size] += part->count;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void Calculate(const WindowBatch& batch, const Params& params, Result& result)
+{
+    Calculate(batch, params, TypeRegistry::GetRegistry(), result);
+}
+
+void Calculate(const WindowBatch& batch, const Params& params, const TypeRegistry::Registry& types, Result& result)
+{
+    TypeRegistry::Kernel kernel;
+    types.Bind(ToValues(params), kernel);
+
+    Accumulator acc;
+    AddWindows(batch, batch.Size(), kernel, nullptr, nullptr, acc);
+    acc.Flush(result);
+}
+
+// =============================================================================
+// CalculateGrouped
+// =============================================================================
+
+void CalculateGrouped(const WindowBatch& batch, const std::vector<uint32_t>& groupOf, size_t groupCount,
+                      const Params& params, Result& total, std::vector<Result>& groups)
+{
+    TypeRegistry::Kernel kernel;
+    TypeRegistry::GetRegistry().Bind(ToValues(params), kernel);
+
+    Accumulator totalAcc;
+    std::vector<Accumulator> groupAcc(groupCount);
+    AddWindows(batch, std::min(batch.Size(), groupOf.size()), kernel, &groupOf, &groupAcc, totalAcc);
+
+    totalAcc.Flush(total);
+    groups.resize(groupCount);
+    for (size_t g = 0; g < groupCount; ++g) {
+        groupAcc[g].Flush(groups[g]);
+    }
+}
+
+// =============================================================================
+// Merge
+// =============================================================================
+
+// Строки результата обратно в гистограммы (как их строит AddWindows)
+static void CollectPlanks(const std::vector<PlankRow>& rows, Groups& groups0, Groups& groups1)
+{
+    for (const PlankRow& row : rows) {
+        (row.calcType == 0 ? groups0 : groups1)[{ row.length, row.width }] += row.count;
+    }
+}
+
+static void Collect(const Result& result, Accumulator& acc)
+{
+    for (const CassetteRow& row : result.cassettes) {
+        acc.groups[0][{ row.x, row.y }] += row.count;
+    }
+    CollectPlanks(result.planks, acc.groups[1], acc.groups[2]);
+    CollectPlanks(result.leftSlopes, acc.groups[3], acc.groups[4]);
+    CollectPlanks(result.rightSlopes, acc.groups[5], acc.groups[6]);
+}
+
+void Merge(Result& into, const Result& from)
+{
+    // Через те же гистограммы, что и Calculate: порядок строк не зависит от
+    // порядка слияния и совпадает с порядком одного расчёта по всем окнам
+    Accumulator acc;
+    Collect(into, acc);
+    Collect(from, acc);
+    acc.Flush(into);
+}
+
+} // namespace CassetteCore
@@ -0,0 +1,95 @@
+#ifndef CASSETTECORE_HPP
+#define CASSETTECORE_HPP
+
+// =============================================================================
+// CassetteCore - Расчёт кассет, планок и откосов без Archicad API
+// =============================================================================
+// Окна передаются колонками (WindowBatch): отдельные массивы ширин, высот,
+// подоконников и типов. Так их удобно заполнять из любого источника
+// (выделение Archicad, книги Excel, снимки модели) и считать без GS типов.
+// CassetteHelper::Calculate - адаптер над этим расчётом.
+// Размеры окон - целые мм (Mm::Length), переведённые из метров при чтении.
+
+#include "Mm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TypeRegistry {
+class Registry;
+}
+
+namespace CassetteCore {
+
+// Параметры расчёта (см. CassetteHelper::CalcParams)
+struct Params {
+    double floorHeight;      // Высота этажа (I2) в метрах
+    int plankWidth0;         // Ширина планки для типа 0 в мм
+    int slopeWidth0;         // Ширина откоса для типа 0 в мм
+    int plankWidth12;        // Ширина планки для типов 1-2 в мм
+    int slopeWidth12;        // Ширина откоса для типов 1-2 в мм
+    int offsetX;             // Низ плюс к низу этажа в мм
+    int offsetY;             // Смещение Y в мм
+    int offsetTop;           // Верх плюс к высоте этажа в мм
+};
+
+Params GetDefaultParams();
+
+// Окна/двери по колонкам (размеры в мм)
+struct WindowBatch {
+    std::vector<Mm::Length> width;        // B
+    std::vector<Mm::Length> height;       // C
+    std::vector<Mm::Length> sillHeight;   // D
+    std::vector<int8_t> calcType;     // Тип расчёта по ID или -1 (тип не определён)
+
+    size_t Size() const { return width.size(); }
+    void Reserve(size_t count);
+    void Clear();
+    void Add(Mm::Length w, Mm::Length h, Mm::Length sill, int type);
+};
+
+struct CassetteRow {
+    int x;
+    int y;
+    int count;
+};
+
+struct PlankRow {
+    int width;
+    int length;
+    int count;
+    int calcType;            // Группа типа: 0 - тип 0, 1 - типы 1-2
+};
+
+struct Result {
+    std::vector<CassetteRow> cassettes;
+    std::vector<PlankRow> planks;
+    std::vector<PlankRow> leftSlopes;
+    std::vector<PlankRow> rightSlopes;
+
+    void Clear();
+};
+
+// Тип расчёта по ID в UTF-8 ("ОК-1: 2" -> 2, "ДВ-0" -> 0) по текущей
+// таблице кодов IdClassifier. -1 - тип не определён.
+int CalcTypeFromId(const char* id, size_t length);
+
+// Расчёт по всем окнам пакета. Детали и формулы каждого типа берутся из
+// реестра типов: текущего (TypeRegistry::GetRegistry) или переданного types.
+void Calculate(const WindowBatch& batch, const Params& params, Result& result);
+void Calculate(const WindowBatch& batch, const Params& params, const TypeRegistry::Registry& types, Result& result);
+
+// Расчёт с разбивкой по группам (фасад, стена, этаж) за один проход: окно i
+// попадает в groups[groupOf[i]] и в total. Окна с groupOf[i] >= groupCount
+// считаются только в total. Строки каждой группы - как у Calculate.
+void CalculateGrouped(const WindowBatch& batch, const std::vector<uint32_t>& groupOf, size_t groupCount,
+                      const Params& params, Result& total, std::vector<Result>& groups);
+
+// Добавить строки from к into (одинаковые размеры суммируются). Строки
+// упорядочены так же, как в Calculate, независимо от порядка слияния
+void Merge(Result& into, const Result& from);
+
+} // namespace CassetteCore
+
+#endif // CASSETTECORE_HPP
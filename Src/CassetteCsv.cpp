@@ -0,0 +1,675 @@
+// =============================================================================
+// CassetteCsv - Экспорт и импорт результатов расчёта в CSV
+// =============================================================================
+
+#include "CassetteCsv.hpp"
+#include "FileIO.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace CassetteCsv {
+
+using CassetteHelper::CassetteSize;
+using CassetteHelper::PlankSize;
+
+// =============================================================================
+// Тексты формата (создаются один раз)
+// =============================================================================
+
+static const GS::UniString HeaderType("Тип");
+static const GS::UniString HeaderElemType("Тип элемента");
+static const GS::UniString HeaderSizeX("Размер X");
+static const GS::UniString HeaderSizeY("Размер Y");
+static const GS::UniString HeaderCount("Количество");
+static const GS::UniString HeaderDescription("Описание");
+
+static const GS::UniString RowCassette("Кассета");
+static const GS::UniString RowPlank("Планка");
+static const GS::UniString RowLeftSlope("Левый откос");
+static const GS::UniString RowRightSlope("Правый откос");
+
+static const GS::UniString ElemType0("0");
+static const GS::UniString ElemType12("1-2");
+
+static const GS::UniString TextSize("Размер: ");
+static const GS::UniString TextCassetteSize("Размер: U x V : ");
+static const GS::UniString TextX("x");
+static const GS::UniString TextMm(" мм");
+static const GS::UniString TextLengthZ("; Длина Z = ");
+static const GS::UniString TextLengthW("; Длина W = ");
+static const GS::UniString TextCount("; Количество: ");
+static const GS::UniString TextPieces(" шт.");
+
+// =============================================================================
+// CsvWriter - строки CSV поверх буферизованного файла
+// =============================================================================
+
+class CsvWriter {
+public:
+    explicit CsvWriter(FileIO::Writer& output) :
+        out(output),
+        firstInRow(true),
+        rows(0)
+    {
+    }
+
+    void Field(const GS::UniString& value)
+    {
+        Separator();
+        if (!NeedsQuotes(value)) {
+            out.WriteUtf8(value);
+            return;
+        }
+
+        GS::UniString escaped(value);
+        escaped.ReplaceAll("\"", "\"\"");
+        out.WriteChar('"');
+        out.WriteUtf8(escaped);
+        out.WriteChar('"');
+    }
+
+    void Field(Int64 value)
+    {
+        Separator();
+        out.WriteInt(value);
+    }
+
+    // Поле в кавычках, собираемое по частям (Text). Части не должны содержать '"'.
+    void BeginQuoted()
+    {
+        Separator();
+        out.WriteChar('"');
+    }
+
+    void Text(const GS::UniString& part) { out.WriteUtf8(part); }
+    void Text(Int64 value)               { out.WriteInt(value); }
+
+    void EndQuoted()
+    {
+        out.WriteChar('"');
+    }
+
+    void EndRow()
+    {
+        out.Write("\r\n", 2);
+        firstInRow = true;
+        rows++;
+    }
+
+    UInt32 GetRowCount() const { return rows; }
+
+private:
+    static bool NeedsQuotes(const GS::UniString& value)
+    {
+        const GS::UniString::UStr wide = value.ToUStr();
+        const GS::uchar_t* p = wide.Get();
+        const GS::uchar_t* end = p + value.GetLength();
+        for (; p < end; ++p) {
+            if (*p == ';' || *p == '"' || *p == '\n' || *p == '\r') {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Separator()
+    {
+        if (!firstInRow) {
+            out.WriteChar(';');
+        }
+        firstInRow = false;
+    }
+
+    FileIO::Writer& out;
+    bool firstInRow;
+    UInt32 rows;
+};
+
+// =============================================================================
+// Строки результата
+// =============================================================================
+
+static void WriteCassetteRow(CsvWriter& csv, const CassetteSize& c)
+{
+    csv.Field(RowCassette);
+    csv.Field(ElemType12);
+    csv.Field(c.x);
+    csv.Field(c.y);
+    csv.Field(c.count);
+
+    // Размер: U x V : XxY мм; Количество: N шт.
+    csv.BeginQuoted();
+    csv.Text(TextCassetteSize);
+    csv.Text(c.x);
+    csv.Text(TextX);
+    csv.Text(c.y);
+    csv.Text(TextMm);
+    csv.Text(TextCount);
+    csv.Text(c.count);
+    csv.Text(TextPieces);
+    csv.EndQuoted();
+
+    csv.EndRow();
+}
+
+// Планки: длина W для типов 1-2, Z для типа 0; откосы: всегда Z
+static void WritePlankRow(CsvWriter& csv, const GS::UniString& rowType, const PlankSize& p, bool isPlank)
+{
+    csv.Field(rowType);
+    csv.Field(p.calcType == 0 ? ElemType0 : ElemType12);
+    csv.Field(p.width);
+    csv.Field(p.length);
+    csv.Field(p.count);
+
+    // Размер: WxL мм; Длина Z = L мм; Количество: N шт.
+    csv.BeginQuoted();
+    csv.Text(TextSize);
+    csv.Text(p.width);
+    csv.Text(TextX);
+    csv.Text(p.length);
+    csv.Text(TextMm);
+    csv.Text(isPlank && p.calcType != 0 ? TextLengthW : TextLengthZ);
+    csv.Text(p.length);
+    csv.Text(TextMm);
+    csv.Text(TextCount);
+    csv.Text(p.count);
+    csv.Text(TextPieces);
+    csv.EndQuoted();
+
+    csv.EndRow();
+}
+
+// =============================================================================
+// ExportResult
+// =============================================================================
+
+bool ExportResult(const GS::UniString& path,
+                  const CassetteHelper::CalculationResult& result,
+                  ExportStats& stats,
+                  GS::UniString& errorMessage)
+{
+    stats.rows = 0;
+    stats.bytes = 0;
+
+    FileIO::Writer out;
+    if (!out.Open(path)) {
+        errorMessage = "Не удалось создать файл: " + path;
+        return false;
+    }
+
+    // BOM - чтобы Excel открывал файл как UTF-8
+    out.Write("\xEF\xBB\xBF", 3);
+
+    CsvWriter csv(out);
+    csv.Field(HeaderType);
+    csv.Field(HeaderElemType);
+    csv.Field(HeaderSizeX);
+    csv.Field(HeaderSizeY);
+    csv.Field(HeaderCount);
+    csv.Field(HeaderDescription);
+    csv.EndRow();
+
+    for (const CassetteSize& c : result.cassettes) {
+        WriteCassetteRow(csv, c);
+    }
+    for (const PlankSize& p : result.planks) {
+        WritePlankRow(csv, RowPlank, p, true);
+    }
+    for (const PlankSize& s : result.leftSlopes) {
+        WritePlankRow(csv, RowLeftSlope, s, false);
+    }
+    for (const PlankSize& s : result.rightSlopes) {
+        WritePlankRow(csv, RowRightSlope, s, false);
+    }
+
+    if (!out.Close()) {
+        errorMessage = "Ошибка записи файла: " + path;
+        return false;
+    }
+
+    stats.rows = csv.GetRowCount() - 1;
+    stats.bytes = out.GetBytesWritten();
+    return true;
+}
+
+// =============================================================================
+// RowReader - однопроходный разбор CSV по байтам
+// =============================================================================
+
+// Поле строки: указатель в отображённый файл или (для полей с "") в буфер строки
+struct Cell {
+    const char* data;
+    size_t size;
+};
+
+class RowReader {
+public:
+    RowReader(const char* data, size_t size) :
+        p(data),
+        end(data + size),
+        line(0),
+        nextLine(1)
+    {
+        // BOM
+        if (size >= 3 && static_cast<unsigned char>(p[0]) == 0xEF &&
+            static_cast<unsigned char>(p[1]) == 0xBB && static_cast<unsigned char>(p[2]) == 0xBF) {
+            p += 3;
+        }
+    }
+
+    // Прочитать следующую строку; false - конец файла
+    bool Next(std::vector<Cell>& cells)
+    {
+        if (p >= end) {
+            return false;
+        }
+
+        cells.clear();
+        arena.clear();
+        arenaCells.clear();
+        line = nextLine;
+
+        for (;;) {
+            ReadField(cells);
+
+            if (p >= end) {
+                break;
+            }
+            if (*p == ';') {
+                ++p;
+                continue;
+            }
+            // Конец строки: \r\n, \n или одиночный \r
+            if (*p == '\r') {
+                ++p;
+            }
+            if (p < end && *p == '\n') {
+                ++p;
+            }
+            nextLine++;
+            break;
+        }
+
+        // Буфер строки больше не растёт - теперь указатели на него стабильны
+        for (const ArenaCell& ac : arenaCells) {
+            cells[ac.cellIndex].data = arena.data() + ac.offset;
+        }
+        return true;
+    }
+
+    // Номер строки файла (с 1), с которой началась последняя прочитанная строка
+    UInt32 GetLine() const { return line; }
+
+private:
+    struct ArenaCell {
+        size_t cellIndex;
+        size_t offset;
+    };
+
+    void ReadField(std::vector<Cell>& cells)
+    {
+        if (p < end && *p == '"') {
+            ReadQuotedField(cells);
+            return;
+        }
+
+        const char* start = p;
+        while (p < end && *p != ';' && *p != '\n' && *p != '\r') {
+            ++p;
+        }
+        cells.push_back({ start, static_cast<size_t>(p - start) });
+    }
+
+    void ReadQuotedField(std::vector<Cell>& cells)
+    {
+        ++p;    // открывающая кавычка
+        const char* start = p;
+        bool inArena = false;
+        size_t arenaOffset = 0;
+
+        while (p < end) {
+            if (*p == '"') {
+                if (p + 1 < end && p[1] == '"') {
+                    // "" - экранированная кавычка: дальше копим поле в буфер строки
+                    if (!inArena) {
+                        arenaOffset = arena.size();
+                        arena.append(start, p - start);
+                        inArena = true;
+                    }
+                    arena.push_back('"');
+                    p += 2;
+                    continue;
+                }
+                break;
+            }
+            if (*p == '\n') {
+                nextLine++;
+            }
+            if (inArena) {
+                arena.push_back(*p);
+            }
+            ++p;
+        }
+
+        if (inArena) {
+            arenaCells.push_back({ cells.size(), arenaOffset });
+            cells.push_back({ nullptr, arena.size() - arenaOffset });
+        } else {
+            cells.push_back({ start, static_cast<size_t>(p - start) });
+        }
+
+        if (p < end) {
+            ++p;    // закрывающая кавычка
+        }
+        // Мусор между закрывающей кавычкой и разделителем игнорируем
+        while (p < end && *p != ';' && *p != '\n' && *p != '\r') {
+            ++p;
+        }
+    }
+
+    const char* p;
+    const char* end;
+    UInt32 line;
+    UInt32 nextLine;
+    std::string arena;
+    std::vector<ArenaCell> arenaCells;
+};
+
+// =============================================================================
+// Разбор полей
+// =============================================================================
+
+static Cell Trim(Cell cell)
+{
+    while (cell.size > 0 && (cell.data[0] == ' ' || cell.data[0] == '\t')) {
+        cell.data++;
+        cell.size--;
+    }
+    while (cell.size > 0 && (cell.data[cell.size - 1] == ' ' || cell.data[cell.size - 1] == '\t')) {
+        cell.size--;
+    }
+    return cell;
+}
+
+static bool Equals(const Cell& cell, const std::string& text)
+{
+    return cell.size == text.size() && (cell.size == 0 || memcmp(cell.data, text.data(), cell.size) == 0);
+}
+
+// Целое число; дробная часть ("285.0", "285,0") отбрасывается
+static bool ParseIntCell(const Cell& raw, Int32& out)
+{
+    const Cell cell = Trim(raw);
+    const char* p = cell.data;
+    const char* end = cell.data + cell.size;
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        ++p;
+    }
+    if (p == end || *p < '0' || *p > '9') {
+        return false;
+    }
+
+    Int64 value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + (*p - '0');
+        if (value > 0x7FFFFFFF) {
+            return false;
+        }
+        ++p;
+    }
+    if (p < end && (*p == '.' || *p == ',')) {
+        ++p;
+        while (p < end && *p >= '0' && *p <= '9') {
+            ++p;
+        }
+    }
+    if (p != end) {
+        return false;
+    }
+
+    out = static_cast<Int32>(negative ? -value : value);
+    return true;
+}
+
+// Колонка по имени заголовка, -1 - нет такой колонки
+static Int32 FindColumn(const std::vector<Cell>& header, const std::string& name)
+{
+    for (size_t i = 0; i < header.size(); ++i) {
+        if (Equals(Trim(header[i]), name)) {
+            return static_cast<Int32>(i);
+        }
+    }
+    return -1;
+}
+
+static const Cell* GetCell(const std::vector<Cell>& cells, Int32 column)
+{
+    if (column < 0 || static_cast<size_t>(column) >= cells.size()) {
+        return nullptr;
+    }
+    return &cells[column];
+}
+
+// =============================================================================
+// Суммирование строк
+// =============================================================================
+
+// Сумма количеств в Int64: false - не помещается в Int32 (строка пропускается)
+static bool AddCount(int& total, Int32 count)
+{
+    const Int64 sum = static_cast<Int64>(total) + count;
+    if (sum > INT32_MAX) {
+        return false;
+    }
+    total = static_cast<int>(sum);
+    return true;
+}
+
+// Одинаковые размеры объединяются в одну строку результата (порядок - по первому появлению)
+class ResultAccumulator {
+public:
+    explicit ResultAccumulator(CassetteHelper::CalculationResult& target) :
+        result(target)
+    {
+    }
+
+    bool AddCassette(Int32 x, Int32 y, Int32 count)
+    {
+        auto key = std::make_tuple(x, y);
+        auto it = cassetteIndex.find(key);
+        if (it != cassetteIndex.end()) {
+            return AddCount(result.cassettes[it->second].count, count);
+        }
+        CassetteSize c;
+        c.x = x;
+        c.y = y;
+        c.count = count;
+        cassetteIndex[key] = result.cassettes.GetSize();
+        result.cassettes.Push(c);
+        return true;
+    }
+
+    bool AddPlank(GS::Array<PlankSize>& list, std::map<std::tuple<Int32, Int32, Int32>, UIndex>& index,
+                  Int32 width, Int32 length, Int32 count, Int32 calcType)
+    {
+        auto key = std::make_tuple(calcType, width, length);
+        auto it = index.find(key);
+        if (it != index.end()) {
+            return AddCount(list[it->second].count, count);
+        }
+        PlankSize ps;
+        ps.width = width;
+        ps.length = length;
+        ps.count = count;
+        ps.calcType = calcType;
+        index[key] = list.GetSize();
+        list.Push(ps);
+        return true;
+    }
+
+    CassetteHelper::CalculationResult& result;
+    std::map<std::tuple<Int32, Int32>, UIndex> cassetteIndex;
+    std::map<std::tuple<Int32, Int32, Int32>, UIndex> plankIndex;
+    std::map<std::tuple<Int32, Int32, Int32>, UIndex> leftSlopeIndex;
+    std::map<std::tuple<Int32, Int32, Int32>, UIndex> rightSlopeIndex;
+};
+
+// Тип элемента: "0" -> 0, "1-2"/"1"/"2" -> 1; иначе (и в старом формате без
+// колонки) - по ширине: 160 и 225 бывают только у типов 1-2
+static Int32 DetectCalcType(const Cell* elemTypeCell, Int32 width,
+                            const std::string& type0, const std::string& type12)
+{
+    if (elemTypeCell != nullptr) {
+        const Cell elemType = Trim(*elemTypeCell);
+        static const std::string type1("1");
+        static const std::string type2("2");
+        if (Equals(elemType, type12) || Equals(elemType, type1) || Equals(elemType, type2)) {
+            return 1;
+        }
+        if (Equals(elemType, type0)) {
+            return 0;
+        }
+    }
+    return (width == 160 || width == 225) ? 1 : 0;
+}
+
+// =============================================================================
+// ParseResult / ImportResult
+// =============================================================================
+
+bool ParseResult(const char* data, size_t size,
+                 CassetteHelper::CalculationResult& result,
+                 ImportStats& stats,
+                 GS::UniString& errorMessage)
+{
+    result.cassettes.Clear();
+    result.planks.Clear();
+    result.leftSlopes.Clear();
+    result.rightSlopes.Clear();
+    result.duplicateIds.Clear();
+    result.errorMessage.Clear();
+    result.success = false;
+
+    stats.rows = 0;
+    stats.imported = 0;
+    stats.skipped = 0;
+    stats.firstSkippedLine = 0;
+
+    RowReader reader(data, size);
+    std::vector<Cell> cells;
+    cells.reserve(8);
+
+    if (!reader.Next(cells)) {
+        errorMessage = "Файл слишком короткий или пустой";
+        return false;
+    }
+
+    // Заголовок
+    const Int32 typeIdx = FindColumn(cells, FileIO::ToUtf8(HeaderType));
+    const Int32 elemTypeIdx = FindColumn(cells, FileIO::ToUtf8(HeaderElemType));
+    const Int32 sizeXIdx = FindColumn(cells, FileIO::ToUtf8(HeaderSizeX));
+    const Int32 sizeYIdx = FindColumn(cells, FileIO::ToUtf8(HeaderSizeY));
+    const Int32 countIdx = FindColumn(cells, FileIO::ToUtf8(HeaderCount));
+
+    if (typeIdx < 0 || sizeXIdx < 0 || countIdx < 0) {
+        errorMessage = "Неверный формат CSV файла. Ожидаются колонки: Тип, Размер X, Размер Y, Количество";
+        return false;
+    }
+
+    const std::string cassetteText = FileIO::ToUtf8(RowCassette);
+    const std::string plankText = FileIO::ToUtf8(RowPlank);
+    const std::string leftSlopeText = FileIO::ToUtf8(RowLeftSlope);
+    const std::string rightSlopeText = FileIO::ToUtf8(RowRightSlope);
+    const std::string type0Text = FileIO::ToUtf8(ElemType0);
+    const std::string type12Text = FileIO::ToUtf8(ElemType12);
+
+    ResultAccumulator acc(result);
+
+    auto skip = [&stats, &reader]() {
+        stats.skipped++;
+        if (stats.firstSkippedLine == 0) {
+            stats.firstSkippedLine = reader.GetLine();
+        }
+    };
+
+    while (reader.Next(cells)) {
+        // Пустые строки не считаем
+        if (cells.size() == 1 && Trim(cells[0]).size == 0) {
+            continue;
+        }
+        stats.rows++;
+
+        const Cell* typeCell = GetCell(cells, typeIdx);
+        const Cell* sizeXCell = GetCell(cells, sizeXIdx);
+        const Cell* sizeYCell = GetCell(cells, sizeYIdx);
+        const Cell* countCell = GetCell(cells, countIdx);
+
+        Int32 sizeX = 0;
+        Int32 count = 0;
+        if (typeCell == nullptr || sizeXCell == nullptr || countCell == nullptr ||
+            !ParseIntCell(*sizeXCell, sizeX) || !ParseIntCell(*countCell, count) || sizeX <= 0 || count <= 0) {
+            skip();
+            continue;
+        }
+
+        // Пустой "Размер Y" - длина равна ширине (как в прежнем импорте)
+        Int32 sizeY = 0;
+        if (sizeYCell != nullptr && Trim(*sizeYCell).size > 0 && (!ParseIntCell(*sizeYCell, sizeY) || sizeY <= 0)) {
+            skip();
+            continue;
+        }
+
+        // У кассеты Y обязателен; сумма количеств должна поместиться в Int32
+        const Cell type = Trim(*typeCell);
+        bool added = false;
+        if (Equals(type, cassetteText)) {
+            added = sizeY > 0 && acc.AddCassette(sizeX, sizeY, count);
+        } else {
+            const Int32 length = sizeY != 0 ? sizeY : sizeX;
+            const Int32 calcType = DetectCalcType(GetCell(cells, elemTypeIdx), sizeX, type0Text, type12Text);
+            if (Equals(type, plankText)) {
+                added = acc.AddPlank(result.planks, acc.plankIndex, sizeX, length, count, calcType);
+            } else if (Equals(type, leftSlopeText)) {
+                added = acc.AddPlank(result.leftSlopes, acc.leftSlopeIndex, sizeX, length, count, calcType);
+            } else if (Equals(type, rightSlopeText)) {
+                added = acc.AddPlank(result.rightSlopes, acc.rightSlopeIndex, sizeX, length, count, calcType);
+            }
+        }
+        if (!added) {
+            skip();
+            continue;
+        }
+        stats.imported++;
+    }
+
+    if (stats.imported == 0) {
+        errorMessage = "В файле не найдено данных для импорта";
+        return false;
+    }
+
+    result.success = true;
+    return true;
+}
+
+bool ImportResult(const GS::UniString& path,
+                  CassetteHelper::CalculationResult& result,
+                  ImportStats& stats,
+                  GS::UniString& errorMessage)
+{
+    FileIO::MappedFile file;
+    if (!file.Open(path)) {
+        errorMessage = "Не удалось открыть файл: " + path;
+        return false;
+    }
+    return ParseResult(file.GetData(), static_cast<size_t>(file.GetSize()), result, stats, errorMessage);
+}
+
+} // namespace CassetteCsv
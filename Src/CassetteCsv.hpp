@@ -0,0 +1,55 @@
+#ifndef CASSETTECSV_HPP
+#define CASSETTECSV_HPP
+
+// =============================================================================
+// CassetteCsv - Экспорт и импорт результатов расчёта в CSV
+// =============================================================================
+// Формат совпадает с прежним экспортом палитры:
+//   Тип;Тип элемента;Размер X;Размер Y;Количество;Описание
+// Файл пишется потоково в UTF-8 с BOM (для Excel), разделитель ';'.
+// Поля с ';', '"' или переводом строки берутся в кавычки.
+//
+// Импорт отображает файл в память и разбирает его за один проход (кавычки,
+// "" внутри кавычек, переводы строк внутри полей, \r\n и \n). Строки сразу
+// проверяются и суммируются в CalculationResult: одинаковые размеры
+// объединяются, количество складывается.
+
+#include "CassetteHelper.hpp"
+
+namespace CassetteCsv {
+
+// Итог экспорта
+struct ExportStats {
+    UInt32 rows;        // Строк данных (без заголовка)
+    UInt64 bytes;       // Размер файла
+};
+
+// Записать результат в файл. При ошибке возвращает false и текст в errorMessage.
+bool ExportResult(const GS::UniString& path,
+                  const CassetteHelper::CalculationResult& result,
+                  ExportStats& stats,
+                  GS::UniString& errorMessage);
+
+// Итог импорта
+struct ImportStats {
+    UInt32 rows;                // Непустых строк данных
+    UInt32 imported;            // Принятых строк
+    UInt32 skipped;             // Пропущенных (неизвестный тип, неверные числа, размеры/количество <= 0, переполнение)
+    UInt32 firstSkippedLine;    // Номер строки файла первой пропущенной (0 - не было)
+};
+
+// Прочитать результат из файла
+bool ImportResult(const GS::UniString& path,
+                  CassetteHelper::CalculationResult& result,
+                  ImportStats& stats,
+                  GS::UniString& errorMessage);
+
+// Разобрать CSV из памяти (UTF-8, BOM допускается)
+bool ParseResult(const char* data, size_t size,
+                 CassetteHelper::CalculationResult& result,
+                 ImportStats& stats,
+                 GS::UniString& errorMessage);
+
+} // namespace CassetteCsv
+
+#endif // CASSETTECSV_HPP
@@ -5,9 +5,18 @@
 #include "CassetteHelper.hpp"
 #include "ACAPinc.h"
 #include "APICommon.h"
+#include "AcHost.hpp"
+#include "FileIO.hpp"
+#include "HostWorkload.hpp"
+#include "OpeningIndex.hpp"
+#include <algorithm>
 #include <cmath>
 #include <map>
 #include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace CassetteHelper {
 
@@ -15,52 +24,6 @@ namespace CassetteHelper {
 // Вспомогательные функции
 // =============================================================================
 
-// Определить тип расчёта из ID элемента
-// Смотрим на конец строки: ":0" или ": 0" → тип 0, ":1" или ": 1" → тип 1, ":2" или ": 2" → тип 2
-int GetCalcTypeFromId(const GS::UniString& id)
-{
-    // Убираем пробелы в конце строки для надёжности
-    GS::UniString trimmedId = id;
-    while (trimmedId.GetLength() > 0 && trimmedId[trimmedId.GetLength() - 1] == ' ') {
-        trimmedId.DeleteLast();
-    }
-    
-    if (trimmedId.GetLength() < 2) {
-        return -1;
-    }
-    
-    // Проверяем последний символ (должен быть 0, 1 или 2)
-    GS::UniChar lastChar = trimmedId[trimmedId.GetLength() - 1];
-    
-    // Проверяем предпоследний символ (должен быть ':' или ': ')
-    GS::UniChar prevChar = trimmedId[trimmedId.GetLength() - 2];
-    
-    bool hasColon = (prevChar == ':');
-    
-    // Если предпоследний - пробел, проверяем символ перед ним
-    if (!hasColon && prevChar == ' ' && trimmedId.GetLength() >= 3) {
-        GS::UniChar prevPrevChar = trimmedId[trimmedId.GetLength() - 3];
-        hasColon = (prevPrevChar == ':');
-    }
-    
-    if (!hasColon) {
-        return -1;
-    }
-    
-    // Определяем тип по последнему символу
-    if (lastChar == '0') {
-        return 0;
-    }
-    if (lastChar == '1') {
-        return 1;
-    }
-    if (lastChar == '2') {
-        return 2;
-    }
-    
-    return -1; // Неизвестный тип
-}
-
 // Получить параметры по умолчанию
 CalcParams GetDefaultParams(CalcType type)
 {
@@ -95,120 +58,62 @@ TargetObjects GetDefaultTargets(CalcType type)
     targets.plankId12 = "OK-1_2_PLNK";
     targets.leftSlopeId12 = "OK-1_2_LOTK";
     targets.rightSlopeId12 = "OK-1_2_ROTK";
+    targets.overflowPages = false;
     
     return targets;
 }
 
+// =============================================================================
+// Вид элемента
+// =============================================================================
+
+const char* GetElemTypeName(ElemType type)
+{
+    return type == ElemType::Door ? "Door" : "Window";
+}
+
+ElemType ElemTypeFromString(const GS::UniString& name)
+{
+    static const GS::UniString door("Door");     // Без временной строки на каждое окно
+    return name == door ? ElemType::Door : ElemType::Window;
+}
+
 // =============================================================================
 // GetSelectedWindowsDoors - получить выделенные окна/двери
 // =============================================================================
 
 GS::Array<WindowDoorInfo> GetSelectedWindowsDoors()
 {
-    GS::Array<WindowDoorInfo> result;
-    
-    // Получаем выделение
-    API_SelectionInfo selectionInfo;
-    GS::Array<API_Neig> selNeigs;
-    
-    GSErrCode err = ACAPI_Selection_Get(&selectionInfo, &selNeigs, false);
-    if (err != NoError || selectionInfo.typeID == API_SelEmpty) {
-        return result;
+    // Чтение выделения и свойств - в HostWorkload (через AcHost, с записью трассы)
+    HostApi::Host& host = AcHost::Get();
+    if (HostTrace::Recorder* recorder = AcHost::GetRecorder()) {
+        recorder->BeginReadSelection();
     }
-    
-    // Обрабатываем каждый выделенный элемент
-    for (const API_Neig& neig : selNeigs) {
-        API_Element element = {};
-        element.header.guid = neig.guid;
-        
-        err = ACAPI_Element_Get(&element);
-        if (err != NoError) continue;
-        
-        // Фильтруем только окна и двери
-        API_ElemTypeID typeID = element.header.type.typeID;
-        if (typeID == API_WindowID || typeID == API_DoorID) {
-            WindowDoorInfo info;
-            info.guid = element.header.guid;
-            
-            // Инициализация
-            info.width = 0;
-            info.height = 0;
-            info.sillHeight = 0;
-            
-            // Получаем размеры из API (openingBase для окон/дверей)
-            if (typeID == API_WindowID) {
-                info.width = element.window.openingBase.width;   // Ширина в метрах
-                info.height = element.window.openingBase.height; // Высота в метрах
-                
-                // Получаем высоту подоконника из lower (Parapet height)
-                info.sillHeight = element.window.lower; // Parapet height = Sill to Storey
-                
-            } else if (typeID == API_DoorID) {
-                info.width = element.door.openingBase.width;    // Ширина в метрах
-                info.height = element.door.openingBase.height;  // Высота в метрах
-                
-                // Получаем высоту подоконника из lower (Parapet height)
-                info.sillHeight = element.door.lower; // Parapet height = Sill to Storey
-            }
-            
-            // Устанавливаем тип элемента
-            if (typeID == API_WindowID) {
-                info.elemType = "Window";
-            } else {
-                info.elemType = "Door";
-            }
-            // Координаты не критичны для расчёта, устанавливаем 0
-            info.x = 0;
-            info.y = 0;
-            info.angle = 0;
-            
-            // Получаем ID элемента через свойства
-            // Сначала пробуем пользовательские свойства
-            GS::Array<API_PropertyDefinition> definitions;
-            err = ACAPI_Element_GetPropertyDefinitions(element.header.guid, API_PropertyDefinitionFilter_UserDefined, definitions);
-            
-            // Ищем свойство ID в пользовательских свойствах
-            bool idFound = false;
-            for (const API_PropertyDefinition& def : definitions) {
-                if (def.name.Contains("ID") || def.name.Contains("id") || 
-                    def.name.Contains("ИД") || def.name.Contains("идентификатор")) {
-                    API_Property property;
-                    err = ACAPI_Element_GetPropertyValue(element.header.guid, def.guid, property);
-                    if (err == NoError && property.isDefault == false) {
-                        if (property.value.singleVariant.variant.type == API_PropertyStringValueType) {
-                            info.id = property.value.singleVariant.variant.uniStringValue;
-                            idFound = true;
-                            break;
-                        }
-                    }
-                }
-            }
-            
-            // Если не нашли в пользовательских, пробуем все свойства
-            if (!idFound) {
-                err = ACAPI_Element_GetPropertyDefinitions(element.header.guid, API_PropertyDefinitionFilter_All, definitions);
-                for (const API_PropertyDefinition& def : definitions) {
-                    if (def.name.Contains("ID") || def.name.Contains("id") || 
-                        def.name.Contains("ИД") || def.name.Contains("идентификатор")) {
-                        API_Property property;
-                        err = ACAPI_Element_GetPropertyValue(element.header.guid, def.guid, property);
-                        if (err == NoError && property.isDefault == false) {
-                            if (property.value.singleVariant.variant.type == API_PropertyStringValueType) {
-                                info.id = property.value.singleVariant.variant.uniStringValue;
-                                break;
-                            }
-                        }
-                    }
-                }
-            }
-            
-            // Определяем тип расчёта из ID
-            info.calcType = GetCalcTypeFromId(info.id);
-            
-            // Добавляем элемент, даже если ID не соответствует паттерну (calcType будет -1)
-            // Это позволит видеть все окна/двери, а не только с правильными ID
-            result.Push(info);
-        }
+
+    std::vector<HostWorkload::Opening> openings;
+    HostWorkload::ReadSelectedOpenings(host, openings, AcHost::GetWallCache());
+
+    GS::Array<WindowDoorInfo> result;
+    result.EnsureCapacity(static_cast<USize>(openings.size()));
+    for (const HostWorkload::Opening& opening : openings) {
+        WindowDoorInfo info;
+        std::memcpy(&info.guid, opening.guid.bytes, sizeof(opening.guid.bytes));
+        info.id = IdPool::InternUtf8(opening.id);
+        info.elemType = opening.type == HostApi::ElemType::Window ? ElemType::Window : ElemType::Door;
+        // Размеры - в мм один раз, при чтении
+        info.width = Mm::FromMetres(opening.width);
+        info.height = Mm::FromMetres(opening.height);
+        info.sillHeight = Mm::FromMetres(opening.sillHeight);
+        // Координаты - по стене проёма (0, если стена не известна)
+        info.x = opening.x;
+        info.y = opening.y;
+        info.angle = opening.angle;
+        info.normal = opening.normal;
+        std::memcpy(&info.wall, opening.wall.bytes, sizeof(opening.wall.bytes));
+        info.storey = opening.storey;
+        // Окна без распознанного типа тоже попадают в список (calcType = -1)
+        info.calcType = opening.calcType;
+        result.Push(info);
     }
     
     return result;
@@ -221,735 +126,364 @@ GS::Array<WindowDoorInfo> GetSelectedWindowsDoors()
 
 double GetFloorHeightFromWall(const GS::UniString& wallIdPattern)
 {
-    if (wallIdPattern.IsEmpty()) {
-        return 0.0;
-    }
-    
-    // Получаем список всех стен в проекте
-    GS::Array<API_Guid> wallGuids;
-    GSErrCode err = ACAPI_Element_GetElemList(API_WallID, &wallGuids);
-    if (err != NoError || wallGuids.IsEmpty()) {
-        return 0.0;
+    const std::string pattern = FileIO::ToUtf8(wallIdPattern);
+    HostApi::Host& host = AcHost::Get();
+    if (HostTrace::Recorder* recorder = AcHost::GetRecorder()) {
+        recorder->BeginFindWallHeight(pattern);
     }
-    
-    // Ищем стену с нужным ID
-    for (const API_Guid& guid : wallGuids) {
-        API_Element element = {};
-        element.header.guid = guid;
-        
-        err = ACAPI_Element_Get(&element);
-        if (err != NoError) continue;
-        
-        // Получаем ID стены через свойства
-        GS::Array<API_PropertyDefinition> definitions;
-        err = ACAPI_Element_GetPropertyDefinitions(guid, API_PropertyDefinitionFilter_UserDefined, definitions);
-        
-        for (const API_PropertyDefinition& def : definitions) {
-            if (def.name.Contains("ID") || def.name.Contains("id") || 
-                def.name.Contains("ИД") || def.name.Contains("идентификатор")) {
-                API_Property property;
-                err = ACAPI_Element_GetPropertyValue(guid, def.guid, property);
-                if (err == NoError && property.isDefault == false) {
-                    if (property.value.singleVariant.variant.type == API_PropertyStringValueType) {
-                        GS::UniString wallId = property.value.singleVariant.variant.uniStringValue;
-                        
-                        // Проверяем, содержит ли ID паттерн
-                        if (wallId.Contains(wallIdPattern)) {
-                            // Нашли стену! Возвращаем её высоту в метрах
-                            double wallHeight = element.wall.height;
-                            return wallHeight;
-                        }
-                    }
-                }
-            }
-        }
-        
-        // Также проверяем все свойства, если не нашли в пользовательских
-        err = ACAPI_Element_GetPropertyDefinitions(guid, API_PropertyDefinitionFilter_All, definitions);
-        for (const API_PropertyDefinition& def : definitions) {
-            if (def.name.Contains("ID") || def.name.Contains("id") || 
-                def.name.Contains("ИД") || def.name.Contains("идентификатор")) {
-                API_Property property;
-                err = ACAPI_Element_GetPropertyValue(guid, def.guid, property);
-                if (err == NoError && property.isDefault == false) {
-                    if (property.value.singleVariant.variant.type == API_PropertyStringValueType) {
-                        GS::UniString wallId = property.value.singleVariant.variant.uniStringValue;
-                        
-                        // Проверяем, содержит ли ID паттерн
-                        if (wallId.Contains(wallIdPattern)) {
-                            // Нашли стену! Возвращаем её высоту в метрах
-                            double wallHeight = element.wall.height;
-                            return wallHeight;
-                        }
-                    }
-                }
-            }
-        }
-    }
-    
-    // Стена не найдена
-    return 0.0;
+    return HostWorkload::FindWallHeight(host, pattern, AcHost::GetWallCache());
 }
 
 // =============================================================================
 // FindDuplicateIds - найти дубликаты ID
 // =============================================================================
 
+GS::Array<DuplicateGroup> FindDuplicateGroups(const GS::Array<WindowDoorInfo>& windows)
+{
+    // Одинаковые ID - один дескриптор пула. Таблица по дескрипторам окон
+    // (а не вектор на весь пул, который растёт от выделения к выделению):
+    // первое вхождение ID или номер его группы.
+    struct Seen {
+        UIndex first;
+        Int32 group;            // -1 - ID пока встретился один раз
+    };
+    std::unordered_map<IdPool::Handle, Seen> seen;
+    seen.reserve(windows.GetSize());
+
+    std::vector<DuplicateGroup> groups;
+    for (UIndex i = 0; i < windows.GetSize(); ++i) {
+        std::pair<std::unordered_map<IdPool::Handle, Seen>::iterator, bool> entry =
+            seen.emplace(windows[i].id, Seen{ i, -1 });
+        if (entry.second) {
+            continue;
+        }
+        Seen& s = entry.first->second;
+        if (s.group < 0) {
+            s.group = static_cast<Int32>(groups.size());
+            groups.emplace_back();
+            groups.back().id = windows[i].id;
+            groups.back().indices.Push(s.first);
+            groups.back().guids.Push(windows[s.first].guid);
+        }
+        groups[s.group].indices.Push(i);
+        groups[s.group].guids.Push(windows[i].guid);
+    }
+
+    // Группы по алфавиту ID, как раньше список дубликатов (сравниваются
+    // только ID групп)
+    std::sort(groups.begin(), groups.end(), [](const DuplicateGroup& a, const DuplicateGroup& b) {
+        return IdPool::Get(a.id) < IdPool::Get(b.id);
+    });
+    GS::Array<DuplicateGroup> result;
+    result.EnsureCapacity(static_cast<USize>(groups.size()));
+    for (DuplicateGroup& group : groups) {
+        result.Push(std::move(group));
+    }
+    return result;
+}
+
 GS::Array<GS::UniString> FindDuplicateIds(const GS::Array<WindowDoorInfo>& windows)
 {
+    const GS::Array<DuplicateGroup> groups = FindDuplicateGroups(windows);
     GS::Array<GS::UniString> duplicates;
-    std::map<GS::UniString, int> idCount;
-    
-    // Подсчитываем количество каждого ID
-    for (const WindowDoorInfo& w : windows) {
-        idCount[w.id]++;
-    }
-    
-    // Находим дубликаты
-    for (const auto& pair : idCount) {
-        if (pair.second > 1) {
-            duplicates.Push(pair.first);
-        }
+    duplicates.EnsureCapacity(groups.GetSize());
+    for (const DuplicateGroup& group : groups) {
+        duplicates.Push(IdPool::Get(group.id));
     }
-    
     return duplicates;
 }
 
+// =============================================================================
+// SelectElements - выделить элементы в модели
+// =============================================================================
+
+bool SelectElements(const GS::Array<API_Guid>& guids)
+{
+    std::vector<HostApi::Guid> elements(guids.GetSize());
+    for (UIndex i = 0; i < guids.GetSize(); ++i) {
+        std::memcpy(elements[i].bytes, &guids[i], sizeof(elements[i].bytes));
+    }
+    return AcHost::Get().SelectElements(elements) == NoError;
+}
+
 // =============================================================================
 // Calculate - выполнить расчёт
 // =============================================================================
 
-CalculationResult Calculate(
-    const GS::Array<WindowDoorInfo>& windows,
-    const CalcParams& params)
+CassetteCore::Params ToCoreParams(const CalcParams& params)
 {
-    CalculationResult result;
-    result.success = true;
-    
-    // Проверяем дубликаты
-    result.duplicateIds = FindDuplicateIds(windows);
-    
-    // Временные структуры для группировки с учётом типа элемента
-    std::map<std::pair<int, int>, int> cassetteGroups;  // (X, Y) -> count (только для типов 1-2)
-    std::map<std::pair<int, int>, int> plankGroups0;   // (length, width) -> count для типа 0
-    std::map<std::pair<int, int>, int> plankGroups12;  // (length, width) -> count для типов 1-2
-    std::map<std::pair<int, int>, int> leftSlopeGroups0;   // (length, width) -> count для типа 0
-    std::map<std::pair<int, int>, int> leftSlopeGroups12;  // (length, width) -> count для типов 1-2
-    std::map<std::pair<int, int>, int> rightSlopeGroups0;  // (length, width) -> count для типа 0
-    std::map<std::pair<int, int>, int> rightSlopeGroups12; // (length, width) -> count для типов 1-2
-    
-    // Обрабатываем каждое окно (обрабатываем все элементы подряд без фильтрации по типу расчёта)
+    CassetteCore::Params core;
+    core.floorHeight = params.floorHeight;
+    core.plankWidth0 = params.plankWidth0;
+    core.slopeWidth0 = params.slopeWidth0;
+    core.plankWidth12 = params.plankWidth12;
+    core.slopeWidth12 = params.slopeWidth12;
+    core.offsetX = params.offsetX;
+    core.offsetY = params.offsetY;
+    core.offsetTop = params.offsetTop;
+    return core;
+}
+
+void ToWindowBatch(const GS::Array<WindowDoorInfo>& windows, CassetteCore::WindowBatch& batch)
+{
+    batch.Clear();
+    batch.Reserve(windows.GetSize());
     for (const WindowDoorInfo& w : windows) {
-        // Определяем ширину планки и откоса в зависимости от типа элемента
-        int plankWidth = (w.calcType == 0) ? params.plankWidth0 : params.plankWidth12;
-        int slopeWidth = (w.calcType == 0) ? params.slopeWidth0 : params.slopeWidth12;
-        
-        // Расчёт планок: длина = B * 1000 + offsetY
-        int plankLength = static_cast<int>(w.width * 1000) + params.offsetY;
-        if (w.calcType == 0) {
-            plankGroups0[{plankLength, plankWidth}] += 2;  // По 2 на каждое окно
-        } else {
-            plankGroups12[{plankLength, plankWidth}] += 2;  // По 2 на каждое окно
-        }
-        
-        // Расчёт откосов: длина = C * 1000
-        int slopeLength = static_cast<int>(w.height * 1000);
-        if (w.calcType == 0) {
-            leftSlopeGroups0[{slopeLength, slopeWidth}] += 1;
-            rightSlopeGroups0[{slopeLength, slopeWidth}] += 1;
-        } else {
-            leftSlopeGroups12[{slopeLength, slopeWidth}] += 1;
-            rightSlopeGroups12[{slopeLength, slopeWidth}] += 1;
-        }
-        
-        // Расчёт кассет (только для типов 1 и 2)
-        if (w.calcType == 1 || w.calcType == 2) {
-            // Y одинаковый для всех кассет: Y = B * 1000 + offsetY
-            int cassetteY = static_cast<int>(w.width * 1000) + params.offsetY;
-            
-            // Тип 1: ТОЛЬКО верхняя кассета
-            // Тип 2: нижняя + верхняя кассеты
-            
-            // Нижняя кассета (только для типа 2)
-            if (w.calcType == 2) {
-                // X = D * 1000 + offsetX
-                int cassetteX = static_cast<int>(w.sillHeight * 1000) + params.offsetX;
-                cassetteGroups[{cassetteX, cassetteY}]++;
-            }
-            
-            // Верхняя кассета (для типов 1 и 2)
-            // X2 = I2*1000 - (190 + C*1000 + D*1000 + 20) + offsetTop
-            int cassetteX2 = static_cast<int>(params.floorHeight * 1000) 
-                - (190 + static_cast<int>(w.height * 1000) + static_cast<int>(w.sillHeight * 1000) + 20) 
-                + params.offsetTop;
-            cassetteGroups[{cassetteX2, cassetteY}]++;
-        }
+        batch.Add(w.width, w.height, w.sillHeight, w.calcType);
     }
-    
-    // Конвертируем группы в результат
-    for (const auto& pair : cassetteGroups) {
+}
+
+CalculationResult FromCoreResult(const CassetteCore::Result& core)
+{
+    CalculationResult result;
+    result.success = true;
+
+    result.cassettes.EnsureCapacity(static_cast<USize>(core.cassettes.size()));
+    for (const CassetteCore::CassetteRow& row : core.cassettes) {
         CassetteSize cs;
-        cs.x = pair.first.first;
-        cs.y = pair.first.second;
-        cs.count = pair.second;
+        cs.x = row.x;
+        cs.y = row.y;
+        cs.count = row.count;
         result.cassettes.Push(cs);
     }
-    
-    // Планки для типа 0
-    for (const auto& pair : plankGroups0) {
-        PlankSize ps;
-        ps.width = pair.first.second;
-        ps.length = pair.first.first;
-        ps.count = pair.second;
-        ps.calcType = 0;  // Тип 0
-        result.planks.Push(ps);
-    }
-    
-    // Планки для типов 1-2
-    for (const auto& pair : plankGroups12) {
-        PlankSize ps;
-        ps.width = pair.first.second;
-        ps.length = pair.first.first;
-        ps.count = pair.second;
-        ps.calcType = 1;  // Тип 1 или 2 (будет уточнено при необходимости, но для записи это не важно - оба идут в объекты типа 1-2)
-        result.planks.Push(ps);
-    }
-    
-    // Левые откосы для типа 0
-    for (const auto& pair : leftSlopeGroups0) {
-        PlankSize ps;
-        ps.width = pair.first.second;
-        ps.length = pair.first.first;
-        ps.count = pair.second;
-        ps.calcType = 0;  // Тип 0
-        result.leftSlopes.Push(ps);
-    }
-    
-    // Левые откосы для типов 1-2
-    for (const auto& pair : leftSlopeGroups12) {
-        PlankSize ps;
-        ps.width = pair.first.second;
-        ps.length = pair.first.first;
-        ps.count = pair.second;
-        ps.calcType = 1;  // Тип 1 или 2
-        result.leftSlopes.Push(ps);
-    }
-    
-    // Правые откосы для типа 0
-    for (const auto& pair : rightSlopeGroups0) {
-        PlankSize ps;
-        ps.width = pair.first.second;
-        ps.length = pair.first.first;
-        ps.count = pair.second;
-        ps.calcType = 0;  // Тип 0
-        result.rightSlopes.Push(ps);
-    }
-    
-    // Правые откосы для типов 1-2
-    for (const auto& pair : rightSlopeGroups12) {
-        PlankSize ps;
-        ps.width = pair.first.second;
-        ps.length = pair.first.first;
-        ps.count = pair.second;
-        ps.calcType = 1;  // Тип 1 или 2
-        result.rightSlopes.Push(ps);
+
+    auto convert = [](const std::vector<CassetteCore::PlankRow>& rows, GS::Array<PlankSize>& target) {
+        target.EnsureCapacity(static_cast<USize>(rows.size()));
+        for (const CassetteCore::PlankRow& row : rows) {
+            PlankSize ps;
+            ps.width = row.width;
+            ps.length = row.length;
+            ps.count = row.count;
+            ps.calcType = row.calcType;
+            target.Push(ps);
+        }
+    };
+    convert(core.planks, result.planks);
+    convert(core.leftSlopes, result.leftSlopes);
+    convert(core.rightSlopes, result.rightSlopes);
+
+    return result;
+}
+
+CassetteCore::Result ToCoreResult(const CalculationResult& result)
+{
+    CassetteCore::Result core;
+    core.cassettes.reserve(result.cassettes.GetSize());
+    for (const CassetteSize& cs : result.cassettes) {
+        core.cassettes.push_back({ cs.x, cs.y, cs.count });
     }
-    
+
+    auto convert = [](const GS::Array<PlankSize>& source, std::vector<CassetteCore::PlankRow>& target) {
+        target.reserve(source.GetSize());
+        for (const PlankSize& ps : source) {
+            target.push_back({ ps.width, ps.length, ps.count, ps.calcType });
+        }
+    };
+    convert(result.planks, core.planks);
+    convert(result.leftSlopes, core.leftSlopes);
+    convert(result.rightSlopes, core.rightSlopes);
+    return core;
+}
+
+CalculationResult Calculate(
+    const GS::Array<WindowDoorInfo>& windows,
+    const CalcParams& params)
+{
+    // Сам расчёт - в CassetteCore (без Archicad API), здесь только преобразование типов
+    CassetteCore::WindowBatch batch;
+    ToWindowBatch(windows, batch);
+
+    CassetteCore::Result core;
+    CassetteCore::Calculate(batch, ToCoreParams(params), core);
+
+    CalculationResult result = FromCoreResult(core);
+    result.duplicateIds = FindDuplicateIds(windows);
     return result;
 }
 
 // =============================================================================
-// WriteToTargetObjects - записать результаты в GDL объекты
+// CalculateGrouped - расчёт по фасадам, стенам или этажам
 // =============================================================================
 
-bool WriteToTargetObjects(
-    const CalculationResult& result,
-    const TargetObjects& targets,
-    const CalcParams& params)
+GroupBy GroupByFromString(const GS::UniString& key)
 {
-    // Получаем выделение
-    API_SelectionInfo selectionInfo;
-    GS::Array<API_Neig> selNeigs;
-    
-    GSErrCode err = ACAPI_Selection_Get(&selectionInfo, &selNeigs, false);
-    if (err != NoError) {
-        return false;
+    if (key == "facade") return GroupBy::Facade;
+    if (key == "wall")   return GroupBy::Wall;
+    if (key == "storey") return GroupBy::Storey;
+    return GroupBy::None;
+}
+
+// Номера групп по ключам окон: группы нумеруются по возрастанию ключа
+template <typename Key>
+static void NumberGroups(const std::vector<Key>& keys, std::vector<uint32_t>& groupOf, std::vector<Key>& groupKeys)
+{
+    std::map<Key, uint32_t> index;
+    for (const Key& key : keys) {
+        index.emplace(key, 0);
     }
-    
-    // Функция для форматирования строки (3 параметра)
-    auto formatLine3 = [](const char* format, int a, int b, int c) -> GS::UniString {
-        char buffer[256];
-        std::snprintf(buffer, sizeof(buffer), format, a, b, c);
-        return GS::UniString(buffer);
-    };
-    
-    // Функция для форматирования строки (4 параметра)
-    auto formatLine4 = [](const char* format, int a, int b, int c, int d) -> GS::UniString {
-        char buffer[256];
-        std::snprintf(buffer, sizeof(buffer), format, a, b, c, d);
-        return GS::UniString(buffer);
-    };
-    
-    // Функция для поиска объекта по ID и записи параметров
-    auto writeToObject = [&](const GS::UniString& targetId, 
-                             const GS::Array<GS::UniString>& lines,
-                             int maxLines) -> bool {
-        if (targetId.IsEmpty()) {
-            WriteReport("=== writeToObject: targetId пустой, пропуск");
-            return true;
+    groupKeys.clear();
+    groupKeys.reserve(index.size());
+    for (auto& pair : index) {
+        pair.second = static_cast<uint32_t>(groupKeys.size());
+        groupKeys.push_back(pair.first);
+    }
+    groupOf.resize(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        groupOf[i] = index[keys[i]];
+    }
+}
+
+CalculationResult CalculateGrouped(
+    const GS::Array<WindowDoorInfo>& windows,
+    const CalcParams& params,
+    GroupBy groupBy,
+    GS::Array<CalculationGroup>& groups)
+{
+    groups.Clear();
+    if (groupBy == GroupBy::None) {
+        return Calculate(windows, params);
+    }
+
+    // Группа каждого окна и подписи групп
+    std::vector<uint32_t> groupOf;
+    if (groupBy == GroupBy::Wall) {
+        std::vector<HostApi::Guid> keys(windows.GetSize());
+        for (UIndex i = 0; i < windows.GetSize(); ++i) {
+            std::memcpy(keys[i].bytes, &windows[i].wall, sizeof(keys[i].bytes));
         }
-        
-        WriteReport("=== writeToObject: поиск объекта ID='%s', lines=%d, maxLines=%d", 
-            targetId.ToCStr().Get(), lines.GetSize(), maxLines);
-        WriteReport("  Выделено элементов: %d", selNeigs.GetSize());
-        
-        for (UIndex neigIdx = 0; neigIdx < selNeigs.GetSize(); neigIdx++) {
-            const API_Neig& neig = selNeigs[neigIdx];
-            API_Element element = {};
-            element.header.guid = neig.guid;
-            
-            WriteReport("  Проверка элемента [%d/%d]: guid=%s", 
-                neigIdx + 1, selNeigs.GetSize(), 
-                APIGuidToString(neig.guid).ToCStr().Get());
-            
-            err = ACAPI_Element_Get(&element);
-            if (err != NoError) {
-                WriteReport("    Ошибка получения элемента: err=%d", err);
-                continue;
-            }
-            
-            WriteReport("    Тип элемента: typeID=%d", element.header.type.typeID);
-            
-            // Проверяем что это Object
-            if (element.header.type.typeID != API_ObjectID) {
-                WriteReport("    Пропуск: не Object (typeID=%d)", element.header.type.typeID);
-                continue;
-            }
-            
-            WriteReport("    Это Object, ищем ID...");
-            
-            // Получаем ID объекта - пробуем все свойства
-            GS::Array<API_PropertyDefinition> definitions;
-            err = ACAPI_Element_GetPropertyDefinitions(element.header.guid, 
-                API_PropertyDefinitionFilter_All, definitions);
-            
-            if (err != NoError) {
-                WriteReport("    Ошибка получения свойств: err=%d", err);
-                continue;
-            }
-            
-            WriteReport("    Найдено свойств: %d", definitions.GetSize());
-            
-            GS::UniString objectId;
-            bool idFound = false;
-            
-            // Сначала пробуем пользовательские свойства
-            for (const API_PropertyDefinition& def : definitions) {
-                GS::UniString propName = def.name;
-                
-                // Логируем все свойства с ID в названии
-                if (propName.Contains("ID", GS::UniString::CaseInsensitive) || 
-                    propName.Contains("id", GS::UniString::CaseInsensitive) ||
-                    propName.Contains("ИД", GS::UniString::CaseInsensitive) ||
-                    propName.Contains("идентификатор", GS::UniString::CaseInsensitive)) {
-                    
-                    WriteReport("    Найдено свойство с ID: '%s'", propName.ToCStr().Get());
-                    
-                    API_Property property;
-                    err = ACAPI_Element_GetPropertyValue(element.header.guid, def.guid, property);
-                    if (err == NoError && property.isDefault == false) {
-                        if (property.value.singleVariant.variant.type == API_PropertyStringValueType) {
-                            objectId = property.value.singleVariant.variant.uniStringValue;
-                            WriteReport("    *** ID объекта: '%s' (ищем '%s')", 
-                                objectId.ToCStr().Get(), targetId.ToCStr().Get());
-                            idFound = true;
-                            break;
-                        }
-                    }
-                }
-            }
-            
-            if (!idFound) {
-                WriteReport("    ВНИМАНИЕ: ID не найден в свойствах!");
-                // Пробуем получить через libInd и имя библиотечной части
-                if (element.object.libInd != 0) {
-                    API_LibPart libPart;
-                    libPart.index = element.object.libInd;
-                    err = ACAPI_LibraryPart_Get(&libPart);
-                    if (err == NoError) {
-                        WriteReport("    Имя библиотечной части: '%s'", 
-                            GS::UniString(libPart.docu_UName).ToCStr().Get());
-                    }
-                }
-                continue;
-            }
-            
-            if (objectId != targetId) {
-                WriteReport("    Пропуск: ID не совпадает ('%s' != '%s')", 
-                    objectId.ToCStr().Get(), targetId.ToCStr().Get());
-                continue;
-            }
-            
-            WriteReport("    *** СОВПАДЕНИЕ! ID='%s' == targetId='%s'", 
-                objectId.ToCStr().Get(), targetId.ToCStr().Get());
-            
-            // Нашли объект, записываем параметры Text_3...Text_N
-            WriteReport("  *** НАЙДЕН объект для записи: ID='%s'", objectId.ToCStr().Get());
-            WriteReport("  Количество строк для записи: %d", lines.GetSize());
-            for (UIndex li = 0; li < lines.GetSize(); li++) {
-                WriteReport("    lines[%d] = '%s'", li, lines[li].ToCStr().Get());
-            }
-            
-            // Используем ACAPI_LibraryPart_ChangeAParameter для изменения параметров
-            // Это правильный способ изменения параметров размещенного объекта
-            WriteReport("  ========================================");
-            WriteReport("  ИСПОЛЬЗУЕМ ACAPI_LibraryPart_ChangeAParameter");
-            WriteReport("  ========================================");
-            
-            // Открываем параметры размещенного объекта
-            API_ParamOwnerType paramOwner = {};
-            paramOwner.guid = element.header.guid;  // GUID размещенного элемента
-            paramOwner.libInd = 0;                  // 0 для размещенного элемента
-            paramOwner.type = element.header.type;   // Тип элемента
-            
-            err = ACAPI_LibraryPart_OpenParameters(&paramOwner);
-            if (err != NoError) {
-                WriteReport("  ❌ ОШИБКА ACAPI_LibraryPart_OpenParameters: err=%d", err);
-                return false;
-            }
-            
-            WriteReport("  ✅ Параметры открыты успешно");
-            
-            // Получаем список параметров для проверки
-            API_GetParamsType getParamsCheck = {};
-            err = ACAPI_LibraryPart_GetActParameters(&getParamsCheck);
-            if (err != NoError || getParamsCheck.params == nullptr) {
-                WriteReport("  ❌ ОШИБКА получения списка параметров: err=%d", err);
-                ACAPI_LibraryPart_CloseParameters();
-                return false;
-            }
-            
-            Int32 nParams = BMGetHandleSize((GSHandle)getParamsCheck.params) / sizeof(API_AddParType);
-            WriteReport("  Найдено параметров в открытом списке: %d", nParams);
-            
-            // Ищем индексы параметров Text_3...Text_18
-            std::map<int, short> textParamIndices;  // textNum -> index
-            for (Int32 i = 0; i < nParams; i++) {
-                API_AddParType& par = (*getParamsCheck.params)[i];
-                GS::UniString parName(par.name);
-                if (parName.BeginsWith("Text_")) {
-                    GS::UniString numStr = parName.GetSubstring(5, parName.GetLength() - 5);
-                    int textNum = 0;
-                    std::sscanf(numStr.ToCStr().Get(), "%d", &textNum);
-                    if (textNum >= 3 && textNum <= 18) {
-                        textParamIndices[textNum] = par.index;
-                        WriteReport("    Найден параметр %s: index=%d, typeID=%d", 
-                            parName.ToCStr().Get(), par.index, par.typeID);
-                    }
-                }
-            }
-            ACAPI_DisposeAddParHdl(&getParamsCheck.params);
-            
-            if (textParamIndices.empty()) {
-                WriteReport("  ❌ ОШИБКА: не найдено ни одного параметра Text_3...Text_18!");
-                ACAPI_LibraryPart_CloseParameters();
-                return false;
-            }
-            
-            bool success = true;
-            
-            // Записываем строки в Text_3...Text_18 используя индекс
-            for (int lineIdx = 0; lineIdx < maxLines && lineIdx < static_cast<int>(lines.GetSize()); lineIdx++) {
-                int textNum = 3 + lineIdx;  // Text_3, Text_4, ..., Text_18
-                
-                if (textNum > 18) break;  // Не выходим за пределы Text_18
-                
-                // Ищем индекс параметра
-                auto it = textParamIndices.find(textNum);
-                if (it == textParamIndices.end()) {
-                    WriteReport("  ⚠ Параметр Text_%d не найден в списке параметров", textNum);
-                    continue;
-                }
-                
-                short paramIndex = it->second;
-                char paramName[API_NameLen];
-                std::snprintf(paramName, sizeof(paramName), "Text_%d", textNum);
-                
-                GS::UniString lineStr = lines[lineIdx];
-                USize strLen = lineStr.GetLength();
-                
-                WriteReport("  Запись в %s (index=%d): строка='%s' (len=%d)", 
-                    paramName, paramIndex, lineStr.ToCStr().Get(), strLen);
-                
-                // Подготавливаем буфер для строки
-                GS::uchar_t* uStrBuffer = nullptr;
-                if (strLen < API_UAddParStrLen) {
-                    uStrBuffer = (GS::uchar_t*)BMAllocatePtr((API_UAddParStrLen + 1) * sizeof(GS::uchar_t), ALLOCATE_CLEAR, 0);
-                    if (uStrBuffer != nullptr) {
-                        GS::ucscpy(uStrBuffer, lineStr.ToUStr());
-                    }
-                } else {
-                    // Обрезаем если слишком длинная
-                    GS::UniString truncated = lineStr.GetSubstring(0, API_UAddParStrLen - 1);
-                    uStrBuffer = (GS::uchar_t*)BMAllocatePtr((API_UAddParStrLen + 1) * sizeof(GS::uchar_t), ALLOCATE_CLEAR, 0);
-                    if (uStrBuffer != nullptr) {
-                        GS::ucscpy(uStrBuffer, truncated.ToUStr());
-                    }
-                    WriteReport("    ⚠ ВНИМАНИЕ: строка обрезана до %d символов", API_UAddParStrLen - 1);
-                }
-                
-                if (uStrBuffer == nullptr) {
-                    WriteReport("    ❌ ОШИБКА: не удалось выделить память для строки");
-                    success = false;
-                    continue;
-                }
-                
-                // Изменяем параметр через ACAPI_LibraryPart_ChangeAParameter
-                // Используем index вместо name для надежности
-                API_ChangeParamType changeParam = {};
-                changeParam.name[0] = '\0';  // Пустое имя
-                changeParam.index = paramIndex;  // Используем index
-                changeParam.ind1 = 0;
-                changeParam.ind2 = 0;
-                changeParam.uStrValue = uStrBuffer;
-                
-                err = ACAPI_LibraryPart_ChangeAParameter(&changeParam);
-                if (err != NoError) {
-                    WriteReport("    ❌ ОШИБКА ACAPI_LibraryPart_ChangeAParameter для %s (index=%d): err=%d (%s)", 
-                        paramName, paramIndex, err, ErrID_To_Name(err));
-                    success = false;
-                } else {
-                    WriteReport("    ✅ Параметр %s (index=%d) изменен успешно", paramName, paramIndex);
-                }
-                
-                // Освобождаем память
-                BMKillPtr((GSPtr*)&uStrBuffer);
-            }
-            
-            // Очищаем остальные параметры (если lines.GetSize() < maxLines)
-            for (int lineIdx = static_cast<int>(lines.GetSize()); lineIdx < maxLines; lineIdx++) {
-                int textNum = 3 + lineIdx;
-                if (textNum > 18) break;
-                
-                // Ищем индекс параметра
-                auto it = textParamIndices.find(textNum);
-                if (it == textParamIndices.end()) {
-                    continue;  // Параметр не найден, пропускаем
-                }
-                
-                short paramIndex = it->second;
-                char paramName[API_NameLen];
-                std::snprintf(paramName, sizeof(paramName), "Text_%d", textNum);
-                
-                WriteReport("  Очистка %s (index=%d)", paramName, paramIndex);
-                
-                // Выделяем память для пробела
-                GS::uchar_t* uStrBuffer = (GS::uchar_t*)BMAllocatePtr((API_UAddParStrLen + 1) * sizeof(GS::uchar_t), ALLOCATE_CLEAR, 0);
-                if (uStrBuffer != nullptr) {
-                    GS::ucscpy(uStrBuffer, GS::UniString(" ").ToUStr());
-                    
-                    API_ChangeParamType changeParam = {};
-                    changeParam.name[0] = '\0';  // Пустое имя
-                    changeParam.index = paramIndex;  // Используем index
-                    changeParam.ind1 = 0;
-                    changeParam.ind2 = 0;
-                    changeParam.uStrValue = uStrBuffer;
-                    
-                    err = ACAPI_LibraryPart_ChangeAParameter(&changeParam);
-                    if (err != NoError) {
-                        WriteReport("    ❌ ОШИБКА очистки %s (index=%d): err=%d (%s)", 
-                            paramName, paramIndex, err, ErrID_To_Name(err));
-                    } else {
-                        WriteReport("    ✅ Параметр %s (index=%d) очищен", paramName, paramIndex);
-                    }
-                    
-                    BMKillPtr((GSPtr*)&uStrBuffer);
-                }
-            }
-            
-            // Получаем измененные параметры и применяем через ACAPI_Element_Change
-            API_GetParamsType getParams = {};
-            err = ACAPI_LibraryPart_GetActParameters(&getParams);
-            if (err != NoError) {
-                WriteReport("  ❌ ОШИБКА ACAPI_LibraryPart_GetActParameters: err=%d", err);
-                ACAPI_LibraryPart_CloseParameters();
-                return false;
-            }
-            
-            WriteReport("  ✅ Получены измененные параметры");
-            
-            // Закрываем параметры
-            ACAPI_LibraryPart_CloseParameters();
-            
-            // Применяем изменения через ACAPI_Element_Change
-            if (success && getParams.params != nullptr) {
-                WriteReport("  ========================================");
-                WriteReport("  ПРИМЕНЕНИЕ ИЗМЕНЕНИЙ через ACAPI_Element_Change");
-                WriteReport("  ========================================");
-                
-                err = ACAPI_CallUndoableCommand("Change Cassette Parameters", [&]() -> GSErrCode {
-                    API_ElementMemo memo = {};
-                    memo.params = getParams.params;
-                    
-                    API_Element mask = {};
-                    ACAPI_ELEMENT_MASK_CLEAR(mask);
-                    
-                    WriteReport("  Вызов ACAPI_Element_Change...");
-                    WriteReport("    element.header.guid = %s", APIGuidToString(element.header.guid).ToCStr().Get());
-                    
-                    GSErrCode changeErr = ACAPI_Element_Change(&element, &mask, &memo, 
-                        APIMemoMask_AddPars, true);
-                    
-                    // НЕ освобождаем memo.params здесь - они принадлежат getParams
-                    
-                    if (changeErr != NoError) {
-                        WriteReport("  ❌ ОШИБКА ACAPI_Element_Change: err=%d", changeErr);
-                        return changeErr;
-                    }
-                    
-                    WriteReport("  ✅ УСПЕХ: ACAPI_Element_Change завершился успешно!");
-                    return NoError;
-                });
-                
-                if (err != NoError) {
-                    WriteReport("  ❌ ОШИБКА ACAPI_CallUndoableCommand: err=%d", err);
-                    ACAPI_DisposeAddParHdl(&getParams.params);
-                    return false;
-                } else {
-                    WriteReport("  ✅ УСПЕХ: ACAPI_CallUndoableCommand завершился успешно!");
-                }
-                
-                // Освобождаем память параметров
-                ACAPI_DisposeAddParHdl(&getParams.params);
+        std::vector<HostApi::Guid> groupKeys;
+        NumberGroups(keys, groupOf, groupKeys);
+        for (const HostApi::Guid& key : groupKeys) {
+            API_Guid wall;
+            std::memcpy(&wall, key.bytes, sizeof(key.bytes));
+            CalculationGroup group;
+            group.key = wall == APINULLGuid ? GS::UniString() : APIGuidToString(wall);
+            group.label = wall == APINULLGuid ? GS::UniString("Без стены") : GS::UniString("Стена ") + group.key;
+            groups.Push(group);
+        }
+    } else {
+        std::vector<Int32> keys(windows.GetSize());
+        for (UIndex i = 0; i < windows.GetSize(); ++i) {
+            const WindowDoorInfo& w = windows[i];
+            if (groupBy == GroupBy::Storey) {
+                keys[i] = w.storey;
             } else {
-                WriteReport("  ⚠ ВНИМАНИЕ: success=false или getParams.params==nullptr");
-                if (getParams.params != nullptr) {
-                    ACAPI_DisposeAddParHdl(&getParams.params);
-                }
+                keys[i] = w.wall == APINULLGuid ? -1 : OpeningIndex::FacadeOf(w.normal);
             }
-            
-            return success;
         }
-        
-        return false; // Объект не найден
-    };
-    
-    // Разделяем результаты по типам элементов (по ширине)
-    // Тип 0: планки width=285, откосы width=285
-    // Типы 1-2: планки width=160, откосы width=225
-    
-    // Формируем строки для кассет (только для типов 1-2)
-    GS::Array<GS::UniString> cassetteLines;
-    WriteReport("=== Формирование строк для записи ===");
-    WriteReport("  Кассеты: count=%d", result.cassettes.GetSize());
-    for (const CassetteSize& cs : result.cassettes) {
-        GS::UniString line = formatLine3("Размер: U x V : %dx%d мм; Количество: %d шт.", 
-            cs.x, cs.y, cs.count);
-        cassetteLines.Push(line);
-        WriteReport("    Кассета: %s", line.ToCStr().Get());
-    }
-    
-    // Формируем строки для планок - разделяем по типу элемента (из calcType)
-    GS::Array<GS::UniString> plankLines0;   // Для типа 0
-    GS::Array<GS::UniString> plankLines12; // Для типов 1-2
-    WriteReport("  Планки: count=%d", result.planks.GetSize());
-    for (const PlankSize& ps : result.planks) {
-        GS::UniString line;
-        // Определяем тип по calcType: 0 → тип 0, 1 или 2 → типы 1-2
-        if (ps.calcType == 0) {
-            // Тип 0: "Размер: 285×{length} мм; Длина Z = {length} мм; Количество: {count} шт."
-            line = formatLine4("Размер: %dx%d мм; Длина Z = %d мм; Количество: %d шт.",
-                ps.width, ps.length, ps.length, ps.count);
-            plankLines0.Push(line);
-            WriteReport("    Планка (тип 0): width=%d, length=%d, count=%d", ps.width, ps.length, ps.count);
-        } else {
-            // Типы 1-2: "Размер: 160×{length} мм; Длина W = {length} мм; Количество: {count} шт."
-            line = formatLine4("Размер: %dx%d мм; Длина W = %d мм; Количество: %d шт.",
-                ps.width, ps.length, ps.length, ps.count);
-            plankLines12.Push(line);
-            WriteReport("    Планка (тип 1-2): width=%d, length=%d, count=%d", ps.width, ps.length, ps.count);
-        }
-        WriteReport("      -> %s", line.ToCStr().Get());
-    }
-    
-    // Формируем строки для левых откосов - разделяем по типу элемента (из calcType)
-    GS::Array<GS::UniString> leftSlopeLines0;   // Для типа 0
-    GS::Array<GS::UniString> leftSlopeLines12; // Для типов 1-2
-    WriteReport("  Левые откосы: count=%d", result.leftSlopes.GetSize());
-    for (const PlankSize& ps : result.leftSlopes) {
-        GS::UniString line = formatLine4("Размер: %dx%d мм; Длина Z = %d мм; Количество: %d шт.",
-            ps.width, ps.length, ps.length, ps.count);
-        // Определяем тип по calcType: 0 → тип 0, 1 или 2 → типы 1-2
-        if (ps.calcType == 0) {
-            leftSlopeLines0.Push(line);
-            WriteReport("    Левый откос (тип 0): width=%d, length=%d, count=%d", ps.width, ps.length, ps.count);
-        } else {
-            leftSlopeLines12.Push(line);
-            WriteReport("    Левый откос (тип 1-2): width=%d, length=%d, count=%d", ps.width, ps.length, ps.count);
-        }
-        WriteReport("      -> %s", line.ToCStr().Get());
-    }
-    
-    // Формируем строки для правых откосов - разделяем по типу элемента (из calcType)
-    GS::Array<GS::UniString> rightSlopeLines0;   // Для типа 0
-    GS::Array<GS::UniString> rightSlopeLines12; // Для типов 1-2
-    WriteReport("  Правые откосы: count=%d", result.rightSlopes.GetSize());
-    for (const PlankSize& ps : result.rightSlopes) {
-        GS::UniString line = formatLine4("Размер: %dx%d мм; Длина Z = %d мм; Количество: %d шт.",
-            ps.width, ps.length, ps.length, ps.count);
-        // Определяем тип по calcType: 0 → тип 0, 1 или 2 → типы 1-2
-        if (ps.calcType == 0) {
-            rightSlopeLines0.Push(line);
-            WriteReport("    Правый откос (тип 0): width=%d, length=%d, count=%d", ps.width, ps.length, ps.count);
-        } else {
-            rightSlopeLines12.Push(line);
-            WriteReport("    Правый откос (тип 1-2): width=%d, length=%d, count=%d", ps.width, ps.length, ps.count);
+        std::vector<Int32> groupKeys;
+        NumberGroups(keys, groupOf, groupKeys);
+        for (Int32 key : groupKeys) {
+            CalculationGroup group;
+            if (groupBy == GroupBy::Storey) {
+                group.key = GS::UniString::Printf("%d", key);
+                group.label = GS::UniString("Этаж ") + group.key;
+            } else if (key < 0) {
+                group.label = "Без стены";
+            } else {
+                group.key = GS::UniString::Printf("%d", key);
+                group.label = GS::UniString::Printf("Фасад %d°", key * 360 / OpeningIndex::FacadeCount);
+            }
+            groups.Push(group);
         }
-        WriteReport("      -> %s", line.ToCStr().Get());
-    }
-    
-    // Записываем в объекты с соответствующими лимитами
-    bool success = true;
-    
-    // Лимиты для типа 0: 8 параметров (Text_3...Text_10)
-    int maxPlanks0 = 8;
-    int maxSlopes0 = 8;
-    
-    // Лимиты для типов 1-2: 16 для кассет и откосов, 8 для планок
-    int maxCassettes12 = 16;
-    int maxPlanks12 = 8;
-    int maxSlopes12 = 16;
-    
-    WriteReport("=== Запись в объекты ===");
-    WriteReport("  Тип 0: maxPlanks=%d, maxSlopes=%d", maxPlanks0, maxSlopes0);
-    WriteReport("  Типы 1-2: maxCassettes=%d, maxPlanks=%d, maxSlopes=%d", maxCassettes12, maxPlanks12, maxSlopes12);
-    
-    // Записываем результаты для типа 0
-    if (!targets.plankId0.IsEmpty() && plankLines0.GetSize() > 0) {
-        success &= writeToObject(targets.plankId0, plankLines0, maxPlanks0);
-    }
-    if (!targets.leftSlopeId0.IsEmpty() && leftSlopeLines0.GetSize() > 0) {
-        success &= writeToObject(targets.leftSlopeId0, leftSlopeLines0, maxSlopes0);
-    }
-    if (!targets.rightSlopeId0.IsEmpty() && rightSlopeLines0.GetSize() > 0) {
-        success &= writeToObject(targets.rightSlopeId0, rightSlopeLines0, maxSlopes0);
     }
-    
-    // Записываем результаты для типов 1-2
-    if (!targets.cassetteId12.IsEmpty() && cassetteLines.GetSize() > 0) {
-        success &= writeToObject(targets.cassetteId12, cassetteLines, maxCassettes12);
-    }
-    if (!targets.plankId12.IsEmpty() && plankLines12.GetSize() > 0) {
-        success &= writeToObject(targets.plankId12, plankLines12, maxPlanks12);
+
+    // Один проход по окнам: общий результат и результаты групп
+    CassetteCore::WindowBatch batch;
+    ToWindowBatch(windows, batch);
+
+    CassetteCore::Result core;
+    std::vector<CassetteCore::Result> groupCores;
+    CassetteCore::CalculateGrouped(batch, groupOf, groups.GetSize(), ToCoreParams(params), core, groupCores);
+
+    std::vector<UInt32> windowCounts(groups.GetSize(), 0);
+    for (uint32_t group : groupOf) {
+        ++windowCounts[group];
     }
-    if (!targets.leftSlopeId12.IsEmpty() && leftSlopeLines12.GetSize() > 0) {
-        success &= writeToObject(targets.leftSlopeId12, leftSlopeLines12, maxSlopes12);
+    for (UIndex g = 0; g < groups.GetSize(); ++g) {
+        groups[g].windowCount = windowCounts[g];
+        groups[g].result = FromCoreResult(groupCores[g]);
     }
-    if (!targets.rightSlopeId12.IsEmpty() && rightSlopeLines12.GetSize() > 0) {
-        success &= writeToObject(targets.rightSlopeId12, rightSlopeLines12, maxSlopes12);
+
+    CalculationResult result = FromCoreResult(core);
+    result.duplicateIds = FindDuplicateIds(windows);
+    return result;
+}
+
+// =============================================================================
+// PlaceFacadeObjects - разместить детали у проёмов
+// =============================================================================
+
+bool PlaceFacadeObjects(
+    const GS::Array<WindowDoorInfo>& windows,
+    const CalcParams& params,
+    const PlacementParts& parts,
+    UInt32& pieces,
+    UInt32& created)
+{
+    std::vector<FacadePlacement::Opening> openings;
+    openings.reserve(windows.GetSize());
+    for (const WindowDoorInfo& w : windows) {
+        FacadePlacement::Opening opening;
+        opening.x = w.x;
+        opening.y = w.y;
+        opening.angle = w.angle;
+        opening.width = w.width;
+        opening.height = w.height;
+        opening.sillHeight = w.sillHeight;
+        opening.storey = w.storey;
+        opening.calcType = w.calcType;
+        openings.push_back(opening);
     }
-    
+
+    FacadePlacement::Layout layout;
+    FacadePlacement::Generate(openings, ToCoreParams(params), layout);
+    pieces = static_cast<UInt32>(layout.Size());
+
+    HostWorkload::LibParts hostParts;
+    hostParts.cassette = FileIO::ToUtf8(parts.cassette);
+    hostParts.plank = FileIO::ToUtf8(parts.plank);
+    hostParts.slope = FileIO::ToUtf8(parts.slope);
+    hostParts.textParam = FileIO::ToUtf8(parts.textParam);
+
+    // Поиск библиотечных элементов и создание - в HostWorkload
+    HostApi::Host& host = AcHost::Get();
+    if (HostTrace::Recorder* recorder = AcHost::GetRecorder()) {
+        recorder->BeginPlaceObjects(layout, hostParts);
+    }
+    size_t placed = 0;
+    const bool success = HostWorkload::PlaceObjects(host, layout, hostParts, placed);
+    created = static_cast<UInt32>(placed);
     return success;
 }
 
+// =============================================================================
+// WriteToTargetObjects - записать результаты в GDL объекты
+// =============================================================================
+
+bool WriteToTargetObjects(
+    const CalculationResult& result,
+    const TargetObjects& targets,
+    const CalcParams& params)
+{
+    HostWorkload::Targets hostTargets;
+    hostTargets.plankId0 = FileIO::ToUtf8(targets.plankId0);
+    hostTargets.leftSlopeId0 = FileIO::ToUtf8(targets.leftSlopeId0);
+    hostTargets.rightSlopeId0 = FileIO::ToUtf8(targets.rightSlopeId0);
+    hostTargets.cassetteId12 = FileIO::ToUtf8(targets.cassetteId12);
+    hostTargets.plankId12 = FileIO::ToUtf8(targets.plankId12);
+    hostTargets.leftSlopeId12 = FileIO::ToUtf8(targets.leftSlopeId12);
+    hostTargets.rightSlopeId12 = FileIO::ToUtf8(targets.rightSlopeId12);
+    hostTargets.overflowPages = targets.overflowPages;
+
+    const CassetteCore::Result core = ToCoreResult(result);
+
+    // Поиск объектов и запись Text_3...Text_N - в HostWorkload
+    HostApi::Host& host = AcHost::Get();
+    if (HostTrace::Recorder* recorder = AcHost::GetRecorder()) {
+        recorder->BeginWriteTargets(core, hostTargets);
+    }
+    return HostWorkload::WriteTargets(host, core, hostTargets);
+}
+
 } // namespace CassetteHelper
@@ -7,6 +7,8 @@
 
 #include "APIEnvir.h"
 #include "ACAPinc.h"
+#include "CassetteCore.hpp"
+#include "IdPool.hpp"
 
 namespace CassetteHelper {
 
@@ -22,6 +24,12 @@ enum class CalcType {
     Type1And2 = 3   // Типы 1 и 2 вместе
 };
 
+// Вид элемента
+enum class ElemType {
+    Window = 0,
+    Door = 1
+};
+
 // =============================================================================
 // Структуры данных
 // =============================================================================
@@ -29,14 +37,17 @@ enum class CalcType {
 // Информация об окне/двери
 struct WindowDoorInfo {
     API_Guid guid;           // Уникальный GUID элемента
-    GS::UniString id;        // ID (может повторяться!)
-    GS::UniString elemType;  // "Window" / "Door"
-    double width;            // Ширина (B) в метрах
-    double height;           // Высота (C) в метрах
-    double sillHeight;       // Высота подоконника (D) в метрах
-    double x;                // Координата X
-    double y;                // Координата Y
-    double angle;            // Угол
+    IdPool::Handle id;       // ID в пуле IdPool (может повторяться!)
+    ElemType elemType;       // Окно / дверь
+    Mm::Length width;        // Ширина (B) в мм
+    Mm::Length height;       // Высота (C) в мм
+    Mm::Length sillHeight;   // Высота подоконника (D) в мм
+    double x;                // Точка проёма на линии привязки стены, м
+    double y;
+    double angle;            // Направление стены в точке проёма, рад
+    double normal;           // Наружная нормаль стены в точке проёма, рад (фасад)
+    API_Guid wall;           // Стена проёма (APINULLGuid - не известна)
+    Int32 storey;            // Индекс этажа (header.floorInd)
     int calcType;            // 0, 1 или 2 (определяется из ID)
 };
 
@@ -82,6 +93,8 @@ struct TargetObjects {
     GS::UniString plankId12;     // OK-1_2_PLNK
     GS::UniString leftSlopeId12; // OK-1_2_LOTK
     GS::UniString rightSlopeId12; // OK-1_2_ROTK
+    // Строки сверх лимита объекта - в OK-1_2_CASS#2, #3, ... (одна отмена)
+    bool overflowPages;
 };
 
 // Результат расчёта
@@ -99,6 +112,10 @@ struct CalculationResult {
 // Функции
 // =============================================================================
 
+// Имя вида для JS и выгрузок ("Window" / "Door") и обратно (иначе Window)
+const char* GetElemTypeName(ElemType type);
+ElemType ElemTypeFromString(const GS::UniString& name);
+
 // Получить выделенные окна и двери
 // Фильтрует по ID: ОК-0, ОК-1, ОК-2, ДВ-0, ДВ-1, ДВ-2
 GS::Array<WindowDoorInfo> GetSelectedWindowsDoors();
@@ -108,12 +125,46 @@ GS::Array<WindowDoorInfo> GetSelectedWindowsDoors();
 // Возвращает высоту в метрах, или 0 если не найдено
 double GetFloorHeightFromWall(const GS::UniString& wallIdPattern);
 
-// Выполнить расчёт кассет, планок и откосов
+// Выполнить расчёт кассет, планок и откосов (через CassetteCore)
 CalculationResult Calculate(
     const GS::Array<WindowDoorInfo>& windows,
     const CalcParams& params
 );
 
+// Разбивка расчёта на группы окон
+enum class GroupBy {
+    None = 0,
+    Facade,                  // Фасад - сектор наружной нормали стены (OpeningIndex::FacadeOf)
+    Wall,                    // Стена проёма
+    Storey                   // Этаж
+};
+
+// Разобрать разбивку из строки JS ("facade", "wall", "storey"; иначе None)
+GroupBy GroupByFromString(const GS::UniString& key);
+
+// Результат одной группы
+struct CalculationGroup {
+    GS::UniString key;       // Номер фасада/этажа или GUID стены; "" - стена не известна
+    GS::UniString label;     // Подпись для палитры
+    UInt32 windowCount;
+    CalculationResult result;
+};
+
+// Расчёт с разбивкой за один проход: возвращает общий результат (как
+// Calculate), строки групп - в groups (по возрастанию ключа)
+CalculationResult CalculateGrouped(
+    const GS::Array<WindowDoorInfo>& windows,
+    const CalcParams& params,
+    GroupBy groupBy,
+    GS::Array<CalculationGroup>& groups
+);
+
+// Преобразования для CassetteCore
+CassetteCore::Params ToCoreParams(const CalcParams& params);
+void ToWindowBatch(const GS::Array<WindowDoorInfo>& windows, CassetteCore::WindowBatch& batch);
+CalculationResult FromCoreResult(const CassetteCore::Result& core);
+CassetteCore::Result ToCoreResult(const CalculationResult& result);
+
 // Записать результаты в GDL объекты
 // Ищет объекты по ID в выделении и записывает в параметры Text_3...Text_N
 bool WriteToTargetObjects(
@@ -122,12 +173,41 @@ bool WriteToTargetObjects(
     const CalcParams& params
 );
 
-// Определить тип расчёта из ID элемента (ОК-0 → 0, ОК-1 → 1, ОК-2 → 2)
-int GetCalcTypeFromId(const GS::UniString& id);
+// Библиотечные элементы для размещения деталей (имя в библиотеке; пусто - не размещать)
+struct PlacementParts {
+    GS::UniString cassette;
+    GS::UniString plank;
+    GS::UniString slope;
+    GS::UniString textParam;     // Строковый параметр для маркировки (размеры в мм)
+};
+
+// Разместить по объекту на каждую кассету, планку и откос у своего проёма
+// (FacadePlacement) одной командой отмены. pieces - деталей, created - создано.
+bool PlaceFacadeObjects(
+    const GS::Array<WindowDoorInfo>& windows,
+    const CalcParams& params,
+    const PlacementParts& parts,
+    UInt32& pieces,
+    UInt32& created
+);
+
+// Элементы с одинаковым ID
+struct DuplicateGroup {
+    IdPool::Handle id;
+    GS::Array<UIndex> indices;      // Индексы в списке окон, по возрастанию
+    GS::Array<API_Guid> guids;      // GUID тех же элементов
+};
 
-// Проверить есть ли дубликаты ID в списке окон
+// Группы повторяющихся ID (по алфавиту ID): один проход по хеш-таблице
+// дескрипторов пула, без сравнения строк
+GS::Array<DuplicateGroup> FindDuplicateGroups(const GS::Array<WindowDoorInfo>& windows);
+
+// Проверить есть ли дубликаты ID в списке окон (ID групп FindDuplicateGroups)
 GS::Array<GS::UniString> FindDuplicateIds(const GS::Array<WindowDoorInfo>& windows);
 
+// Выделить элементы в модели вместо текущего выделения
+bool SelectElements(const GS::Array<API_Guid>& guids);
+
 // Получить параметры по умолчанию для типа расчёта
 CalcParams GetDefaultParams(CalcType type);
 
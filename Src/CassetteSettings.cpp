@@ -4,6 +4,9 @@
 
 #include "CassetteSettings.hpp"
 #include "ACAPinc.h"
+#include "FileIO.hpp"
+#include "IdClassifier.hpp"
+#include "TypeRegistry.hpp"
 
 #include <Windows.h>
 #include <ShlObj.h>
@@ -172,6 +175,8 @@ Settings GetDefaultSettings()
     s.defaultType = 0;
     s.wallIdForFloorHeight = "СН-МД1";
     s.showDuplicateWarning = true;
+    s.idTypeCodes = "0=0,1=1,2=2";
+    s.idPrefixes = "ОК-,ДВ-";
     
     // Тип 0
     s.type0.plankWidth = 285;
@@ -255,6 +260,15 @@ bool LoadSettings(Settings& settings)
     settings.defaultType = getInt(L"defaultType", 0);
     settings.wallIdForFloorHeight = getString(L"wallIdForFloorHeight", "СН-МД1");
     settings.showDuplicateWarning = getInt(L"showDuplicateWarning", 1) != 0;
+    settings.idTypeCodes = getString(L"idTypeCodes", settings.idTypeCodes);
+    settings.idPrefixes = getString(L"idPrefixes", settings.idPrefixes);
+
+    // Определения типов: все ключи type.*
+    for (const auto& pair : values) {
+        if (pair.first.compare(0, 5, L"type.") == 0) {
+            settings.typeDefinitions[pair.first] = pair.second;
+        }
+    }
     
     // Тип 0
     settings.type0.plankWidth = getInt(L"type0.plankWidth", 285);
@@ -309,6 +323,11 @@ bool SaveSettings(const Settings& settings)
     WriteCsvLine(file, L"defaultType", settings.defaultType);
     WriteCsvLine(file, L"wallIdForFloorHeight", settings.wallIdForFloorHeight.ToUStr().Get());
     WriteCsvLine(file, L"showDuplicateWarning", settings.showDuplicateWarning ? 1 : 0);
+    WriteCsvLine(file, L"idTypeCodes", settings.idTypeCodes.ToUStr().Get());
+    WriteCsvLine(file, L"idPrefixes", settings.idPrefixes.ToUStr().Get());
+    for (const auto& pair : settings.typeDefinitions) {
+        WriteCsvLine(file, pair.first, pair.second);
+    }
     
     // Тип 0
     WriteCsvLine(file, L"type0.plankWidth", settings.type0.plankWidth);
@@ -336,6 +355,40 @@ bool SaveSettings(const Settings& settings)
     return true;
 }
 
+// =============================================================================
+// ApplyIdTypes
+// =============================================================================
+
+bool ApplyIdTypes(const Settings& settings)
+{
+    IdClassifier::Table table;
+    if (!table.ParseCodes(FileIO::ToUtf8(settings.idTypeCodes)) ||
+        !table.ParsePrefixes(FileIO::ToUtf8(settings.idPrefixes))) {
+        return false;
+    }
+    IdClassifier::SetTable(table);
+    return true;
+}
+
+// =============================================================================
+// ApplyTypeDefinitions
+// =============================================================================
+
+bool ApplyTypeDefinitions(const Settings& settings, GS::UniString& error)
+{
+    TypeRegistry::Registry registry = TypeRegistry::Registry::Standard();
+    for (const auto& pair : settings.typeDefinitions) {
+        std::string message;
+        const std::string key = FileIO::ToUtf8(GS::UniString(pair.first.c_str() + 5));
+        if (!registry.SetType(key, FileIO::ToUtf8(GS::UniString(pair.second.c_str())), message)) {
+            error = GS::UniString(message.c_str(), CC_UTF8);
+            return false;
+        }
+    }
+    TypeRegistry::SetRegistry(registry);
+    return true;
+}
+
 // =============================================================================
 // Конвертации
 // =============================================================================
@@ -376,6 +429,7 @@ CassetteHelper::TargetObjects ToTargetObjects(const Settings& settings, Cassette
     targets.plankId12 = settings.type1_2.plankId;
     targets.leftSlopeId12 = settings.type1_2.leftSlopeId;
     targets.rightSlopeId12 = settings.type1_2.rightSlopeId;
+    targets.overflowPages = false;
     
     return targets;
 }
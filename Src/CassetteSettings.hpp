@@ -8,6 +8,9 @@
 #include "CassetteHelper.hpp"
 #include "GSRoot.hpp"
 
+#include <map>
+#include <string>
+
 namespace CassetteSettings {
 
 // Структура настроек для одного типа
@@ -30,6 +33,10 @@ struct Settings {
     int defaultType;                    // Тип по умолчанию (0, 1, 2)
     GS::UniString wallIdForFloorHeight; // ID стены для получения высоты этажа
     bool showDuplicateWarning;          // Показывать предупреждение о дубликатах
+    GS::UniString idTypeCodes;          // Коды типа в ID: "0=0,1=1,2=2" (IdClassifier)
+    GS::UniString idPrefixes;           // Префиксы ID с кодом типа: "ОК-,ДВ-"
+    std::map<std::wstring, std::wstring> typeDefinitions;  // type.N / type.other -> определение типа
+                                                            // (TypeRegistry); нет ключа - стандартный тип
     
     TypeSettings type0;                 // Настройки для типа 0
     TypeSettings type1_2;               // Настройки для типов 1 и 2
@@ -48,6 +55,15 @@ bool SaveSettings(const Settings& settings);
 // Получить путь к файлу настроек
 GS::UniString GetSettingsFilePath();
 
+// Применить коды типов ID к определению типа окон (IdClassifier).
+// false - строка кодов или префиксов неверна, прежние правила остаются.
+bool ApplyIdTypes(const Settings& settings);
+
+// Применить определения типов к реестру типов (TypeRegistry): стандартные
+// типы, заменённые ключами type.N из настроек. false - ошибка в определении
+// (текст в error), прежний реестр остаётся.
+bool ApplyTypeDefinitions(const Settings& settings, GS::UniString& error);
+
 // Конвертация настроек в CalcParams
 CassetteHelper::CalcParams ToCalcParams(const Settings& settings, CassetteHelper::CalcType type);
 
@@ -0,0 +1,305 @@
+// =============================================================================
+// CassetteSnapshot - Двоичный снимок окон/дверей (.cassnap)
+// =============================================================================
+
+#include "CassetteSnapshot.hpp"
+
+#include <cstring>
+
+namespace CassetteSnapshot {
+
+// =============================================================================
+// Формат файла
+// =============================================================================
+
+static const char Magic[8] = { 'C', 'A', 'S', 'S', 'N', 'A', 'P', 0 };
+static const uint32_t ByteOrderMark = 0x01020304;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;        // sizeof(FileHeader)
+    uint32_t byteOrder;         // ByteOrderMark: другой порядок байт не поддерживается
+    uint32_t blockCount;
+    uint64_t windowCount;
+    double floorHeight;
+    uint64_t reserved[3];
+};
+
+struct BlockEntry {
+    uint32_t column;            // Column
+    uint32_t elementSize;       // Байт на окно (0 - блок переменной длины)
+    uint64_t offset;            // От начала файла, кратно 8
+    uint64_t size;              // Байт
+};
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader layout");
+static_assert(sizeof(BlockEntry) == 24, "BlockEntry layout");
+
+static size_t Align8(size_t value)
+{
+    return (value + 7) & ~static_cast<size_t>(7);
+}
+
+// =============================================================================
+// Builder
+// =============================================================================
+
+Builder::Builder() :
+    floorHeight(0.0)
+{
+}
+
+void Builder::Reserve(size_t count)
+{
+    guids.reserve(count * 16);
+    idIndex.reserve(count);
+    width.reserve(count);
+    height.reserve(count);
+    sill.reserve(count);
+    storey.reserve(count);
+    calcType.reserve(count);
+    x.reserve(count);
+    y.reserve(count);
+    angle.reserve(count);
+    normal.reserve(count);
+}
+
+void Builder::Add(const uint8_t guid[16], std::string_view id,
+                  double w, double h, double s,
+                  int32_t storeyIndex, int type,
+                  double px, double py, double a, double n)
+{
+    guids.insert(guids.end(), guid, guid + 16);
+
+    auto it = idLookup.find(std::string(id));
+    if (it == idLookup.end()) {
+        it = idLookup.emplace(std::string(id), static_cast<uint32_t>(ids.size())).first;
+        ids.push_back(&it->first);
+    }
+    idIndex.push_back(it->second);
+
+    width.push_back(w);
+    height.push_back(h);
+    sill.push_back(s);
+    storey.push_back(storeyIndex);
+    calcType.push_back(static_cast<int8_t>(type));
+    x.push_back(px);
+    y.push_back(py);
+    angle.push_back(a);
+    normal.push_back(n);
+}
+
+void Builder::Serialize(std::string& out) const
+{
+    struct Block {
+        Column column;
+        uint32_t elementSize;
+        const void* data;
+        size_t size;
+    };
+
+    // Таблица строк ID: count, offsets[count + 1], байты
+    std::string idTable;
+    const uint32_t idCount = static_cast<uint32_t>(ids.size());
+    idTable.append(reinterpret_cast<const char*>(&idCount), sizeof(idCount));
+    uint32_t offset = 0;
+    for (const std::string* id : ids) {
+        idTable.append(reinterpret_cast<const char*>(&offset), sizeof(offset));
+        offset += static_cast<uint32_t>(id->size());
+    }
+    idTable.append(reinterpret_cast<const char*>(&offset), sizeof(offset));
+    for (const std::string* id : ids) {
+        idTable += *id;
+    }
+
+    const size_t n = width.size();
+    const Block blocks[] = {
+        { Column::Guid,      16, guids.data(),    guids.size() },
+        { Column::IdIndex,   4,  idIndex.data(),  n * 4 },
+        { Column::Width,     8,  width.data(),    n * 8 },
+        { Column::Height,    8,  height.data(),   n * 8 },
+        { Column::Sill,      8,  sill.data(),     n * 8 },
+        { Column::Storey,    4,  storey.data(),   n * 4 },
+        { Column::CalcType,  1,  calcType.data(), n },
+        { Column::X,         8,  x.data(),        n * 8 },
+        { Column::Y,         8,  y.data(),        n * 8 },
+        { Column::Angle,     8,  angle.data(),    n * 8 },
+        { Column::Normal,    8,  normal.data(),   n * 8 },
+        { Column::IdStrings, 0,  idTable.data(),  idTable.size() }
+    };
+    const uint32_t blockCount = static_cast<uint32_t>(sizeof(blocks) / sizeof(blocks[0]));
+
+    FileHeader header = {};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.headerSize = sizeof(FileHeader);
+    header.byteOrder = ByteOrderMark;
+    header.blockCount = blockCount;
+    header.windowCount = n;
+    header.floorHeight = floorHeight;
+
+    std::vector<BlockEntry> entries(blockCount);
+    size_t position = Align8(sizeof(FileHeader) + blockCount * sizeof(BlockEntry));
+    for (uint32_t i = 0; i < blockCount; ++i) {
+        entries[i].column = static_cast<uint32_t>(blocks[i].column);
+        entries[i].elementSize = blocks[i].elementSize;
+        entries[i].offset = position;
+        entries[i].size = blocks[i].size;
+        position = Align8(position + blocks[i].size);
+    }
+
+    out.clear();
+    out.reserve(position);
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.append(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(BlockEntry));
+    for (uint32_t i = 0; i < blockCount; ++i) {
+        out.resize(static_cast<size_t>(entries[i].offset), '\0');
+        out.append(static_cast<const char*>(blocks[i].data), blocks[i].size);
+    }
+    out.resize(position, '\0');
+}
+
+// =============================================================================
+// View
+// =============================================================================
+
+View::View() :
+    count(0),
+    floorHeight(0.0),
+    guids(nullptr),
+    idIndex(nullptr),
+    width(nullptr),
+    height(nullptr),
+    sill(nullptr),
+    storey(nullptr),
+    calcType(nullptr),
+    x(nullptr),
+    y(nullptr),
+    angle(nullptr),
+    normal(nullptr),
+    idCount(0),
+    idOffsets(nullptr),
+    idBytes(nullptr)
+{
+}
+
+bool View::Open(const char* data, size_t size, std::string& error)
+{
+    *this = View();
+
+    if (reinterpret_cast<uintptr_t>(data) % 8 != 0) {
+        error = "Снимок в памяти не выровнен";
+        return false;
+    }
+    if (size < sizeof(FileHeader) || std::memcmp(data, Magic, sizeof(Magic)) != 0) {
+        error = "Файл не является снимком окон (.cassnap)";
+        return false;
+    }
+
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(data);
+    if (header->byteOrder != ByteOrderMark) {
+        error = "Снимок записан с другим порядком байт";
+        return false;
+    }
+    if (header->version == 0 || header->version > Version) {
+        error = "Версия снимка " + std::to_string(header->version) + " не поддерживается";
+        return false;
+    }
+    // Таблица блоков читается на месте - её начало должно быть выровнено на 8
+    if (header->headerSize < sizeof(FileHeader) || header->headerSize % 8 != 0 ||
+        header->headerSize + static_cast<uint64_t>(header->blockCount) * sizeof(BlockEntry) > size) {
+        error = "Снимок повреждён (заголовок)";
+        return false;
+    }
+
+    count = static_cast<size_t>(header->windowCount);
+    floorHeight = header->floorHeight;
+
+    const BlockEntry* entries = reinterpret_cast<const BlockEntry*>(data + header->headerSize);
+    const char* idTable = nullptr;
+    uint64_t idTableSize = 0;
+    for (uint32_t i = 0; i < header->blockCount; ++i) {
+        const BlockEntry& entry = entries[i];
+        if (entry.offset % 8 != 0 || entry.offset > size || entry.size > size - entry.offset) {
+            error = "Снимок повреждён (блок " + std::to_string(entry.column) + ")";
+            return false;
+        }
+        const char* block = data + entry.offset;
+
+        // Колонка: размер элемента и длина должны совпадать с числом окон
+        auto column = [&entry, this](uint32_t elementSize) -> bool {
+            return entry.elementSize == elementSize && entry.size == static_cast<uint64_t>(elementSize) * count;
+        };
+
+        bool valid = true;
+        switch (static_cast<Column>(entry.column)) {
+            case Column::Guid:      valid = column(16); guids = reinterpret_cast<const uint8_t*>(block); break;
+            case Column::IdIndex:   valid = column(4);  idIndex = reinterpret_cast<const uint32_t*>(block); break;
+            case Column::Width:     valid = column(8);  width = reinterpret_cast<const double*>(block); break;
+            case Column::Height:    valid = column(8);  height = reinterpret_cast<const double*>(block); break;
+            case Column::Sill:      valid = column(8);  sill = reinterpret_cast<const double*>(block); break;
+            case Column::Storey:    valid = column(4);  storey = reinterpret_cast<const int32_t*>(block); break;
+            case Column::CalcType:  valid = column(1);  calcType = reinterpret_cast<const int8_t*>(block); break;
+            case Column::X:         valid = column(8);  x = reinterpret_cast<const double*>(block); break;
+            case Column::Y:         valid = column(8);  y = reinterpret_cast<const double*>(block); break;
+            case Column::Angle:     valid = column(8);  angle = reinterpret_cast<const double*>(block); break;
+            case Column::Normal:    valid = column(8);  normal = reinterpret_cast<const double*>(block); break;
+            case Column::IdStrings: idTable = block; idTableSize = entry.size; break;
+            default:                break;      // Колонка более новой версии
+        }
+        if (!valid) {
+            error = "Снимок повреждён (размер колонки " + std::to_string(entry.column) + ")";
+            return false;
+        }
+    }
+
+    if (guids == nullptr || idIndex == nullptr || width == nullptr || height == nullptr ||
+        sill == nullptr || calcType == nullptr || idTable == nullptr) {
+        error = "В снимке нет обязательных колонок";
+        return false;
+    }
+
+    // Таблица строк: смещения не убывают и не выходят за блок; номера ID в пределах таблицы
+    std::memcpy(&idCount, idTable, idTableSize >= 4 ? 4 : 0);
+    const uint64_t offsetsSize = (static_cast<uint64_t>(idCount) + 1) * 4;
+    if (idTableSize < 4 + offsetsSize) {
+        error = "Снимок повреждён (строки ID)";
+        return false;
+    }
+    idOffsets = reinterpret_cast<const uint32_t*>(idTable + 4);
+    idBytes = idTable + 4 + offsetsSize;
+    const uint64_t bytesSize = idTableSize - 4 - offsetsSize;
+    for (uint32_t i = 0; i < idCount; ++i) {
+        if (idOffsets[i] > idOffsets[i + 1] || idOffsets[i + 1] > bytesSize) {
+            error = "Снимок повреждён (строки ID)";
+            return false;
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (idIndex[i] >= idCount) {
+            error = "Снимок повреждён (номер ID)";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::string_view View::Id(size_t index) const
+{
+    const uint32_t id = idIndex[index];
+    return std::string_view(idBytes + idOffsets[id], idOffsets[id + 1] - idOffsets[id]);
+}
+
+void View::ToWindowBatch(CassetteCore::WindowBatch& batch) const
+{
+    // В файле - метры, в пакете - мм
+    batch.Clear();
+    batch.Reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        batch.Add(Mm::FromMetres(width[i]), Mm::FromMetres(height[i]), Mm::FromMetres(sill[i]), calcType[i]);
+    }
+}
+
+} // namespace CassetteSnapshot
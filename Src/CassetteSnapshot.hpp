@@ -0,0 +1,146 @@
+#ifndef CASSETTESNAPSHOT_HPP
+#define CASSETTESNAPSHOT_HPP
+
+// =============================================================================
+// CassetteSnapshot - Двоичный снимок окон/дверей (.cassnap)
+// =============================================================================
+// Файл состоит из заголовка, каталога блоков и блоков-колонок:
+//   FileHeader (64 байта)
+//   BlockEntry[blockCount] (по 24 байта)
+//   блоки, каждый с границы 8 байт
+// Колонка - массив значений одного поля для всех окон (GUID, номер ID,
+// ширина, высота, подоконник, этаж, тип, X, Y, угол, нормаль). Строки ID хранятся
+// один раз в блоке IdStrings: число строк, смещения (count + 1) и байты UTF-8.
+// Все числа little-endian.
+//
+// View читает отображённый файл без разбора: колонки - указатели прямо в
+// данные. Неизвестные блоки пропускаются, поэтому новые колонки можно
+// добавлять без смены версии; версия меняется, если меняется смысл старых.
+// Модуль не зависит от Archicad API (только стандартная библиотека).
+
+#include "CassetteCore.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace CassetteSnapshot {
+
+const uint32_t Version = 1;
+
+enum class Column : uint32_t {
+    Guid = 1,           // 16 байт на окно
+    IdIndex = 2,        // uint32 - номер строки в IdStrings
+    Width = 3,          // double, м
+    Height = 4,         // double, м
+    Sill = 5,           // double, м
+    Storey = 6,         // int32 - индекс этажа
+    CalcType = 7,       // int8 - 0, 1, 2 или -1
+    X = 8,              // double
+    Y = 9,              // double
+    Angle = 10,         // double - направление стены
+    IdStrings = 11,     // Таблица строк ID
+    Normal = 12         // double - наружная нормаль стены (фасад)
+};
+
+// =============================================================================
+// Builder - сбор снимка в памяти
+// =============================================================================
+
+class Builder {
+public:
+    Builder();
+
+    void Reserve(size_t count);
+
+    // guid - 16 байт, id - UTF-8. Одинаковые ID хранятся один раз.
+    void Add(const uint8_t guid[16], std::string_view id,
+             double width, double height, double sill,
+             int32_t storey, int calcType,
+             double x, double y, double angle, double normal);
+
+    // Высота этажа на момент снимка (для повтора расчёта)
+    void SetFloorHeight(double height) { floorHeight = height; }
+
+    size_t Size() const { return width.size(); }
+    size_t GetIdCount() const { return ids.size(); }
+
+    // Записать файл целиком в out
+    void Serialize(std::string& out) const;
+
+private:
+    double floorHeight;
+    std::vector<uint8_t> guids;
+    std::vector<uint32_t> idIndex;
+    std::vector<double> width;
+    std::vector<double> height;
+    std::vector<double> sill;
+    std::vector<int32_t> storey;
+    std::vector<int8_t> calcType;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> angle;
+    std::vector<double> normal;
+
+    std::unordered_map<std::string, uint32_t> idLookup;
+    std::vector<const std::string*> ids;    // По номеру (ключи idLookup)
+};
+
+// =============================================================================
+// View - чтение без копирования
+// =============================================================================
+
+class View {
+public:
+    View();
+
+    // data должна быть выровнена на 8 байт (отображение файла или std::string)
+    // и жить, пока используется View
+    bool Open(const char* data, size_t size, std::string& error);
+
+    size_t Size() const { return count; }
+    double GetFloorHeight() const { return floorHeight; }
+
+    const uint8_t* Guid(size_t index) const { return guids + index * 16; }
+    std::string_view Id(size_t index) const;
+
+    const double* Width() const { return width; }
+    const double* Height() const { return height; }
+    const double* Sill() const { return sill; }
+    const int8_t* CalcType() const { return calcType; }
+
+    // Необязательные колонки: при отсутствии - 0
+    int32_t Storey(size_t index) const { return storey != nullptr ? storey[index] : 0; }
+    double X(size_t index) const { return x != nullptr ? x[index] : 0.0; }
+    double Y(size_t index) const { return y != nullptr ? y[index] : 0.0; }
+    double Angle(size_t index) const { return angle != nullptr ? angle[index] : 0.0; }
+    double Normal(size_t index) const { return normal != nullptr ? normal[index] : 0.0; }
+
+    // Окна для CassetteCore (копирование колонок, без разбора)
+    void ToWindowBatch(CassetteCore::WindowBatch& batch) const;
+
+private:
+    size_t count;
+    double floorHeight;
+    const uint8_t* guids;
+    const uint32_t* idIndex;
+    const double* width;
+    const double* height;
+    const double* sill;
+    const int32_t* storey;
+    const int8_t* calcType;
+    const double* x;
+    const double* y;
+    const double* angle;
+    const double* normal;
+    uint32_t idCount;
+    const uint32_t* idOffsets;
+    const char* idBytes;
+};
+
+} // namespace CassetteSnapshot
+
+#endif // CASSETTESNAPSHOT_HPP
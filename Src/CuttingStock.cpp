@@ -0,0 +1,488 @@
+// =============================================================================
+// CuttingStock - Раскрой планок и откосов из хлыстов (одномерный раскрой)
+// =============================================================================
+
+#include "CuttingStock.hpp"
+#include "MultiStart.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <random>
+#include <thread>
+
+namespace CuttingStock {
+
+// Пределы поиска на профиль: 512 попыток (дальше улучшения редки, а время
+// растёт линейно), поиск прекращается после 96 попыток подряд без улучшения
+static const MultiStart::Limits SearchLimits = { 512, 96 };
+
+Params GetDefaultParams()
+{
+    Params p;
+    p.stockLengths = { 6000 };
+    p.kerf = 3;
+    p.trim = 0;
+    p.threads = 0;
+    p.timeLimitMs = 800;
+    return p;
+}
+
+// =============================================================================
+// Решение для одного профиля
+// =============================================================================
+// Длины деталей считаются вместе с резом (length + kerf), вместимость
+// хлыста - stock - trim + kerf: последнему резу не нужна ширина реза.
+
+struct Bin {
+    int free;                   // Свободная вместимость
+    std::vector<int> items;     // Длины деталей с резом
+};
+
+struct Solution {
+    std::vector<Bin> bins;
+    int64_t stockTotal;         // Суммарная длина хлыстов после подбора длин
+    size_t patternCount;        // Различных вариантов раскроя (меньше - меньше переналадок)
+    uint64_t start;             // Номер попытки (для воспроизводимого выбора)
+};
+
+struct Problem {
+    std::vector<int> items;         // Все детали с резом, по убыванию
+    std::vector<int> stocks;        // Длины хлыстов по возрастанию
+    std::vector<int> capacities;    // Вместимость хлыстов stocks
+    int capacity;                   // Вместимость самого длинного хлыста
+    int64_t lowerBoundCost;         // Граница суммарной длины (только при одной длине хлыста)
+};
+
+// Подобрать самый короткий хлыст для заполнения used
+static int StockFor(const Problem& problem, int used)
+{
+    for (size_t i = 0; i < problem.capacities.size(); ++i) {
+        if (used <= problem.capacities[i]) {
+            return problem.stocks[i];
+        }
+    }
+    return problem.stocks.back();
+}
+
+static int64_t StockTotal(const Problem& problem, const std::vector<Bin>& bins)
+{
+    int64_t total = 0;
+    for (const Bin& bin : bins) {
+        total += StockFor(problem, problem.capacity - bin.free);
+    }
+    return total;
+}
+
+static size_t PatternCount(std::vector<Bin>& bins)
+{
+    std::vector<std::vector<int>> patterns;
+    patterns.reserve(bins.size());
+    for (Bin& bin : bins) {
+        std::sort(bin.items.begin(), bin.items.end(), std::greater<int>());
+        patterns.push_back(bin.items);
+    }
+    std::sort(patterns.begin(), patterns.end());
+    return static_cast<size_t>(std::unique(patterns.begin(), patterns.end()) - patterns.begin());
+}
+
+// Лучший подходящий: хлыст с наименьшим достаточным остатком
+static void BestFit(const std::vector<int>& order, int capacity, std::vector<Bin>& bins)
+{
+    std::multimap<int, size_t> byFree;
+    for (int item : order) {
+        auto it = byFree.lower_bound(item);
+        if (it == byFree.end()) {
+            bins.push_back({ capacity - item, { item } });
+            byFree.emplace(capacity - item, bins.size() - 1);
+            continue;
+        }
+        const size_t index = it->second;
+        byFree.erase(it);
+        Bin& bin = bins[index];
+        bin.free -= item;
+        bin.items.push_back(item);
+        byFree.emplace(bin.free, index);
+    }
+}
+
+// Расформировать самые пустые хлысты: их детали раскладываются по остаткам
+// других хлыстов. Хлыст удаляется, только если поместились все его детали.
+static void EliminateBins(std::vector<Bin>& bins)
+{
+    bool improved = true;
+    while (improved && bins.size() > 1) {
+        improved = false;
+
+        std::vector<size_t> order(bins.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&bins](size_t a, size_t b) {
+            return bins[a].free > bins[b].free;
+        });
+
+        int64_t freeTotal = 0;
+        for (const Bin& bin : bins) {
+            freeTotal += bin.free;
+        }
+
+        std::vector<bool> removed(bins.size(), false);
+        std::multimap<int, size_t> byFree;
+        for (size_t i = 0; i < bins.size(); ++i) {
+            byFree.emplace(bins[i].free, i);
+        }
+
+        for (size_t candidate : order) {
+            Bin& source = bins[candidate];
+            int used = 0;
+            for (int item : source.items) {
+                used += item;
+            }
+            // Остатков других хлыстов не хватит ни на что из следующих (они полнее)
+            if (freeTotal - source.free < used) {
+                break;
+            }
+
+            // Убираем кандидата из поиска и пробуем разложить его детали
+            auto self = byFree.equal_range(source.free);
+            for (auto it = self.first; it != self.second; ++it) {
+                if (it->second == candidate) {
+                    byFree.erase(it);
+                    break;
+                }
+            }
+
+            std::vector<int> items = source.items;
+            std::sort(items.begin(), items.end(), std::greater<int>());
+            std::vector<std::pair<size_t, int>> moves;
+            bool fits = true;
+            for (int item : items) {
+                auto it = byFree.lower_bound(item);
+                if (it == byFree.end()) {
+                    fits = false;
+                    break;
+                }
+                const size_t target = it->second;
+                byFree.erase(it);
+                bins[target].free -= item;
+                bins[target].items.push_back(item);
+                byFree.emplace(bins[target].free, target);
+                moves.emplace_back(target, item);
+            }
+
+            if (fits) {
+                removed[candidate] = true;
+                freeTotal -= source.free + used;
+                source.items.clear();
+                improved = true;
+                continue;
+            }
+
+            // Откат: детали возвращаются кандидату
+            for (auto move = moves.rbegin(); move != moves.rend(); ++move) {
+                Bin& target = bins[move->first];
+                auto range = byFree.equal_range(target.free);
+                for (auto it = range.first; it != range.second; ++it) {
+                    if (it->second == move->first) {
+                        byFree.erase(it);
+                        break;
+                    }
+                }
+                target.free += move->second;
+                target.items.pop_back();
+                byFree.emplace(target.free, move->first);
+            }
+            byFree.emplace(source.free, candidate);
+        }
+
+        if (improved) {
+            std::vector<Bin> kept;
+            kept.reserve(bins.size());
+            for (size_t i = 0; i < bins.size(); ++i) {
+                if (!removed[i]) {
+                    kept.push_back(std::move(bins[i]));
+                }
+            }
+            bins.swap(kept);
+        }
+    }
+}
+
+// Подмножество pool с наибольшей суммой не больше capacity (перебор с отсечением)
+static void BestSubset(const std::vector<int>& pool, size_t index, int sum, int rest, int capacity,
+                       uint32_t mask, int& bestSum, uint32_t& bestMask)
+{
+    if (sum > bestSum) {
+        bestSum = sum;
+        bestMask = mask;
+    }
+    if (index == pool.size() || bestSum == capacity || sum + rest <= bestSum) {
+        return;
+    }
+    const int item = pool[index];
+    if (sum + item <= capacity) {
+        BestSubset(pool, index + 1, sum + item, rest - item, capacity, mask | (1u << index), bestSum, bestMask);
+    }
+    BestSubset(pool, index + 1, sum, rest - item, capacity, mask, bestSum, bestMask);
+}
+
+// Сбор отхода в одном хлысте: детали самого пустого хлыста и другого хлыста
+// перекладываются так, чтобы другой был заполнен как можно плотнее, а
+// остаток ушёл в пустой. Опустевший хлыст удаляется. Без улучшения - выход.
+static void ConcentrateWaste(std::vector<Bin>& bins, int capacity, std::mt19937& random)
+{
+    const size_t MaxPool = 24;
+    std::vector<size_t> partners;
+    std::vector<int> pool;
+    for (size_t step = 0, steps = 4 * bins.size(); step < steps && bins.size() > 1; ++step) {
+        size_t emptiest = 0;
+        for (size_t i = 1; i < bins.size(); ++i) {
+            if (bins[i].free > bins[emptiest].free) {
+                emptiest = i;
+            }
+        }
+
+        partners.clear();
+        for (size_t i = 0; i < bins.size(); ++i) {
+            if (i != emptiest) {
+                partners.push_back(i);
+            }
+        }
+        std::shuffle(partners.begin(), partners.end(), random);
+
+        bool improved = false;
+        for (size_t partner : partners) {
+            Bin& source = bins[emptiest];
+            Bin& target = bins[partner];
+            if (source.items.size() + target.items.size() > MaxPool) {
+                continue;
+            }
+            pool = source.items;
+            pool.insert(pool.end(), target.items.begin(), target.items.end());
+            std::sort(pool.begin(), pool.end(), std::greater<int>());
+
+            int total = 0;
+            for (int item : pool) {
+                total += item;
+            }
+            const int targetUsed = capacity - target.free;
+            int bestSum = targetUsed;
+            uint32_t bestMask = 0;
+            BestSubset(pool, 0, 0, total, capacity, 0, bestSum, bestMask);
+            if (bestSum <= targetUsed) {
+                continue;
+            }
+
+            target.items.clear();
+            source.items.clear();
+            for (size_t i = 0; i < pool.size(); ++i) {
+                ((bestMask >> i) & 1u ? target : source).items.push_back(pool[i]);
+            }
+            target.free = capacity - bestSum;
+            source.free = capacity - (total - bestSum);
+            if (source.items.empty()) {
+                bins.erase(bins.begin() + static_cast<std::ptrdiff_t>(emptiest));
+            }
+            improved = true;
+            break;
+        }
+        if (!improved) {
+            return;
+        }
+    }
+}
+
+// Одна попытка: start 0 - точный порядок по убыванию, остальные - длины
+// со случайным множителем, чтобы детали близких длин менялись местами
+static void RunStart(const Problem& problem, uint64_t start, Solution& solution)
+{
+    std::mt19937 random = MultiStart::Random(start);
+    std::vector<int> order;
+    if (start == 0) {
+        order = problem.items;
+    } else {
+        std::uniform_real_distribution<double> jitter = MultiStart::Jitter(start, 0.02, 0.28);
+
+        std::vector<std::pair<double, int>> keyed;
+        keyed.reserve(problem.items.size());
+        for (int item : problem.items) {
+            keyed.emplace_back(item * jitter(random), item);
+        }
+        std::sort(keyed.begin(), keyed.end(), [](const std::pair<double, int>& a, const std::pair<double, int>& b) {
+            return a.first > b.first;
+        });
+        order.reserve(keyed.size());
+        for (const std::pair<double, int>& k : keyed) {
+            order.push_back(k.second);
+        }
+    }
+
+    solution.bins.clear();
+    solution.start = start;
+    BestFit(order, problem.capacity, solution.bins);
+    EliminateBins(solution.bins);
+    ConcentrateWaste(solution.bins, problem.capacity, random);
+    EliminateBins(solution.bins);
+    solution.stockTotal = StockTotal(problem, solution.bins);
+    solution.patternCount = PatternCount(solution.bins);
+}
+
+static bool IsBetter(const Solution& a, const Solution& b)
+{
+    if (a.stockTotal != b.stockTotal) {
+        return a.stockTotal < b.stockTotal;
+    }
+    if (a.bins.size() != b.bins.size()) {
+        return a.bins.size() < b.bins.size();
+    }
+    if (a.patternCount != b.patternCount) {
+        return a.patternCount < b.patternCount;
+    }
+    return a.start < b.start;
+}
+
+// Параллельные попытки (MultiStart). Одна деталь раскладывается единственным
+// способом, поэтому её решение сразу считается оптимальным
+static void Search(const Problem& problem, unsigned threadCount,
+                   std::chrono::steady_clock::time_point deadline, Solution& best, uint64_t& starts)
+{
+    MultiStart::Search(SearchLimits, threadCount, deadline,
+        [&problem](uint64_t start, Solution& solution) { RunStart(problem, start, solution); },
+        IsBetter,
+        [&problem](const Solution& solution) {
+            return solution.stockTotal <= problem.lowerBoundCost || problem.items.size() < 2;
+        },
+        best, starts);
+}
+
+// Хлысты решения -> варианты раскроя (одинаковые хлысты объединяются)
+static void BuildPatterns(const Problem& problem, int kerf, const Solution& solution, Profile& profile)
+{
+    std::map<std::pair<int, std::vector<int>>, int> counts;
+    for (const Bin& bin : solution.bins) {
+        std::vector<int> cuts;
+        cuts.reserve(bin.items.size());
+        for (int item : bin.items) {
+            cuts.push_back(item - kerf);
+        }
+        std::sort(cuts.begin(), cuts.end(), std::greater<int>());
+        ++counts[std::make_pair(StockFor(problem, problem.capacity - bin.free), std::move(cuts))];
+    }
+
+    for (const auto& entry : counts) {
+        Pattern pattern;
+        pattern.stockLength = entry.first.first;
+        pattern.repeat = entry.second;
+        pattern.cuts = entry.first.second;
+        pattern.waste = pattern.stockLength;
+        for (int cut : pattern.cuts) {
+            pattern.waste -= cut;
+        }
+        profile.patterns.push_back(std::move(pattern));
+    }
+    std::sort(profile.patterns.begin(), profile.patterns.end(), [](const Pattern& a, const Pattern& b) {
+        if (a.repeat != b.repeat) {
+            return a.repeat > b.repeat;
+        }
+        return a.waste < b.waste;
+    });
+}
+
+// =============================================================================
+// Optimize
+// =============================================================================
+
+bool Optimize(const std::vector<CassetteCore::PlankRow>& pieces, const Params& params, Plan& plan)
+{
+    const auto begin = std::chrono::steady_clock::now();
+    plan.profiles.clear();
+    plan.starts = 0;
+    plan.elapsedMs = 0.0;
+
+    const int kerf = std::max(0, params.kerf);
+    const int trim = std::max(0, params.trim);
+    Problem base;
+    for (int stock : params.stockLengths) {
+        if (stock > trim) {
+            base.stocks.push_back(stock);
+        }
+    }
+    std::sort(base.stocks.begin(), base.stocks.end());
+    base.stocks.erase(std::unique(base.stocks.begin(), base.stocks.end()), base.stocks.end());
+    if (base.stocks.empty()) {
+        return false;
+    }
+    for (int stock : base.stocks) {
+        base.capacities.push_back(stock - trim + kerf);
+    }
+    base.capacity = base.capacities.back();
+
+    unsigned threadCount = params.threads > 0
+        ? static_cast<unsigned>(params.threads)
+        : std::max(1u, std::thread::hardware_concurrency());
+    plan.threads = threadCount;
+
+    // Ширина профиля -> длина -> количество
+    std::map<int, std::map<int, int64_t>> groups;
+    for (const CassetteCore::PlankRow& row : pieces) {
+        if (row.length > 0 && row.count > 0) {
+            groups[row.width][row.length] += row.count;
+        }
+    }
+
+    size_t remaining = groups.size();
+    const auto deadline = begin + std::chrono::milliseconds(std::max(1, params.timeLimitMs));
+    for (const auto& group : groups) {
+        Profile profile;
+        profile.width = group.first;
+        profile.pieces = 0;
+        profile.pieceTotal = 0;
+
+        Problem problem = base;
+        for (auto it = group.second.rbegin(); it != group.second.rend(); ++it) {
+            const int effective = it->first + kerf;
+            if (effective > problem.capacity) {
+                profile.oversize.push_back({ it->first, static_cast<int>(it->second) });
+                continue;
+            }
+            problem.items.insert(problem.items.end(), static_cast<size_t>(it->second), effective);
+            profile.pieces += it->second;
+            profile.pieceTotal += static_cast<int64_t>(it->first) * it->second;
+        }
+
+        int64_t effectiveTotal = 0;
+        for (int item : problem.items) {
+            effectiveTotal += item;
+        }
+        profile.lowerBound = (effectiveTotal + problem.capacity - 1) / problem.capacity;
+        problem.lowerBoundCost = problem.stocks.size() == 1
+            ? profile.lowerBound * problem.stocks[0]
+            : 0;
+
+        // Оставшееся время делится поровну между оставшимися профилями
+        const auto now = std::chrono::steady_clock::now();
+        const auto share = deadline > now ? (deadline - now) / static_cast<int>(remaining) : std::chrono::steady_clock::duration::zero();
+        --remaining;
+
+        Solution best;
+        uint64_t starts = 0;
+        if (!problem.items.empty()) {
+            Search(problem, threadCount, now + share, best, starts);
+        }
+        plan.starts += starts;
+
+        BuildPatterns(problem, kerf, best, profile);
+        profile.bars = static_cast<int64_t>(best.bins.size());
+        profile.stockTotal = problem.items.empty() ? 0 : best.stockTotal;
+        profile.wastePercent = profile.stockTotal > 0
+            ? 100.0 * static_cast<double>(profile.stockTotal - profile.pieceTotal) / static_cast<double>(profile.stockTotal)
+            : 0.0;
+        plan.profiles.push_back(std::move(profile));
+    }
+
+    plan.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    return true;
+}
+
+} // namespace CuttingStock
@@ -0,0 +1,79 @@
+#ifndef CUTTINGSTOCK_HPP
+#define CUTTINGSTOCK_HPP
+
+// =============================================================================
+// CuttingStock - Раскрой планок и откосов из хлыстов (одномерный раскрой)
+// =============================================================================
+// Детали (длина × количество) группируются по ширине профиля: планки и откосы
+// одной ширины режутся из одного профиля. Для каждого профиля строится план:
+// варианты раскроя хлыста (какие детали из него режутся и сколько таких
+// хлыстов), число хлыстов и процент отхода.
+//
+// Начальное решение - "лучший подходящий по убыванию длины" (BFD), затем
+// самые пустые хлысты расформировываются по остаткам других, а отход
+// перекладыванием пар хлыстов собирается в одном хлысте. Остальные попытки
+// повторяют то же со случайно возмущённым порядком деталей и идут
+// параллельно; берётся решение с наименьшей суммарной длиной хлыстов, при
+// равной - с меньшим числом хлыстов и различных вариантов раскроя.
+// Поиск останавливается на нижней границе, после серии попыток без улучшения
+// или по времени.
+// Модуль не зависит от Archicad API (только стандартная библиотека).
+
+#include "CassetteCore.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace CuttingStock {
+
+struct Params {
+    std::vector<int> stockLengths;  // Длины хлыстов в мм (одна или несколько)
+    int kerf;                       // Ширина реза в мм
+    int trim;                       // Обрезка торцов на хлыст в мм
+    int threads;                    // Число потоков; 0 - по числу ядер
+    int timeLimitMs;                // Предел времени на весь раскрой
+};
+
+Params GetDefaultParams();
+
+struct Piece {
+    int length;
+    int count;
+};
+
+// Вариант раскроя одного хлыста
+struct Pattern {
+    int stockLength;            // Длина хлыста в мм
+    int repeat;                 // Сколько хлыстов режется так
+    std::vector<int> cuts;      // Длины деталей по убыванию
+    int waste;                  // Остаток одного хлыста в мм (с резами и торцами)
+};
+
+// План раскроя одного профиля
+struct Profile {
+    int width;                      // Ширина профиля в мм
+    std::vector<Pattern> patterns;
+    std::vector<Piece> oversize;    // Детали длиннее самого длинного хлыста (не раскроены)
+    int64_t pieces;                 // Раскроено деталей
+    int64_t bars;                   // Хлыстов
+    int64_t lowerBound;             // Нижняя граница числа хлыстов самой большой длины
+    int64_t stockTotal;             // Суммарная длина хлыстов в мм
+    int64_t pieceTotal;             // Суммарная длина деталей в мм
+    double wastePercent;            // Отход, % от длины хлыстов
+};
+
+struct Plan {
+    std::vector<Profile> profiles;  // По возрастанию ширины
+    uint64_t starts;                // Выполнено попыток (все профили и потоки)
+    unsigned threads;
+    double elapsedMs;
+};
+
+// Раскрой деталей (планки и откосы вместе; calcType не учитывается).
+// false - не задано ни одного хлыста длиннее обрезки торцов.
+bool Optimize(const std::vector<CassetteCore::PlankRow>& pieces, const Params& params, Plan& plan);
+
+} // namespace CuttingStock
+
+#endif // CUTTINGSTOCK_HPP
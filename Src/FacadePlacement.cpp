@@ -0,0 +1,88 @@
+// =============================================================================
+// FacadePlacement - Экземпляры кассет, планок и откосов у каждого проёма
+// =============================================================================
+
+#include "FacadePlacement.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+namespace FacadePlacement {
+
+// Маркировка: размеры в мм
+static std::string Mark(int a, int b)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%dx%d", a, b);
+    return buffer;
+}
+
+// Экземпляр, левый край которого сдвинут на along м вдоль стены от середины проёма
+static HostApi::PlacedObject Place(const Opening& opening, double along, double level, int aMm, int bMm, const std::string& text)
+{
+    HostApi::PlacedObject object;
+    object.x = opening.x + along * std::cos(opening.angle);
+    object.y = opening.y + along * std::sin(opening.angle);
+    object.level = level;
+    object.angle = opening.angle;
+    object.floorInd = opening.storey;
+    object.a = aMm / 1000.0;
+    object.b = bMm / 1000.0;
+    object.text = text;
+    return object;
+}
+
+void Generate(const std::vector<Opening>& openings, const CassetteCore::Params& params, Layout& layout)
+{
+    layout.cassettes.clear();
+    layout.planks.clear();
+    layout.slopes.clear();
+    layout.planks.reserve(openings.size() * 2);
+    layout.slopes.reserve(openings.size() * 2);
+
+    const int floorHeightMm = Mm::FromMetres(params.floorHeight);
+
+    for (const Opening& opening : openings) {
+        // Размеры - как в CassetteCore::Calculate
+        const int widthMm = opening.width;
+        const int heightMm = opening.height;
+        const int sillMm = opening.sillHeight;
+
+        const bool type0 = (opening.calcType == 0);
+        const int plankWidth = type0 ? params.plankWidth0 : params.plankWidth12;
+        const int slopeWidth = type0 ? params.slopeWidth0 : params.slopeWidth12;
+
+        // Планки под проёмом и над ним, по центру проёма
+        const int plankLength = widthMm + params.offsetY;
+        const double plankStart = -plankLength / 2000.0;
+        const std::string plankMark = Mark(plankWidth, plankLength);
+        layout.planks.push_back(Place(opening, plankStart, sillMm / 1000.0, plankLength, plankWidth, plankMark));
+        layout.planks.push_back(Place(opening, plankStart, (sillMm + heightMm) / 1000.0, plankLength, plankWidth, plankMark));
+
+        // Откосы: левый заканчивается на левой границе, правый начинается на правой
+        const std::string slopeMark = Mark(slopeWidth, heightMm);
+        layout.slopes.push_back(Place(opening, -widthMm / 2000.0 - slopeWidth / 1000.0, sillMm / 1000.0, slopeWidth, heightMm, slopeMark));
+        layout.slopes.push_back(Place(opening, widthMm / 2000.0, sillMm / 1000.0, slopeWidth, heightMm, slopeMark));
+
+        if (opening.calcType != 1 && opening.calcType != 2) {
+            continue;
+        }
+
+        const int cassetteY = widthMm + params.offsetY;
+        const double cassetteStart = -cassetteY / 2000.0;
+
+        // Нижняя: X = D * 1000 + offsetX, верх - на подоконнике
+        if (opening.calcType == 2) {
+            const int cassetteX = sillMm + params.offsetX;
+            layout.cassettes.push_back(Place(opening, cassetteStart, (sillMm - cassetteX) / 1000.0,
+                cassetteY, cassetteX, Mark(cassetteX, cassetteY)));
+        }
+
+        // Верхняя: X2 = I2*1000 - (190 + C*1000 + D*1000 + 20) + offsetTop, верх - высота этажа + offsetTop
+        const int cassetteX2 = floorHeightMm - (190 + heightMm + sillMm + 20) + params.offsetTop;
+        layout.cassettes.push_back(Place(opening, cassetteStart, (floorHeightMm + params.offsetTop - cassetteX2) / 1000.0,
+            cassetteY, cassetteX2, Mark(cassetteX2, cassetteY)));
+    }
+}
+
+} // namespace FacadePlacement
@@ -0,0 +1,52 @@
+#ifndef FACADEPLACEMENT_HPP
+#define FACADEPLACEMENT_HPP
+
+// =============================================================================
+// FacadePlacement - Экземпляры кассет, планок и откосов у каждого проёма
+// =============================================================================
+// Те же детали, что считает CassetteCore::Calculate, но не сводкой, а по одной
+// на проём: с точкой вставки, отметкой и поворотом по стене. Точка проёма -
+// середина по ширине на линии привязки стены, направление - угол стены.
+//   Планки     - под проёмом и над ним, длина B * 1000 + offsetY;
+//   Откосы     - у левой и правой границы, длина C * 1000;
+//   Кассеты    - тип 1: верхняя, тип 2: нижняя и верхняя (размеры X × Y как
+//                в расчёте; нижняя стоит на низу этажа минус offsetX, верх
+//                верхней - на высоте этажа плюс offsetTop).
+// A - размер вдоль стены, B - по высоте (у планок - ширина профиля).
+// Размещение - HostWorkload::PlaceObjects (одна команда отмены).
+// Модуль не зависит от Archicad API (только стандартная библиотека).
+
+#include "CassetteCore.hpp"
+#include "HostApi.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace FacadePlacement {
+
+// Проём (координаты в метрах, размеры в мм)
+struct Opening {
+    double x;                   // Середина проёма на линии привязки стены
+    double y;
+    double angle;               // Направление стены, рад
+    Mm::Length width;           // B
+    Mm::Length height;          // C
+    Mm::Length sillHeight;      // D
+    int32_t storey;
+    int calcType;               // 0, 1, 2 или -1 (как типы 1-2, без кассет)
+};
+
+struct Layout {
+    std::vector<HostApi::PlacedObject> cassettes;
+    std::vector<HostApi::PlacedObject> planks;
+    std::vector<HostApi::PlacedObject> slopes;      // Левые и правые
+
+    size_t Size() const { return cassettes.size() + planks.size() + slopes.size(); }
+};
+
+// Детали всех проёмов; маркировка (text) - размеры в мм, как в строках Text_N
+void Generate(const std::vector<Opening>& openings, const CassetteCore::Params& params, Layout& layout);
+
+} // namespace FacadePlacement
+
+#endif // FACADEPLACEMENT_HPP
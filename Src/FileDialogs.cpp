@@ -0,0 +1,142 @@
+// =============================================================================
+// FileDialogs - Системные диалоги выбора файла
+// =============================================================================
+
+#include "FileDialogs.hpp"
+
+#include <Windows.h>
+#include <commdlg.h>
+#include <string>
+
+namespace FileDialogs {
+
+// =============================================================================
+// Вспомогательные функции
+// =============================================================================
+
+// Фильтр вида "CSV файлы (*.csv)\0*.csv\0Все файлы\0*.*\0\0"
+static std::wstring BuildFilter(const FileType& type)
+{
+    const std::wstring ext(type.extension.ToUStr().Get());
+    const std::wstring mask = L"*." + ext;
+
+    std::wstring filter(type.description.ToUStr().Get());
+    filter += L" (" + mask + L")";
+    filter.push_back(L'\0');
+    filter += mask;
+    filter.push_back(L'\0');
+    filter += L"Все файлы";
+    filter.push_back(L'\0');
+    filter += L"*.*";
+    filter.push_back(L'\0');
+    filter.push_back(L'\0');
+    return filter;
+}
+
+static bool RunDialog(bool save, const GS::UniString& title, const FileType& type,
+    const GS::UniString& defaultName, GS::UniString& path)
+{
+    wchar_t fileName[MAX_PATH] = L"";
+    if (!defaultName.IsEmpty()) {
+        const std::wstring name(defaultName.ToUStr().Get());
+        wcsncpy_s(fileName, name.c_str(), _TRUNCATE);
+    }
+
+    const std::wstring filter = BuildFilter(type);
+    const std::wstring titleW(title.ToUStr().Get());
+    const std::wstring extW(type.extension.ToUStr().Get());
+
+    OPENFILENAMEW ofn = {};
+    ofn.lStructSize = sizeof(ofn);
+    ofn.hwndOwner = GetActiveWindow();
+    ofn.lpstrFilter = filter.c_str();
+    ofn.lpstrFile = fileName;
+    ofn.nMaxFile = MAX_PATH;
+    ofn.lpstrTitle = titleW.c_str();
+    ofn.lpstrDefExt = extW.c_str();
+
+    BOOL ok = FALSE;
+    if (save) {
+        ofn.Flags = OFN_OVERWRITEPROMPT | OFN_PATHMUSTEXIST | OFN_NOCHANGEDIR;
+        ok = GetSaveFileNameW(&ofn);
+    } else {
+        ofn.Flags = OFN_FILEMUSTEXIST | OFN_PATHMUSTEXIST | OFN_NOCHANGEDIR;
+        ok = GetOpenFileNameW(&ofn);
+    }
+
+    if (!ok) {
+        return false;
+    }
+
+    path = GS::UniString(fileName);
+    return true;
+}
+
+// =============================================================================
+// Диалоги
+// =============================================================================
+
+bool AskSavePath(const GS::UniString& title, const FileType& type,
+    const GS::UniString& defaultName, GS::UniString& path)
+{
+    return RunDialog(true, title, type, defaultName, path);
+}
+
+bool AskOpenPath(const GS::UniString& title, const FileType& type, GS::UniString& path)
+{
+    return RunDialog(false, title, type, GS::UniString(), path);
+}
+
+bool AskOpenPaths(const GS::UniString& title, const FileType& type, GS::Array<GS::UniString>& paths)
+{
+    // Несколько файлов: "каталог\0имя1\0имя2\0\0", один файл: "полный путь\0\0"
+    std::wstring buffer(32 * 1024, L'\0');
+
+    const std::wstring filter = BuildFilter(type);
+    const std::wstring titleW(title.ToUStr().Get());
+
+    OPENFILENAMEW ofn = {};
+    ofn.lStructSize = sizeof(ofn);
+    ofn.hwndOwner = GetActiveWindow();
+    ofn.lpstrFilter = filter.c_str();
+    ofn.lpstrFile = &buffer[0];
+    ofn.nMaxFile = static_cast<DWORD>(buffer.size());
+    ofn.lpstrTitle = titleW.c_str();
+    ofn.Flags = OFN_ALLOWMULTISELECT | OFN_EXPLORER | OFN_FILEMUSTEXIST | OFN_PATHMUSTEXIST | OFN_NOCHANGEDIR;
+
+    if (!GetOpenFileNameW(&ofn)) {
+        return false;
+    }
+
+    const wchar_t* p = buffer.c_str();
+    const std::wstring first(p);
+    p += first.size() + 1;
+    if (*p == L'\0') {
+        paths.Push(GS::UniString(first.c_str()));
+        return true;
+    }
+
+    std::wstring directory = first;
+    if (!directory.empty() && directory.back() != L'\\') {
+        directory.push_back(L'\\');
+    }
+    while (*p != L'\0') {
+        const std::wstring name(p);
+        paths.Push(GS::UniString((directory + name).c_str()));
+        p += name.size() + 1;
+    }
+    return true;
+}
+
+GS::UniString MakeDatedFileName(const GS::UniString& prefix, const GS::UniString& extension)
+{
+    SYSTEMTIME now;
+    GetLocalTime(&now);
+
+    wchar_t date[16];
+    swprintf_s(date, L"%04u%02u%02u", now.wYear, now.wMonth, now.wDay);
+
+    return prefix + "_" + GS::UniString(date) + "." + extension;
+}
+
+} // namespace FileDialogs
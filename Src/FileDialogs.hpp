@@ -0,0 +1,35 @@
+#ifndef FILEDIALOGS_HPP
+#define FILEDIALOGS_HPP
+
+// =============================================================================
+// FileDialogs - Системные диалоги выбора файла
+// =============================================================================
+
+#include "GSRoot.hpp"
+#include "UniString.hpp"
+
+namespace FileDialogs {
+
+// Тип файла для фильтра диалога
+struct FileType {
+    GS::UniString description;  // "CSV файлы"
+    GS::UniString extension;    // "csv" (без точки)
+};
+
+// Диалог сохранения. defaultName - имя файла по умолчанию.
+// Возвращает false, если пользователь отменил диалог.
+bool AskSavePath(const GS::UniString& title, const FileType& type,
+    const GS::UniString& defaultName, GS::UniString& path);
+
+// Диалог открытия существующего файла
+bool AskOpenPath(const GS::UniString& title, const FileType& type, GS::UniString& path);
+
+// Диалог открытия нескольких файлов; пути добавляются в paths
+bool AskOpenPaths(const GS::UniString& title, const FileType& type, GS::Array<GS::UniString>& paths);
+
+// Имя файла с текущей датой: prefix_ГГГГММДД.extension
+GS::UniString MakeDatedFileName(const GS::UniString& prefix, const GS::UniString& extension);
+
+} // namespace FileDialogs
+
+#endif // FILEDIALOGS_HPP
@@ -0,0 +1,289 @@
+// =============================================================================
+// FileIO - Буферизованная запись и отображение файлов в память
+// =============================================================================
+
+#include "FileIO.hpp"
+
+#include <Windows.h>
+#include <cstring>
+#include <string>
+
+namespace FileIO {
+
+// Размер буфера записи
+static const size_t BufferSize = 64 * 1024;
+
+// =============================================================================
+// UTF-8
+// =============================================================================
+
+// Следующий символ UTF-16 (с учётом суррогатных пар)
+static UInt32 NextCodePoint(const GS::uchar_t*& p, const GS::uchar_t* end)
+{
+    UInt32 cp = *p++;
+    if (cp >= 0xD800 && cp <= 0xDBFF && p < end && *p >= 0xDC00 && *p <= 0xDFFF) {
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (*p++ - 0xDC00);
+    }
+    return cp;
+}
+
+// Закодировать символ в out (до 4 байт), вернуть число байт
+static size_t EncodeUtf8(UInt32 cp, char* out)
+{
+    if (cp < 0x80) {
+        out[0] = static_cast<char>(cp);
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (cp >> 6));
+        out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (cp >> 12));
+        out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (cp >> 18));
+    out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+void AppendUtf8(std::string& target, const GS::UniString& text)
+{
+    // Буфер UTF-16 живёт в wide, пока идёт разбор
+    const GS::UniString::UStr wide = text.ToUStr();
+    const GS::uchar_t* p = wide.Get();
+    const GS::uchar_t* end = p + text.GetLength();
+    char encoded[4];
+    while (p < end) {
+        target.append(encoded, EncodeUtf8(NextCodePoint(p, end), encoded));
+    }
+}
+
+std::string ToUtf8(const GS::UniString& text)
+{
+    std::string result;
+    result.reserve(text.GetLength());
+    AppendUtf8(result, text);
+    return result;
+}
+
+// =============================================================================
+// Writer
+// =============================================================================
+
+Writer::Writer() :
+    handle(nullptr),
+    used(0),
+    bytesWritten(0),
+    failed(false)
+{
+}
+
+Writer::~Writer()
+{
+    Close();
+}
+
+bool Writer::Open(const GS::UniString& path)
+{
+    Close();
+
+    std::wstring wpath(path.ToUStr().Get());
+    HANDLE h = CreateFileW(wpath.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (h == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    handle = h;
+    buffer.resize(BufferSize);
+    used = 0;
+    bytesWritten = 0;
+    failed = false;
+    return true;
+}
+
+bool Writer::Flush()
+{
+    if (handle == nullptr || used == 0) {
+        return !failed;
+    }
+
+    DWORD written = 0;
+    if (!WriteFile(static_cast<HANDLE>(handle), buffer.data(), static_cast<DWORD>(used), &written, NULL) ||
+        written != used) {
+        failed = true;
+    }
+    bytesWritten += written;
+    used = 0;
+    return !failed;
+}
+
+void Writer::Write(const char* data, size_t size)
+{
+    if (handle == nullptr) {
+        return;
+    }
+
+    // Крупные блоки пишем напрямую, минуя буфер
+    if (size >= BufferSize) {
+        Flush();
+        DWORD written = 0;
+        if (!WriteFile(static_cast<HANDLE>(handle), data, static_cast<DWORD>(size), &written, NULL) ||
+            written != size) {
+            failed = true;
+        }
+        bytesWritten += written;
+        return;
+    }
+
+    if (used + size > buffer.size()) {
+        Flush();
+    }
+    memcpy(buffer.data() + used, data, size);
+    used += size;
+}
+
+void Writer::WriteChar(char c)
+{
+    if (handle == nullptr) {
+        return;
+    }
+    if (used == buffer.size()) {
+        Flush();
+    }
+    buffer[used++] = c;
+}
+
+void Writer::WriteInt(Int64 value)
+{
+    char digits[24];
+    size_t len = 0;
+    UInt64 v = value < 0 ? static_cast<UInt64>(-(value + 1)) + 1 : static_cast<UInt64>(value);
+    do {
+        digits[len++] = static_cast<char>('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+
+    if (value < 0) {
+        WriteChar('-');
+    }
+    while (len > 0) {
+        WriteChar(digits[--len]);
+    }
+}
+
+void Writer::WriteUtf8(const GS::UniString& text)
+{
+    if (handle == nullptr) {
+        return;
+    }
+
+    const GS::UniString::UStr wide = text.ToUStr();
+    const GS::uchar_t* p = wide.Get();
+    const GS::uchar_t* end = p + text.GetLength();
+
+    while (p < end) {
+        // В буфере всегда должно быть место под один символ UTF-8 (до 4 байт)
+        if (buffer.size() - used < 4) {
+            Flush();
+        }
+
+        used += EncodeUtf8(NextCodePoint(p, end), buffer.data() + used);
+    }
+}
+
+bool Writer::Close()
+{
+    if (handle == nullptr) {
+        return !failed;
+    }
+
+    Flush();
+    if (!CloseHandle(static_cast<HANDLE>(handle))) {
+        failed = true;
+    }
+    handle = nullptr;
+    buffer.clear();
+    buffer.shrink_to_fit();
+    return !failed;
+}
+
+// =============================================================================
+// MappedFile
+// =============================================================================
+
+MappedFile::MappedFile() :
+    file(nullptr),
+    mapping(nullptr),
+    data(nullptr),
+    size(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const GS::UniString& path)
+{
+    Close();
+
+    std::wstring wpath(path.ToUStr().Get());
+    HANDLE h = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (h == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    file = h;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(h, &fileSize)) {
+        Close();
+        return false;
+    }
+
+    // Пустой файл отобразить нельзя - это не ошибка, данных просто нет
+    size = static_cast<UInt64>(fileSize.QuadPart);
+    if (size == 0) {
+        return true;
+    }
+
+    mapping = CreateFileMappingW(h, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == nullptr) {
+        Close();
+        return false;
+    }
+
+    data = static_cast<const char*>(MapViewOfFile(static_cast<HANDLE>(mapping), FILE_MAP_READ, 0, 0, 0));
+    if (data == nullptr) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (data != nullptr) {
+        UnmapViewOfFile(data);
+        data = nullptr;
+    }
+    if (mapping != nullptr) {
+        CloseHandle(static_cast<HANDLE>(mapping));
+        mapping = nullptr;
+    }
+    if (file != nullptr) {
+        CloseHandle(static_cast<HANDLE>(file));
+        file = nullptr;
+    }
+    size = 0;
+}
+
+} // namespace FileIO
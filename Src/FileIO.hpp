@@ -0,0 +1,83 @@
+#ifndef FILEIO_HPP
+#define FILEIO_HPP
+
+// =============================================================================
+// FileIO - Буферизованная запись и отображение файлов в память
+// =============================================================================
+// Writer накапливает данные в буфере фиксированного размера и сбрасывает его
+// на диск крупными блоками. Строки GS::UniString кодируются в UTF-8 прямо в
+// буфер, без промежуточной строки ToCStr.
+// MappedFile отображает файл в память только для чтения: парсер работает
+// прямо по байтам файла, без чтения в промежуточный буфер.
+
+#include "GSRoot.hpp"
+#include "UniString.hpp"
+
+#include <string>
+#include <vector>
+
+namespace FileIO {
+
+class Writer {
+public:
+    Writer();
+    ~Writer();
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    // Создать (перезаписать) файл
+    bool Open(const GS::UniString& path);
+
+    void Write(const char* data, size_t size);
+    void WriteChar(char c);
+    void WriteInt(Int64 value);
+    void WriteUtf8(const GS::UniString& text);
+
+    // Сбросить буфер и закрыть файл. false - если была ошибка записи.
+    bool Close();
+
+    bool IsOpen() const { return handle != nullptr; }
+    UInt64 GetBytesWritten() const { return bytesWritten; }
+
+private:
+    bool Flush();
+
+    void* handle;               // HANDLE файла
+    std::vector<char> buffer;
+    size_t used;
+    UInt64 bytesWritten;
+    bool failed;
+};
+
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Отобразить существующий файл. Пустой файл открывается с GetSize() == 0.
+    bool Open(const GS::UniString& path);
+    void Close();
+
+    const char* GetData() const { return data; }
+    UInt64 GetSize() const { return size; }
+
+private:
+    void* file;                 // HANDLE файла
+    void* mapping;              // HANDLE отображения
+    const char* data;
+    UInt64 size;
+};
+
+// Строка в UTF-8 (для сравнения с байтами файла)
+std::string ToUtf8(const GS::UniString& text);
+
+// Дописать строку в UTF-8 в конец target (без промежуточной строки)
+void AppendUtf8(std::string& target, const GS::UniString& text);
+
+} // namespace FileIO
+
+#endif // FILEIO_HPP
@@ -0,0 +1,140 @@
+#ifndef HOSTAPI_HPP
+#define HOSTAPI_HPP
+
+// =============================================================================
+// HostApi - Вызовы Archicad, которые делает аддон, без типов Archicad API
+// =============================================================================
+// Чтение выделения, элементов и свойств, запись параметров GDL объектов и
+// размещение новых объектов идут через интерфейс Host. В Archicad его
+// реализует AcHost (ACAPI), для записи трассы - HostTrace::Recorder, для
+// повтора без Archicad - HostTrace::Player.
+// Логика над этими вызовами - в HostWorkload. Строки - UTF-8.
+// Модуль не зависит от Archicad API (только стандартная библиотека).
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace HostApi {
+
+typedef int32_t ErrCode;            // GSErrCode
+const ErrCode NoError = 0;
+
+struct Guid {
+    uint8_t bytes[16];              // API_Guid как есть
+
+    bool operator==(const Guid& other) const { return std::memcmp(bytes, other.bytes, sizeof(bytes)) == 0; }
+    bool operator!=(const Guid& other) const { return !(*this == other); }
+    bool operator<(const Guid& other) const { return std::memcmp(bytes, other.bytes, sizeof(bytes)) < 0; }
+};
+
+enum class ElemType : int32_t {
+    Other = 0,
+    Wall = 1,
+    Window = 2,
+    Door = 3,
+    Object = 4
+};
+
+enum class PropertyFilter : int32_t {
+    UserDefined = 0,                // API_PropertyDefinitionFilter_UserDefined
+    All = 1                         // API_PropertyDefinitionFilter_All
+};
+
+// Поля элемента, которые читает аддон
+struct Element {
+    Guid guid;
+    ElemType type;
+    int32_t floorInd;
+    double openingWidth;            // window/door.openingBase.width, м
+    double openingHeight;           // window/door.openingBase.height, м
+    double lower;                   // window/door.lower (подоконник), м
+    Guid owner;                     // window/door.owner - стена проёма
+    double objLoc;                  // window/door.objLoc - от начала стены по линии привязки, м
+    double wallHeight;              // wall.height, м
+    double begX;                    // wall.begC, wall.endC - линия привязки стены, м
+    double begY;
+    double endX;
+    double endY;
+    double arcAngle;                // wall.angle - центральный угол дуговой стены (0 - прямая, > 0 - против часовой), рад
+    bool flipped;                   // wall.flipped - стена отражена относительно линии привязки
+    int32_t libInd;                 // object.libInd
+};
+
+struct PropertyDefinition {
+    Guid guid;
+    std::string name;
+};
+
+struct PropertyValue {
+    bool isDefault;
+    bool isString;                  // API_PropertyStringValueType
+    std::string text;               // Только для строк
+};
+
+// Параметр открытого объекта (API_AddParType)
+struct Parameter {
+    std::string name;
+    int32_t index;
+    int32_t typeID;
+};
+
+// Размещаемый экземпляр библиотечного элемента
+struct PlacedObject {
+    double x;                       // Точка вставки на плане, м
+    double y;
+    double level;                   // Отметка от этажа, м
+    double angle;                   // Поворот, рад
+    int32_t floorInd;
+    double a;                       // Размеры A и B, м
+    double b;
+    std::string text;               // В строковый параметр textParam (маркировка)
+};
+
+class Host {
+public:
+    virtual ~Host() {}
+
+    // Выделение и элементы
+    virtual ErrCode GetSelection(std::vector<Guid>& elements) = 0;
+    virtual ErrCode GetElemList(ElemType type, std::vector<Guid>& elements) = 0;
+    virtual ErrCode GetElement(const Guid& guid, Element& element) = 0;
+    virtual ErrCode GetLibPartName(int32_t libInd, std::string& name) = 0;
+    // Заменить выделение в модели на elements (палитра: выделить дубликаты)
+    virtual ErrCode SelectElements(const std::vector<Guid>& elements) = 0;
+
+    // Свойства
+    virtual ErrCode GetPropertyDefinitions(const Guid& element, PropertyFilter filter, std::vector<PropertyDefinition>& definitions) = 0;
+    virtual ErrCode GetPropertyValue(const Guid& element, const Guid& definition, PropertyValue& value) = 0;
+
+    // Параметры размещённого объекта: Open, Get/Change..., Commit или Close
+    virtual ErrCode OpenParameters(const Guid& element, ElemType type) = 0;
+    virtual ErrCode GetParameters(std::vector<Parameter>& parameters) = 0;
+    virtual ErrCode ChangeParameter(int32_t index, const std::string& value) = 0;
+    // Забрать изменённые параметры и закрыть их; apply - записать в элемент (одна отмена)
+    virtual ErrCode CommitParameters(const Guid& element, bool apply) = 0;
+    virtual void CloseParameters() = 0;
+
+    // Выполнить action одной командой отмены: CommitParameters внутри не
+    // открывают свою команду, все изменения отменяются одним Undo
+    virtual ErrCode RunUndoable(const std::string& name, const std::function<ErrCode()>& action) = 0;
+
+    // Размещение объектов. Параметры библиотечного элемента читаются один раз,
+    // для каждого экземпляра меняются только размеры, положение и textParam.
+    // Вне RunUndoable все объекты создаются одной командой отмены.
+    virtual ErrCode FindLibPart(const std::string& name, int32_t& libInd) = 0;
+    virtual ErrCode CreateObjects(int32_t libInd, const std::string& textParam,
+                                  const std::vector<PlacedObject>& objects, std::vector<Guid>& created) = 0;
+
+    // Следить за изменениями и удалением элемента (уведомления для WallCache)
+    virtual void WatchElement(const Guid& element) = 0;
+
+    // Строка отчёта (WriteReport)
+    virtual void Report(const char* text) = 0;
+};
+
+} // namespace HostApi
+
+#endif // HOSTAPI_HPP
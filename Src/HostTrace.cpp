@@ -0,0 +1,1025 @@
+// =============================================================================
+// HostTrace - Запись и повтор вызовов Archicad (трасса .castrace)
+// =============================================================================
+
+#include "HostTrace.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace HostTrace {
+
+using HostApi::ErrCode;
+using HostApi::NoError;
+
+typedef std::chrono::steady_clock Clock;
+
+static const char Magic[8] = { 'C', 'A', 'S', 'T', 'R', 'A', 'C', 'E' };
+static const size_t HeaderSize = sizeof(Magic) + 8;    // magic, version, reserved
+
+// Ответ Player после расхождения с трассой
+static const ErrCode ReplayError = -1;
+
+static uint64_t NanosecondsSince(Clock::time_point start)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+const char* GetOpName(Op op)
+{
+    switch (op) {
+        case Op::Workload:               return "Workload";
+        case Op::GetSelection:           return "GetSelection";
+        case Op::GetElemList:            return "GetElemList";
+        case Op::GetElement:             return "GetElement";
+        case Op::GetLibPartName:         return "GetLibPartName";
+        case Op::GetPropertyDefinitions: return "GetPropertyDefinitions";
+        case Op::GetPropertyValue:       return "GetPropertyValue";
+        case Op::OpenParameters:         return "OpenParameters";
+        case Op::GetParameters:          return "GetParameters";
+        case Op::ChangeParameter:        return "ChangeParameter";
+        case Op::CommitParameters:       return "CommitParameters";
+        case Op::CloseParameters:        return "CloseParameters";
+        case Op::RunUndoable:            return "RunUndoable";
+        case Op::FindLibPart:            return "FindLibPart";
+        case Op::CreateObjects:          return "CreateObjects";
+        default:                         return "?";
+    }
+}
+
+const char* GetWorkloadName(Workload workload)
+{
+    switch (workload) {
+        case Workload::ReadSelection:  return "ReadSelection";
+        case Workload::FindWallHeight: return "FindWallHeight";
+        case Workload::WriteTargets:   return "WriteTargets";
+        case Workload::PlaceObjects:   return "PlaceObjects";
+        default:                       return "?";
+    }
+}
+
+// =============================================================================
+// Recorder
+// =============================================================================
+
+class Recorder::Encoder {
+public:
+    explicit Encoder(Recorder& owner) : recorder(owner) {}
+
+    void U8(uint8_t value) { recorder.data.push_back(static_cast<char>(value)); }
+    void I32(int32_t value) { Raw(&value, sizeof(value)); }
+    void U32(uint32_t value) { Raw(&value, sizeof(value)); }
+    void U64(uint64_t value) { Raw(&value, sizeof(value)); }
+    void Double(double value) { Raw(&value, sizeof(value)); }
+
+    // Строка или GUID: при первом появлении - 0 и значение, дальше - номер + 1
+    void String(const std::string& value)
+    {
+        if (Interned(recorder.stringIndex, value)) {
+            return;
+        }
+        U32(static_cast<uint32_t>(value.size()));
+        Raw(value.data(), value.size());
+    }
+
+    void Guid(const HostApi::Guid& guid)
+    {
+        if (Interned(recorder.guidIndex, std::string(reinterpret_cast<const char*>(guid.bytes), sizeof(guid.bytes)))) {
+            return;
+        }
+        Raw(guid.bytes, sizeof(guid.bytes));
+    }
+
+    void Call(Op op)
+    {
+        U8(static_cast<uint8_t>(op));
+        recorder.calls++;
+    }
+
+    void Result(ErrCode err, uint64_t nanoseconds)
+    {
+        I32(err);
+        U64(nanoseconds);
+        recorder.callNs += nanoseconds;
+    }
+
+    void Guids(const std::vector<HostApi::Guid>& guids)
+    {
+        U32(static_cast<uint32_t>(guids.size()));
+        for (const HostApi::Guid& guid : guids) {
+            Guid(guid);
+        }
+    }
+
+    void Objects(const std::vector<HostApi::PlacedObject>& objects)
+    {
+        U32(static_cast<uint32_t>(objects.size()));
+        for (const HostApi::PlacedObject& object : objects) {
+            Double(object.x);
+            Double(object.y);
+            Double(object.level);
+            Double(object.angle);
+            I32(object.floorInd);
+            Double(object.a);
+            Double(object.b);
+            String(object.text);
+        }
+    }
+
+private:
+    void Raw(const void* bytes, size_t size)
+    {
+        recorder.data.append(static_cast<const char*>(bytes), size);
+    }
+
+    bool Interned(std::unordered_map<std::string, uint32_t>& index, const std::string& key)
+    {
+        auto it = index.find(key);
+        if (it != index.end()) {
+            U32(it->second + 1);
+            return true;
+        }
+        index.emplace(key, static_cast<uint32_t>(index.size()));
+        U32(0);
+        return false;
+    }
+
+    Recorder& recorder;
+};
+
+Recorder::Recorder(HostApi::Host& host) :
+    target(host),
+    calls(0),
+    callNs(0)
+{
+    data.append(Magic, sizeof(Magic));
+    const uint32_t header[2] = { Version, 0 };
+    data.append(reinterpret_cast<const char*>(header), sizeof(header));
+}
+
+void Recorder::BeginReadSelection()
+{
+    Encoder out(*this);
+    out.U8(static_cast<uint8_t>(Op::Workload));
+    out.U8(static_cast<uint8_t>(Workload::ReadSelection));
+}
+
+void Recorder::BeginFindWallHeight(const std::string& wallIdPattern)
+{
+    Encoder out(*this);
+    out.U8(static_cast<uint8_t>(Op::Workload));
+    out.U8(static_cast<uint8_t>(Workload::FindWallHeight));
+    out.String(wallIdPattern);
+}
+
+void Recorder::BeginWriteTargets(const CassetteCore::Result& result, const HostWorkload::Targets& targets)
+{
+    Encoder out(*this);
+    out.U8(static_cast<uint8_t>(Op::Workload));
+    out.U8(static_cast<uint8_t>(Workload::WriteTargets));
+
+    out.U32(static_cast<uint32_t>(result.cassettes.size()));
+    for (const CassetteCore::CassetteRow& row : result.cassettes) {
+        out.I32(row.x);
+        out.I32(row.y);
+        out.I32(row.count);
+    }
+    for (const std::vector<CassetteCore::PlankRow>* rows : { &result.planks, &result.leftSlopes, &result.rightSlopes }) {
+        out.U32(static_cast<uint32_t>(rows->size()));
+        for (const CassetteCore::PlankRow& row : *rows) {
+            out.I32(row.width);
+            out.I32(row.length);
+            out.I32(row.count);
+            out.I32(row.calcType);
+        }
+    }
+
+    for (const std::string* id : { &targets.plankId0, &targets.leftSlopeId0, &targets.rightSlopeId0,
+                                   &targets.cassetteId12, &targets.plankId12, &targets.leftSlopeId12, &targets.rightSlopeId12 }) {
+        out.String(*id);
+    }
+    out.U8(targets.overflowPages ? 1 : 0);
+}
+
+void Recorder::BeginPlaceObjects(const FacadePlacement::Layout& layout, const HostWorkload::LibParts& parts)
+{
+    Encoder out(*this);
+    out.U8(static_cast<uint8_t>(Op::Workload));
+    out.U8(static_cast<uint8_t>(Workload::PlaceObjects));
+    out.Objects(layout.cassettes);
+    out.Objects(layout.planks);
+    out.Objects(layout.slopes);
+    for (const std::string* name : { &parts.cassette, &parts.plank, &parts.slope, &parts.textParam }) {
+        out.String(*name);
+    }
+}
+
+ErrCode Recorder::GetSelection(std::vector<HostApi::Guid>& elements)
+{
+    const Clock::time_point start = Clock::now();
+    const ErrCode err = target.GetSelection(elements);
+    const uint64_t ns = NanosecondsSince(start);
+
+    Encoder out(*this);
+    out.Call(Op::GetSelection);
+    out.Result(err, ns);
+    out.Guids(elements);
+    return err;
+}
+
+ErrCode Recorder::GetElemList(HostApi::ElemType type, std::vector<HostApi::Guid>& elements)
+{
+    const Clock::time_point start = Clock::now();
+    const ErrCode err = target.GetElemList(type, elements);
+    const uint64_t ns = NanosecondsSince(start);
+
+    Encoder out(*this);
+    out.Call(Op::GetElemList);
+    out.I32(static_cast<int32_t>(type));
+    out.Result(err, ns);
+    out.Guids(elements);
+    return err;
+}
+
+ErrCode Recorder::GetElement(const HostApi::Guid& guid, HostApi::Element& element)
+{
+    const Clock::time_point start = Clock::now();
+    const ErrCode err = target.GetElement(guid, element);
+    const uint64_t ns = NanosecondsSince(start);
+
+    Encoder out(*this);
+    out.Call(Op::GetElement);
+    out.Guid(guid);
+    out.Result(err, ns);
+    out.Guid(element.guid);
+    out.I32(static_cast<int32_t>(element.type));
+    out.I32(element.floorInd);
+    out.Double(element.openingWidth);
+    out.Double(element.openingHeight);
+    out.Double(element.lower);
+    out.Double(element.wallHeight);
+    out.I32(element.libInd);
+    out.Guid(element.owner);
+    out.Double(element.objLoc);
+    out.Double(element.begX);
+    out.Double(element.begY);
+    out.Double(element.endX);
+    out.Double(element.endY);
+    out.Double(element.arcAngle);
+    out.U8(element.flipped ? 1 : 0);
+    return err;
+}
+
+ErrCode Recorder::GetLibPartName(int32_t libInd, std::string& name)
+{
+    const Clock::time_point start = Clock::now();
+    const ErrCode err = target.GetLibPartName(libInd, name);
+    const uint64_t ns = NanosecondsSince(start);
+
+    Encoder out(*this);
+    out.Call(Op::GetLibPartName);
+    out.I32(libInd);
+    out.Result(err, ns);
+    out.String(name);
+    return err;
+}
+
+ErrCode Recorder::SelectElements(const std::vector<HostApi::Guid>& elements)
+{
+    return target.SelectElements(elements);     // Не записывается: выделение не влияет на расчёт
+}
+
+ErrCode Recorder::GetPropertyDefinitions(const HostApi::Guid& element, HostApi::PropertyFilter filter, std::vector<HostApi::PropertyDefinition>& definitions)
+{
+    const Clock::time_point start = Clock::now();
+    const ErrCode err = target.GetPropertyDefinitions(element, filter, definitions);
+    const uint64_t ns = NanosecondsSince(start);
+
+    Encoder out(*this);
+    out.Call(Op::GetPropertyDefinitions);
+    out.Guid(element);
+    out.I32(static_cast<int32_t>(filter));
+    out.Result(err, ns);
+    out.U32(static_cast<uint32_t>(definitions.size()));
+    for (const HostApi::PropertyDefinition& def : definitions) {
+        out.Guid(def.guid);
+        out.String(def.name);
+    }
+    return err;
+}
+
+ErrCode Recorder::GetPropertyValue(const HostApi::Guid& element, const HostApi::Guid& definition, HostApi::PropertyValue& value)
+{
+    const Clock::time_point start = Clock::now();
+    const ErrCode err = target.GetPropertyValue(element, definition, value);
+    const uint64_t ns = NanosecondsSince(start);
+
+    Encoder out(*this);
+    out.Call(Op::GetPropertyValue);
+    out.Guid(element);
+    out.Guid(definition);
+    out.Result(err, ns);
+    out.U8(value.isDefault ? 1 : 0);
+    out.U8(value.isString ? 1 : 0);
+    out.String(value.text);
+    return err;
+}
+
+ErrCode Recorder::OpenParameters(const HostApi::Guid& element, HostApi::ElemType type)
+{
+    const Clock::time_point start = Clock::now();
+    const ErrCode err = target.OpenParameters(element, type);
+    const uint64_t ns = NanosecondsSince(start);
+
+    Encoder out(*this);
+    out.Call(Op::OpenParameters);
+    out.Guid(element);
+    out.I32(static_cast<int32_t>(type));
+    out.Result(err, ns);
+    return err;
+}
+
+ErrCode Recorder::GetParameters(std::vector<HostApi::Parameter>& parameters)
+{
+    const Clock::time_point start = Clock::now();
+    const ErrCode err = target.GetParameters(parameters);
+    const uint64_t ns = NanosecondsSince(start);
+
+    Encoder out(*this);
+    out.Call(Op::GetParameters);
+    out.Result(err, ns);
+    out.U32(static_cast<uint32_t>(parameters.size()));
+    for (const HostApi::Parameter& par : parameters) {
+        out.String(par.name);
+        out.I32(par.index);
+        out.I32(par.typeID);
+    }
+    return err;
+}
+
+ErrCode Recorder::ChangeParameter(int32_t index, const std::string& value)
+{
+    const Clock::time_point start = Clock::now();
+    const ErrCode err = target.ChangeParameter(index, value);
+    const uint64_t ns = NanosecondsSince(start);
+
+    Encoder out(*this);
+    out.Call(Op::ChangeParameter);
+    out.I32(index);
+    out.String(value);
+    out.Result(err, ns);
+    return err;
+}
+
+ErrCode Recorder::CommitParameters(const HostApi::Guid& element, bool apply)
+{
+    const Clock::time_point start = Clock::now();
+    const ErrCode err = target.CommitParameters(element, apply);
+    const uint64_t ns = NanosecondsSince(start);
+
+    Encoder out(*this);
+    out.Call(Op::CommitParameters);
+    out.Guid(element);
+    out.U8(apply ? 1 : 0);
+    out.Result(err, ns);
+    return err;
+}
+
+void Recorder::CloseParameters()
+{
+    const Clock::time_point start = Clock::now();
+    target.CloseParameters();
+    const uint64_t ns = NanosecondsSince(start);
+
+    Encoder out(*this);
+    out.Call(Op::CloseParameters);
+    out.Result(NoError, ns);
+}
+
+ErrCode Recorder::RunUndoable(const std::string& name, const std::function<ErrCode()>& action)
+{
+    // action вызывает этот же Recorder, вложенные вызовы пишутся как обычно
+    const uint64_t nestedBefore = callNs;
+    const Clock::time_point start = Clock::now();
+    const ErrCode err = target.RunUndoable(name, action);
+    const uint64_t ns = NanosecondsSince(start);
+    const uint64_t nested = callNs - nestedBefore;
+
+    Encoder out(*this);
+    out.Call(Op::RunUndoable);
+    out.String(name);
+    out.Result(err, ns > nested ? ns - nested : 0);
+    return err;
+}
+
+ErrCode Recorder::FindLibPart(const std::string& name, int32_t& libInd)
+{
+    const Clock::time_point start = Clock::now();
+    const ErrCode err = target.FindLibPart(name, libInd);
+    const uint64_t ns = NanosecondsSince(start);
+
+    Encoder out(*this);
+    out.Call(Op::FindLibPart);
+    out.String(name);
+    out.Result(err, ns);
+    out.I32(libInd);
+    return err;
+}
+
+ErrCode Recorder::CreateObjects(int32_t libInd, const std::string& textParam,
+                                const std::vector<HostApi::PlacedObject>& objects, std::vector<HostApi::Guid>& created)
+{
+    const Clock::time_point start = Clock::now();
+    const ErrCode err = target.CreateObjects(libInd, textParam, objects, created);
+    const uint64_t ns = NanosecondsSince(start);
+
+    Encoder out(*this);
+    out.Call(Op::CreateObjects);
+    out.I32(libInd);
+    out.String(textParam);
+    out.Objects(objects);
+    out.Result(err, ns);
+    out.Guids(created);
+    return err;
+}
+
+void Recorder::WatchElement(const HostApi::Guid& element)
+{
+    target.WatchElement(element);   // Не записывается: при записи трассы кэш стен не используется
+}
+
+void Recorder::Report(const char* text)
+{
+    target.Report(text);     // Отчёт не записывается: при повторе его строит та же логика
+}
+
+// =============================================================================
+// Player
+// =============================================================================
+
+// Чтение записи; при выходе за конец трассы Player переходит в состояние расхождения
+class Player::Decoder {
+public:
+    explicit Decoder(Player& owner) : player(owner) {}
+
+    uint8_t U8() { uint8_t value = 0; Raw(&value, sizeof(value)); return value; }
+    int32_t I32() { int32_t value = 0; Raw(&value, sizeof(value)); return value; }
+    uint32_t U32() { uint32_t value = 0; Raw(&value, sizeof(value)); return value; }
+    uint64_t U64() { uint64_t value = 0; Raw(&value, sizeof(value)); return value; }
+    double Double() { double value = 0.0; Raw(&value, sizeof(value)); return value; }
+
+    void String(std::string& value)
+    {
+        const uint32_t ref = U32();
+        if (ref != 0) {
+            if (ref > player.strings.size()) {
+                player.Diverged("неверный номер строки");
+                value.clear();
+                return;
+            }
+            value = player.strings[ref - 1];
+            return;
+        }
+        const uint32_t size = U32();
+        if (static_cast<size_t>(player.end - player.position) < size) {
+            player.Diverged("трасса обрезана");
+            value.clear();
+            return;
+        }
+        value.assign(player.position, size);
+        player.position += size;
+        player.strings.push_back(value);
+    }
+
+    void Guid(HostApi::Guid& guid)
+    {
+        const uint32_t ref = U32();
+        if (ref != 0) {
+            if (ref > player.guids.size()) {
+                player.Diverged("неверный номер GUID");
+                std::memset(guid.bytes, 0, sizeof(guid.bytes));
+                return;
+            }
+            guid = player.guids[ref - 1];
+            return;
+        }
+        Raw(guid.bytes, sizeof(guid.bytes));
+        player.guids.push_back(guid);
+    }
+
+    void Guids(std::vector<HostApi::Guid>& guids)
+    {
+        const uint32_t count = U32();
+        guids.clear();
+        for (uint32_t i = 0; i < count && !player.failed; ++i) {
+            HostApi::Guid guid;
+            Guid(guid);
+            guids.push_back(guid);
+        }
+    }
+
+    void Objects(std::vector<HostApi::PlacedObject>& objects)
+    {
+        const uint32_t count = U32();
+        objects.clear();
+        for (uint32_t i = 0; i < count && !player.failed; ++i) {
+            HostApi::PlacedObject object;
+            object.x = Double();
+            object.y = Double();
+            object.level = Double();
+            object.angle = Double();
+            object.floorInd = I32();
+            object.a = Double();
+            object.b = Double();
+            String(object.text);
+            objects.push_back(object);
+        }
+    }
+
+    // Аргументы вызова должны совпасть с записанными
+    void MatchObjects(const std::vector<HostApi::PlacedObject>& expected)
+    {
+        std::vector<HostApi::PlacedObject> recorded;
+        Objects(recorded);
+        bool same = recorded.size() == expected.size();
+        for (size_t i = 0; same && i < recorded.size(); ++i) {
+            const HostApi::PlacedObject& r = recorded[i];
+            const HostApi::PlacedObject& e = expected[i];
+            same = r.x == e.x && r.y == e.y && r.level == e.level && r.angle == e.angle &&
+                   r.floorInd == e.floorInd && r.a == e.a && r.b == e.b && r.text == e.text;
+        }
+        if (!same) {
+            player.Diverged("другие объекты в аргументах");
+        }
+    }
+
+    void MatchGuid(const HostApi::Guid& expected)
+    {
+        HostApi::Guid recorded;
+        Guid(recorded);
+        if (recorded != expected) {
+            player.Diverged("другой GUID в аргументах");
+        }
+    }
+
+    void MatchI32(int32_t expected)
+    {
+        if (I32() != expected) {
+            player.Diverged("другое число в аргументах");
+        }
+    }
+
+    void MatchString(const std::string& expected)
+    {
+        std::string recorded;
+        String(recorded);
+        if (recorded != expected) {
+            player.Diverged("другая строка в аргументах");
+        }
+    }
+
+    // Код ошибки и время вызова при записи
+    ErrCode Result(Op op)
+    {
+        const ErrCode err = I32();
+        const uint64_t ns = U64();
+        if (player.stats != nullptr) {
+            OpStats& opStats = player.stats->ops[static_cast<size_t>(op)];
+            opStats.calls++;
+            opStats.recordedNs += ns;
+        }
+        if (player.run != nullptr) {
+            player.run->calls++;
+            player.run->recordedNs += ns;
+        }
+        return err;
+    }
+
+private:
+    void Raw(void* value, size_t size)
+    {
+        if (player.failed) {
+            return;
+        }
+        if (static_cast<size_t>(player.end - player.position) < size) {
+            player.Diverged("трасса обрезана");
+            return;
+        }
+        std::memcpy(value, player.position, size);
+        player.position += size;
+    }
+
+    Player& player;
+};
+
+Player::Player() :
+    begin(nullptr),
+    position(nullptr),
+    end(nullptr),
+    version(0),
+    failed(false),
+    echoReport(false),
+    stats(nullptr),
+    run(nullptr)
+{
+}
+
+bool Player::Open(const char* data, size_t size, std::string& error)
+{
+    if (size < HeaderSize || std::memcmp(data, Magic, sizeof(Magic)) != 0) {
+        error = "Файл не является трассой вызовов (.castrace)";
+        return false;
+    }
+    version = 0;
+    std::memcpy(&version, data + sizeof(Magic), sizeof(version));
+    if (version == 0 || version > Version) {
+        error = "Версия трассы " + std::to_string(version) + " не поддерживается";
+        return false;
+    }
+
+    begin = data;
+    position = data + HeaderSize;
+    end = data + size;
+    return true;
+}
+
+bool Player::Diverged(const char* what)
+{
+    if (!failed) {
+        failed = true;
+        failure = "Расхождение с трассой (смещение " + std::to_string(position - begin);
+        if (run != nullptr) {
+            failure += std::string(", операция ") + GetWorkloadName(run->workload);
+        }
+        failure += std::string("): ") + what;
+    }
+    return false;
+}
+
+bool Player::Expect(Op op)
+{
+    if (failed) {
+        return false;
+    }
+    if (position >= end || static_cast<Op>(*position) == Op::Workload) {
+        return Diverged((std::string("лишний вызов ") + GetOpName(op)).c_str());
+    }
+    const Op recorded = static_cast<Op>(*position);
+    if (recorded != op) {
+        return Diverged((std::string("вызов ") + GetOpName(op) + " вместо " + GetOpName(recorded)).c_str());
+    }
+    ++position;
+    return true;
+}
+
+ErrCode Player::Finish(ErrCode err)
+{
+    return failed ? ReplayError : err;
+}
+
+bool Player::Replay(ReplayStats& result, std::string& error)
+{
+    result = ReplayStats();
+    stats = &result;
+    run = nullptr;
+    position = begin + HeaderSize;
+    failed = false;
+    failure.clear();
+    strings.clear();
+    guids.clear();
+
+    while (!failed && position < end) {
+        Decoder in(*this);
+        if (static_cast<Op>(in.U8()) != Op::Workload) {
+            Diverged("ожидался маркер операции аддона");
+            break;
+        }
+
+        WorkloadRun current = {};
+        current.workload = static_cast<Workload>(in.U8());
+
+        // Входные данные операции
+        std::string wallIdPattern;
+        CassetteCore::Result calcResult;
+        HostWorkload::Targets targets;
+        FacadePlacement::Layout layout;
+        HostWorkload::LibParts parts;
+        switch (current.workload) {
+            case Workload::ReadSelection:
+                break;
+            case Workload::FindWallHeight:
+                in.String(wallIdPattern);
+                break;
+            case Workload::WriteTargets: {
+                const uint32_t cassettes = in.U32();
+                for (uint32_t i = 0; i < cassettes && !failed; ++i) {
+                    CassetteCore::CassetteRow row;
+                    row.x = in.I32();
+                    row.y = in.I32();
+                    row.count = in.I32();
+                    calcResult.cassettes.push_back(row);
+                }
+                for (std::vector<CassetteCore::PlankRow>* rows : { &calcResult.planks, &calcResult.leftSlopes, &calcResult.rightSlopes }) {
+                    const uint32_t count = in.U32();
+                    for (uint32_t i = 0; i < count && !failed; ++i) {
+                        CassetteCore::PlankRow row;
+                        row.width = in.I32();
+                        row.length = in.I32();
+                        row.count = in.I32();
+                        row.calcType = in.I32();
+                        rows->push_back(row);
+                    }
+                }
+                for (std::string* id : { &targets.plankId0, &targets.leftSlopeId0, &targets.rightSlopeId0,
+                                         &targets.cassetteId12, &targets.plankId12, &targets.leftSlopeId12, &targets.rightSlopeId12 }) {
+                    in.String(*id);
+                }
+                targets.overflowPages = version >= 2 && in.U8() != 0;
+                break;
+            }
+            case Workload::PlaceObjects:
+                in.Objects(layout.cassettes);
+                in.Objects(layout.planks);
+                in.Objects(layout.slopes);
+                for (std::string* name : { &parts.cassette, &parts.plank, &parts.slope, &parts.textParam }) {
+                    in.String(*name);
+                }
+                break;
+            default:
+                Diverged("неизвестная операция аддона");
+                break;
+        }
+        if (failed) {
+            break;
+        }
+
+        result.runs.push_back(current);
+        run = &result.runs.back();
+
+        const Clock::time_point start = Clock::now();
+        switch (current.workload) {
+            case Workload::ReadSelection: {
+                std::vector<HostWorkload::Opening> openings;
+                HostWorkload::ReadSelectedOpenings(*this, openings);
+                run->outcome = openings.size();
+                break;
+            }
+            case Workload::FindWallHeight:
+                run->outcome = HostWorkload::FindWallHeight(*this, wallIdPattern) > 0.0 ? 1 : 0;
+                break;
+            case Workload::WriteTargets:
+                run->outcome = HostWorkload::WriteTargets(*this, calcResult, targets) ? 1 : 0;
+                break;
+            case Workload::PlaceObjects: {
+                size_t created = 0;
+                HostWorkload::PlaceObjects(*this, layout, parts, created);
+                run->outcome = created;
+                break;
+            }
+        }
+        run->replayMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        // Операция должна использовать все свои записанные вызовы
+        if (!failed && position < end && static_cast<Op>(*position) != Op::Workload) {
+            Diverged((std::string("не повторён вызов ") + GetOpName(static_cast<Op>(*position))).c_str());
+        }
+    }
+
+    run = nullptr;
+    stats = nullptr;
+    if (failed) {
+        error = failure;
+    }
+    return !failed;
+}
+
+ErrCode Player::GetSelection(std::vector<HostApi::Guid>& elements)
+{
+    elements.clear();
+    if (!Expect(Op::GetSelection)) {
+        return ReplayError;
+    }
+    Decoder in(*this);
+    const ErrCode err = in.Result(Op::GetSelection);
+    in.Guids(elements);
+    return Finish(err);
+}
+
+ErrCode Player::GetElemList(HostApi::ElemType type, std::vector<HostApi::Guid>& elements)
+{
+    elements.clear();
+    if (!Expect(Op::GetElemList)) {
+        return ReplayError;
+    }
+    Decoder in(*this);
+    in.MatchI32(static_cast<int32_t>(type));
+    const ErrCode err = in.Result(Op::GetElemList);
+    in.Guids(elements);
+    return Finish(err);
+}
+
+ErrCode Player::GetElement(const HostApi::Guid& guid, HostApi::Element& element)
+{
+    if (!Expect(Op::GetElement)) {
+        return ReplayError;
+    }
+    element = HostApi::Element();
+    Decoder in(*this);
+    in.MatchGuid(guid);
+    const ErrCode err = in.Result(Op::GetElement);
+    in.Guid(element.guid);
+    element.type = static_cast<HostApi::ElemType>(in.I32());
+    element.floorInd = in.I32();
+    element.openingWidth = in.Double();
+    element.openingHeight = in.Double();
+    element.lower = in.Double();
+    element.wallHeight = in.Double();
+    element.libInd = in.I32();
+    if (version >= 4) {
+        in.Guid(element.owner);
+        element.objLoc = in.Double();
+        element.begX = in.Double();
+        element.begY = in.Double();
+        element.endX = in.Double();
+        element.endY = in.Double();
+    }
+    if (version >= 5) {
+        element.arcAngle = in.Double();
+        element.flipped = in.U8() != 0;
+    }
+    return Finish(err);
+}
+
+ErrCode Player::GetLibPartName(int32_t libInd, std::string& name)
+{
+    name.clear();
+    if (!Expect(Op::GetLibPartName)) {
+        return ReplayError;
+    }
+    Decoder in(*this);
+    in.MatchI32(libInd);
+    const ErrCode err = in.Result(Op::GetLibPartName);
+    in.String(name);
+    return Finish(err);
+}
+
+ErrCode Player::SelectElements(const std::vector<HostApi::Guid>&)
+{
+    return NoError;
+}
+
+ErrCode Player::GetPropertyDefinitions(const HostApi::Guid& element, HostApi::PropertyFilter filter, std::vector<HostApi::PropertyDefinition>& definitions)
+{
+    definitions.clear();
+    if (!Expect(Op::GetPropertyDefinitions)) {
+        return ReplayError;
+    }
+    Decoder in(*this);
+    in.MatchGuid(element);
+    in.MatchI32(static_cast<int32_t>(filter));
+    const ErrCode err = in.Result(Op::GetPropertyDefinitions);
+    const uint32_t count = in.U32();
+    for (uint32_t i = 0; i < count && !failed; ++i) {
+        HostApi::PropertyDefinition def;
+        in.Guid(def.guid);
+        in.String(def.name);
+        definitions.push_back(def);
+    }
+    return Finish(err);
+}
+
+ErrCode Player::GetPropertyValue(const HostApi::Guid& element, const HostApi::Guid& definition, HostApi::PropertyValue& value)
+{
+    value.isDefault = true;
+    value.isString = false;
+    value.text.clear();
+    if (!Expect(Op::GetPropertyValue)) {
+        return ReplayError;
+    }
+    Decoder in(*this);
+    in.MatchGuid(element);
+    in.MatchGuid(definition);
+    const ErrCode err = in.Result(Op::GetPropertyValue);
+    value.isDefault = in.U8() != 0;
+    value.isString = in.U8() != 0;
+    in.String(value.text);
+    return Finish(err);
+}
+
+ErrCode Player::OpenParameters(const HostApi::Guid& element, HostApi::ElemType type)
+{
+    if (!Expect(Op::OpenParameters)) {
+        return ReplayError;
+    }
+    Decoder in(*this);
+    in.MatchGuid(element);
+    in.MatchI32(static_cast<int32_t>(type));
+    return Finish(in.Result(Op::OpenParameters));
+}
+
+ErrCode Player::GetParameters(std::vector<HostApi::Parameter>& parameters)
+{
+    parameters.clear();
+    if (!Expect(Op::GetParameters)) {
+        return ReplayError;
+    }
+    Decoder in(*this);
+    const ErrCode err = in.Result(Op::GetParameters);
+    const uint32_t count = in.U32();
+    for (uint32_t i = 0; i < count && !failed; ++i) {
+        HostApi::Parameter par;
+        in.String(par.name);
+        par.index = in.I32();
+        par.typeID = in.I32();
+        parameters.push_back(par);
+    }
+    return Finish(err);
+}
+
+ErrCode Player::ChangeParameter(int32_t index, const std::string& value)
+{
+    if (!Expect(Op::ChangeParameter)) {
+        return ReplayError;
+    }
+    Decoder in(*this);
+    in.MatchI32(index);
+    in.MatchString(value);
+    return Finish(in.Result(Op::ChangeParameter));
+}
+
+ErrCode Player::CommitParameters(const HostApi::Guid& element, bool apply)
+{
+    if (!Expect(Op::CommitParameters)) {
+        return ReplayError;
+    }
+    Decoder in(*this);
+    in.MatchGuid(element);
+    if ((in.U8() != 0) != apply) {
+        Diverged("другой признак применения параметров");
+    }
+    return Finish(in.Result(Op::CommitParameters));
+}
+
+void Player::CloseParameters()
+{
+    if (Expect(Op::CloseParameters)) {
+        Decoder in(*this);
+        in.Result(Op::CloseParameters);
+    }
+}
+
+ErrCode Player::RunUndoable(const std::string& name, const std::function<ErrCode()>& action)
+{
+    // Вложенные вызовы в трассе идут до записи RunUndoable
+    const ErrCode actionErr = action();
+    if (!Expect(Op::RunUndoable)) {
+        return ReplayError;
+    }
+    Decoder in(*this);
+    in.MatchString(name);
+    const ErrCode err = in.Result(Op::RunUndoable);
+    return Finish(err != NoError ? err : actionErr);
+}
+
+ErrCode Player::FindLibPart(const std::string& name, int32_t& libInd)
+{
+    libInd = 0;
+    if (!Expect(Op::FindLibPart)) {
+        return ReplayError;
+    }
+    Decoder in(*this);
+    in.MatchString(name);
+    const ErrCode err = in.Result(Op::FindLibPart);
+    libInd = in.I32();
+    return Finish(err);
+}
+
+ErrCode Player::CreateObjects(int32_t libInd, const std::string& textParam,
+                              const std::vector<HostApi::PlacedObject>& objects, std::vector<HostApi::Guid>& created)
+{
+    created.clear();
+    if (!Expect(Op::CreateObjects)) {
+        return ReplayError;
+    }
+    Decoder in(*this);
+    in.MatchI32(libInd);
+    in.MatchString(textParam);
+    in.MatchObjects(objects);
+    const ErrCode err = in.Result(Op::CreateObjects);
+    in.Guids(created);
+    return Finish(err);
+}
+
+void Player::WatchElement(const HostApi::Guid&)
+{
+}
+
+void Player::Report(const char* text)
+{
+    if (echoReport) {
+        std::printf("%s\n", text);
+    }
+}
+
+} // namespace HostTrace
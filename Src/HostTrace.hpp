@@ -0,0 +1,192 @@
+#ifndef HOSTTRACE_HPP
+#define HOSTTRACE_HPP
+
+// =============================================================================
+// HostTrace - Запись и повтор вызовов Archicad (трасса .castrace)
+// =============================================================================
+// Recorder оборачивает настоящий Host: каждый вызов передаётся дальше, а его
+// аргументы, код ошибки, время и ответ дописываются в трассу. Перед каждой
+// операцией аддона (чтение выделения, поиск стены, запись в объекты,
+// размещение объектов) в трассу пишется маркер с её входными данными.
+// Player читает трассу и сам является Host: повторяет операции через
+// HostWorkload и отвечает записанными данными. Вызовы должны идти в том же
+// порядке и с теми же аргументами; при расхождении повтор останавливается.
+// Так тяжёлую сессию заказчика можно повторить и профилировать без его .pln.
+//
+// Формат: "CASTRACE", версия, затем записи: код операции, аргументы, код
+// ошибки, время вызова (нс), ответ. Строки и GUID пишутся один раз, дальше -
+// номером. Все числа little-endian.
+// Модуль не зависит от Archicad API (только стандартная библиотека).
+
+#include "HostApi.hpp"
+#include "HostWorkload.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace HostTrace {
+
+const uint32_t Version = 5;    // 2 - RunUndoable, признак страниц в WriteTargets; 3 - размещение объектов;
+                                // 4 - стена проёма и линия привязки стены в GetElement;
+                                // 5 - дуга и отражение стены в GetElement
+
+// Код записи в трассе
+enum class Op : uint8_t {
+    Workload = 0,           // Маркер операции аддона
+    GetSelection,
+    GetElemList,
+    GetElement,
+    GetLibPartName,
+    GetPropertyDefinitions,
+    GetPropertyValue,
+    OpenParameters,
+    GetParameters,
+    ChangeParameter,
+    CommitParameters,
+    CloseParameters,
+    RunUndoable,            // Пишется после вложенных вызовов, время - без них
+    FindLibPart,
+    CreateObjects,
+    Count
+};
+
+// Операции аддона, которые повторяет Player
+enum class Workload : uint8_t {
+    ReadSelection = 1,      // CassetteHelper::GetSelectedWindowsDoors
+    FindWallHeight = 2,     // CassetteHelper::GetFloorHeightFromWall
+    WriteTargets = 3,       // CassetteHelper::WriteToTargetObjects
+    PlaceObjects = 4        // CassetteHelper::PlaceFacadeObjects
+};
+
+const char* GetOpName(Op op);
+const char* GetWorkloadName(Workload workload);
+
+// =============================================================================
+// Recorder
+// =============================================================================
+
+class Recorder : public HostApi::Host {
+public:
+    explicit Recorder(HostApi::Host& target);
+
+    // Маркеры операций аддона (до первого вызова операции)
+    void BeginReadSelection();
+    void BeginFindWallHeight(const std::string& wallIdPattern);
+    void BeginWriteTargets(const CassetteCore::Result& result, const HostWorkload::Targets& targets);
+    void BeginPlaceObjects(const FacadePlacement::Layout& layout, const HostWorkload::LibParts& parts);
+
+    uint64_t GetCallCount() const { return calls; }
+    const std::string& GetData() const { return data; }
+
+    HostApi::ErrCode GetSelection(std::vector<HostApi::Guid>& elements) override;
+    HostApi::ErrCode GetElemList(HostApi::ElemType type, std::vector<HostApi::Guid>& elements) override;
+    HostApi::ErrCode GetElement(const HostApi::Guid& guid, HostApi::Element& element) override;
+    HostApi::ErrCode GetLibPartName(int32_t libInd, std::string& name) override;
+    HostApi::ErrCode SelectElements(const std::vector<HostApi::Guid>& elements) override;
+    HostApi::ErrCode GetPropertyDefinitions(const HostApi::Guid& element, HostApi::PropertyFilter filter, std::vector<HostApi::PropertyDefinition>& definitions) override;
+    HostApi::ErrCode GetPropertyValue(const HostApi::Guid& element, const HostApi::Guid& definition, HostApi::PropertyValue& value) override;
+    HostApi::ErrCode OpenParameters(const HostApi::Guid& element, HostApi::ElemType type) override;
+    HostApi::ErrCode GetParameters(std::vector<HostApi::Parameter>& parameters) override;
+    HostApi::ErrCode ChangeParameter(int32_t index, const std::string& value) override;
+    HostApi::ErrCode CommitParameters(const HostApi::Guid& element, bool apply) override;
+    void CloseParameters() override;
+    HostApi::ErrCode RunUndoable(const std::string& name, const std::function<HostApi::ErrCode()>& action) override;
+    HostApi::ErrCode FindLibPart(const std::string& name, int32_t& libInd) override;
+    HostApi::ErrCode CreateObjects(int32_t libInd, const std::string& textParam,
+                                   const std::vector<HostApi::PlacedObject>& objects, std::vector<HostApi::Guid>& created) override;
+    void WatchElement(const HostApi::Guid& element) override;
+    void Report(const char* text) override;
+
+private:
+    class Encoder;
+
+    HostApi::Host& target;
+    std::string data;
+    uint64_t calls;
+    uint64_t callNs;            // Сумма времени записанных вызовов
+    std::unordered_map<std::string, uint32_t> stringIndex;
+    std::unordered_map<std::string, uint32_t> guidIndex;    // 16 байт GUID -> номер
+};
+
+// =============================================================================
+// Player
+// =============================================================================
+
+struct OpStats {
+    uint64_t calls;
+    uint64_t recordedNs;        // Время вызовов в Archicad при записи
+};
+
+struct WorkloadRun {
+    Workload workload;
+    uint64_t calls;
+    uint64_t recordedNs;        // Время вызовов Archicad при записи
+    double replayMs;            // Время операции при повторе (логика аддона без Archicad)
+    size_t outcome;             // ReadSelection - окон; PlaceObjects - создано объектов;
+                                // FindWallHeight, WriteTargets - 1 при успехе
+};
+
+struct ReplayStats {
+    OpStats ops[static_cast<size_t>(Op::Count)];
+    std::vector<WorkloadRun> runs;
+};
+
+class Player : public HostApi::Host {
+public:
+    Player();
+
+    // data должна жить, пока используется Player
+    bool Open(const char* data, size_t size, std::string& error);
+
+    // Повторить все операции трассы; false - вызовы разошлись с записью
+    bool Replay(ReplayStats& stats, std::string& error);
+
+    // Вывод отчёта аддона (WriteReport) в stdout
+    void SetEchoReport(bool echo) { echoReport = echo; }
+
+    HostApi::ErrCode GetSelection(std::vector<HostApi::Guid>& elements) override;
+    HostApi::ErrCode GetElemList(HostApi::ElemType type, std::vector<HostApi::Guid>& elements) override;
+    HostApi::ErrCode GetElement(const HostApi::Guid& guid, HostApi::Element& element) override;
+    HostApi::ErrCode GetLibPartName(int32_t libInd, std::string& name) override;
+    HostApi::ErrCode SelectElements(const std::vector<HostApi::Guid>& elements) override;
+    HostApi::ErrCode GetPropertyDefinitions(const HostApi::Guid& element, HostApi::PropertyFilter filter, std::vector<HostApi::PropertyDefinition>& definitions) override;
+    HostApi::ErrCode GetPropertyValue(const HostApi::Guid& element, const HostApi::Guid& definition, HostApi::PropertyValue& value) override;
+    HostApi::ErrCode OpenParameters(const HostApi::Guid& element, HostApi::ElemType type) override;
+    HostApi::ErrCode GetParameters(std::vector<HostApi::Parameter>& parameters) override;
+    HostApi::ErrCode ChangeParameter(int32_t index, const std::string& value) override;
+    HostApi::ErrCode CommitParameters(const HostApi::Guid& element, bool apply) override;
+    void CloseParameters() override;
+    HostApi::ErrCode RunUndoable(const std::string& name, const std::function<HostApi::ErrCode()>& action) override;
+    HostApi::ErrCode FindLibPart(const std::string& name, int32_t& libInd) override;
+    HostApi::ErrCode CreateObjects(int32_t libInd, const std::string& textParam,
+                                   const std::vector<HostApi::PlacedObject>& objects, std::vector<HostApi::Guid>& created) override;
+    void WatchElement(const HostApi::Guid& element) override;
+    void Report(const char* text) override;
+
+private:
+    class Decoder;
+
+    // Начать ответ на вызов op; false - трасса разошлась (ответ - ошибка)
+    bool Expect(Op op);
+    bool Diverged(const char* what);
+    HostApi::ErrCode Finish(HostApi::ErrCode err);
+
+    const char* begin;
+    const char* position;
+    const char* end;
+    uint32_t version;
+    bool failed;
+    bool echoReport;
+    std::string failure;
+    ReplayStats* stats;
+    WorkloadRun* run;
+    std::vector<std::string> strings;
+    std::vector<HostApi::Guid> guids;
+};
+
+} // namespace HostTrace
+
+#endif // HOSTTRACE_HPP
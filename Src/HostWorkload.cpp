@@ -0,0 +1,794 @@
+// =============================================================================
+// HostWorkload - Чтение окон, поиск стены и запись в GDL объекты через Host
+// =============================================================================
+
+#include "HostWorkload.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <map>
+
+namespace HostWorkload {
+
+using HostApi::ErrCode;
+using HostApi::Guid;
+using HostApi::Host;
+using HostApi::NoError;
+
+// Код ошибки действия RunUndoable: хотя бы один объект не записан
+static const ErrCode WriteFailed = -1;
+
+// =============================================================================
+// Вспомогательные функции
+// =============================================================================
+
+static void Report(Host& host, const char* format, ...)
+{
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    host.Report(buffer);
+}
+
+std::string GuidToString(const Guid& guid)
+{
+    // API_Guid: time_low (4), time_mid (2), time_hi (2) little-endian, затем 8 байт как есть
+    const uint8_t* b = guid.bytes;
+    char buffer[40];
+    std::snprintf(buffer, sizeof(buffer), "%02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X",
+        b[3], b[2], b[1], b[0], b[5], b[4], b[7], b[6],
+        b[8], b[9], b[10], b[11], b[12], b[13], b[14], b[15]);
+    return buffer;
+}
+
+// Строчные буквы для ASCII и кириллицы в UTF-8 (А-Я, Ё)
+static std::string ToLower(const std::string& text)
+{
+    std::string lower(text);
+    for (size_t i = 0; i < lower.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(lower[i]);
+        if (c >= 'A' && c <= 'Z') {
+            lower[i] = static_cast<char>(c - 'A' + 'a');
+        } else if (c == 0xD0 && i + 1 < lower.size()) {
+            unsigned char next = static_cast<unsigned char>(lower[i + 1]);
+            if (next >= 0x90 && next <= 0x9F) {         // А-П -> а-п
+                lower[i + 1] = static_cast<char>(next + 0x20);
+            } else if (next >= 0xA0 && next <= 0xAF) {  // Р-Я -> р-я
+                lower[i] = static_cast<char>(0xD1);
+                lower[i + 1] = static_cast<char>(next - 0x20);
+            } else if (next == 0x81) {                  // Ё -> ё
+                lower[i] = static_cast<char>(0xD1);
+                lower[i + 1] = static_cast<char>(0x91);
+            }
+            ++i;
+        }
+    }
+    return lower;
+}
+
+static bool Contains(const std::string& text, const char* part)
+{
+    return text.find(part) != std::string::npos;
+}
+
+// Свойство с ID элемента: имя содержит "ID", "id", "ИД" или "идентификатор"
+static bool IsIdProperty(const std::string& name)
+{
+    return Contains(name, "ID") || Contains(name, "id") ||
+           Contains(name, "ИД") || Contains(name, "идентификатор");
+}
+
+// То же без учёта регистра ("идентификатор" содержит "ид")
+static bool IsIdPropertyIgnoreCase(const std::string& name)
+{
+    const std::string lower = ToLower(name);
+    return Contains(lower, "id") || Contains(lower, "ид");
+}
+
+// Строковое значение первого непустого свойства ID из definitions
+static bool ReadIdValue(Host& host, const Guid& element, const std::vector<HostApi::PropertyDefinition>& definitions, std::string& id)
+{
+    HostApi::PropertyValue value;
+    for (const HostApi::PropertyDefinition& def : definitions) {
+        if (!IsIdProperty(def.name)) {
+            continue;
+        }
+        if (host.GetPropertyValue(element, def.guid, value) == NoError && !value.isDefault && value.isString) {
+            id = value.text;
+            return true;
+        }
+    }
+    return false;
+}
+
+static const double Pi = 3.14159265358979323846;
+
+// Линия привязки стены: отрезок или дуга. Наружная сторона - слева по ходу
+// стены от начала к концу (контур рисуется по часовой стрелке, линия привязки -
+// по наружной грани, тело стены - справа); у отражённой стены (flipped) - справа
+struct WallLine {
+    bool valid;
+    bool arc;
+    double begX;                // Отрезок: начало и единичный вектор к концу
+    double begY;
+    double dirX;
+    double dirY;
+    double centerX;             // Дуга: центр, радиус, угол начала на окружности
+    double centerY;
+    double radius;
+    double begPhi;
+    double turn;                // Обход дуги: +1 - против часовой, -1 - по часовой
+    double outward;             // Наружная нормаль: +1 - слева по ходу стены, -1 - справа
+};
+
+// Точка на линии привязки: координаты, направление стены и наружная нормаль
+struct WallPoint {
+    double x;
+    double y;
+    double angle;
+    double normal;
+};
+
+static WallLine MakeWallLine(double begX, double begY, double endX, double endY, double arcAngle, bool flipped)
+{
+    WallLine line = {};
+    const double dx = endX - begX;
+    const double dy = endY - begY;
+    const double length = std::sqrt(dx * dx + dy * dy);
+    if (length > 0.0) {
+        line.valid = true;
+        line.begX = begX;
+        line.begY = begY;
+        line.dirX = dx / length;
+        line.dirY = dy / length;
+        line.outward = flipped ? -1.0 : 1.0;
+
+        // Дуга по хорде и центральному углу: центр - на перпендикуляре к середине хорды
+        const double half = arcAngle / 2.0;
+        if (std::fabs(std::sin(half)) > 1e-9) {
+            const double offset = length / 2.0 / std::tan(half);
+            line.arc = true;
+            line.centerX = (begX + endX) / 2.0 - line.dirY * offset;
+            line.centerY = (begY + endY) / 2.0 + line.dirX * offset;
+            line.radius = length / (2.0 * std::fabs(std::sin(half)));
+            line.begPhi = std::atan2(begY - line.centerY, begX - line.centerX);
+            line.turn = arcAngle > 0.0 ? 1.0 : -1.0;
+        }
+    }
+    return line;
+}
+
+// Точка в distance м от начала стены по линии привязки (у дуговой стены - по дуге)
+static WallPoint PointAt(const WallLine& line, double distance)
+{
+    WallPoint point;
+    if (line.arc) {
+        const double phi = line.begPhi + line.turn * distance / line.radius;
+        point.x = line.centerX + line.radius * std::cos(phi);
+        point.y = line.centerY + line.radius * std::sin(phi);
+        point.angle = phi + line.turn * Pi / 2.0;
+    } else {
+        point.x = line.begX + line.dirX * distance;
+        point.y = line.begY + line.dirY * distance;
+        point.angle = std::atan2(line.dirY, line.dirX);
+    }
+    point.normal = point.angle + line.outward * Pi / 2.0;
+    return point;
+}
+
+// Линия стены guid; каждая стена читается один раз за вызов (lines), а с
+// общим кэшем (shared) - один раз, пока не изменится
+static const WallLine& GetWallLine(Host& host, const Guid& guid, std::map<Guid, WallLine>& lines, WallCache::Cache* shared)
+{
+    std::map<Guid, WallLine>::iterator it = lines.find(guid);
+    if (it != lines.end()) {
+        return it->second;
+    }
+
+    WallLine line = {};
+    if (const WallCache::Wall* cached = shared != nullptr ? shared->Find(guid) : nullptr) {
+        line = MakeWallLine(cached->begX, cached->begY, cached->endX, cached->endY, cached->arcAngle, cached->flipped);
+    } else {
+        HostApi::Element wall;
+        if (host.GetElement(guid, wall) == NoError && wall.type == HostApi::ElemType::Wall) {
+            line = MakeWallLine(wall.begX, wall.begY, wall.endX, wall.endY, wall.arcAngle, wall.flipped);
+            if (shared != nullptr) {
+                shared->Put(wall);
+                host.WatchElement(guid);
+            }
+        }
+    }
+    return lines.insert(std::make_pair(guid, line)).first->second;
+}
+
+// =============================================================================
+// ReadSelectedOpenings
+// =============================================================================
+
+void ReadSelectedOpenings(Host& host, std::vector<Opening>& openings, WallCache::Cache* cache)
+{
+    openings.clear();
+
+    std::vector<Guid> selection;
+    if (host.GetSelection(selection) != NoError) {
+        return;
+    }
+
+    HostApi::Element element;
+    std::vector<HostApi::PropertyDefinition> definitions;
+    std::map<Guid, WallLine> walls;
+    const Guid noWall = {};
+    for (const Guid& guid : selection) {
+        if (host.GetElement(guid, element) != NoError) {
+            continue;
+        }
+        if (element.type != HostApi::ElemType::Window && element.type != HostApi::ElemType::Door) {
+            continue;
+        }
+
+        Opening opening;
+        opening.guid = element.guid;
+        opening.type = element.type;
+        opening.width = element.openingWidth;
+        opening.height = element.openingHeight;
+        opening.sillHeight = element.lower;
+        opening.storey = element.floorInd;
+        opening.wall = element.owner;
+        opening.x = 0.0;
+        opening.y = 0.0;
+        opening.angle = 0.0;
+        opening.normal = 0.0;
+
+        // Точка на линии привязки в objLoc от начала стены (дуговые стены - по дуге)
+        if (element.owner != noWall) {
+            const WallLine& line = GetWallLine(host, element.owner, walls, cache);
+            if (line.valid) {
+                const WallPoint point = PointAt(line, element.objLoc);
+                opening.x = point.x;
+                opening.y = point.y;
+                opening.angle = point.angle;
+                opening.normal = point.normal;
+            }
+            if (cache != nullptr && cache->AddOpening(element.owner, element.guid)) {
+                host.WatchElement(element.guid);
+            }
+        }
+
+        // ID: сначала пользовательские свойства, затем все
+        host.GetPropertyDefinitions(element.guid, HostApi::PropertyFilter::UserDefined, definitions);
+        if (!ReadIdValue(host, element.guid, definitions, opening.id)) {
+            host.GetPropertyDefinitions(element.guid, HostApi::PropertyFilter::All, definitions);
+            ReadIdValue(host, element.guid, definitions, opening.id);
+        }
+
+        // Окна без распознанного типа тоже попадают в список (calcType = -1)
+        opening.calcType = CassetteCore::CalcTypeFromId(opening.id.data(), opening.id.size());
+        openings.push_back(opening);
+    }
+}
+
+// =============================================================================
+// FindWallHeight
+// =============================================================================
+
+// Строковые значения свойств ID стены (пользовательские, затем все)
+static void ReadWallIds(Host& host, const Guid& guid, std::vector<std::string>& ids)
+{
+    ids.clear();
+    HostApi::PropertyValue value;
+    std::vector<HostApi::PropertyDefinition> definitions;
+    for (HostApi::PropertyFilter filter : { HostApi::PropertyFilter::UserDefined, HostApi::PropertyFilter::All }) {
+        host.GetPropertyDefinitions(guid, filter, definitions);
+        for (const HostApi::PropertyDefinition& def : definitions) {
+            if (IsIdProperty(def.name) && host.GetPropertyValue(guid, def.guid, value) == NoError &&
+                !value.isDefault && value.isString) {
+                ids.push_back(value.text);
+            }
+        }
+    }
+}
+
+// Поиск по кэшу: из модели читаются только стены, которых в нём нет
+static double FindWallHeightCached(Host& host, const std::string& wallIdPattern, WallCache::Cache& cache)
+{
+    std::vector<Guid> walls;
+    if (!cache.GetWallList(walls)) {
+        if (host.GetElemList(HostApi::ElemType::Wall, walls) != NoError) {
+            return 0.0;
+        }
+        cache.SetWallList(walls);
+    }
+
+    HostApi::Element element;
+    std::vector<std::string> ids;
+    for (const Guid& guid : walls) {
+        const WallCache::Wall* wall = cache.Find(guid);
+        if (wall == nullptr) {
+            if (host.GetElement(guid, element) != NoError) {
+                continue;
+            }
+            wall = &cache.Put(element);
+            host.WatchElement(guid);
+        }
+        if (!wall->idsKnown) {
+            ReadWallIds(host, guid, ids);
+            cache.SetIds(guid, ids);
+        }
+        for (const std::string& id : wall->ids) {
+            if (id.find(wallIdPattern) != std::string::npos) {
+                return wall->height;
+            }
+        }
+    }
+    return 0.0;
+}
+
+double FindWallHeight(Host& host, const std::string& wallIdPattern, WallCache::Cache* cache)
+{
+    if (wallIdPattern.empty()) {
+        return 0.0;
+    }
+    if (cache != nullptr) {
+        return FindWallHeightCached(host, wallIdPattern, *cache);
+    }
+
+    std::vector<Guid> walls;
+    if (host.GetElemList(HostApi::ElemType::Wall, walls) != NoError || walls.empty()) {
+        return 0.0;
+    }
+
+    HostApi::Element element;
+    HostApi::PropertyValue value;
+    std::vector<HostApi::PropertyDefinition> definitions;
+    for (const Guid& guid : walls) {
+        if (host.GetElement(guid, element) != NoError) {
+            continue;
+        }
+
+        // Пользовательские свойства, затем все
+        for (HostApi::PropertyFilter filter : { HostApi::PropertyFilter::UserDefined, HostApi::PropertyFilter::All }) {
+            host.GetPropertyDefinitions(guid, filter, definitions);
+            for (const HostApi::PropertyDefinition& def : definitions) {
+                if (!IsIdProperty(def.name)) {
+                    continue;
+                }
+                if (host.GetPropertyValue(guid, def.guid, value) == NoError && !value.isDefault && value.isString &&
+                    value.text.find(wallIdPattern) != std::string::npos) {
+                    return element.wallHeight;
+                }
+            }
+        }
+    }
+
+    return 0.0;
+}
+
+// =============================================================================
+// WriteTargets
+// =============================================================================
+
+static std::string FormatLine(const char* format, int a, int b, int c, int d = 0)
+{
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer), format, a, b, c, d);
+    return buffer;
+}
+
+// Записать строки в Text_3...Text_N найденного объекта; оставшиеся до maxLines очищаются
+static bool WriteParameters(Host& host, const Guid& guid, HostApi::ElemType type,
+                            const std::vector<std::string>& lines, int maxLines)
+{
+    ErrCode err = host.OpenParameters(guid, type);
+    if (err != NoError) {
+        Report(host, "  ❌ ОШИБКА открытия параметров: err=%d", err);
+        return false;
+    }
+
+    // Индексы параметров Text_3...Text_18
+    std::vector<HostApi::Parameter> parameters;
+    err = host.GetParameters(parameters);
+    if (err != NoError) {
+        Report(host, "  ❌ ОШИБКА получения списка параметров: err=%d", err);
+        host.CloseParameters();
+        return false;
+    }
+    Report(host, "  Найдено параметров в открытом списке: %d", static_cast<int>(parameters.size()));
+
+    std::map<int, int32_t> textParamIndices;    // textNum -> index
+    for (const HostApi::Parameter& par : parameters) {
+        if (par.name.compare(0, 5, "Text_") != 0) {
+            continue;
+        }
+        int textNum = 0;
+        std::sscanf(par.name.c_str() + 5, "%d", &textNum);
+        if (textNum >= 3 && textNum <= 18) {
+            textParamIndices[textNum] = par.index;
+            Report(host, "    Найден параметр %s: index=%d, typeID=%d", par.name.c_str(), par.index, par.typeID);
+        }
+    }
+
+    if (textParamIndices.empty()) {
+        Report(host, "  ❌ ОШИБКА: не найдено ни одного параметра Text_3...Text_18!");
+        host.CloseParameters();
+        return false;
+    }
+
+    // Строки в Text_3..., оставшиеся параметры до maxLines очищаются пробелом
+    bool success = true;
+    for (int lineIdx = 0; lineIdx < maxLines; lineIdx++) {
+        const int textNum = 3 + lineIdx;
+        if (textNum > 18) {
+            break;
+        }
+        auto it = textParamIndices.find(textNum);
+        if (it == textParamIndices.end()) {
+            if (lineIdx < static_cast<int>(lines.size())) {
+                Report(host, "  ⚠ Параметр Text_%d не найден в списке параметров", textNum);
+            }
+            continue;
+        }
+
+        const bool clear = lineIdx >= static_cast<int>(lines.size());
+        const std::string& text = clear ? std::string(" ") : lines[lineIdx];
+        err = host.ChangeParameter(it->second, text);
+        if (err != NoError) {
+            Report(host, "    ❌ ОШИБКА %s Text_%d (index=%d): err=%d", clear ? "очистки" : "записи", textNum, it->second, err);
+            if (!clear) {
+                success = false;
+            }
+        } else {
+            Report(host, "    ✅ Параметр Text_%d (index=%d) %s", textNum, it->second, clear ? "очищен" : text.c_str());
+        }
+    }
+
+    // Изменённые параметры - в элемент одной командой отмены (или в общей RunUndoable)
+    err = host.CommitParameters(guid, success);
+    if (err != NoError) {
+        Report(host, "  ❌ ОШИБКА применения параметров: err=%d", err);
+        return false;
+    }
+    Report(host, success ? "  ✅ УСПЕХ: параметры записаны" : "  ⚠ ВНИМАНИЕ: параметры не применены");
+    return success;
+}
+
+// Найти объект с ID targetId в выделении и записать строки в Text_3...Text_N
+static bool WriteObject(Host& host, const std::vector<Guid>& selection,
+                        const std::string& targetId, const std::vector<std::string>& lines, int maxLines)
+{
+    if (targetId.empty()) {
+        Report(host, "=== writeToObject: targetId пустой, пропуск");
+        return true;
+    }
+
+    Report(host, "=== writeToObject: поиск объекта ID='%s', lines=%d, maxLines=%d",
+        targetId.c_str(), static_cast<int>(lines.size()), maxLines);
+    Report(host, "  Выделено элементов: %d", static_cast<int>(selection.size()));
+
+    HostApi::Element element;
+    HostApi::PropertyValue value;
+    std::vector<HostApi::PropertyDefinition> definitions;
+    for (size_t neigIdx = 0; neigIdx < selection.size(); neigIdx++) {
+        const Guid& guid = selection[neigIdx];
+        Report(host, "  Проверка элемента [%d/%d]: guid=%s",
+            static_cast<int>(neigIdx + 1), static_cast<int>(selection.size()), GuidToString(guid).c_str());
+
+        ErrCode err = host.GetElement(guid, element);
+        if (err != NoError) {
+            Report(host, "    Ошибка получения элемента: err=%d", err);
+            continue;
+        }
+
+        // Только объекты
+        if (element.type != HostApi::ElemType::Object) {
+            Report(host, "    Пропуск: не Object (type=%d)", static_cast<int>(element.type));
+            continue;
+        }
+
+        err = host.GetPropertyDefinitions(guid, HostApi::PropertyFilter::All, definitions);
+        if (err != NoError) {
+            Report(host, "    Ошибка получения свойств: err=%d", err);
+            continue;
+        }
+        Report(host, "    Найдено свойств: %d", static_cast<int>(definitions.size()));
+
+        std::string objectId;
+        bool idFound = false;
+        for (const HostApi::PropertyDefinition& def : definitions) {
+            if (!IsIdPropertyIgnoreCase(def.name)) {
+                continue;
+            }
+            Report(host, "    Найдено свойство с ID: '%s'", def.name.c_str());
+            if (host.GetPropertyValue(guid, def.guid, value) == NoError && !value.isDefault && value.isString) {
+                objectId = value.text;
+                Report(host, "    *** ID объекта: '%s' (ищем '%s')", objectId.c_str(), targetId.c_str());
+                idFound = true;
+                break;
+            }
+        }
+
+        if (!idFound) {
+            Report(host, "    ВНИМАНИЕ: ID не найден в свойствах!");
+            std::string libPartName;
+            if (element.libInd != 0 && host.GetLibPartName(element.libInd, libPartName) == NoError) {
+                Report(host, "    Имя библиотечной части: '%s'", libPartName.c_str());
+            }
+            continue;
+        }
+
+        if (objectId != targetId) {
+            Report(host, "    Пропуск: ID не совпадает ('%s' != '%s')", objectId.c_str(), targetId.c_str());
+            continue;
+        }
+
+        Report(host, "  *** НАЙДЕН объект для записи: ID='%s', строк: %d", objectId.c_str(), static_cast<int>(lines.size()));
+        for (size_t li = 0; li < lines.size(); li++) {
+            Report(host, "    lines[%d] = '%s'", static_cast<int>(li), lines[li].c_str());
+        }
+        return WriteParameters(host, guid, element.type, lines, maxLines);
+    }
+
+    return false;   // Объект не найден
+}
+
+// Объект выделения для постраничной записи
+struct TargetObject {
+    Guid guid;
+    HostApi::ElemType type;
+};
+
+// Объекты выделения по ID за один проход (первый объект с данным ID)
+static void IndexObjects(Host& host, const std::vector<Guid>& selection, std::map<std::string, TargetObject>& objects)
+{
+    Report(host, "=== Поиск целевых объектов: выделено элементов %d", static_cast<int>(selection.size()));
+
+    HostApi::Element element;
+    HostApi::PropertyValue value;
+    std::vector<HostApi::PropertyDefinition> definitions;
+    for (const Guid& guid : selection) {
+        if (host.GetElement(guid, element) != NoError || element.type != HostApi::ElemType::Object) {
+            continue;
+        }
+        if (host.GetPropertyDefinitions(guid, HostApi::PropertyFilter::All, definitions) != NoError) {
+            continue;
+        }
+        for (const HostApi::PropertyDefinition& def : definitions) {
+            if (!IsIdPropertyIgnoreCase(def.name)) {
+                continue;
+            }
+            if (host.GetPropertyValue(guid, def.guid, value) == NoError && !value.isDefault && value.isString) {
+                if (!objects.emplace(value.text, TargetObject{ guid, element.type }).second) {
+                    Report(host, "  ⚠ ID '%s' повторяется, запись в первый объект", value.text.c_str());
+                }
+                break;
+            }
+        }
+    }
+    Report(host, "  Объектов с ID: %d", static_cast<int>(objects.size()));
+}
+
+// ID страницы: первая - сам targetId, дальше targetId#2, targetId#3, ...
+static std::string PageId(const std::string& targetId, size_t page)
+{
+    return page == 0 ? targetId : targetId + "#" + std::to_string(page + 1);
+}
+
+static size_t PageCount(const std::vector<std::string>& lines, int maxLines)
+{
+    return (lines.size() + static_cast<size_t>(maxLines) - 1) / static_cast<size_t>(maxLines);
+}
+
+// Записать строки по maxLines на объект: targetId, targetId#2, ...
+// Страницы сверх нужных, оставшиеся с прошлой записи, очищаются (при пустом
+// списке - все, начиная с самого targetId)
+static bool WritePages(Host& host, const std::map<std::string, TargetObject>& objects,
+                       const std::string& targetId, const std::vector<std::string>& lines, int maxLines)
+{
+    const size_t pages = PageCount(lines, maxLines);
+    bool success = true;
+    for (size_t page = 0; ; ++page) {
+        const std::string id = PageId(targetId, page);
+        auto it = objects.find(id);
+        if (it == objects.end()) {
+            break;      // Все страницы найдены заранее, дальше - нет лишних
+        }
+        const size_t first = std::min(lines.size(), page * static_cast<size_t>(maxLines));
+        const size_t last = std::min(lines.size(), first + static_cast<size_t>(maxLines));
+        const std::vector<std::string> pageLines(lines.begin() + first, lines.begin() + last);
+        if (page < pages) {
+            Report(host, "=== Страница %d/%d: ID='%s', строки %d...%d", static_cast<int>(page + 1), static_cast<int>(pages),
+                id.c_str(), static_cast<int>(first + 1), static_cast<int>(last));
+        } else {
+            Report(host, "=== Лишняя страница ID='%s' очищается", id.c_str());
+        }
+        success &= WriteParameters(host, it->second.guid, it->second.type, pageLines, maxLines);
+    }
+    return success;
+}
+
+bool WriteTargets(Host& host, const CassetteCore::Result& result, const Targets& targets)
+{
+    std::vector<Guid> selection;
+    if (host.GetSelection(selection) != NoError) {
+        return false;
+    }
+
+    // Строки по типам: тип 0 и типы 1-2 пишутся в разные объекты (по calcType)
+    std::vector<std::string> cassetteLines;
+    std::vector<std::string> plankLines0;
+    std::vector<std::string> plankLines12;
+    std::vector<std::string> leftSlopeLines0;
+    std::vector<std::string> leftSlopeLines12;
+    std::vector<std::string> rightSlopeLines0;
+    std::vector<std::string> rightSlopeLines12;
+
+    Report(host, "=== Формирование строк для записи ===");
+    for (const CassetteCore::CassetteRow& cs : result.cassettes) {
+        cassetteLines.push_back(FormatLine("Размер: U x V : %dx%d мм; Количество: %d шт.", cs.x, cs.y, cs.count));
+    }
+    for (const CassetteCore::PlankRow& ps : result.planks) {
+        if (ps.calcType == 0) {
+            plankLines0.push_back(FormatLine("Размер: %dx%d мм; Длина Z = %d мм; Количество: %d шт.",
+                ps.width, ps.length, ps.length, ps.count));
+        } else {
+            plankLines12.push_back(FormatLine("Размер: %dx%d мм; Длина W = %d мм; Количество: %d шт.",
+                ps.width, ps.length, ps.length, ps.count));
+        }
+    }
+    auto slopeLines = [](const std::vector<CassetteCore::PlankRow>& rows, std::vector<std::string>& lines0, std::vector<std::string>& lines12) {
+        for (const CassetteCore::PlankRow& ps : rows) {
+            (ps.calcType == 0 ? lines0 : lines12).push_back(FormatLine("Размер: %dx%d мм; Длина Z = %d мм; Количество: %d шт.",
+                ps.width, ps.length, ps.length, ps.count));
+        }
+    };
+    slopeLines(result.leftSlopes, leftSlopeLines0, leftSlopeLines12);
+    slopeLines(result.rightSlopes, rightSlopeLines0, rightSlopeLines12);
+    Report(host, "  Кассеты: %d, планки: %d + %d, откосы: %d + %d / %d + %d",
+        static_cast<int>(cassetteLines.size()),
+        static_cast<int>(plankLines0.size()), static_cast<int>(plankLines12.size()),
+        static_cast<int>(leftSlopeLines0.size()), static_cast<int>(leftSlopeLines12.size()),
+        static_cast<int>(rightSlopeLines0.size()), static_cast<int>(rightSlopeLines12.size()));
+
+    // Лимиты: тип 0 - 8 параметров (Text_3...Text_10); типы 1-2 - 16 для кассет и откосов, 8 для планок
+    const int maxPlanks0 = 8;
+    const int maxSlopes0 = 8;
+    const int maxCassettes12 = 16;
+    const int maxPlanks12 = 8;
+    const int maxSlopes12 = 16;
+
+    struct Write {
+        const std::string& targetId;
+        const std::vector<std::string>& lines;
+        int maxLines;
+    };
+    const Write writes[] = {
+        { targets.plankId0,       plankLines0,       maxPlanks0 },
+        { targets.leftSlopeId0,   leftSlopeLines0,   maxSlopes0 },
+        { targets.rightSlopeId0,  rightSlopeLines0,  maxSlopes0 },
+        { targets.cassetteId12,   cassetteLines,     maxCassettes12 },
+        { targets.plankId12,      plankLines12,      maxPlanks12 },
+        { targets.leftSlopeId12,  leftSlopeLines12,  maxSlopes12 },
+        { targets.rightSlopeId12, rightSlopeLines12, maxSlopes12 }
+    };
+
+    if (!targets.overflowPages) {
+        Report(host, "=== Запись в объекты ===");
+        bool success = true;
+        for (const Write& write : writes) {
+            if (!write.targetId.empty() && !write.lines.empty()) {
+                success &= WriteObject(host, selection, write.targetId, write.lines, write.maxLines);
+            }
+        }
+        return success;
+    }
+
+    // Постранично: строки сверх лимита - в объекты ID#2, ID#3, ... Выделение
+    // читается один раз; если какой-то страницы нет, ничего не пишется
+    std::map<std::string, TargetObject> objects;
+    IndexObjects(host, selection, objects);
+
+    bool complete = true;
+    for (const Write& write : writes) {
+        if (write.targetId.empty() || write.lines.empty()) {
+            continue;
+        }
+        const size_t pages = PageCount(write.lines, write.maxLines);
+        for (size_t page = 0; page < pages; ++page) {
+            const std::string id = PageId(write.targetId, page);
+            if (objects.find(id) == objects.end()) {
+                Report(host, "  ❌ Не найден объект ID='%s' для строк %d...%d", id.c_str(),
+                    static_cast<int>(page * write.maxLines + 1),
+                    static_cast<int>(std::min(write.lines.size(), (page + 1) * write.maxLines)));
+                complete = false;
+            }
+        }
+    }
+    if (!complete) {
+        return false;
+    }
+
+    // Все объекты - одной командой отмены; при ошибке Archicad откатывает её целиком.
+    // Пустой список тоже пишется: страницы прошлой записи (ID, ID#2, ...) очищаются
+    const ErrCode err = host.RunUndoable("Write Cassette Results", [&]() -> ErrCode {
+        bool success = true;
+        for (const Write& write : writes) {
+            if (!write.targetId.empty()) {
+                success &= WritePages(host, objects, write.targetId, write.lines, write.maxLines);
+            }
+        }
+        return success ? NoError : WriteFailed;
+    });
+    if (err != NoError) {
+        Report(host, "  ❌ ОШИБКА записи в объекты: err=%d", err);
+    }
+    return err == NoError;
+}
+
+// =============================================================================
+// PlaceObjects
+// =============================================================================
+
+bool PlaceObjects(Host& host, const FacadePlacement::Layout& layout, const LibParts& parts, size_t& created)
+{
+    created = 0;
+
+    struct Group {
+        const char* title;
+        const std::string& libPart;
+        const std::vector<HostApi::PlacedObject>& objects;
+        int32_t libInd;
+    };
+    Group groups[] = {
+        { "Кассеты", parts.cassette, layout.cassettes, 0 },
+        { "Планки",  parts.plank,    layout.planks,    0 },
+        { "Откосы",  parts.slope,    layout.slopes,    0 }
+    };
+
+    // Библиотечные элементы ищутся до размещения: без них не создаётся ничего
+    Report(host, "=== Размещение объектов: деталей %d", static_cast<int>(layout.Size()));
+    bool complete = true;
+    for (Group& group : groups) {
+        if (group.libPart.empty() || group.objects.empty()) {
+            continue;
+        }
+        const ErrCode err = host.FindLibPart(group.libPart, group.libInd);
+        if (err != NoError) {
+            Report(host, "  ❌ %s: элемент '%s' не найден в библиотеке (err=%d)", group.title, group.libPart.c_str(), err);
+            complete = false;
+        } else {
+            Report(host, "  %s: '%s' (libInd=%d), экземпляров %d", group.title, group.libPart.c_str(),
+                group.libInd, static_cast<int>(group.objects.size()));
+        }
+    }
+    if (!complete) {
+        return false;
+    }
+
+    std::vector<Guid> guids;
+    const ErrCode err = host.RunUndoable("Place Cassette Objects", [&]() -> ErrCode {
+        for (const Group& group : groups) {
+            if (group.libPart.empty() || group.objects.empty()) {
+                continue;
+            }
+            const ErrCode groupErr = host.CreateObjects(group.libInd, parts.textParam, group.objects, guids);
+            created += guids.size();
+            if (groupErr != NoError) {
+                Report(host, "  ❌ %s: создано %d из %d (err=%d)", group.title, static_cast<int>(guids.size()),
+                    static_cast<int>(group.objects.size()), groupErr);
+                return groupErr;
+            }
+        }
+        return NoError;
+    });
+    if (err != NoError) {
+        created = 0;    // Команда отменена целиком
+        return false;
+    }
+    Report(host, "  ✅ Создано объектов: %d", static_cast<int>(created));
+    return true;
+}
+
+} // namespace HostWorkload
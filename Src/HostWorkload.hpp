@@ -0,0 +1,81 @@
+#ifndef HOSTWORKLOAD_HPP
+#define HOSTWORKLOAD_HPP
+
+// =============================================================================
+// HostWorkload - Чтение окон, поиск стены и запись в GDL объекты через Host
+// =============================================================================
+// Логика CassetteHelper::GetSelectedWindowsDoors, GetFloorHeightFromWall,
+// WriteToTargetObjects и PlaceFacadeObjects над интерфейсом HostApi::Host. В аддоне Host - это
+// Archicad, в cassette-replay - записанная трасса, поэтому одна и та же
+// последовательность вызовов повторяется и профилируется без Archicad.
+// Модуль не зависит от Archicad API (только стандартная библиотека).
+
+#include "CassetteCore.hpp"
+#include "FacadePlacement.hpp"
+#include "HostApi.hpp"
+#include "WallCache.hpp"
+
+#include <string>
+#include <vector>
+
+namespace HostWorkload {
+
+// Окно/дверь из выделения (см. CassetteHelper::WindowDoorInfo)
+struct Opening {
+    HostApi::Guid guid;
+    HostApi::ElemType type;     // Window или Door
+    std::string id;             // UTF-8, может быть пустым
+    double width;               // м
+    double height;              // м
+    double sillHeight;          // м
+    int32_t storey;
+    int calcType;               // 0, 1, 2 или -1
+    HostApi::Guid wall;         // Стена проёма (нулевой GUID - не известна)
+    double x;                   // Точка проёма на линии привязки стены, м
+    double y;
+    double angle;               // Направление стены в точке проёма, рад
+    double normal;              // Наружная нормаль стены в точке проёма, рад (фасад)
+};
+
+// ID целевых GDL объектов (см. CassetteHelper::TargetObjects)
+struct Targets {
+    std::string plankId0;
+    std::string leftSlopeId0;
+    std::string rightSlopeId0;
+    std::string cassetteId12;
+    std::string plankId12;
+    std::string leftSlopeId12;
+    std::string rightSlopeId12;
+    bool overflowPages;         // Строки сверх лимита - в объекты ID#2, ID#3, ... (одна отмена)
+};
+
+// Библиотечные элементы для размещения (имя как в библиотеке; пусто - не размещать)
+struct LibParts {
+    std::string cassette;
+    std::string plank;
+    std::string slope;
+    std::string textParam;      // Строковый параметр для маркировки; пусто - не писать
+};
+
+// Выделенные окна и двери. С cache стены проёмов берутся из кэша (новые
+// запоминаются), проёмы привязываются к стенам кэша
+void ReadSelectedOpenings(HostApi::Host& host, std::vector<Opening>& openings, WallCache::Cache* cache = nullptr);
+
+// Высота стены, ID которой содержит wallIdPattern; 0 - не найдена.
+// С cache стены и их ID читаются из модели только при первом обращении
+double FindWallHeight(HostApi::Host& host, const std::string& wallIdPattern, WallCache::Cache* cache = nullptr);
+
+// Записать результат в параметры Text_3...Text_18 целевых объектов выделения.
+// Без overflowPages строки сверх лимита объекта отбрасываются
+bool WriteTargets(HostApi::Host& host, const CassetteCore::Result& result, const Targets& targets);
+
+// Разместить детали layout одной командой отмены; если какого-то элемента нет
+// в библиотеке, ничего не размещается
+bool PlaceObjects(HostApi::Host& host, const FacadePlacement::Layout& layout, const LibParts& parts, size_t& created);
+
+// GUID в виде XXXXXXXX-XXXX-XXXX-XXXX-XXXXXXXXXXXX (как APIGuidToString)
+std::string GuidToString(const HostApi::Guid& guid);
+
+} // namespace HostWorkload
+
+#endif // HOSTWORKLOAD_HPP
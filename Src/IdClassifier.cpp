@@ -0,0 +1,331 @@
+// =============================================================================
+// IdClassifier - Тип расчёта по ID окна/двери (таблица кодов)
+// =============================================================================
+
+#include "IdClassifier.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace IdClassifier {
+
+// =============================================================================
+// Вспомогательные функции
+// =============================================================================
+
+// Буква или цифра: ASCII или любой байт символа UTF-8 (кириллица и т.п.)
+static bool IsWordByte(unsigned char c)
+{
+    return c >= 0x80 || (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+// Перед позицией pos - ':' или ': '
+static bool HasColonBefore(std::string_view id, size_t pos)
+{
+    if (pos >= 1 && id[pos - 1] == ':') {
+        return true;
+    }
+    return pos >= 2 && id[pos - 1] == ' ' && id[pos - 2] == ':';
+}
+
+// После кода длины length в начале rest - конец ID или не буква/цифра
+static bool IsCodeEnd(std::string_view rest, size_t length)
+{
+    return rest.size() == length || !IsWordByte(static_cast<unsigned char>(rest[length]));
+}
+
+// Короткое сравнение без вызова memcmp (остаток префикса - обычно 1-2 байта)
+static bool SameBytes(const char* a, const char* b, size_t length)
+{
+    for (size_t i = 0; i < length; ++i) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::string_view Trim(std::string_view text)
+{
+    while (!text.empty() && text.front() == ' ') {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && text.back() == ' ') {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// Элементы списка через запятую (без пробелов по краям)
+template <typename Visitor>
+static bool ForEachItem(std::string_view spec, Visitor visit)
+{
+    while (!Trim(spec).empty()) {
+        const size_t comma = spec.find(',');
+        const std::string_view item = Trim(spec.substr(0, comma));
+        if (item.empty() || !visit(item)) {
+            return false;
+        }
+        spec = comma == std::string_view::npos ? std::string_view() : spec.substr(comma + 1);
+    }
+    return true;
+}
+
+// =============================================================================
+// Table
+// =============================================================================
+
+Table::Table() :
+    maxCodeLength(0)
+{
+    std::fill(std::begin(byChar), std::end(byChar), static_cast<int8_t>(-1));
+}
+
+Table Table::Standard()
+{
+    Table table;
+    table.AddCode("0", 0);
+    table.AddCode("1", 1);
+    table.AddCode("2", 2);
+    table.AddPrefix("ОК-");
+    table.AddPrefix("ДВ-");
+    return table;
+}
+
+void Table::AddCode(std::string_view code, int calcType)
+{
+    if (code.empty()) {
+        return;
+    }
+    std::vector<Code>::iterator it = std::find_if(codes.begin(), codes.end(), [code](const Code& c) {
+        return c.text == code;
+    });
+    if (it != codes.end()) {
+        it->calcType = calcType;
+    } else {
+        // Длинные коды первыми, при равной длине - в порядке добавления
+        it = std::find_if(codes.begin(), codes.end(), [code](const Code& c) {
+            return c.text.size() < code.size();
+        });
+        codes.insert(it, Code{ std::string(code), calcType });
+        maxCodeLength = std::max(maxCodeLength, code.size());
+    }
+
+    const unsigned char first = static_cast<unsigned char>(code[0]);
+    if (code.size() == 1 && first < 128) {
+        byChar[first] = static_cast<int8_t>(calcType);
+    }
+}
+
+void Table::AddPrefix(std::string_view prefix)
+{
+    const bool known = std::any_of(prefixes.begin(), prefixes.end(), [prefix](const Prefix& p) {
+        return p.text == prefix;
+    });
+    if (prefix.empty() || known) {
+        return;
+    }
+
+    // Первые до 4 байт префикса - для сравнения одним словом
+    Prefix added{ std::string(prefix), 0, 0 };
+    const size_t headLength = std::min<size_t>(prefix.size(), sizeof(added.head));
+    std::memcpy(&added.head, prefix.data(), headLength);
+    std::memset(&added.mask, 0xFF, headLength);
+    prefixes.push_back(added);
+}
+
+bool Table::ParseCodes(std::string_view spec)
+{
+    Table parsed;
+    parsed.prefixes = prefixes;
+    const bool valid = ForEachItem(spec, [&parsed](std::string_view item) {
+        const size_t eq = item.find('=');
+        if (eq == std::string_view::npos) {
+            return false;
+        }
+        const std::string_view code = Trim(item.substr(0, eq));
+        const std::string_view type = Trim(item.substr(eq + 1));
+        if (code.empty() || code.find(':') != std::string_view::npos || type.empty() || type.size() > 2) {
+            return false;
+        }
+        int calcType = 0;
+        for (char c : type) {
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            calcType = calcType * 10 + (c - '0');
+        }
+        if (calcType >= TypeCount) {
+            return false;
+        }
+        parsed.AddCode(code, calcType);
+        return true;
+    });
+    if (valid) {
+        *this = parsed;
+    }
+    return valid;
+}
+
+bool Table::ParsePrefixes(std::string_view spec)
+{
+    Table parsed;
+    const bool valid = ForEachItem(spec, [&parsed](std::string_view item) {
+        parsed.AddPrefix(item);
+        return true;
+    });
+    if (valid) {
+        prefixes.swap(parsed.prefixes);
+    }
+    return valid;
+}
+
+std::string Table::FormatCodes() const
+{
+    std::string spec;
+    for (const Code& code : codes) {
+        if (!spec.empty()) {
+            spec += ',';
+        }
+        spec += code.text;
+        spec += '=';
+        spec += std::to_string(code.calcType);
+    }
+    return spec;
+}
+
+std::string Table::FormatPrefixes() const
+{
+    std::string spec;
+    for (const Prefix& prefix : prefixes) {
+        if (!spec.empty()) {
+            spec += ',';
+        }
+        spec += prefix.text;
+    }
+    return spec;
+}
+
+// =============================================================================
+// Classify
+// =============================================================================
+
+int Table::MatchSuffix(std::string_view id) const
+{
+    if (id.size() < 2) {
+        return -1;
+    }
+
+    // Однобайтовый код - обычный случай, без перебора таблицы
+    const unsigned char last = static_cast<unsigned char>(id.back());
+    if (last < 128 && byChar[last] >= 0 && HasColonBefore(id, id.size() - 1)) {
+        return byChar[last];
+    }
+    if (maxCodeLength < 2) {
+        return -1;
+    }
+    for (const Code& code : codes) {
+        if (code.text.size() < 2) {
+            break;      // Дальше только однобайтовые, они проверены
+        }
+        if (code.text.size() < id.size() &&
+            id.compare(id.size() - code.text.size(), code.text.size(), code.text) == 0 &&
+            HasColonBefore(id, id.size() - code.text.size())) {
+            return code.calcType;
+        }
+    }
+    return -1;
+}
+
+int Table::MatchPrefix(std::string_view id) const
+{
+    // Начало ID сравнивается с префиксами одним словом (4 байта), остаток
+    // длинного префикса - отдельно
+    uint32_t head = 0;
+    const bool hasHead = id.size() >= sizeof(head);
+    if (hasHead) {
+        std::memcpy(&head, id.data(), sizeof(head));
+    }
+    for (const Prefix& prefix : prefixes) {
+        const size_t length = prefix.text.size();
+        if (id.size() <= length) {
+            continue;
+        }
+        if (hasHead) {
+            if ((head & prefix.mask) != prefix.head ||
+                !SameBytes(id.data() + sizeof(head), prefix.text.data() + sizeof(head), length - std::min(length, sizeof(head)))) {
+                continue;
+            }
+        } else if (std::memcmp(id.data(), prefix.text.data(), length) != 0) {
+            continue;
+        }
+        const std::string_view rest = id.substr(length);
+        const unsigned char first = static_cast<unsigned char>(rest[0]);
+        if (first < 128 && byChar[first] >= 0 && IsCodeEnd(rest, 1)) {
+            return byChar[first];
+        }
+        for (const Code& code : codes) {
+            if (code.text.size() < 2) {
+                break;
+            }
+            if (code.text.size() <= rest.size() && rest.compare(0, code.text.size(), code.text) == 0 &&
+                IsCodeEnd(rest, code.text.size())) {
+                return code.calcType;
+            }
+        }
+    }
+    return -1;
+}
+
+int Table::Classify(std::string_view id) const
+{
+    // Пробелы в конце не учитываются
+    const char* text = id.data();
+    size_t length = id.size();
+    while (length > 0 && text[length - 1] == ' ') {
+        --length;
+    }
+
+    // Быстрый путь - однобайтовый код после ':' или ': ' (почти все ID проекта):
+    // те же проверки, что в прежнем CalcTypeFromId, плюс одно чтение byChar
+    if (length >= 2) {
+        const unsigned char last = static_cast<unsigned char>(text[length - 1]);
+        const char before = text[length - 2];
+        if (last < 128 && byChar[last] >= 0 &&
+            (before == ':' || (before == ' ' && length >= 3 && text[length - 3] == ':'))) {
+            return byChar[last];
+        }
+    }
+
+    id = std::string_view(text, length);
+    if (maxCodeLength >= 2) {
+        const int bySuffix = MatchSuffix(id);
+        if (bySuffix >= 0) {
+            return bySuffix;
+        }
+    }
+    return prefixes.empty() ? -1 : MatchPrefix(id);
+}
+
+// =============================================================================
+// Текущая таблица
+// =============================================================================
+
+static Table& Current()
+{
+    static Table table = Table::Standard();
+    return table;
+}
+
+const Table& GetTable()
+{
+    return Current();
+}
+
+void SetTable(const Table& table)
+{
+    Current() = table;
+}
+
+} // namespace IdClassifier
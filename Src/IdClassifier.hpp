@@ -0,0 +1,80 @@
+#ifndef IDCLASSIFIER_HPP
+#define IDCLASSIFIER_HPP
+
+// =============================================================================
+// IdClassifier - Тип расчёта по ID окна/двери (таблица кодов)
+// =============================================================================
+// ID разбирается на месте (std::string_view, UTF-8), без копии и без выделения
+// памяти. Правила берутся из таблицы кодов, поэтому новый код типа добавляется
+// строкой настроек (idTypeCodes / idPrefixes в settings.csv), а не правкой кода:
+//   - суффикс ":код" или ": код" в конце ID ("ОК-1: 2" -> 2), пробелы в конце
+//     не учитываются; суффикс проверяется первым;
+//   - префикс и код в начале ID ("ОК-1", "ДВ-2.03" -> 1, 2); за кодом - конец
+//     ID или не буква/цифра ("ОК-12" коду "1" не соответствует).
+// Стандартная таблица: коды 0, 1, 2 -> типы 0, 1, 2; префиксы ОК-, ДВ-.
+// Модуль не зависит от Archicad API (только стандартная библиотека).
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace IdClassifier {
+
+// Типы расчёта: 0...TypeCount - 1 (детали типов - в TypeRegistry)
+const int TypeCount = 16;
+
+class Table {
+public:
+    Table();                        // Пустая таблица: тип не определяется
+
+    // Коды 0, 1, 2 и префиксы ОК-, ДВ-
+    static Table Standard();
+
+    // Код типа (UTF-8, без ':'); повторный код заменяет прежний
+    void AddCode(std::string_view code, int calcType);
+    void AddPrefix(std::string_view prefix);
+
+    // Разобрать строки настроек: коды "0=0,1=1,2=2,2А=2", префиксы "ОК-,ДВ-".
+    // Тип кода - 0...TypeCount - 1.
+    // Пустая строка - без кодов/префиксов. false - ошибка, таблица не меняется.
+    bool ParseCodes(std::string_view spec);
+    bool ParsePrefixes(std::string_view spec);
+
+    // Строки настроек текущей таблицы (обратно к ParseCodes / ParsePrefixes)
+    std::string FormatCodes() const;
+    std::string FormatPrefixes() const;
+
+    // Тип расчёта по ID; -1 - тип не определён
+    int Classify(std::string_view id) const;
+
+private:
+    struct Code {
+        std::string text;
+        int calcType;
+    };
+
+    int MatchSuffix(std::string_view id) const;
+    int MatchPrefix(std::string_view id) const;
+
+    int8_t byChar[128];             // Однобайтовые коды: тип по символу, -1 - нет
+    struct Prefix {
+        std::string text;
+        uint32_t head;              // Первые до 4 байт text
+        uint32_t mask;              // Байты head, которые сравниваются
+    };
+
+    std::vector<Code> codes;        // Все коды, длинные первыми
+    std::vector<Prefix> prefixes;
+    size_t maxCodeLength;
+};
+
+// Таблица, по которой работает CassetteCore::CalcTypeFromId (по умолчанию -
+// Standard). SetTable вызывается из главного потока аддона при загрузке и
+// сохранении настроек; в cassette-batch у каждого проекта своя таблица.
+const Table& GetTable();
+void SetTable(const Table& table);
+
+} // namespace IdClassifier
+
+#endif // IDCLASSIFIER_HPP
@@ -0,0 +1,68 @@
+// =============================================================================
+// IdPool - Пул ID окон/дверей: каждая строка хранится один раз
+// =============================================================================
+
+#include "IdPool.hpp"
+
+#include <deque>
+#include <unordered_map>
+
+namespace IdPool {
+
+// Строки по дескриптору; дескриптор 0 - пустая строка. deque не переносит
+// строки при добавлении, поэтому ссылки из Get остаются действительными
+static std::deque<GS::UniString>& Strings()
+{
+    static std::deque<GS::UniString> strings(1);
+    return strings;
+}
+
+static GS::HashTable<GS::UniString, Handle> s_byString;
+static std::unordered_map<std::string, Handle> s_byUtf8;
+
+Handle Intern(const GS::UniString& id)
+{
+    if (id.IsEmpty()) {
+        return EmptyId;
+    }
+
+    Handle handle = EmptyId;
+    if (s_byString.Get(id, &handle)) {
+        return handle;
+    }
+
+    std::deque<GS::UniString>& strings = Strings();
+    handle = static_cast<Handle>(strings.size());
+    strings.push_back(id);
+    s_byString.Add(id, handle);
+    return handle;
+}
+
+Handle InternUtf8(const std::string& id)
+{
+    if (id.empty()) {
+        return EmptyId;
+    }
+
+    std::unordered_map<std::string, Handle>::const_iterator it = s_byUtf8.find(id);
+    if (it != s_byUtf8.end()) {
+        return it->second;
+    }
+
+    const Handle handle = Intern(GS::UniString(id.c_str(), CC_UTF8));
+    s_byUtf8.emplace(id, handle);
+    return handle;
+}
+
+const GS::UniString& Get(Handle handle)
+{
+    const std::deque<GS::UniString>& strings = Strings();
+    return handle < strings.size() ? strings[handle] : strings[EmptyId];
+}
+
+USize GetCount()
+{
+    return static_cast<USize>(Strings().size());
+}
+
+} // namespace IdPool
@@ -0,0 +1,40 @@
+#ifndef IDPOOL_HPP
+#define IDPOOL_HPP
+
+// =============================================================================
+// IdPool - Пул ID окон/дверей: каждая строка хранится один раз
+// =============================================================================
+// WindowDoorInfo хранит вместо строки ID 32-битный дескриптор пула. Одинаковые
+// ID получают один дескриптор, поэтому поиск дубликатов, группировка и фильтры
+// сравнивают числа, а не строки UTF-16, и строка не копируется на каждое окно.
+// Дескрипторы действуют до выгрузки аддона: пул только растёт, различных ID
+// в проекте немного по сравнению с числом окон.
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+
+#include <string>
+
+namespace IdPool {
+
+typedef UInt32 Handle;
+
+// Дескриптор пустого ID
+const Handle EmptyId = 0;
+
+// Дескриптор строки (новая строка добавляется в пул)
+Handle Intern(const GS::UniString& id);
+
+// То же для UTF-8 из HostWorkload: известный ID не перекодируется в UTF-16
+Handle InternUtf8(const std::string& id);
+
+// Строка по дескриптору (пустая для неизвестного дескриптора); ссылка
+// действительна до выгрузки аддона
+const GS::UniString& Get(Handle handle);
+
+// Число строк в пуле; дескрипторы - 0...GetCount() - 1
+USize GetCount();
+
+} // namespace IdPool
+
+#endif // IDPOOL_HPP
@@ -0,0 +1,428 @@
+// =============================================================================
+// JsDecode - Разбор значений JS моста в структуры CassetteHelper
+// =============================================================================
+
+#include "JsDecode.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+namespace JsDecode {
+
+using CassetteHelper::WindowDoorInfo;
+using CassetteHelper::CalcParams;
+using CassetteHelper::TargetObjects;
+using CassetteHelper::CassetteSize;
+using CassetteHelper::PlankSize;
+
+// =============================================================================
+// Разбор чисел по месту
+// =============================================================================
+
+// Степени 10, представимые в double точно
+static const double ExactPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static bool IsSpace(GS::uchar_t c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static bool IsDigit(GS::uchar_t c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Разбор "[-+]digits[.,digits][e[-+]digits]" из UTF-16 буфера.
+// Быстрый путь: до 15 значащих цифр и |exp| <= 22 дают точный результат
+// одним умножением/делением. Иначе - strtod по копии в стековом буфере.
+static bool ParseDoubleChars(const GS::uchar_t* p, const GS::uchar_t* end, double& out)
+{
+    while (p < end && IsSpace(*p)) ++p;
+
+    const GS::uchar_t* start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    UInt64 mantissa = 0;
+    int digits = 0;          // Значащие цифры в mantissa
+    int exponent = 0;        // Десятичный порядок
+    bool anyDigit = false;
+
+    for (; p < end && IsDigit(*p); ++p) {
+        anyDigit = true;
+        if (digits < 19) {
+            if (mantissa != 0 || *p != '0') {
+                mantissa = mantissa * 10 + (*p - '0');
+                ++digits;
+            }
+        } else {
+            ++exponent;
+        }
+    }
+    if (p < end && (*p == '.' || *p == ',')) {
+        ++p;
+        for (; p < end && IsDigit(*p); ++p) {
+            anyDigit = true;
+            if (digits < 19) {
+                if (mantissa != 0 || *p != '0') {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    ++digits;
+                }
+                --exponent;
+            }
+        }
+    }
+    if (!anyDigit) {
+        return false;
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const GS::uchar_t* expStart = p;
+        ++p;
+        bool expNegative = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            expNegative = (*p == '-');
+            ++p;
+        }
+        if (p < end && IsDigit(*p)) {
+            int e = 0;
+            for (; p < end && IsDigit(*p); ++p) {
+                if (e < 10000) e = e * 10 + (*p - '0');
+            }
+            exponent += expNegative ? -e : e;
+        } else {
+            p = expStart;   // "1e" - экспоненты нет
+        }
+    }
+
+    if (digits <= 15 && exponent >= -22 && exponent <= 22) {
+        double value = static_cast<double>(mantissa);
+        value = (exponent < 0) ? value / ExactPow10[-exponent] : value * ExactPow10[exponent];
+        out = negative ? -value : value;
+        return true;
+    }
+
+    // Редкий случай: длинная мантисса или большой порядок
+    char buffer[64];
+    size_t len = 0;
+    for (const GS::uchar_t* q = start; q < p && len + 1 < sizeof(buffer); ++q) {
+        buffer[len++] = (*q == ',') ? '.' : static_cast<char>(*q);
+    }
+    buffer[len] = '\0';
+    out = std::strtod(buffer, nullptr);
+    return true;
+}
+
+// Целое как у sscanf("%d"): пробелы, знак, цифры; дробная часть отбрасывается
+static bool ParseIntChars(const GS::uchar_t* p, const GS::uchar_t* end, Int32& out)
+{
+    while (p < end && IsSpace(*p)) ++p;
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        ++p;
+    }
+    if (p >= end || !IsDigit(*p)) {
+        return false;
+    }
+
+    Int64 value = 0;
+    for (; p < end && IsDigit(*p); ++p) {
+        if (value < 0x7FFFFFFFLL) value = value * 10 + (*p - '0');
+    }
+    if (value > 0x7FFFFFFFLL) value = 0x7FFFFFFFLL;
+    out = static_cast<Int32>(negative ? -value : value);
+    return true;
+}
+
+// Буфер UTF-16 живёт в wide, пока идёт разбор
+bool ParseDouble(const GS::UniString& s, double& out)
+{
+    const GS::UniString::UStr wide = s.ToUStr();
+    const GS::uchar_t* p = wide.Get();
+    return ParseDoubleChars(p, p + s.GetLength(), out);
+}
+
+bool ParseInt(const GS::UniString& s, Int32& out)
+{
+    const GS::UniString::UStr wide = s.ToUStr();
+    const GS::uchar_t* p = wide.Get();
+    return ParseIntChars(p, p + s.GetLength(), out);
+}
+
+// =============================================================================
+// Примитивы
+// =============================================================================
+
+GS::UniString GetString(const GS::Ref<JS::Base>& p)
+{
+    if (p == nullptr) return GS::UniString();
+
+    if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(p)) {
+        if (v->GetType() == JS::Value::STRING) {
+            return v->GetString();
+        }
+    }
+    return GS::UniString();
+}
+
+double GetDouble(const GS::Ref<JS::Base>& p, double def)
+{
+    if (p == nullptr) return def;
+
+    if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(p)) {
+        const auto t = v->GetType();
+        if (t == JS::Value::DOUBLE) return v->GetDouble();
+        if (t == JS::Value::INTEGER) return static_cast<double>(v->GetInteger());
+        if (t == JS::Value::STRING) {
+            double out = def;
+            ParseDouble(v->GetString(), out);
+            return out;
+        }
+    }
+    return def;
+}
+
+Int32 GetInt(const GS::Ref<JS::Base>& p, Int32 def)
+{
+    if (p == nullptr) return def;
+
+    if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(p)) {
+        const auto t = v->GetType();
+        if (t == JS::Value::INTEGER) return v->GetInteger();
+        if (t == JS::Value::DOUBLE) {
+            // NaN - значение по умолчанию, за пределами Int32 - граница диапазона
+            const double value = v->GetDouble();
+            if (std::isnan(value)) return def;
+            if (value <= INT32_MIN) return INT32_MIN;
+            if (value >= INT32_MAX) return INT32_MAX;
+            return static_cast<Int32>(value);
+        }
+        if (t == JS::Value::STRING) {
+            Int32 out = def;
+            ParseInt(v->GetString(), out);
+            return out;
+        }
+    }
+    return def;
+}
+
+// Строковое значение JS или nullptr. Строка берётся прямо из значения и не
+// копируется в промежуточную GS::UniString (как в GetString)
+static GS::Ref<JS::Value> GetStringValue(const GS::Ref<JS::Base>& p)
+{
+    if (p == nullptr) return nullptr;
+
+    GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(p);
+    if (v != nullptr && v->GetType() == JS::Value::STRING) {
+        return v;
+    }
+    return nullptr;
+}
+
+static IdPool::Handle GetId(const GS::Ref<JS::Base>& p)
+{
+    const GS::Ref<JS::Value> v = GetStringValue(p);
+    return v != nullptr ? IdPool::Intern(v->GetString()) : IdPool::EmptyId;
+}
+
+static CassetteHelper::ElemType GetElemType(const GS::Ref<JS::Base>& p)
+{
+    const GS::Ref<JS::Value> v = GetStringValue(p);
+    return v != nullptr ? CassetteHelper::ElemTypeFromString(v->GetString()) : CassetteHelper::ElemType::Window;
+}
+
+bool GetBool(const GS::Ref<JS::Base>& p, bool def)
+{
+    if (p == nullptr) return def;
+
+    if (GS::Ref<JS::Value> v = GS::DynamicCast<JS::Value>(p)) {
+        if (v->GetType() == JS::Value::BOOL) {
+            return v->GetBool();
+        }
+    }
+    return def;
+}
+
+// =============================================================================
+// Схемы
+// =============================================================================
+
+// Описание поля: ключ в JS объекте и функция записи значения в структуру
+template <typename T>
+struct FieldSpec {
+    GS::UniString key;
+    void (*decode)(const GS::Ref<JS::Base>& value, T& target);
+};
+
+template <typename T, size_t N>
+static bool DecodeObject(const GS::Ref<JS::Base>& value, const FieldSpec<T> (&schema)[N], T& target)
+{
+    GS::Ref<JS::Object> jsObject = GS::DynamicCast<JS::Object>(value);
+    if (jsObject == nullptr) {
+        return false;
+    }
+
+    const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& itemTable = jsObject->GetItemTable();
+    GS::Ref<JS::Base> item;
+    for (const FieldSpec<T>& field : schema) {
+        if (itemTable.Get(field.key, &item)) {
+            field.decode(item, target);
+        }
+    }
+    return true;
+}
+
+static const FieldSpec<WindowDoorInfo> WindowSchema[] = {
+    { "id",         [](const GS::Ref<JS::Base>& v, WindowDoorInfo& w) { w.id = GetId(v); } },
+    { "elemType",   [](const GS::Ref<JS::Base>& v, WindowDoorInfo& w) { w.elemType = GetElemType(v); } },
+    { "width",      [](const GS::Ref<JS::Base>& v, WindowDoorInfo& w) { w.width = Mm::FromMetres(GetDouble(v)); } },
+    { "height",     [](const GS::Ref<JS::Base>& v, WindowDoorInfo& w) { w.height = Mm::FromMetres(GetDouble(v)); } },
+    { "sillHeight", [](const GS::Ref<JS::Base>& v, WindowDoorInfo& w) { w.sillHeight = Mm::FromMetres(GetDouble(v)); } },
+    { "x",          [](const GS::Ref<JS::Base>& v, WindowDoorInfo& w) { w.x = GetDouble(v); } },
+    { "y",          [](const GS::Ref<JS::Base>& v, WindowDoorInfo& w) { w.y = GetDouble(v); } },
+    { "angle",      [](const GS::Ref<JS::Base>& v, WindowDoorInfo& w) { w.angle = GetDouble(v); } },
+    { "normal",     [](const GS::Ref<JS::Base>& v, WindowDoorInfo& w) { w.normal = GetDouble(v); } },
+    { "calcType",   [](const GS::Ref<JS::Base>& v, WindowDoorInfo& w) { w.calcType = GetInt(v); } }
+};
+
+static const FieldSpec<CalcParams> CalcParamsSchema[] = {
+    { "type",         [](const GS::Ref<JS::Base>& v, CalcParams& p) { p.type = static_cast<CassetteHelper::CalcType>(GetInt(v)); } },
+    { "floorHeight",  [](const GS::Ref<JS::Base>& v, CalcParams& p) { p.floorHeight = GetDouble(v, 2.99); } },
+    { "plankWidth0",  [](const GS::Ref<JS::Base>& v, CalcParams& p) { p.plankWidth0 = GetInt(v, 285); } },
+    { "slopeWidth0",  [](const GS::Ref<JS::Base>& v, CalcParams& p) { p.slopeWidth0 = GetInt(v, 285); } },
+    { "plankWidth12", [](const GS::Ref<JS::Base>& v, CalcParams& p) { p.plankWidth12 = GetInt(v, 160); } },
+    { "slopeWidth12", [](const GS::Ref<JS::Base>& v, CalcParams& p) { p.slopeWidth12 = GetInt(v, 225); } },
+    { "offsetX",      [](const GS::Ref<JS::Base>& v, CalcParams& p) { p.offsetX = GetInt(v, 165); } },
+    { "offsetY",      [](const GS::Ref<JS::Base>& v, CalcParams& p) { p.offsetY = GetInt(v, 50); } },
+    { "offsetTop",    [](const GS::Ref<JS::Base>& v, CalcParams& p) { p.offsetTop = GetInt(v, 745); } }
+};
+
+static const FieldSpec<TargetObjects> TargetsSchema[] = {
+    { "plankId0",       [](const GS::Ref<JS::Base>& v, TargetObjects& t) { t.plankId0 = GetString(v); } },
+    { "leftSlopeId0",   [](const GS::Ref<JS::Base>& v, TargetObjects& t) { t.leftSlopeId0 = GetString(v); } },
+    { "rightSlopeId0",  [](const GS::Ref<JS::Base>& v, TargetObjects& t) { t.rightSlopeId0 = GetString(v); } },
+    { "cassetteId12",   [](const GS::Ref<JS::Base>& v, TargetObjects& t) { t.cassetteId12 = GetString(v); } },
+    { "plankId12",      [](const GS::Ref<JS::Base>& v, TargetObjects& t) { t.plankId12 = GetString(v); } },
+    { "leftSlopeId12",  [](const GS::Ref<JS::Base>& v, TargetObjects& t) { t.leftSlopeId12 = GetString(v); } },
+    { "rightSlopeId12", [](const GS::Ref<JS::Base>& v, TargetObjects& t) { t.rightSlopeId12 = GetString(v); } },
+    { "overflowPages",  [](const GS::Ref<JS::Base>& v, TargetObjects& t) { t.overflowPages = GetBool(v); } }
+};
+
+static const FieldSpec<CassetteSize> CassetteSizeSchema[] = {
+    { "x",     [](const GS::Ref<JS::Base>& v, CassetteSize& c) { c.x = GetInt(v); } },
+    { "y",     [](const GS::Ref<JS::Base>& v, CassetteSize& c) { c.y = GetInt(v); } },
+    { "count", [](const GS::Ref<JS::Base>& v, CassetteSize& c) { c.count = GetInt(v); } }
+};
+
+static const FieldSpec<PlankSize> PlankSizeSchema[] = {
+    { "width",    [](const GS::Ref<JS::Base>& v, PlankSize& p) { p.width = GetInt(v); } },
+    { "length",   [](const GS::Ref<JS::Base>& v, PlankSize& p) { p.length = GetInt(v); } },
+    { "count",    [](const GS::Ref<JS::Base>& v, PlankSize& p) { p.count = GetInt(v); } },
+    { "calcType", [](const GS::Ref<JS::Base>& v, PlankSize& p) { p.calcType = GetInt(v); } }
+};
+
+bool DecodeWindow(const GS::Ref<JS::Base>& value, WindowDoorInfo& window)
+{
+    window.guid = APINULLGuid;
+    window.id = IdPool::EmptyId;
+    window.elemType = CassetteHelper::ElemType::Window;
+    window.width = 0;
+    window.height = 0;
+    window.sillHeight = 0;
+    window.x = 0.0;
+    window.y = 0.0;
+    window.angle = 0.0;
+    window.normal = 0.0;
+    window.wall = APINULLGuid;
+    window.storey = 0;
+    window.calcType = -1;
+    return DecodeObject(value, WindowSchema, window);
+}
+
+bool DecodeCalcParams(const GS::Ref<JS::Base>& value, CalcParams& params)
+{
+    return DecodeObject(value, CalcParamsSchema, params);
+}
+
+bool DecodeTargets(const GS::Ref<JS::Base>& value, TargetObjects& targets)
+{
+    targets.overflowPages = false;
+    return DecodeObject(value, TargetsSchema, targets);
+}
+
+bool DecodeCassetteSize(const GS::Ref<JS::Base>& value, CassetteSize& size)
+{
+    size.x = 0;
+    size.y = 0;
+    size.count = 0;
+    return DecodeObject(value, CassetteSizeSchema, size);
+}
+
+bool DecodePlankSize(const GS::Ref<JS::Base>& value, PlankSize& size)
+{
+    size.width = 0;
+    size.length = 0;
+    size.count = 0;
+    size.calcType = 0;
+    return DecodeObject(value, PlankSizeSchema, size);
+}
+
+// Массив объектов одной схемы; элементы, которые не удалось разобрать, пропускаются
+template <typename T>
+static void DecodeArray(const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& table, const GS::UniString& key,
+                        bool (*decode)(const GS::Ref<JS::Base>&, T&), GS::Array<T>& target)
+{
+    GS::Ref<JS::Base> arrayBase;
+    if (!table.Get(key, &arrayBase)) {
+        return;
+    }
+    if (GS::Ref<JS::Array> jsArray = GS::DynamicCast<JS::Array>(arrayBase)) {
+        const GS::Array<GS::Ref<JS::Base>>& items = jsArray->GetItemArray();
+        target.EnsureCapacity(items.GetSize());
+        for (const GS::Ref<JS::Base>& item : items) {
+            T decoded;
+            if (decode(item, decoded)) {
+                target.Push(decoded);
+            }
+        }
+    }
+}
+
+static const GS::UniString CassettesKey("cassettes");
+static const GS::UniString PlanksKey("planks");
+static const GS::UniString LeftSlopesKey("leftSlopes");
+static const GS::UniString RightSlopesKey("rightSlopes");
+
+bool DecodeResult(const GS::Ref<JS::Base>& value, CassetteHelper::CalculationResult& result)
+{
+    result.cassettes.Clear();
+    result.planks.Clear();
+    result.leftSlopes.Clear();
+    result.rightSlopes.Clear();
+    result.duplicateIds.Clear();
+    result.errorMessage.Clear();
+    result.success = true;
+
+    GS::Ref<JS::Object> jsObject = GS::DynamicCast<JS::Object>(value);
+    if (jsObject == nullptr) {
+        return false;
+    }
+
+    const GS::HashTable<GS::UniString, GS::Ref<JS::Base>>& table = jsObject->GetItemTable();
+    DecodeArray(table, CassettesKey, DecodeCassetteSize, result.cassettes);
+    DecodeArray(table, PlanksKey, DecodePlankSize, result.planks);
+    DecodeArray(table, LeftSlopesKey, DecodePlankSize, result.leftSlopes);
+    DecodeArray(table, RightSlopesKey, DecodePlankSize, result.rightSlopes);
+    return true;
+}
+
+} // namespace JsDecode
@@ -0,0 +1,54 @@
+#ifndef JSDECODE_HPP
+#define JSDECODE_HPP
+
+// =============================================================================
+// JsDecode - Разбор значений JS моста в структуры CassetteHelper
+// =============================================================================
+// Поля объектов описываются схемами (ключ + функция разбора). Ключи созданы
+// один раз при загрузке модуля, поэтому при поиске в таблице объекта не
+// строятся временные GS::UniString. Числа из строк разбираются прямо по
+// символам UniString, без копирования и без ToCStr/sscanf.
+
+#include "APIEnvir.h"
+#include "ACAPinc.h"
+#include "CassetteHelper.hpp"
+
+namespace JsDecode {
+
+// =============================================================================
+// Примитивы
+// =============================================================================
+
+GS::UniString GetString(const GS::Ref<JS::Base>& p);
+double GetDouble(const GS::Ref<JS::Base>& p, double def = 0.0);
+Int32 GetInt(const GS::Ref<JS::Base>& p, Int32 def = 0);
+bool GetBool(const GS::Ref<JS::Base>& p, bool def = false);
+
+// Разбор числа из строки по месту ("1.25", "1,25", " -3e2 ").
+// Возвращает false, если в начале строки нет числа.
+bool ParseDouble(const GS::UniString& s, double& out);
+bool ParseInt(const GS::UniString& s, Int32& out);
+
+// =============================================================================
+// Схемы структур
+// =============================================================================
+
+// Окно/дверь из палитры (id, elemType, width, height, sillHeight, x, y, angle, normal, calcType)
+bool DecodeWindow(const GS::Ref<JS::Base>& value, CassetteHelper::WindowDoorInfo& window);
+
+// Параметры расчёта; отсутствующие поля остаются как есть
+bool DecodeCalcParams(const GS::Ref<JS::Base>& value, CassetteHelper::CalcParams& params);
+
+// ID целевых объектов; отсутствующие поля остаются как есть
+bool DecodeTargets(const GS::Ref<JS::Base>& value, CassetteHelper::TargetObjects& targets);
+
+// Строки результата расчёта (x, y, count) и (width, length, count, calcType)
+bool DecodeCassetteSize(const GS::Ref<JS::Base>& value, CassetteHelper::CassetteSize& size);
+bool DecodePlankSize(const GS::Ref<JS::Base>& value, CassetteHelper::PlankSize& size);
+
+// Результат расчёта { cassettes, planks, leftSlopes, rightSlopes }
+bool DecodeResult(const GS::Ref<JS::Base>& value, CassetteHelper::CalculationResult& result);
+
+} // namespace JsDecode
+
+#endif // JSDECODE_HPP
@@ -14,6 +14,7 @@
 // Cassette Panel includes
 #include "CassettePalette.hpp"
 #include "CassetteSettingsPalette.hpp"
+#include "AcHost.hpp"
 
 // -----------------------------------------------------------------------------
 // MenuCommandHandler
@@ -96,6 +97,12 @@ GSErrCode Initialize ()
 	if (DBERROR (settingsPalErr != NoError))
 		return settingsPalErr;
 
+	// 3) Уведомления об изменении стен и проёмов (кэш стен). Без них аддон
+	//    работает, просто читает стены без кэша
+	GSErrCode notifyErr = AcHost::InstallNotifications();
+	if (DBERROR (notifyErr != NoError))
+		WriteReport ("Cassette: уведомления не установлены (ошибка %d), кэш стен отключён", (int) notifyErr);
+
 	return NoError;
 }
 
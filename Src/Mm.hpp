@@ -0,0 +1,39 @@
+#ifndef MM_HPP
+#define MM_HPP
+
+// =============================================================================
+// Mm - Длины проёмов в целых миллиметрах
+// =============================================================================
+// Размеры окон приходят в метрах (double: Archicad, палитра, книги, снимки) и
+// переводятся в целые мм один раз - при чтении; дальше расчёт, сортировка,
+// мост и выгрузки работают с целыми. Округление одно: к ближайшему мм,
+// половина - от нуля (без промежуточных единиц, чтобы не округлять дважды).
+// Модуль не зависит от Archicad API (только стандартная библиотека).
+
+#include <cmath>
+#include <cstdint>
+
+namespace Mm {
+
+typedef int32_t Length;                 // Длина в мм
+
+const int32_t MmPerMetre = 1000;
+
+// Метры -> мм (за пределами int32 - граница диапазона)
+inline Length FromMetres(double metres)
+{
+    const double mm = std::round(metres * MmPerMetre);
+    if (!(mm > INT32_MIN)) {
+        return INT32_MIN;               // В т.ч. NaN
+    }
+    return mm < INT32_MAX ? static_cast<Length>(mm) : INT32_MAX;
+}
+
+inline double ToMetres(Length length)
+{
+    return static_cast<double>(length) / MmPerMetre;
+}
+
+} // namespace Mm
+
+#endif // MM_HPP
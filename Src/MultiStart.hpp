@@ -0,0 +1,98 @@
+#ifndef MULTISTART_HPP
+#define MULTISTART_HPP
+
+// =============================================================================
+// MultiStart - Параллельный поиск из многих попыток (раскрой, раскладка)
+// =============================================================================
+// Попытка start 0 выполняется первой и сразу становится лучшим решением;
+// остальные номера потоки берут по очереди. Поиск заканчивается, когда
+// решение достигло нижней границы, номера кончились (maxStarts), подряд
+// staleStarts попыток не дали улучшения или вышло время. При равных оценках
+// isBetter предпочитает меньший номер попытки - так результат меньше зависит
+// от того, какой поток закончил первым.
+// Модуль не зависит от Archicad API (только стандартная библиотека).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace MultiStart {
+
+struct Limits {
+    uint64_t maxStarts;         // Всего попыток
+    uint64_t staleStarts;       // Попыток подряд без улучшения
+};
+
+// Генератор попытки: у каждого номера своя воспроизводимая последовательность
+inline std::mt19937 Random(uint64_t start)
+{
+    return std::mt19937(static_cast<uint32_t>(start * 2654435761u));
+}
+
+// Случайный множитель ключа сортировки: разброс от base до base + range
+// по кругу из 8 попыток (малые перестановки чередуются с крупными)
+inline std::uniform_real_distribution<double> Jitter(uint64_t start, double base, double range)
+{
+    const double spread = base + range * static_cast<double>(start % 8) / 7.0;
+    return std::uniform_real_distribution<double>(1.0 - spread, 1.0 + spread);
+}
+
+// runStart(start, solution) - одна попытка; isBetter(a, b) - a лучше b;
+// isOptimal(solution) - лучше не бывает (нижняя граница), поиск можно прекратить
+template <typename Solution, typename RunStart, typename IsBetter, typename IsOptimal>
+void Search(const Limits& limits, unsigned threadCount, std::chrono::steady_clock::time_point deadline,
+            RunStart runStart, IsBetter isBetter, IsOptimal isOptimal, Solution& best, uint64_t& starts)
+{
+    runStart(0, best);
+    starts = 1;
+    if (isOptimal(best)) {
+        return;
+    }
+
+    std::atomic<uint64_t> next(1);
+    std::atomic<uint64_t> lastImproved(0);
+    std::atomic<bool> done(false);
+    std::mutex bestMutex;
+
+    auto worker = [&]() {
+        Solution solution;
+        for (;;) {
+            if (done || std::chrono::steady_clock::now() >= deadline) {
+                return;
+            }
+            const uint64_t start = next++;
+            if (start >= limits.maxStarts || start > lastImproved + limits.staleStarts) {
+                return;
+            }
+            runStart(start, solution);
+
+            std::lock_guard<std::mutex> lock(bestMutex);
+            ++starts;
+            if (isBetter(solution, best)) {
+                best = solution;
+                lastImproved = std::max<uint64_t>(lastImproved, start);
+                if (isOptimal(best)) {
+                    done = true;
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+} // namespace MultiStart
+
+#endif // MULTISTART_HPP
@@ -0,0 +1,201 @@
+// =============================================================================
+// OpeningIndex - Пространственный индекс проёмов (равномерная сетка)
+// =============================================================================
+
+#include "OpeningIndex.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace OpeningIndex {
+
+static const double Pi = 3.14159265358979323846;
+
+// Ячеек не больше CellsPerItem на проём (при вытянутом выделении сетка укрупняется)
+static const size_t CellsPerItem = 4;
+
+int FacadeOf(double normal)
+{
+    const double sector = 2.0 * Pi / FacadeCount;
+    const int facade = static_cast<int>(std::floor(normal / sector + 0.5)) % FacadeCount;
+    return facade < 0 ? facade + FacadeCount : facade;
+}
+
+static bool IsLocated(const Item& item)
+{
+    const HostApi::Guid noWall = {};
+    return item.wall != noWall;
+}
+
+Grid::Grid()
+{
+    Clear();
+}
+
+void Grid::Clear()
+{
+    located = 0;
+    points.clear();
+    originX = 0.0;
+    originY = 0.0;
+    cellSize = 1.0;
+    cols = 0;
+    rows = 0;
+    cellStart.clear();
+    cellItems.clear();
+    byWall.clear();
+    facadeStart.assign(FacadeCount + 1, 0);
+    facadeItems.clear();
+}
+
+// =============================================================================
+// Build
+// =============================================================================
+
+void Grid::Build(const std::vector<Item>& items)
+{
+    Clear();
+
+    points.reserve(items.size());
+    double maxX = 0.0;
+    double maxY = 0.0;
+    for (const Item& item : items) {
+        points.push_back(std::make_pair(item.x, item.y));
+        if (!IsLocated(item)) {
+            continue;
+        }
+        if (located == 0) {
+            originX = maxX = item.x;
+            originY = maxY = item.y;
+        } else {
+            originX = std::min(originX, item.x);
+            originY = std::min(originY, item.y);
+            maxX = std::max(maxX, item.x);
+            maxY = std::max(maxY, item.y);
+        }
+        ++located;
+    }
+    if (located == 0) {
+        return;
+    }
+
+    // Около двух проёмов на ячейку; для проёмов на одной линии - по длине
+    const double width = maxX - originX;
+    const double height = maxY - originY;
+    const double half = static_cast<double>(located) / 2.0;
+    if (width > 0.0 && height > 0.0) {
+        cellSize = std::sqrt(width * height / half);
+    } else if (width > 0.0 || height > 0.0) {
+        cellSize = std::max(width, height) / half;
+    }
+    cellSize = std::max(cellSize, 0.01);
+
+    const double maxCells = static_cast<double>(located * CellsPerItem + 16);
+    while ((std::floor(width / cellSize) + 1.0) * (std::floor(height / cellSize) + 1.0) > maxCells) {
+        cellSize *= 2.0;
+    }
+    cols = static_cast<int32_t>(width / cellSize) + 1;
+    rows = static_cast<int32_t>(height / cellSize) + 1;
+
+    // Ячейки: подсчёт, начала списков, раскладка (номера по возрастанию)
+    std::vector<uint32_t> cellOf(items.size(), 0);
+    cellStart.assign(static_cast<size_t>(cols) * rows + 1, 0);
+    facadeStart.assign(FacadeCount + 1, 0);
+    byWall.reserve(located);
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (!IsLocated(items[i])) {
+            continue;
+        }
+        const int32_t col = std::min(cols - 1, static_cast<int32_t>((items[i].x - originX) / cellSize));
+        const int32_t row = std::min(rows - 1, static_cast<int32_t>((items[i].y - originY) / cellSize));
+        cellOf[i] = static_cast<uint32_t>(row * cols + col);
+        ++cellStart[cellOf[i] + 1];
+        ++facadeStart[FacadeOf(items[i].normal) + 1];
+        byWall.push_back(std::make_pair(items[i].wall, static_cast<uint32_t>(i)));
+    }
+    for (size_t c = 1; c < cellStart.size(); ++c) {
+        cellStart[c] += cellStart[c - 1];
+    }
+    for (size_t f = 1; f < facadeStart.size(); ++f) {
+        facadeStart[f] += facadeStart[f - 1];
+    }
+
+    cellItems.resize(located);
+    facadeItems.resize(located);
+    std::vector<uint32_t> cellFill(cellStart.begin(), cellStart.end() - 1);
+    std::vector<uint32_t> facadeFill(facadeStart.begin(), facadeStart.end() - 1);
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (!IsLocated(items[i])) {
+            continue;
+        }
+        cellItems[cellFill[cellOf[i]]++] = static_cast<uint32_t>(i);
+        facadeItems[facadeFill[FacadeOf(items[i].normal)]++] = static_cast<uint32_t>(i);
+    }
+
+    // Номера внутри стены уже по возрастанию, stable_sort их сохраняет
+    std::stable_sort(byWall.begin(), byWall.end(),
+        [](const std::pair<HostApi::Guid, uint32_t>& a, const std::pair<HostApi::Guid, uint32_t>& b) {
+            return a.first < b.first;
+        });
+}
+
+// =============================================================================
+// Запросы
+// =============================================================================
+
+void Grid::QueryRect(double minX, double minY, double maxX, double maxY, std::vector<uint32_t>& result) const
+{
+    result.clear();
+    if (located == 0 || minX > maxX || minY > maxY) {
+        return;
+    }
+
+    // Пересекаемые ячейки (с обрезкой по сетке)
+    const double x0 = std::floor((minX - originX) / cellSize);
+    const double y0 = std::floor((minY - originY) / cellSize);
+    const double x1 = std::floor((maxX - originX) / cellSize);
+    const double y1 = std::floor((maxY - originY) / cellSize);
+    if (x1 < 0.0 || y1 < 0.0 || x0 >= cols || y0 >= rows) {
+        return;
+    }
+    const int32_t colBegin = static_cast<int32_t>(std::max(x0, 0.0));
+    const int32_t rowBegin = static_cast<int32_t>(std::max(y0, 0.0));
+    const int32_t colEnd = static_cast<int32_t>(std::min(x1, static_cast<double>(cols - 1)));
+    const int32_t rowEnd = static_cast<int32_t>(std::min(y1, static_cast<double>(rows - 1)));
+
+    for (int32_t row = rowBegin; row <= rowEnd; ++row) {
+        for (int32_t col = colBegin; col <= colEnd; ++col) {
+            const size_t cell = static_cast<size_t>(row) * cols + col;
+            for (uint32_t k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                const std::pair<double, double>& point = points[cellItems[k]];
+                if (point.first >= minX && point.first <= maxX && point.second >= minY && point.second <= maxY) {
+                    result.push_back(cellItems[k]);
+                }
+            }
+        }
+    }
+    std::sort(result.begin(), result.end());
+}
+
+void Grid::QueryWall(const HostApi::Guid& wall, std::vector<uint32_t>& result) const
+{
+    result.clear();
+    std::vector<std::pair<HostApi::Guid, uint32_t>>::const_iterator it = std::lower_bound(byWall.begin(), byWall.end(), wall,
+        [](const std::pair<HostApi::Guid, uint32_t>& entry, const HostApi::Guid& key) {
+            return entry.first < key;
+        });
+    for (; it != byWall.end() && it->first == wall; ++it) {
+        result.push_back(it->second);
+    }
+}
+
+void Grid::QueryFacade(int facade, std::vector<uint32_t>& result) const
+{
+    result.clear();
+    if (facade < 0 || facade >= FacadeCount) {
+        return;
+    }
+    result.assign(facadeItems.begin() + facadeStart[facade], facadeItems.begin() + facadeStart[facade + 1]);
+}
+
+} // namespace OpeningIndex
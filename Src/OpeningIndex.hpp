@@ -0,0 +1,78 @@
+#ifndef OPENINGINDEX_HPP
+#define OPENINGINDEX_HPP
+
+// =============================================================================
+// OpeningIndex - Пространственный индекс проёмов (равномерная сетка)
+// =============================================================================
+// Проёмы выделения раскладываются по ячейкам сетки на плане (в среднем
+// около двух проёмов на ячейку), по стенам и по фасадам. Запрос по
+// прямоугольнику просматривает только пересекаемые ячейки, запрос по стене
+// или фасаду - готовый список, поэтому выборка части большого выделения не
+// перебирает все проёмы.
+//
+// Фасад - сектор наружной нормали стены в точке проёма: 8 секторов по 45°,
+// сектор 0 - нормаль вдоль +X (от -22.5° до 22.5°), далее против часовой
+// стрелки. Нормаль учитывает отражение стены, поэтому стены одного фасада
+// попадают в один сектор, в какую бы сторону их ни рисовали, а
+// противоположные фасады - в разные.
+// Проёмы без известной стены (нулевой GUID) в индекс не попадают.
+// Модуль не зависит от Archicad API (только стандартная библиотека).
+
+#include "HostApi.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace OpeningIndex {
+
+const int FacadeCount = 8;
+
+// Сектор фасада для наружной нормали normal (рад), 0...FacadeCount - 1
+int FacadeOf(double normal);
+
+// Проём: точка на линии привязки стены и наружная нормаль стены в ней
+struct Item {
+    double x;                   // м
+    double y;
+    double normal;              // рад
+    HostApi::Guid wall;
+};
+
+class Grid {
+public:
+    Grid();
+
+    // Построить индекс; номера проёмов в запросах - индексы items
+    void Build(const std::vector<Item>& items);
+    void Clear();
+
+    size_t GetCount() const { return located; }
+
+    // Проёмы в прямоугольнике [minX, maxX] × [minY, maxY] (м), по возрастанию номера
+    void QueryRect(double minX, double minY, double maxX, double maxY, std::vector<uint32_t>& result) const;
+
+    // Проёмы стены wall, по возрастанию номера
+    void QueryWall(const HostApi::Guid& wall, std::vector<uint32_t>& result) const;
+
+    // Проёмы фасада facade (см. FacadeOf), по возрастанию номера
+    void QueryFacade(int facade, std::vector<uint32_t>& result) const;
+
+private:
+    size_t located;                                     // Проёмов в индексе
+    std::vector<std::pair<double, double>> points;      // Точки всех items
+    double originX;                                     // Левый нижний угол сетки
+    double originY;
+    double cellSize;                                    // Сторона ячейки, м
+    int32_t cols;
+    int32_t rows;
+    std::vector<uint32_t> cellStart;                    // cols * rows + 1 (начала списков ячеек)
+    std::vector<uint32_t> cellItems;
+    std::vector<std::pair<HostApi::Guid, uint32_t>> byWall;     // По GUID стены, затем номеру
+    std::vector<uint32_t> facadeStart;                  // FacadeCount + 1
+    std::vector<uint32_t> facadeItems;
+};
+
+} // namespace OpeningIndex
+
+#endif // OPENINGINDEX_HPP
@@ -0,0 +1,48 @@
+// =============================================================================
+// ResultStore - Результаты расчёта, хранящиеся на стороне C++
+// =============================================================================
+
+#include "ResultStore.hpp"
+
+#include <map>
+
+namespace ResultStore {
+
+// Сколько последних результатов держать в памяти
+static const size_t MaxResults = 16;
+
+// Дескрипторы растут монотонно, поэтому begin() - самый старый результат
+static std::map<Int32, CassetteHelper::CalculationResult> s_results;
+static Int32 s_nextHandle = 1;
+
+Int32 Put(const CassetteHelper::CalculationResult& result)
+{
+    while (s_results.size() >= MaxResults) {
+        s_results.erase(s_results.begin());
+    }
+
+    const Int32 handle = s_nextHandle++;
+    s_results[handle] = result;
+    return handle;
+}
+
+const CassetteHelper::CalculationResult* Get(Int32 handle)
+{
+    auto it = s_results.find(handle);
+    if (it == s_results.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+bool Release(Int32 handle)
+{
+    return s_results.erase(handle) > 0;
+}
+
+void Clear()
+{
+    s_results.clear();
+}
+
+} // namespace ResultStore
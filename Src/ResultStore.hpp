@@ -0,0 +1,33 @@
+#ifndef RESULTSTORE_HPP
+#define RESULTSTORE_HPP
+
+// =============================================================================
+// ResultStore - Результаты расчёта, хранящиеся на стороне C++
+// =============================================================================
+// CalculateCassettes и импорт кладут результат сюда и возвращают в JS только
+// числовой дескриптор. Экспорт и запись в объекты получают результат по
+// дескриптору, поэтому большие таблицы не гоняются через мост туда и обратно.
+
+#include "CassetteHelper.hpp"
+
+namespace ResultStore {
+
+// Неверный дескриптор
+const Int32 InvalidHandle = 0;
+
+// Сохранить результат; возвращает новый дескриптор (> 0).
+// Хранится ограниченное число последних результатов, старые вытесняются.
+Int32 Put(const CassetteHelper::CalculationResult& result);
+
+// Результат по дескриптору или nullptr, если он уже вытеснен/удалён
+const CassetteHelper::CalculationResult* Get(Int32 handle);
+
+// Удалить результат
+bool Release(Int32 handle);
+
+// Удалить все результаты
+void Clear();
+
+} // namespace ResultStore
+
+#endif // RESULTSTORE_HPP
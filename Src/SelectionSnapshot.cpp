@@ -0,0 +1,316 @@
+// =============================================================================
+// SelectionSnapshot - Кэш выделенных окон/дверей для постраничной выдачи в JS
+// =============================================================================
+
+#include "SelectionSnapshot.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+namespace SelectionSnapshot {
+
+using CassetteHelper::WindowDoorInfo;
+
+// =============================================================================
+// Состояние снимка
+// =============================================================================
+
+static GS::Array<WindowDoorInfo> s_windows;         // Элементы в порядке выделения
+static GS::Array<CassetteHelper::DuplicateGroup> s_duplicateGroups;    // Повторяющиеся ID и их элементы
+static std::vector<Int32> s_duplicateGroupOf;       // Группа дубликатов по индексу элемента (-1 - нет)
+static OpeningIndex::Grid s_index;                  // Проёмы по ячейкам плана, стенам и фасадам
+
+static std::vector<int8_t> s_idMatch;               // Фильтр ID по дескриптору пула: -1 - не проверен, 0/1
+static std::vector<UInt32> s_idRank;                // Место ID по алфавиту по дескриптору пула (сортировка)
+
+static std::vector<UIndex> s_view;                  // Индексы элементов текущего представления
+static ViewQuery s_viewQuery = GetDefaultQuery();   // Запрос, по которому построено представление
+static bool s_viewValid = false;
+
+// =============================================================================
+// Вспомогательные функции
+// =============================================================================
+
+static bool IsSameQuery(const ViewQuery& a, const ViewQuery& b)
+{
+    return a.sortKey == b.sortKey &&
+        a.descending == b.descending &&
+        a.calcTypeFilter == b.calcTypeFilter &&
+        a.duplicatesOnly == b.duplicatesOnly &&
+        a.idFilter == b.idFilter &&
+        a.regionFilter == b.regionFilter &&
+        (!a.regionFilter || (a.regionMinX == b.regionMinX && a.regionMinY == b.regionMinY &&
+                             a.regionMaxX == b.regionMaxX && a.regionMaxY == b.regionMaxY)) &&
+        a.wallFilter == b.wallFilter &&
+        a.facadeFilter == b.facadeFilter;
+}
+
+static bool HasPlanFilter(const ViewQuery& query)
+{
+    return query.regionFilter || query.wallFilter != APINULLGuid || query.facadeFilter != -1;
+}
+
+// candidates ∩ part (оба по возрастанию); первая выборка берётся как есть
+static void Intersect(std::vector<uint32_t>& candidates, std::vector<uint32_t>& part, bool& first)
+{
+    if (first) {
+        candidates.swap(part);
+        first = false;
+        return;
+    }
+    std::vector<uint32_t> merged;
+    std::set_intersection(candidates.begin(), candidates.end(), part.begin(), part.end(), std::back_inserter(merged));
+    candidates.swap(merged);
+}
+
+// Кандидаты по фильтрам плана (по возрастанию индекса): пересечение выборок индекса
+static void QueryPlan(const ViewQuery& query, std::vector<uint32_t>& candidates)
+{
+    std::vector<uint32_t> part;
+    bool first = true;
+
+    candidates.clear();
+    if (query.regionFilter) {
+        s_index.QueryRect(query.regionMinX, query.regionMinY, query.regionMaxX, query.regionMaxY, part);
+        Intersect(candidates, part, first);
+    }
+    if (query.wallFilter != APINULLGuid) {
+        HostApi::Guid wall;
+        std::memcpy(wall.bytes, &query.wallFilter, sizeof(wall.bytes));
+        s_index.QueryWall(wall, part);
+        Intersect(candidates, part, first);
+    }
+    if (query.facadeFilter != -1) {
+        s_index.QueryFacade(query.facadeFilter, part);
+        Intersect(candidates, part, first);
+    }
+}
+
+static bool PassesFilter(const ViewQuery& query, UIndex index)
+{
+    const WindowDoorInfo& w = s_windows[index];
+
+    if (query.calcTypeFilter != -2 && w.calcType != query.calcTypeFilter) {
+        return false;
+    }
+    if (query.duplicatesOnly && s_duplicateGroupOf[index] < 0) {
+        return false;
+    }
+    if (!query.idFilter.IsEmpty()) {
+        // Строка сравнивается один раз на различный ID
+        int8_t& match = s_idMatch[w.id];
+        if (match < 0) {
+            match = IdPool::Get(w.id).Contains(query.idFilter, GS::UniString::CaseInsensitive) ? 1 : 0;
+        }
+        if (match == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Места ID снимка по алфавиту: строки сравниваются только между различными ID
+static void RankIds()
+{
+    std::vector<IdPool::Handle> ids;
+    std::vector<bool> seen(IdPool::GetCount(), false);
+    for (const WindowDoorInfo& w : s_windows) {
+        if (!seen[w.id]) {
+            seen[w.id] = true;
+            ids.push_back(w.id);
+        }
+    }
+    std::sort(ids.begin(), ids.end(), [](IdPool::Handle a, IdPool::Handle b) {
+        return IdPool::Get(a) < IdPool::Get(b);
+    });
+
+    s_idRank.assign(IdPool::GetCount(), 0);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        s_idRank[ids[i]] = static_cast<UInt32>(i);
+    }
+}
+
+// Сравнение двух элементов по ключу сортировки (строго "меньше")
+static bool LessByKey(SortKey key, const WindowDoorInfo& a, const WindowDoorInfo& b)
+{
+    switch (key) {
+        case SortKey::Id:         return s_idRank[a.id] < s_idRank[b.id];
+        case SortKey::Width:      return a.width < b.width;
+        case SortKey::Height:     return a.height < b.height;
+        case SortKey::SillHeight: return a.sillHeight < b.sillHeight;
+        case SortKey::CalcType:   return a.calcType < b.calcType;
+        default:                  return false;
+    }
+}
+
+// =============================================================================
+// Запросы
+// =============================================================================
+
+ViewQuery GetDefaultQuery()
+{
+    ViewQuery query;
+    query.sortKey = SortKey::None;
+    query.descending = false;
+    query.calcTypeFilter = -2;
+    query.duplicatesOnly = false;
+    query.regionFilter = false;
+    query.regionMinX = 0.0;
+    query.regionMinY = 0.0;
+    query.regionMaxX = 0.0;
+    query.regionMaxY = 0.0;
+    query.wallFilter = APINULLGuid;
+    query.facadeFilter = -1;
+    return query;
+}
+
+SortKey SortKeyFromString(const GS::UniString& key)
+{
+    if (key == "id")         return SortKey::Id;
+    if (key == "width")      return SortKey::Width;
+    if (key == "height")     return SortKey::Height;
+    if (key == "sillHeight") return SortKey::SillHeight;
+    if (key == "calcType")   return SortKey::CalcType;
+    return SortKey::None;
+}
+
+// =============================================================================
+// Refresh - обновить снимок из выделения
+// =============================================================================
+
+void Refresh()
+{
+    s_windows = CassetteHelper::GetSelectedWindowsDoors();
+    s_duplicateGroups = CassetteHelper::FindDuplicateGroups(s_windows);
+
+    // Группа каждого элемента - из индексов групп, без повторного подсчёта
+    s_duplicateGroupOf.assign(s_windows.GetSize(), -1);
+    for (UIndex g = 0; g < s_duplicateGroups.GetSize(); ++g) {
+        for (UIndex index : s_duplicateGroups[g].indices) {
+            s_duplicateGroupOf[index] = static_cast<Int32>(g);
+        }
+    }
+
+    std::vector<OpeningIndex::Item> items(s_windows.GetSize());
+    for (UIndex i = 0; i < s_windows.GetSize(); ++i) {
+        items[i].x = s_windows[i].x;
+        items[i].y = s_windows[i].y;
+        items[i].normal = s_windows[i].normal;
+        std::memcpy(items[i].wall.bytes, &s_windows[i].wall, sizeof(items[i].wall.bytes));
+    }
+    s_index.Build(items);
+
+    s_view.clear();
+    s_viewValid = false;
+}
+
+USize GetCount()
+{
+    return s_windows.GetSize();
+}
+
+const GS::Array<WindowDoorInfo>& GetWindows()
+{
+    return s_windows;
+}
+
+const GS::Array<CassetteHelper::DuplicateGroup>& GetDuplicateGroups()
+{
+    return s_duplicateGroups;
+}
+
+bool IsDuplicate(UIndex index)
+{
+    return GetDuplicateGroup(index) >= 0;
+}
+
+Int32 GetDuplicateGroup(UIndex index)
+{
+    return index < s_duplicateGroupOf.size() ? s_duplicateGroupOf[index] : -1;
+}
+
+const OpeningIndex::Grid& GetIndex()
+{
+    return s_index;
+}
+
+Int32 GetFacade(UIndex index)
+{
+    if (index >= s_windows.GetSize() || s_windows[index].wall == APINULLGuid) {
+        return -1;
+    }
+    return OpeningIndex::FacadeOf(s_windows[index].normal);
+}
+
+// =============================================================================
+// ApplyQuery - построить представление (фильтр + сортировка)
+// =============================================================================
+
+USize ApplyQuery(const ViewQuery& query)
+{
+    if (s_viewValid && IsSameQuery(query, s_viewQuery)) {
+        return static_cast<USize>(s_view.size());
+    }
+
+    s_view.clear();
+    if (!query.idFilter.IsEmpty()) {
+        s_idMatch.assign(IdPool::GetCount(), -1);
+    }
+    if (query.sortKey == SortKey::Id) {
+        RankIds();
+    }
+    if (HasPlanFilter(query)) {
+        // Только проёмы из выборки индекса, остальные не просматриваются
+        std::vector<uint32_t> candidates;
+        QueryPlan(query, candidates);
+        s_view.reserve(candidates.size());
+        for (uint32_t i : candidates) {
+            if (PassesFilter(query, static_cast<UIndex>(i))) {
+                s_view.push_back(static_cast<UIndex>(i));
+            }
+        }
+    } else {
+        s_view.reserve(s_windows.GetSize());
+        for (UIndex i = 0; i < s_windows.GetSize(); ++i) {
+            if (PassesFilter(query, i)) {
+                s_view.push_back(i);
+            }
+        }
+    }
+
+    // stable_sort сохраняет порядок выделения среди равных значений
+    if (query.sortKey != SortKey::None) {
+        const SortKey key = query.sortKey;
+        if (query.descending) {
+            std::stable_sort(s_view.begin(), s_view.end(), [key](UIndex a, UIndex b) {
+                return LessByKey(key, s_windows[b], s_windows[a]);
+            });
+        } else {
+            std::stable_sort(s_view.begin(), s_view.end(), [key](UIndex a, UIndex b) {
+                return LessByKey(key, s_windows[a], s_windows[b]);
+            });
+        }
+    }
+
+    s_viewQuery = query;
+    s_viewValid = true;
+    return static_cast<USize>(s_view.size());
+}
+
+GS::Array<UIndex> GetPage(UIndex offset, USize count)
+{
+    GS::Array<UIndex> page;
+    if (!s_viewValid) {
+        ApplyQuery(s_viewQuery);
+    }
+
+    const size_t end = std::min(s_view.size(), static_cast<size_t>(offset) + count);
+    for (size_t i = offset; i < end; ++i) {
+        page.Push(s_view[i]);
+    }
+    return page;
+}
+
+} // namespace SelectionSnapshot
@@ -0,0 +1,75 @@
+#ifndef SELECTIONSNAPSHOT_HPP
+#define SELECTIONSNAPSHOT_HPP
+
+// =============================================================================
+// SelectionSnapshot - Кэш выделенных окон/дверей для постраничной выдачи в JS
+// =============================================================================
+// Снимок выделения хранится на стороне C++. Палитра запрашивает только видимые
+// строки таблицы (GetCassetteSelectionPage), сортировка и фильтрация выполняются
+// здесь же, поэтому в браузер не передаётся весь список окон.
+
+#include "CassetteHelper.hpp"
+#include "OpeningIndex.hpp"
+
+namespace SelectionSnapshot {
+
+// Ключ сортировки таблицы окон
+enum class SortKey {
+    None = 0,       // Порядок выделения
+    Id,
+    Width,
+    Height,
+    SillHeight,
+    CalcType
+};
+
+// Параметры представления (сортировка + фильтр)
+struct ViewQuery {
+    SortKey sortKey;            // Ключ сортировки
+    bool descending;            // По убыванию
+    GS::UniString idFilter;     // Подстрока ID (пусто - без фильтра)
+    Int32 calcTypeFilter;       // Тип элемента: -2 - все, -1/0/1/2 - конкретный
+    bool duplicatesOnly;        // Только элементы с повторяющимся ID
+    // Фильтры по плану - через OpeningIndex, без перебора всего снимка
+    bool regionFilter;          // Только проёмы в прямоугольнике region* (м)
+    double regionMinX;
+    double regionMinY;
+    double regionMaxX;
+    double regionMaxY;
+    API_Guid wallFilter;        // Только проёмы стены (APINULLGuid - все)
+    Int32 facadeFilter;         // Фасад (OpeningIndex::FacadeOf): -1 - все
+};
+
+// Представление по умолчанию: порядок выделения, без фильтра
+ViewQuery GetDefaultQuery();
+
+// Разобрать ключ сортировки из строки JS ("id", "width", "height", "sillHeight", "calcType")
+SortKey SortKeyFromString(const GS::UniString& key);
+
+// Обновить снимок из текущего выделения Archicad
+void Refresh();
+
+// Данные снимка
+USize GetCount();
+const GS::Array<CassetteHelper::WindowDoorInfo>& GetWindows();
+const GS::Array<CassetteHelper::DuplicateGroup>& GetDuplicateGroups();
+bool IsDuplicate(UIndex index);
+// Номер группы GetDuplicateGroups элемента; -1 - ID не повторяется
+Int32 GetDuplicateGroup(UIndex index);
+
+// Пространственный индекс снимка (номера проёмов - индексы GetWindows)
+const OpeningIndex::Grid& GetIndex();
+
+// Фасад проёма; -1 - стена не известна
+Int32 GetFacade(UIndex index);
+
+// Применить сортировку и фильтр. Пересчёт выполняется только при смене запроса.
+// Возвращает количество строк в представлении.
+USize ApplyQuery(const ViewQuery& query);
+
+// Индексы элементов снимка для строк представления [offset, offset + count)
+GS::Array<UIndex> GetPage(UIndex offset, USize count);
+
+} // namespace SelectionSnapshot
+
+#endif // SELECTIONSNAPSHOT_HPP
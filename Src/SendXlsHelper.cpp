@@ -0,0 +1,213 @@
+// =============================================================================
+// SendXlsHelper - Выгрузка в Excel (.xlsx) для ACAPI.SaveSendXls
+// =============================================================================
+
+#include "SendXlsHelper.hpp"
+#include "SelectionSnapshot.hpp"
+#include "XlsxWriter.hpp"
+
+namespace SendXlsHelper {
+
+using CassetteHelper::CassetteSize;
+using CassetteHelper::PlankSize;
+
+// =============================================================================
+// Вспомогательные функции
+// =============================================================================
+
+static bool OpenBook(Xlsx::Writer& book, const GS::UniString& path, GS::UniString& errorMessage)
+{
+    if (!book.Open(path)) {
+        errorMessage = "Не удалось создать файл: " + path;
+        return false;
+    }
+    return true;
+}
+
+static bool CloseBook(Xlsx::Writer& book, const GS::UniString& path, UInt32& rowCount, GS::UniString& errorMessage)
+{
+    rowCount = book.GetRowCount();
+    if (!book.Close()) {
+        errorMessage = "Ошибка записи файла: " + path;
+        return false;
+    }
+    return true;
+}
+
+static void WriteHeader(Xlsx::Writer& book, const GS::UniString* titles, size_t count)
+{
+    book.BeginRow(true);
+    for (size_t i = 0; i < count; ++i) {
+        book.Text(titles[i]);
+    }
+    book.EndRow();
+}
+
+// Ячейка из значения JS
+static void WriteJsCell(Xlsx::Writer& book, const GS::Ref<JS::Base>& item)
+{
+    GS::Ref<JS::Value> value = GS::DynamicCast<JS::Value>(item);
+    if (value == nullptr) {
+        book.Skip();
+        return;
+    }
+
+    switch (value->GetType()) {
+        case JS::Value::STRING:   book.Text(value->GetString()); break;
+        case JS::Value::DOUBLE:   book.Number(value->GetDouble()); break;
+        case JS::Value::INTEGER:  book.Integer(value->GetInteger()); break;
+        case JS::Value::BOOL:     book.Text(value->GetBool() ? "Да" : "Нет"); break;
+        default:                  book.Skip(); break;
+    }
+}
+
+// =============================================================================
+// SaveSelection
+// =============================================================================
+
+bool SaveSelection(const GS::UniString& path, UInt32& rowCount, GS::UniString& errorMessage)
+{
+    rowCount = 0;
+
+    Xlsx::Writer book;
+    if (!OpenBook(book, path, errorMessage)) {
+        return false;
+    }
+
+    static const GS::UniString titles[] = {
+        "ID", "Тип элемента", "Ширина, м", "Высота, м", "Подоконник, м", "Тип расчёта", "Дубликат", "GUID"
+    };
+    static const GS::UniString yes("Да");
+
+    book.BeginSheet("Окна и двери");
+    WriteHeader(book, titles, sizeof(titles) / sizeof(titles[0]));
+
+    // Строки в порядке текущего представления таблицы (сортировка и фильтр палитры)
+    const GS::Array<CassetteHelper::WindowDoorInfo>& windows = SelectionSnapshot::GetWindows();
+    const GS::Array<UIndex> view = SelectionSnapshot::GetPage(0, SelectionSnapshot::GetCount());
+    for (UIndex index : view) {
+        const CassetteHelper::WindowDoorInfo& w = windows[index];
+        book.BeginRow();
+        book.InlineText(IdPool::Get(w.id));
+        book.Text(CassetteHelper::GetElemTypeName(w.elemType));
+        book.Number(Mm::ToMetres(w.width));
+        book.Number(Mm::ToMetres(w.height));
+        book.Number(Mm::ToMetres(w.sillHeight));
+        book.Integer(w.calcType);
+        if (SelectionSnapshot::IsDuplicate(index)) {
+            book.Text(yes);
+        } else {
+            book.Skip();
+        }
+        book.InlineText(APIGuidToString(w.guid));
+        book.EndRow();
+    }
+
+    return CloseBook(book, path, rowCount, errorMessage);
+}
+
+// =============================================================================
+// SaveResult
+// =============================================================================
+
+bool SaveResult(const GS::UniString& path,
+                const CassetteHelper::CalculationResult& result,
+                UInt32& rowCount,
+                GS::UniString& errorMessage)
+{
+    rowCount = 0;
+
+    Xlsx::Writer book;
+    if (!OpenBook(book, path, errorMessage)) {
+        return false;
+    }
+
+    static const GS::UniString titles[] = {
+        "Тип", "Тип элемента", "Размер X", "Размер Y", "Количество"
+    };
+    static const GS::UniString cassette("Кассета");
+    static const GS::UniString plank("Планка");
+    static const GS::UniString leftSlope("Левый откос");
+    static const GS::UniString rightSlope("Правый откос");
+    static const GS::UniString type0("0");
+    static const GS::UniString type12("1-2");
+
+    book.BeginSheet("Результат");
+    WriteHeader(book, titles, sizeof(titles) / sizeof(titles[0]));
+
+    for (const CassetteSize& c : result.cassettes) {
+        book.BeginRow();
+        book.Text(cassette);
+        book.Text(type12);
+        book.Integer(c.x);
+        book.Integer(c.y);
+        book.Integer(c.count);
+        book.EndRow();
+    }
+
+    auto writePlanks = [&book](const GS::UniString& rowType, const GS::Array<PlankSize>& list) {
+        for (const PlankSize& p : list) {
+            book.BeginRow();
+            book.Text(rowType);
+            book.Text(p.calcType == 0 ? type0 : type12);
+            book.Integer(p.width);
+            book.Integer(p.length);
+            book.Integer(p.count);
+            book.EndRow();
+        }
+    };
+    writePlanks(plank, result.planks);
+    writePlanks(leftSlope, result.leftSlopes);
+    writePlanks(rightSlope, result.rightSlopes);
+
+    return CloseBook(book, path, rowCount, errorMessage);
+}
+
+// =============================================================================
+// SaveJsTable
+// =============================================================================
+
+bool SaveJsTable(const GS::UniString& path,
+                 const GS::UniString& sheetName,
+                 const GS::Ref<JS::Base>& columns,
+                 const GS::Ref<JS::Base>& rows,
+                 UInt32& rowCount,
+                 GS::UniString& errorMessage)
+{
+    rowCount = 0;
+
+    GS::Ref<JS::Array> jsRows = GS::DynamicCast<JS::Array>(rows);
+    if (jsRows == nullptr) {
+        errorMessage = "rows не является массивом";
+        return false;
+    }
+
+    Xlsx::Writer book;
+    if (!OpenBook(book, path, errorMessage)) {
+        return false;
+    }
+
+    book.BeginSheet(sheetName.IsEmpty() ? GS::UniString("Данные") : sheetName);
+
+    if (GS::Ref<JS::Array> jsColumns = GS::DynamicCast<JS::Array>(columns)) {
+        book.BeginRow(true);
+        for (const GS::Ref<JS::Base>& title : jsColumns->GetItemArray()) {
+            WriteJsCell(book, title);
+        }
+        book.EndRow();
+    }
+
+    for (const GS::Ref<JS::Base>& rowBase : jsRows->GetItemArray()) {
+        book.BeginRow();
+        if (GS::Ref<JS::Array> jsRow = GS::DynamicCast<JS::Array>(rowBase)) {
+            for (const GS::Ref<JS::Base>& item : jsRow->GetItemArray()) {
+                WriteJsCell(book, item);
+            }
+        }
+        book.EndRow();
+    }
+
+    return CloseBook(book, path, rowCount, errorMessage);
+}
+
+} // namespace SendXlsHelper
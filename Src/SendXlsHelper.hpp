@@ -0,0 +1,37 @@
+#ifndef SENDXLSHELPER_HPP
+#define SENDXLSHELPER_HPP
+
+// =============================================================================
+// SendXlsHelper - Выгрузка в Excel (.xlsx) для ACAPI.SaveSendXls
+// =============================================================================
+// Источники данных:
+//   - снимок выделения (SelectionSnapshot) в текущем порядке/фильтре таблицы;
+//   - результат расчёта из ResultStore;
+//   - произвольная таблица из JS (columns + rows).
+// Книга пишется потоково (см. XlsxWriter), память не растёт с числом строк.
+
+#include "CassetteHelper.hpp"
+
+namespace SendXlsHelper {
+
+// Выделенные окна/двери (как в таблице палитры)
+bool SaveSelection(const GS::UniString& path, UInt32& rowCount, GS::UniString& errorMessage);
+
+// Результат расчёта: кассеты, планки и откосы на одном листе
+bool SaveResult(const GS::UniString& path,
+                const CassetteHelper::CalculationResult& result,
+                UInt32& rowCount,
+                GS::UniString& errorMessage);
+
+// Таблица из JS: columns - массив заголовков, rows - массив массивов значений
+// (строки и числа; прочие значения дают пустую ячейку)
+bool SaveJsTable(const GS::UniString& path,
+                 const GS::UniString& sheetName,
+                 const GS::Ref<JS::Base>& columns,
+                 const GS::Ref<JS::Base>& rows,
+                 UInt32& rowCount,
+                 GS::UniString& errorMessage);
+
+} // namespace SendXlsHelper
+
+#endif // SENDXLSHELPER_HPP
@@ -0,0 +1,545 @@
+// =============================================================================
+// SheetNesting - Раскладка заготовок кассет на листы (двумерный раскрой)
+// =============================================================================
+
+#include "SheetNesting.hpp"
+#include "MultiStart.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <random>
+#include <thread>
+#include <tuple>
+
+namespace SheetNesting {
+
+// Пределы поиска: попытка дороже, чем в CuttingStock, поэтому их меньше
+static const MultiStart::Limits SearchLimits = { 256, 48 };
+
+Params GetDefaultParams()
+{
+    Params p;
+    p.sheetWidth = 1250;
+    p.sheetHeight = 2500;
+    p.foldAllowance = 40;
+    p.gap = 4;
+    p.margin = 10;
+    p.allowRotation = true;
+    p.guillotine = false;
+    p.threads = 0;
+    p.timeLimitMs = 3000;
+    return p;
+}
+
+// =============================================================================
+// Листы
+// =============================================================================
+// Размеры заготовок увеличены на зазор, рабочая область листа - на зазор
+// меньше двух полей: так зазор между соседями и у края учитывается одинаково.
+
+struct Rect {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+struct Item {
+    int width;                  // С зазором
+    int height;
+    int source;                 // Номер строки кассет
+};
+
+struct Placed {
+    Rect rect;                  // С зазором
+    int source;
+    bool rotated;
+};
+
+enum class Rule {
+    ShortSide,                  // Наименьший остаток по короткой стороне
+    Area,                       // Наименьшая свободная площадь вокруг
+    BottomLeft,                 // Ниже и левее
+    Count
+};
+
+// Оценка места: меньше - лучше
+struct Score {
+    int64_t primary;
+    int64_t secondary;
+
+    bool operator< (const Score& other) const
+    {
+        return primary != other.primary ? primary < other.primary : secondary < other.secondary;
+    }
+};
+
+static const Score WorstScore = { std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::max() };
+
+static Score ScoreFit(Rule rule, const Rect& free, int width, int height)
+{
+    const int64_t leftoverX = free.width - width;
+    const int64_t leftoverY = free.height - height;
+    switch (rule) {
+        case Rule::ShortSide:
+            return { std::min(leftoverX, leftoverY), std::max(leftoverX, leftoverY) };
+        case Rule::Area:
+            return { static_cast<int64_t>(free.width) * free.height - static_cast<int64_t>(width) * height,
+                     std::min(leftoverX, leftoverY) };
+        case Rule::BottomLeft:
+        default:
+            return { static_cast<int64_t>(free.y) + height, free.x };
+    }
+}
+
+class Sheet {
+public:
+    Sheet(int width, int height, bool guillotine) :
+        guillotine(guillotine),
+        freeArea(static_cast<int64_t>(width) * height),
+        maxFreeWidth(width),
+        maxFreeHeight(height)
+    {
+        freeRects.push_back({ 0, 0, width, height });
+    }
+
+    int64_t FreeArea() const { return freeArea; }
+
+    // Может ли поместиться заготовка площадью не меньше area и короткой стороной не меньше side
+    bool CanFit(int64_t area, int side) const
+    {
+        return freeArea >= area && maxFreeWidth >= side && maxFreeHeight >= side;
+    }
+    const std::vector<Placed>& Parts() const { return parts; }
+
+    // Лучшее место для заготовки; false - не помещается
+    bool Find(const Item& item, Rule rule, bool allowRotation, Score& score, size_t& freeIndex, bool& rotated) const
+    {
+        score = WorstScore;
+        bool found = false;
+        // Быстрый отказ: не помещается ни в один свободный прямоугольник по габаритам
+        const bool straight = item.width <= maxFreeWidth && item.height <= maxFreeHeight;
+        const bool turned = allowRotation && item.height <= maxFreeWidth && item.width <= maxFreeHeight;
+        if (!straight && !turned) {
+            return false;
+        }
+        for (size_t i = 0; i < freeRects.size(); ++i) {
+            const Rect& free = freeRects[i];
+            if (item.width <= free.width && item.height <= free.height) {
+                const Score s = ScoreFit(rule, free, item.width, item.height);
+                if (s < score) {
+                    score = s;
+                    freeIndex = i;
+                    rotated = false;
+                    found = true;
+                }
+            }
+            if (allowRotation && item.width != item.height && item.height <= free.width && item.width <= free.height) {
+                const Score s = ScoreFit(rule, free, item.height, item.width);
+                if (s < score) {
+                    score = s;
+                    freeIndex = i;
+                    rotated = true;
+                    found = true;
+                }
+            }
+        }
+        return found;
+    }
+
+    void Place(const Item& item, size_t freeIndex, bool rotated)
+    {
+        const Rect free = freeRects[freeIndex];
+        const Rect used = { free.x, free.y, rotated ? item.height : item.width, rotated ? item.width : item.height };
+        parts.push_back({ used, item.source, rotated });
+        freeArea -= static_cast<int64_t>(used.width) * used.height;
+
+        if (guillotine) {
+            SplitGuillotine(freeIndex, used);
+        } else {
+            SplitMaxRects(used);
+        }
+
+        maxFreeWidth = 0;
+        maxFreeHeight = 0;
+        for (const Rect& free : freeRects) {
+            maxFreeWidth = std::max(maxFreeWidth, free.width);
+            maxFreeHeight = std::max(maxFreeHeight, free.height);
+        }
+    }
+
+private:
+    // Гильотина: кусок делится одним резом вдоль короткого остатка, чтобы
+    // больший остаток остался цельным
+    void SplitGuillotine(size_t freeIndex, const Rect& used)
+    {
+        const Rect free = freeRects[freeIndex];
+        freeRects[freeIndex] = freeRects.back();
+        freeRects.pop_back();
+
+        const int leftoverX = free.width - used.width;
+        const int leftoverY = free.height - used.height;
+        const bool splitHorizontal = leftoverX < leftoverY;
+
+        Rect right = { free.x + used.width, free.y, leftoverX, splitHorizontal ? used.height : free.height };
+        Rect top = { free.x, free.y + used.height, splitHorizontal ? free.width : used.width, leftoverY };
+        if (right.width > 0 && right.height > 0) {
+            freeRects.push_back(right);
+        }
+        if (top.width > 0 && top.height > 0) {
+            freeRects.push_back(top);
+        }
+    }
+
+    // MaxRects: каждый свободный прямоугольник, задетый деталью, заменяется
+    // до четырёх максимальными остатками; вложенные удаляются
+    void SplitMaxRects(const Rect& used)
+    {
+        const size_t count = freeRects.size();
+        std::vector<bool> split(count, false);
+        for (size_t i = 0; i < count; ++i) {
+            const Rect free = freeRects[i];
+            if (used.x >= free.x + free.width || used.x + used.width <= free.x ||
+                used.y >= free.y + free.height || used.y + used.height <= free.y) {
+                continue;
+            }
+            split[i] = true;
+            if (used.x > free.x) {
+                freeRects.push_back({ free.x, free.y, used.x - free.x, free.height });
+            }
+            if (used.x + used.width < free.x + free.width) {
+                freeRects.push_back({ used.x + used.width, free.y, free.x + free.width - used.x - used.width, free.height });
+            }
+            if (used.y > free.y) {
+                freeRects.push_back({ free.x, free.y, free.width, used.y - free.y });
+            }
+            if (used.y + used.height < free.y + free.height) {
+                freeRects.push_back({ free.x, used.y + used.height, free.width, free.y + free.height - used.y - used.height });
+            }
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < freeRects.size(); ++i) {
+            if (i >= count || !split[i]) {
+                freeRects[kept++] = freeRects[i];
+            }
+        }
+        freeRects.resize(kept);
+        Prune();
+    }
+
+    void Prune()
+    {
+        std::vector<bool> removed(freeRects.size(), false);
+        for (size_t i = 0; i < freeRects.size(); ++i) {
+            if (removed[i]) {
+                continue;
+            }
+            for (size_t j = i + 1; j < freeRects.size(); ++j) {
+                if (removed[j]) {
+                    continue;
+                }
+                if (Contains(freeRects[j], freeRects[i])) {
+                    removed[i] = true;
+                    break;
+                }
+                if (Contains(freeRects[i], freeRects[j])) {
+                    removed[j] = true;
+                }
+            }
+        }
+        size_t kept = 0;
+        for (size_t i = 0; i < freeRects.size(); ++i) {
+            if (!removed[i]) {
+                freeRects[kept++] = freeRects[i];
+            }
+        }
+        freeRects.resize(kept);
+    }
+
+    static bool Contains(const Rect& outer, const Rect& inner)
+    {
+        return inner.x >= outer.x && inner.y >= outer.y &&
+               inner.x + inner.width <= outer.x + outer.width &&
+               inner.y + inner.height <= outer.y + outer.height;
+    }
+
+    bool guillotine;
+    int64_t freeArea;
+    int maxFreeWidth;           // Наибольшие ширина и высота свободных прямоугольников
+    int maxFreeHeight;
+    std::vector<Rect> freeRects;
+    std::vector<Placed> parts;
+};
+
+// =============================================================================
+// Попытки
+// =============================================================================
+
+struct Problem {
+    std::vector<Item> items;
+    int width;                  // Рабочая область листа с зазором
+    int height;
+    bool allowRotation;
+    bool guillotine;
+    int64_t lowerBound;
+};
+
+struct Solution {
+    std::vector<Sheet> sheets;
+    int64_t lastFree;           // Свободная площадь самого пустого листа
+    size_t layoutCount;
+    uint64_t start;
+};
+
+enum class Order {
+    Area,
+    LongSide,
+    Perimeter,
+    Count
+};
+
+static int64_t OrderKey(Order order, const Item& item)
+{
+    switch (order) {
+        case Order::Area:      return static_cast<int64_t>(item.width) * item.height;
+        case Order::LongSide:  return static_cast<int64_t>(std::max(item.width, item.height)) * 100000 + std::min(item.width, item.height);
+        case Order::Perimeter:
+        default:               return static_cast<int64_t>(item.width) + item.height;
+    }
+}
+
+// Ключ листа для объединения одинаковых раскладок
+static std::vector<std::tuple<int, int, int, int, int>> SheetKey(const Sheet& sheet)
+{
+    std::vector<std::tuple<int, int, int, int, int>> key;
+    key.reserve(sheet.Parts().size());
+    for (const Placed& placed : sheet.Parts()) {
+        key.emplace_back(placed.rect.x, placed.rect.y, placed.rect.width, placed.rect.height, placed.source);
+    }
+    std::sort(key.begin(), key.end());
+    return key;
+}
+
+// Одна попытка. Первые попытки перебирают правило и порядок без случайности,
+// следующие - порядок площадей со случайным множителем
+static void RunStart(const Problem& problem, uint64_t start, Solution& solution)
+{
+    const uint64_t rules = static_cast<uint64_t>(Rule::Count);
+    const uint64_t orders = static_cast<uint64_t>(Order::Count);
+    const Rule rule = static_cast<Rule>(start % rules);
+    const Order order = static_cast<Order>((start / rules) % orders);
+
+    std::vector<std::pair<double, size_t>> keyed;
+    keyed.reserve(problem.items.size());
+    if (start < rules * orders) {
+        for (size_t i = 0; i < problem.items.size(); ++i) {
+            keyed.emplace_back(static_cast<double>(OrderKey(order, problem.items[i])), i);
+        }
+    } else {
+        std::mt19937 random = MultiStart::Random(start);
+        std::uniform_real_distribution<double> jitter = MultiStart::Jitter(start, 0.05, 0.35);
+        for (size_t i = 0; i < problem.items.size(); ++i) {
+            keyed.emplace_back(static_cast<double>(OrderKey(order, problem.items[i])) * jitter(random), i);
+        }
+    }
+    std::stable_sort(keyed.begin(), keyed.end(), [](const std::pair<double, size_t>& a, const std::pair<double, size_t>& b) {
+        return a.first > b.first;
+    });
+
+    // Наименьшие площадь и короткая сторона среди ещё не разложенных заготовок
+    std::vector<int64_t> restArea(keyed.size() + 1, std::numeric_limits<int64_t>::max());
+    std::vector<int> restSide(keyed.size() + 1, std::numeric_limits<int>::max());
+    for (size_t i = keyed.size(); i-- > 0;) {
+        const Item& item = problem.items[keyed[i].second];
+        restArea[i] = std::min(restArea[i + 1], static_cast<int64_t>(item.width) * item.height);
+        restSide[i] = std::min(restSide[i + 1], std::min(item.width, item.height));
+    }
+
+    // Каждая заготовка - на лучшее место среди открытых листов, иначе новый лист.
+    // Лист закрывается, когда на него не лезет ни одна из оставшихся заготовок.
+    solution.sheets.clear();
+    solution.start = start;
+    std::vector<size_t> open;
+    for (size_t position = 0; position < keyed.size(); ++position) {
+        const Item& item = problem.items[keyed[position].second];
+        const int64_t area = static_cast<int64_t>(item.width) * item.height;
+
+        Score best = WorstScore;
+        size_t bestSheet = 0;
+        size_t bestFree = 0;
+        bool bestRotated = false;
+        bool found = false;
+        for (size_t s : open) {
+            const Sheet& sheet = solution.sheets[s];
+            if (sheet.FreeArea() < area) {
+                continue;
+            }
+            Score score;
+            size_t freeIndex = 0;
+            bool rotated = false;
+            if (sheet.Find(item, rule, problem.allowRotation, score, freeIndex, rotated) && score < best) {
+                best = score;
+                bestSheet = s;
+                bestFree = freeIndex;
+                bestRotated = rotated;
+                found = true;
+            }
+        }
+        if (!found) {
+            solution.sheets.emplace_back(problem.width, problem.height, problem.guillotine);
+            bestSheet = solution.sheets.size() - 1;
+            open.push_back(bestSheet);
+            Score score;
+            solution.sheets.back().Find(item, rule, problem.allowRotation, score, bestFree, bestRotated);
+        }
+        Sheet& target = solution.sheets[bestSheet];
+        target.Place(item, bestFree, bestRotated);
+        if (!target.CanFit(restArea[position + 1], restSide[position + 1])) {
+            open.erase(std::find(open.begin(), open.end(), bestSheet));
+        }
+    }
+
+    solution.lastFree = 0;
+    std::vector<std::vector<std::tuple<int, int, int, int, int>>> keys;
+    keys.reserve(solution.sheets.size());
+    for (const Sheet& sheet : solution.sheets) {
+        solution.lastFree = std::max(solution.lastFree, sheet.FreeArea());
+        keys.push_back(SheetKey(sheet));
+    }
+    std::sort(keys.begin(), keys.end());
+    solution.layoutCount = static_cast<size_t>(std::unique(keys.begin(), keys.end()) - keys.begin());
+}
+
+static bool IsBetter(const Solution& a, const Solution& b)
+{
+    if (a.sheets.size() != b.sheets.size()) {
+        return a.sheets.size() < b.sheets.size();
+    }
+    if (a.lastFree != b.lastFree) {
+        return a.lastFree > b.lastFree;
+    }
+    if (a.layoutCount != b.layoutCount) {
+        return a.layoutCount < b.layoutCount;
+    }
+    return a.start < b.start;
+}
+
+// Параллельные попытки (MultiStart) до нижней границы по площади
+static void Search(const Problem& problem, unsigned threadCount,
+                   std::chrono::steady_clock::time_point deadline, Solution& best, uint64_t& starts)
+{
+    MultiStart::Search(SearchLimits, threadCount, deadline,
+        [&problem](uint64_t start, Solution& solution) { RunStart(problem, start, solution); },
+        IsBetter,
+        [&problem](const Solution& solution) {
+            return static_cast<int64_t>(solution.sheets.size()) <= problem.lowerBound;
+        },
+        best, starts);
+}
+
+// =============================================================================
+// Nest
+// =============================================================================
+
+bool Nest(const std::vector<CassetteCore::CassetteRow>& cassettes, const Params& params, Plan& plan)
+{
+    const auto begin = std::chrono::steady_clock::now();
+    plan.layouts.clear();
+    plan.oversize.clear();
+    plan.parts = 0;
+    plan.sheets = 0;
+    plan.lowerBound = 0;
+    plan.utilisation = 0.0;
+    plan.starts = 0;
+    plan.elapsedMs = 0.0;
+
+    const int gap = std::max(0, params.gap);
+    const int margin = std::max(0, params.margin);
+    const int fold = std::max(0, params.foldAllowance);
+
+    Problem problem;
+    problem.width = params.sheetWidth - 2 * margin + gap;
+    problem.height = params.sheetHeight - 2 * margin + gap;
+    problem.allowRotation = params.allowRotation;
+    problem.guillotine = params.guillotine;
+    plan.threads = params.threads > 0
+        ? static_cast<unsigned>(params.threads)
+        : std::max(1u, std::thread::hardware_concurrency());
+    if (problem.width <= gap || problem.height <= gap) {
+        return false;
+    }
+
+    int64_t itemArea = 0;
+    int64_t blankArea = 0;
+    for (size_t i = 0; i < cassettes.size(); ++i) {
+        const CassetteCore::CassetteRow& row = cassettes[i];
+        if (row.x <= 0 || row.y <= 0 || row.count <= 0) {
+            continue;
+        }
+        const Item item = { row.x + 2 * fold + gap, row.y + 2 * fold + gap, static_cast<int>(i) };
+        const bool fits = (item.width <= problem.width && item.height <= problem.height) ||
+            (problem.allowRotation && item.height <= problem.width && item.width <= problem.height);
+        if (!fits) {
+            plan.oversize.push_back({ row.x, row.y, row.count });
+            continue;
+        }
+        problem.items.insert(problem.items.end(), static_cast<size_t>(row.count), item);
+        itemArea += static_cast<int64_t>(item.width) * item.height * row.count;
+        blankArea += static_cast<int64_t>(row.x + 2 * fold) * (row.y + 2 * fold) * row.count;
+        plan.parts += row.count;
+    }
+
+    const int64_t sheetArea = static_cast<int64_t>(problem.width) * problem.height;
+    problem.lowerBound = (itemArea + sheetArea - 1) / sheetArea;
+    plan.lowerBound = problem.lowerBound;
+    if (problem.items.empty()) {
+        plan.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        return true;
+    }
+
+    Solution best;
+    Search(problem, plan.threads, begin + std::chrono::milliseconds(std::max(1, params.timeLimitMs)), best, plan.starts);
+
+    // Одинаковые листы -> одна раскладка с числом повторов
+    const double fullSheetArea = static_cast<double>(params.sheetWidth) * params.sheetHeight;
+    std::map<std::vector<std::tuple<int, int, int, int, int>>, size_t> layoutIndex;
+    for (const Sheet& sheet : best.sheets) {
+        auto inserted = layoutIndex.emplace(SheetKey(sheet), plan.layouts.size());
+        if (!inserted.second) {
+            plan.layouts[inserted.first->second].repeat++;
+            continue;
+        }
+
+        Layout layout;
+        layout.repeat = 1;
+        int64_t area = 0;
+        for (const Placed& placed : sheet.Parts()) {
+            const CassetteCore::CassetteRow& row = cassettes[static_cast<size_t>(placed.source)];
+            Placement part;
+            part.x = placed.rect.x + margin;
+            part.y = placed.rect.y + margin;
+            part.width = placed.rect.width - gap;
+            part.height = placed.rect.height - gap;
+            part.rotated = placed.rotated;
+            part.cassetteX = row.x;
+            part.cassetteY = row.y;
+            area += static_cast<int64_t>(part.width) * part.height;
+            layout.parts.push_back(part);
+        }
+        layout.utilisation = static_cast<double>(area) / fullSheetArea;
+        plan.layouts.push_back(std::move(layout));
+    }
+    std::stable_sort(plan.layouts.begin(), plan.layouts.end(), [](const Layout& a, const Layout& b) {
+        return a.repeat > b.repeat;
+    });
+
+    plan.sheets = static_cast<int64_t>(best.sheets.size());
+    plan.utilisation = static_cast<double>(blankArea) / (fullSheetArea * static_cast<double>(plan.sheets));
+    plan.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    return true;
+}
+
+} // namespace SheetNesting
@@ -0,0 +1,84 @@
+#ifndef SHEETNESTING_HPP
+#define SHEETNESTING_HPP
+
+// =============================================================================
+// SheetNesting - Раскладка заготовок кассет на листы (двумерный раскрой)
+// =============================================================================
+// Заготовка кассеты - X × Y плюс отгиб с каждой стороны. Заготовки
+// раскладываются на листы одного размера с полем по краю и зазором между
+// деталями. Два вида раскладки:
+//   MaxRects   - свободная область хранится как набор максимальных
+//                прямоугольников (лазер, координатная резка);
+//   Guillotine - каждый рез проходит через весь кусок (гильотинные ножницы).
+// Попытки различаются правилом выбора места (короткая сторона, площадь,
+// нижний левый угол), порядком заготовок (площадь, длинная сторона, периметр)
+// и случайным возмущением порядка; идут параллельно, берётся раскладка с
+// наименьшим числом листов, при равном - с самым пустым последним листом
+// (больше делового остатка) и меньшим числом различных раскладок.
+// Одинаковые листы объединяются в одну раскладку с числом повторов.
+// Модуль не зависит от Archicad API (только стандартная библиотека).
+
+#include "CassetteCore.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SheetNesting {
+
+struct Params {
+    int sheetWidth;             // Ширина листа в мм
+    int sheetHeight;            // Длина листа в мм
+    int foldAllowance;          // Отгиб на сторону кассеты в мм
+    int gap;                    // Зазор между заготовками (рез) в мм
+    int margin;                 // Поле по краю листа в мм
+    bool allowRotation;         // Можно поворачивать заготовку на 90°
+    bool guillotine;            // Только гильотинные резы
+    int threads;                // Число потоков; 0 - по числу ядер
+    int timeLimitMs;            // Предел времени на поиск
+};
+
+Params GetDefaultParams();
+
+// Заготовка на листе (координаты от угла листа, размеры - как легла)
+struct Placement {
+    int x;
+    int y;
+    int width;
+    int height;
+    bool rotated;
+    int cassetteX;              // Размер кассеты без отгибов
+    int cassetteY;
+};
+
+// Раскладка одного листа
+struct Layout {
+    int repeat;                     // Сколько листов раскладывается так
+    std::vector<Placement> parts;
+    double utilisation;             // Площадь заготовок / площадь листа
+};
+
+struct Oversize {
+    int x;
+    int y;
+    int count;
+};
+
+struct Plan {
+    std::vector<Layout> layouts;    // По убыванию числа повторов
+    std::vector<Oversize> oversize; // Кассеты, заготовка которых не помещается на лист
+    int64_t parts;                  // Разложено заготовок
+    int64_t sheets;
+    int64_t lowerBound;             // Площадь заготовок / площадь листа (с зазорами)
+    double utilisation;             // По всем листам
+    uint64_t starts;
+    unsigned threads;
+    double elapsedMs;
+};
+
+// Раскладка заготовок кассет; false - лист меньше двух полей
+bool Nest(const std::vector<CassetteCore::CassetteRow>& cassettes, const Params& params, Plan& plan);
+
+} // namespace SheetNesting
+
+#endif // SHEETNESTING_HPP
@@ -0,0 +1,278 @@
+// =============================================================================
+// SizeClustering - Сокращение числа типоразмеров кассет
+// =============================================================================
+
+#include "SizeClustering.hpp"
+
+#include <algorithm>
+#include <map>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+
+namespace SizeClustering {
+
+Params GetDefaultParams()
+{
+    Params p;
+    p.toleranceX = 20;
+    p.toleranceY = 20;
+    p.maxRows = 16;
+    return p;
+}
+
+// =============================================================================
+// Группы и сетка
+// =============================================================================
+
+struct Cluster {
+    int x;                      // Размер изготовления (наибольшие X и Y членов)
+    int y;
+    int minX;                   // Наименьшие X и Y членов (для проверки допуска)
+    int minY;
+    int64_t count;
+    int64_t area;               // Сумма count * x * y членов
+    int64_t extra;              // x * y * count - area
+    bool alive;
+    bool hasBest;               // Есть ли группа, с которой можно объединиться
+    int64_t bestDelta;          // Самое дешёвое объединение этой группы
+    size_t bestPartner;
+    uint32_t version;           // Меняется с каждым новым лучшим кандидатом
+    std::vector<Member> members;
+};
+
+// Лучший кандидат группы id; в очереди сверху - наименьший прирост.
+// Запись устарела, если версия группы с тех пор сменилась.
+struct Candidate {
+    int64_t delta;
+    size_t id;
+    size_t partner;
+    uint32_t version;
+
+    bool operator< (const Candidate& other) const
+    {
+        return std::tie(delta, id, partner) > std::tie(other.delta, other.id, other.partner);
+    }
+};
+
+class Grid {
+public:
+    Grid(int cellX, int cellY) :
+        cellX(std::max(1, cellX)),
+        cellY(std::max(1, cellY))
+    {
+    }
+
+    void Add(const Cluster& cluster, size_t id)
+    {
+        cells[Key(cluster.x / cellX, cluster.y / cellY)].push_back(id);
+    }
+
+    void Remove(const Cluster& cluster, size_t id)
+    {
+        std::vector<size_t>& cell = cells[Key(cluster.x / cellX, cluster.y / cellY)];
+        cell.erase(std::find(cell.begin(), cell.end(), id));
+    }
+
+    // Группы в соседних ячейках (3 × 3 вокруг размера cluster)
+    template <typename Visitor>
+    void ForNeighbours(const Cluster& cluster, Visitor visit) const
+    {
+        const int cx = cluster.x / cellX;
+        const int cy = cluster.y / cellY;
+        for (int dx = -1; dx <= 1; ++dx) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                auto it = cells.find(Key(cx + dx, cy + dy));
+                if (it == cells.end()) {
+                    continue;
+                }
+                for (size_t id : it->second) {
+                    visit(id);
+                }
+            }
+        }
+    }
+
+private:
+    static int64_t Key(int cx, int cy)
+    {
+        return (static_cast<int64_t>(cx) << 32) ^ static_cast<uint32_t>(cy);
+    }
+
+    int cellX;
+    int cellY;
+    std::unordered_map<int64_t, std::vector<size_t>> cells;
+};
+
+// Прирост лишней площади при объединении a и b; false - запас вышел бы за допуск
+static bool MergeDelta(const Cluster& a, const Cluster& b, const Params& params, int64_t& delta)
+{
+    const int x = std::max(a.x, b.x);
+    const int y = std::max(a.y, b.y);
+    if (x - std::min(a.minX, b.minX) > params.toleranceX || y - std::min(a.minY, b.minY) > params.toleranceY) {
+        return false;
+    }
+    const int64_t extra = static_cast<int64_t>(x) * y * (a.count + b.count) - (a.area + b.area);
+    delta = extra - a.extra - b.extra;
+    return true;
+}
+
+// =============================================================================
+// ClusterSizes
+// =============================================================================
+
+void ClusterSizes(const std::vector<CassetteCore::CassetteRow>& cassettes, const Params& params, Report& report)
+{
+    report.groups.clear();
+    report.merges = 0;
+    report.cassetteArea = 0;
+    report.extraArea = 0;
+
+    // Одинаковые размеры - одна группа
+    std::map<std::pair<int, int>, int64_t> sizes;
+    for (const CassetteCore::CassetteRow& row : cassettes) {
+        if (row.count > 0) {
+            sizes[{ row.x, row.y }] += row.count;
+        }
+    }
+    report.rowsBefore = sizes.size();
+
+    std::vector<Cluster> clusters;
+    clusters.reserve(sizes.size() * 2);
+    Grid grid(params.toleranceX + 1, params.toleranceY + 1);
+    for (const auto& size : sizes) {
+        Cluster cluster;
+        cluster.x = cluster.minX = size.first.first;
+        cluster.y = cluster.minY = size.first.second;
+        cluster.count = size.second;
+        cluster.area = static_cast<int64_t>(cluster.x) * cluster.y * cluster.count;
+        cluster.extra = 0;
+        cluster.alive = true;
+        cluster.hasBest = false;
+        cluster.bestDelta = 0;
+        cluster.bestPartner = 0;
+        cluster.version = 0;
+        cluster.members.push_back({ cluster.x, cluster.y, static_cast<int>(cluster.count), 0 });
+        report.cassetteArea += cluster.area;
+        grid.Add(cluster, clusters.size());
+        clusters.push_back(std::move(cluster));
+    }
+
+    // В очереди - по одному лучшему кандидату на группу
+    std::priority_queue<Candidate> queue;
+    auto offer = [&](size_t id, size_t partner, int64_t delta) {
+        Cluster& cluster = clusters[id];
+        if (cluster.hasBest && std::tie(cluster.bestDelta, cluster.bestPartner) <= std::tie(delta, partner)) {
+            return;
+        }
+        cluster.hasBest = true;
+        cluster.bestDelta = delta;
+        cluster.bestPartner = partner;
+        ++cluster.version;
+        queue.push({ delta, id, partner, cluster.version });
+    };
+    auto findBest = [&](size_t id) {
+        clusters[id].hasBest = false;
+        grid.ForNeighbours(clusters[id], [&](size_t other) {
+            int64_t delta = 0;
+            if (other != id && MergeDelta(clusters[id], clusters[other], params, delta)) {
+                offer(id, other, delta);
+            }
+        });
+    };
+    for (size_t id = 0; id < clusters.size(); ++id) {
+        findBest(id);
+    }
+
+    // Самое дешёвое объединение. Если партнёр уже слит с другой группой,
+    // лучший кандидат пересчитывается и возвращается в очередь.
+    size_t rows = clusters.size();
+    while (!queue.empty()) {
+        if (params.maxRows > 0 && rows <= static_cast<size_t>(params.maxRows)) {
+            break;
+        }
+        const Candidate candidate = queue.top();
+        queue.pop();
+        if (!clusters[candidate.id].alive || clusters[candidate.id].version != candidate.version) {
+            continue;
+        }
+        if (!clusters[candidate.partner].alive) {
+            findBest(candidate.id);
+            continue;
+        }
+
+        Cluster& a = clusters[candidate.id];
+        Cluster& b = clusters[candidate.partner];
+        Cluster merged;
+        merged.x = std::max(a.x, b.x);
+        merged.y = std::max(a.y, b.y);
+        merged.minX = std::min(a.minX, b.minX);
+        merged.minY = std::min(a.minY, b.minY);
+        merged.count = a.count + b.count;
+        merged.area = a.area + b.area;
+        merged.extra = static_cast<int64_t>(merged.x) * merged.y * merged.count - merged.area;
+        merged.alive = true;
+        merged.hasBest = false;
+        merged.bestDelta = 0;
+        merged.bestPartner = 0;
+        merged.version = 0;
+        merged.members = std::move(a.members);
+        merged.members.insert(merged.members.end(), b.members.begin(), b.members.end());
+        b.members.clear();
+
+        a.alive = false;
+        b.alive = false;
+        grid.Remove(a, candidate.id);
+        grid.Remove(b, candidate.partner);
+
+        // Новая группа может стать лучшим кандидатом и для соседей
+        const size_t id = clusters.size();
+        clusters.push_back(std::move(merged));
+        grid.Add(clusters[id], id);
+        grid.ForNeighbours(clusters[id], [&](size_t other) {
+            int64_t delta = 0;
+            if (other != id && MergeDelta(clusters[id], clusters[other], params, delta)) {
+                offer(id, other, delta);
+                offer(other, id, delta);
+            }
+        });
+
+        --rows;
+        ++report.merges;
+    }
+    report.withinLimit = params.maxRows <= 0 || rows <= static_cast<size_t>(params.maxRows);
+
+    for (Cluster& cluster : clusters) {
+        if (!cluster.alive) {
+            continue;
+        }
+        Group group;
+        group.x = cluster.x;
+        group.y = cluster.y;
+        group.count = static_cast<int>(cluster.count);
+        group.extraArea = cluster.extra;
+        group.members = std::move(cluster.members);
+        for (Member& member : group.members) {
+            member.extraArea = (static_cast<int64_t>(group.x) * group.y - static_cast<int64_t>(member.x) * member.y) * member.count;
+        }
+        std::sort(group.members.begin(), group.members.end(), [](const Member& l, const Member& r) {
+            return std::tie(r.x, r.y) < std::tie(l.x, l.y);
+        });
+        report.extraArea += group.extraArea;
+        report.groups.push_back(std::move(group));
+    }
+    std::sort(report.groups.begin(), report.groups.end(), [](const Group& l, const Group& r) {
+        return std::tie(l.x, l.y) < std::tie(r.x, r.y);
+    });
+}
+
+void ToRows(const Report& report, std::vector<CassetteCore::CassetteRow>& cassettes)
+{
+    cassettes.clear();
+    cassettes.reserve(report.groups.size());
+    for (const Group& group : report.groups) {
+        cassettes.push_back({ group.x, group.y, group.count });
+    }
+}
+
+} // namespace SizeClustering
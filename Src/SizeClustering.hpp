@@ -0,0 +1,71 @@
+#ifndef SIZECLUSTERING_HPP
+#define SIZECLUSTERING_HPP
+
+// =============================================================================
+// SizeClustering - Сокращение числа типоразмеров кассет
+// =============================================================================
+// Близкие размеры X × Y объединяются: группа изготавливается по наибольшим
+// X и Y своих размеров, поэтому меньшие кассеты группы получаются с
+// запасом. Запас по каждой стороне не больше допуска. Цена объединения -
+// лишняя площадь металла (запас × количество), она выводится по каждому
+// исходному размеру.
+//
+// Объединения выполняются от самого дешёвого: кандидаты ищутся по сетке с
+// ячейкой в допуск (соседние ячейки 3 × 3), а не перебором всех пар, и
+// в очереди по приросту лишней площади лежит лучший кандидат каждой группы.
+// Если задан предел строк, объединение останавливается, как только строк не
+// больше предела
+// (в объекты пишется 16 строк кассет, Text_3...Text_18).
+// Модуль не зависит от Archicad API (только стандартная библиотека).
+
+#include "CassetteCore.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SizeClustering {
+
+struct Params {
+    int toleranceX;             // Допуск запаса по X в мм
+    int toleranceY;             // Допуск запаса по Y в мм
+    int maxRows;                // Предел строк; 0 - объединять всё, что в допуске
+};
+
+Params GetDefaultParams();
+
+// Исходный размер в группе
+struct Member {
+    int x;
+    int y;
+    int count;
+    int64_t extraArea;          // Лишняя площадь всех кассет размера в мм²
+};
+
+// Группа: изготавливается размером x × y
+struct Group {
+    int x;
+    int y;
+    int count;
+    int64_t extraArea;          // Сумма по членам группы в мм²
+    std::vector<Member> members;
+};
+
+struct Report {
+    std::vector<Group> groups;  // По возрастанию X, затем Y
+    size_t rowsBefore;
+    uint64_t merges;
+    int64_t cassetteArea;       // Площадь всех кассет до объединения в мм²
+    int64_t extraArea;          // Лишняя площадь после объединения в мм²
+    bool withinLimit;           // Строк не больше maxRows (или предел не задан)
+};
+
+// Объединить размеры кассет
+void ClusterSizes(const std::vector<CassetteCore::CassetteRow>& cassettes, const Params& params, Report& report);
+
+// Строки кассет по группам отчёта
+void ToRows(const Report& report, std::vector<CassetteCore::CassetteRow>& cassettes);
+
+} // namespace SizeClustering
+
+#endif // SIZECLUSTERING_HPP
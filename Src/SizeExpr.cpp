@@ -0,0 +1,535 @@
+// =============================================================================
+// SizeExpr - Формулы размеров деталей: разбор в байткод и расчёт по колонкам
+// =============================================================================
+
+#include "SizeExpr.hpp"
+
+#include <algorithm>
+
+namespace SizeExpr {
+
+// =============================================================================
+// Операции
+// =============================================================================
+
+// Результат по модулю 2^32
+static int32_t Wrap(int64_t value)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(value));
+}
+
+static int32_t Neg(int32_t x)         { return Wrap(-static_cast<int64_t>(x)); }
+static int32_t Abs(int32_t x)         { return x < 0 ? Neg(x) : x; }
+static int32_t Add(int32_t x, int32_t y) { return Wrap(static_cast<int64_t>(x) + y); }
+static int32_t Sub(int32_t x, int32_t y) { return Wrap(static_cast<int64_t>(x) - y); }
+static int32_t Mul(int32_t x, int32_t y) { return Wrap(static_cast<int64_t>(x) * y); }
+static int32_t Div(int32_t x, int32_t y) { return y == 0 ? 0 : Wrap(static_cast<int64_t>(x) / y); }
+static int32_t Min(int32_t x, int32_t y) { return x < y ? x : y; }
+static int32_t Max(int32_t x, int32_t y) { return x > y ? x : y; }
+
+static int32_t Round(int32_t x, int32_t step)
+{
+    if (step <= 0) {
+        return x;
+    }
+    const int64_t half = step / 2;
+    const int64_t magnitude = (x < 0 ? -static_cast<int64_t>(x) : x) + half;
+    const int64_t rounded = magnitude / step * step;
+    return Wrap(x < 0 ? -rounded : rounded);
+}
+
+static int Arity(Op op)
+{
+    switch (op) {
+        case Op::Const:
+        case Op::Var:   return 0;
+        case Op::Neg:
+        case Op::Abs:   return 1;
+        default:        return 2;
+    }
+}
+
+static int32_t Apply(Op op, int32_t x, int32_t y)
+{
+    switch (op) {
+        case Op::Neg:   return Neg(x);
+        case Op::Abs:   return Abs(x);
+        case Op::Add:   return Add(x, y);
+        case Op::Sub:   return Sub(x, y);
+        case Op::Mul:   return Mul(x, y);
+        case Op::Div:   return Div(x, y);
+        case Op::Min:   return Min(x, y);
+        case Op::Max:   return Max(x, y);
+        case Op::Round: return Round(x, y);
+        default:        return x;
+    }
+}
+
+static size_t MaxDepth(const std::vector<Instr>& code)
+{
+    size_t depth = 0;
+    size_t maxDepth = 0;
+    for (const Instr& instr : code) {
+        const int arity = Arity(instr.op);
+        depth = depth + 1 - arity;
+        maxDepth = std::max(maxDepth, depth);
+    }
+    return maxDepth;
+}
+
+// =============================================================================
+// Разбор
+// =============================================================================
+
+// Рекурсивный спуск: выражение -> код в обратной польской записи
+class Parser {
+public:
+    Parser(std::string_view text, const char* const* names, size_t nameCount) :
+        text(text),
+        pos(0),
+        names(names),
+        nameCount(nameCount),
+        nesting(0)
+    {
+    }
+
+    bool Parse(std::vector<Instr>& result, std::string& message)
+    {
+        SkipSpaces();
+        if (pos == text.size()) {
+            message = "пустая формула";
+            return false;
+        }
+        if (!Expression()) {
+            message = error;
+            return false;
+        }
+        if (pos != text.size()) {
+            message = "лишний символ '" + std::string(1, text[pos]) + "' в позиции " + std::to_string(pos + 1);
+            return false;
+        }
+        result.swap(code);
+        return true;
+    }
+
+private:
+    static const int MaxNesting = 64;
+
+    bool Fail(const std::string& message)
+    {
+        if (error.empty()) {
+            error = message;
+        }
+        return false;
+    }
+
+    std::string Position() const
+    {
+        return " в позиции " + std::to_string(pos + 1);
+    }
+
+    void SkipSpaces()
+    {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t')) {
+            ++pos;
+        }
+    }
+
+    bool Accept(char c)
+    {
+        if (pos < text.size() && text[pos] == c) {
+            ++pos;
+            SkipSpaces();
+            return true;
+        }
+        return false;
+    }
+
+    static bool IsDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    static bool IsNameChar(char c)
+    {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_' || IsDigit(c);
+    }
+
+    // выражение := слагаемое (('+' | '-') слагаемое)*
+    bool Expression()
+    {
+        if (++nesting > MaxNesting) {
+            return Fail("слишком глубокая вложенность");
+        }
+        if (!Term()) {
+            return false;
+        }
+        for (;;) {
+            if (Accept('+')) {
+                if (!Term()) {
+                    return false;
+                }
+                code.push_back({ Op::Add, 0 });
+            } else if (Accept('-')) {
+                if (!Term()) {
+                    return false;
+                }
+                code.push_back({ Op::Sub, 0 });
+            } else {
+                break;
+            }
+        }
+        --nesting;
+        return true;
+    }
+
+    // слагаемое := множитель (('*' | '/') множитель)*
+    bool Term()
+    {
+        if (!Unary()) {
+            return false;
+        }
+        for (;;) {
+            if (Accept('*')) {
+                if (!Unary()) {
+                    return false;
+                }
+                code.push_back({ Op::Mul, 0 });
+            } else if (Accept('/')) {
+                if (!Unary()) {
+                    return false;
+                }
+                code.push_back({ Op::Div, 0 });
+            } else {
+                break;
+            }
+        }
+        return true;
+    }
+
+    bool Unary()
+    {
+        if (Accept('-')) {
+            if (++nesting > MaxNesting) {
+                return Fail("слишком глубокая вложенность");
+            }
+            if (!Unary()) {
+                return false;
+            }
+            --nesting;
+            code.push_back({ Op::Neg, 0 });
+            return true;
+        }
+        Accept('+');
+        return Primary();
+    }
+
+    bool Primary()
+    {
+        if (pos == text.size()) {
+            return Fail("формула оборвалась");
+        }
+        if (Accept('(')) {
+            if (!Expression()) {
+                return false;
+            }
+            return Accept(')') || Fail("ожидается ')'" + Position());
+        }
+        if (IsDigit(text[pos])) {
+            return Number();
+        }
+        if (IsNameChar(text[pos])) {
+            return Name();
+        }
+        return Fail("ожидается число или переменная" + Position());
+    }
+
+    bool Number()
+    {
+        const size_t begin = pos;
+        int32_t value = 0;
+        while (pos < text.size() && IsDigit(text[pos])) {
+            if (pos - begin >= 9) {
+                return Fail("слишком длинное число" + Position());
+            }
+            value = value * 10 + (text[pos] - '0');
+            ++pos;
+        }
+        SkipSpaces();
+        code.push_back({ Op::Const, value });
+        return true;
+    }
+
+    bool Name()
+    {
+        const size_t begin = pos;
+        while (pos < text.size() && IsNameChar(text[pos])) {
+            ++pos;
+        }
+        const std::string_view name = text.substr(begin, pos - begin);
+        SkipSpaces();
+
+        if (Accept('(')) {
+            return Function(name);
+        }
+        for (size_t i = 0; i < nameCount; ++i) {
+            if (name == names[i]) {
+                code.push_back({ Op::Var, static_cast<int32_t>(i) });
+                return true;
+            }
+        }
+        return Fail("неизвестная переменная \"" + std::string(name) + "\"");
+    }
+
+    // min(a, b, ...), max(a, b, ...), abs(x), round(x, шаг); '(' уже прочитана
+    bool Function(std::string_view name)
+    {
+        Op op = Op::Const;
+        size_t minArgs = 0;
+        size_t maxArgs = 0;
+        if (name == "min" || name == "max") {
+            op = name == "min" ? Op::Min : Op::Max;
+            minArgs = 2;
+            maxArgs = 64;
+        } else if (name == "abs") {
+            op = Op::Abs;
+            minArgs = maxArgs = 1;
+        } else if (name == "round") {
+            op = Op::Round;
+            minArgs = maxArgs = 2;
+        } else {
+            return Fail("неизвестная функция \"" + std::string(name) + "\"");
+        }
+
+        size_t args = 0;
+        do {
+            if (!Expression()) {
+                return false;
+            }
+            ++args;
+            if (args > maxArgs) {
+                return Fail("у " + std::string(name) + " не больше " + std::to_string(maxArgs) + " аргументов");
+            }
+            // min/max по цепочке: каждый следующий аргумент сворачивается с предыдущими
+            if (args >= 2 || op == Op::Abs) {
+                code.push_back({ op, 0 });
+            }
+        } while (Accept(','));
+
+        if (args < minArgs) {
+            return Fail("у " + std::string(name) + " " + std::to_string(minArgs) + " аргумента");
+        }
+        return Accept(')') || Fail("ожидается ')'" + Position());
+    }
+
+    std::string_view text;
+    size_t pos;
+    const char* const* names;
+    size_t nameCount;
+    int nesting;
+    std::vector<Instr> code;
+    std::string error;
+};
+
+// =============================================================================
+// Program
+// =============================================================================
+
+Program::Program() :
+    maxDepth(0)
+{
+}
+
+bool Program::Compile(std::string_view text, const char* const* names, size_t nameCount, std::string& error)
+{
+    std::vector<Instr> parsed;
+    Parser parser(text, names, nameCount);
+    if (!parser.Parse(parsed, error)) {
+        return false;
+    }
+
+    code.swap(parsed);
+    maxDepth = MaxDepth(code);
+    source.assign(text.data(), text.size());
+    while (!source.empty() && source.back() == ' ') {
+        source.pop_back();
+    }
+    source.erase(0, source.find_first_not_of(' '));
+    return true;
+}
+
+Program Program::Bind(const Binding* bindings) const
+{
+    // Операнды на стеке: начало их кода и значение, если постоянны
+    struct Entry {
+        size_t start;
+        bool constant;
+        int32_t value;
+    };
+
+    Program bound;
+    bound.source = source;
+    std::vector<Entry> entries;
+    for (Instr instr : code) {
+        if (instr.op == Op::Var) {
+            const Binding& binding = bindings[instr.arg];
+            instr = binding.isColumn ? Instr{ Op::Var, binding.value } : Instr{ Op::Const, binding.value };
+        }
+
+        const int arity = Arity(instr.op);
+        if (arity == 0) {
+            entries.push_back({ bound.code.size(), instr.op == Op::Const, instr.arg });
+            bound.code.push_back(instr);
+            continue;
+        }
+
+        const size_t first = entries.size() - arity;
+        const size_t start = entries[first].start;
+        const bool constant = entries[first].constant && (arity == 1 || entries[first + 1].constant);
+        Entry result = { start, false, 0 };
+        if (constant) {
+            // Постоянное подвыражение - одна константа
+            result.constant = true;
+            result.value = Apply(instr.op, entries[first].value, arity == 2 ? entries[first + 1].value : 0);
+            bound.code.resize(start);
+            bound.code.push_back({ Op::Const, result.value });
+        } else {
+            bound.code.push_back(instr);
+        }
+        entries.resize(first);
+        entries.push_back(result);
+    }
+
+    bound.maxDepth = MaxDepth(bound.code);
+    return bound;
+}
+
+bool Program::GetLinear(size_t columnCount, int32_t* coeff) const
+{
+    // Линейная форма по колонкам на каждый элемент стека (по модулю 2^32)
+    const size_t width = columnCount + 1;
+    std::vector<int32_t> forms;
+    for (const Instr& instr : code) {
+        const size_t top = forms.size() / width;
+        switch (instr.op) {
+            case Op::Const:
+                forms.resize(forms.size() + width, 0);
+                forms[top * width] = instr.arg;
+                break;
+            case Op::Var:
+                if (instr.arg < 0 || static_cast<size_t>(instr.arg) >= columnCount) {
+                    return false;
+                }
+                forms.resize(forms.size() + width, 0);
+                forms[top * width + 1 + instr.arg] = 1;
+                break;
+            case Op::Neg:
+                for (size_t k = 0; k < width; ++k) {
+                    forms[(top - 1) * width + k] = Neg(forms[(top - 1) * width + k]);
+                }
+                break;
+            case Op::Add:
+            case Op::Sub:
+            case Op::Mul: {
+                int32_t* x = &forms[(top - 2) * width];
+                const int32_t* y = &forms[(top - 1) * width];
+                if (instr.op == Op::Mul) {
+                    // Линейно, только если один из множителей постоянен
+                    const bool xConstant = std::all_of(x + 1, x + width, [](int32_t c) { return c == 0; });
+                    const bool yConstant = std::all_of(y + 1, y + width, [](int32_t c) { return c == 0; });
+                    if (!xConstant && !yConstant) {
+                        return false;
+                    }
+                    const int32_t factor = yConstant ? y[0] : x[0];
+                    const int32_t* form = yConstant ? x : y;
+                    for (size_t k = 0; k < width; ++k) {
+                        x[k] = Mul(form[k], factor);
+                    }
+                } else {
+                    for (size_t k = 0; k < width; ++k) {
+                        x[k] = instr.op == Op::Add ? Add(x[k], y[k]) : Sub(x[k], y[k]);
+                    }
+                }
+                forms.resize(forms.size() - width);
+                break;
+            }
+            default:
+                return false;       // Деление, min, max, abs, round - нелинейны
+        }
+    }
+    if (forms.size() != width) {
+        return false;
+    }
+    std::copy(forms.begin(), forms.end(), coeff);
+    return true;
+}
+
+// =============================================================================
+// Evaluate
+// =============================================================================
+
+template <typename Function>
+static void Unary(int32_t* x, size_t count, Function f)
+{
+    for (size_t j = 0; j < count; ++j) {
+        x[j] = f(x[j]);
+    }
+}
+
+template <typename Function>
+static void Binary(int32_t* x, const int32_t* y, size_t count, Function f)
+{
+    for (size_t j = 0; j < count; ++j) {
+        x[j] = f(x[j], y[j]);
+    }
+}
+
+void Program::Evaluate(const int32_t* const* columns, size_t count, int32_t* out, std::vector<int32_t>& stack) const
+{
+    if (code.empty()) {
+        std::fill_n(out, count, 0);
+        return;
+    }
+
+    stack.resize(maxDepth * BlockSize);
+    int32_t* const base = stack.data();
+    size_t depth = 0;
+    for (const Instr& instr : code) {
+        int32_t* const top = base + depth * BlockSize;     // Следующая свободная строка
+        if (instr.op == Op::Const) {
+            std::fill_n(top, count, instr.arg);
+            ++depth;
+            continue;
+        }
+        if (instr.op == Op::Var) {
+            std::copy_n(columns[instr.arg], count, top);
+            ++depth;
+            continue;
+        }
+
+        int32_t* const y = top - BlockSize;                 // Верхний операнд
+        if (Arity(instr.op) == 1) {
+            if (instr.op == Op::Neg) {
+                Unary(y, count, Neg);
+            } else {
+                Unary(y, count, Abs);
+            }
+            continue;
+        }
+
+        int32_t* const x = y - BlockSize;                   // Результат - на место левого
+        switch (instr.op) {
+            case Op::Add:   Binary(x, y, count, Add); break;
+            case Op::Sub:   Binary(x, y, count, Sub); break;
+            case Op::Mul:   Binary(x, y, count, Mul); break;
+            case Op::Div:   Binary(x, y, count, Div); break;
+            case Op::Min:   Binary(x, y, count, Min); break;
+            case Op::Max:   Binary(x, y, count, Max); break;
+            default:        Binary(x, y, count, Round); break;
+        }
+        --depth;
+    }
+    std::copy_n(base, count, out);
+}
+
+} // namespace SizeExpr
@@ -0,0 +1,89 @@
+#ifndef SIZEEXPR_HPP
+#define SIZEEXPR_HPP
+
+// =============================================================================
+// SizeExpr - Формулы размеров деталей: разбор в байткод и расчёт по колонкам
+// =============================================================================
+// Выражение разбирается один раз в программу стековой машины (обратная
+// польская запись). Язык - целые мм:
+//   числа, переменные (имена задаёт вызывающий), + - * /, унарный минус,
+//   скобки, функции min(a, b, ...), max(a, b, ...), abs(x), round(x, шаг).
+// Деление целое с отбрасыванием дробной части, деление на 0 даёт 0;
+// round(x, шаг) - ближайшее кратное шага (половина - от нуля). Переполнение
+// int32 - по модулю 2^32 (без неопределённого поведения).
+//
+// Bind подставляет параметры расчёта как константы и сворачивает постоянные
+// подвыражения; оставшиеся переменные - колонки пакета окон. Если результат
+// линеен по колонкам (GetLinear), расчёт идёт скалярным произведением, иначе
+// Evaluate исполняет программу блоком до BlockSize окон: каждая инструкция -
+// цикл по блоку, поэтому разбор инструкции делится на весь блок, а простые
+// циклы компилятор векторизует.
+// Модуль не зависит от Archicad API (только стандартная библиотека).
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace SizeExpr {
+
+// Окон в одном вызове Evaluate
+const size_t BlockSize = 256;
+
+enum class Op : uint8_t {
+    Const = 0,          // arg - значение
+    Var,                // arg - номер переменной (после Bind - колонки)
+    Neg,
+    Abs,
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Min,
+    Max,
+    Round
+};
+
+struct Instr {
+    Op op;
+    int32_t arg;
+};
+
+// Значение переменной при Bind: константа или колонка пакета
+struct Binding {
+    bool isColumn;
+    int32_t value;      // Номер колонки или значение
+};
+
+class Program {
+public:
+    Program();
+
+    // Разобрать выражение; names[i] - имя переменной i. false - ошибка в
+    // error, программа не меняется.
+    bool Compile(std::string_view text, const char* const* names, size_t nameCount, std::string& error);
+
+    // Текст, из которого собрана программа
+    const std::string& GetSource() const { return source; }
+
+    // Подставить переменные (bindings[i] - для переменной i) и свернуть константы
+    Program Bind(const Binding* bindings) const;
+
+    // Линейна ли программа по колонкам 0...columnCount - 1: coeff[0] -
+    // постоянное слагаемое, coeff[1 + k] - множитель колонки k
+    bool GetLinear(size_t columnCount, int32_t* coeff) const;
+
+    // out[j] - значение для окна j блока; columns[k][j] - колонка k,
+    // count <= BlockSize; stack - рабочая память (переиспользуется между вызовами)
+    void Evaluate(const int32_t* const* columns, size_t count, int32_t* out, std::vector<int32_t>& stack) const;
+
+private:
+    std::vector<Instr> code;
+    size_t maxDepth;
+    std::string source;
+};
+
+} // namespace SizeExpr
+
+#endif // SIZEEXPR_HPP
@@ -0,0 +1,55 @@
+// =============================================================================
+// SnapshotDump - Запись окон/дверей в двоичный снимок (.cassnap)
+// =============================================================================
+
+#include "SnapshotDump.hpp"
+#include "CassetteSnapshot.hpp"
+#include "FileIO.hpp"
+
+#include <string>
+
+namespace SnapshotDump {
+
+static_assert(sizeof(API_Guid) == 16, "API_Guid is stored as 16 bytes");
+
+bool SaveWindows(const GS::UniString& path,
+                 const GS::Array<CassetteHelper::WindowDoorInfo>& windows,
+                 double floorHeight,
+                 UInt64& bytes,
+                 GS::UniString& errorMessage)
+{
+    bytes = 0;
+
+    CassetteSnapshot::Builder builder;
+    builder.Reserve(windows.GetSize());
+    builder.SetFloorHeight(floorHeight);
+
+    std::string id;
+    for (const CassetteHelper::WindowDoorInfo& w : windows) {
+        id.clear();
+        FileIO::AppendUtf8(id, IdPool::Get(w.id));
+        builder.Add(reinterpret_cast<const uint8_t*>(&w.guid), id,
+                    Mm::ToMetres(w.width), Mm::ToMetres(w.height), Mm::ToMetres(w.sillHeight),
+                    w.storey, w.calcType,
+                    w.x, w.y, w.angle, w.normal);
+    }
+
+    std::string data;
+    builder.Serialize(data);
+
+    FileIO::Writer out;
+    if (!out.Open(path)) {
+        errorMessage = "Не удалось создать файл: " + path;
+        return false;
+    }
+    out.Write(data.data(), data.size());
+    if (!out.Close()) {
+        errorMessage = "Ошибка записи файла: " + path;
+        return false;
+    }
+
+    bytes = data.size();
+    return true;
+}
+
+} // namespace SnapshotDump
@@ -0,0 +1,23 @@
+#ifndef SNAPSHOTDUMP_HPP
+#define SNAPSHOTDUMP_HPP
+
+// =============================================================================
+// SnapshotDump - Запись окон/дверей в двоичный снимок (.cassnap)
+// =============================================================================
+// Снимок (см. CassetteSnapshot.hpp) повторяет расчёт без Archicad: его
+// читает cassette-batch, в том числе для замеров и сверки результатов.
+
+#include "CassetteHelper.hpp"
+
+namespace SnapshotDump {
+
+// Записать окна в файл. floorHeight - высота этажа, с которой шёл расчёт.
+bool SaveWindows(const GS::UniString& path,
+                 const GS::Array<CassetteHelper::WindowDoorInfo>& windows,
+                 double floorHeight,
+                 UInt64& bytes,
+                 GS::UniString& errorMessage);
+
+} // namespace SnapshotDump
+
+#endif // SNAPSHOTDUMP_HPP
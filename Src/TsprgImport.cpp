@@ -0,0 +1,159 @@
+// =============================================================================
+// TsprgImport - Окна из книг Excel старых скриптов tsprg
+// =============================================================================
+
+#include "TsprgImport.hpp"
+#include "XlsxReader.hpp"
+
+namespace TsprgImport {
+
+// Имена листов в UTF-8
+static const char* const SheetNames[3] = {
+    "\xD0\x9B\xD0\xB8\xD1\x81\xD1\x82" "1",     // Лист1
+    "\xD0\x9B\xD0\xB8\xD1\x81\xD1\x82" "2",     // Лист2
+    "\xD0\x9B\xD0\xB8\xD1\x81\xD1\x82" "3"      // Лист3
+};
+
+static const uint32_t ColumnB = 1;
+static const uint32_t ColumnD = 3;
+static const uint32_t ColumnI = 8;
+static const uint32_t Row2 = 1;
+
+// Текущая строка листа: значения B, C, D
+class RowCollector {
+public:
+    RowCollector(Workbook& target, int sheetType) :
+        book(target),
+        calcType(sheetType),
+        row(0),
+        active(false),
+        hasData(false),
+        numeric(false),
+        values{ 0.0, 0.0, 0.0 },
+        hasNumber{ false, false, false }
+    {
+    }
+
+    void Add(const Xlsx::Cell& cell)
+    {
+        if (calcType == 0 && cell.row == Row2 && cell.column == ColumnI) {
+            double value = 0.0;
+            if (cell.GetNumber(value) && value > 0.0) {
+                book.floorHeight = value;
+                book.hasFloorHeight = true;
+            }
+        }
+
+        if (cell.column < ColumnB || cell.column > ColumnD) {
+            return;
+        }
+        if (!active || cell.row != row) {
+            Flush();
+            Reset(cell.row);
+        }
+
+        const size_t slot = cell.column - ColumnB;
+        hasNumber[slot] = cell.GetNumber(values[slot]);
+        hasData = true;
+        if (hasNumber[slot]) {
+            numeric = true;
+        }
+    }
+
+    void Flush()
+    {
+        if (!active || !hasData) {
+            return;
+        }
+        active = false;
+
+        const bool valid = hasNumber[0] && hasNumber[1] && values[0] > 0.0 && values[1] > 0.0;
+        if (valid) {
+            const double sill = (calcType != 0 && hasNumber[2]) ? values[2] : 0.0;
+            book.windows.Add(Mm::FromMetres(values[0]), Mm::FromMetres(values[1]), Mm::FromMetres(sill), calcType);
+            book.windowsByType[calcType]++;
+        } else if (numeric) {
+            // Строка только из текста - заголовок, в пропущенные не считается
+            book.skippedRows++;
+        }
+    }
+
+private:
+    void Reset(uint32_t newRow)
+    {
+        row = newRow;
+        active = true;
+        hasData = false;
+        numeric = false;
+        for (int i = 0; i < 3; ++i) {
+            values[i] = 0.0;
+            hasNumber[i] = false;
+        }
+    }
+
+    Workbook& book;
+    int calcType;
+    uint32_t row;
+    bool active;
+    bool hasData;
+    bool numeric;
+    double values[3];
+    bool hasNumber[3];
+};
+
+bool Parse(const char* data, size_t size, Workbook& book, std::string& error)
+{
+    book.windows.Clear();
+    book.floorHeight = 0.0;
+    book.hasFloorHeight = false;
+    book.skippedRows = 0;
+    for (int i = 0; i < 3; ++i) {
+        book.windowsByType[i] = 0;
+    }
+
+    Xlsx::Reader reader;
+    if (!reader.Open(data, size)) {
+        error = reader.GetError();
+        return false;
+    }
+
+    int sheets[3];
+    bool named = false;
+    for (int type = 0; type < 3; ++type) {
+        sheets[type] = reader.FindSheet(SheetNames[type]);
+        named = named || sheets[type] >= 0;
+    }
+    if (!named) {
+        for (int type = 0; type < 3; ++type) {
+            sheets[type] = type < static_cast<int>(reader.GetSheetCount()) ? type : -1;
+        }
+    }
+
+    for (int type = 0; type < 3; ++type) {
+        if (sheets[type] < 0) {
+            continue;
+        }
+        RowCollector collector(book, type);
+        const bool ok = reader.ReadSheet(static_cast<size_t>(sheets[type]), [&collector](const Xlsx::Cell& cell) {
+            collector.Add(cell);
+        });
+        if (!ok) {
+            error = reader.GetError();
+            return false;
+        }
+        collector.Flush();
+    }
+
+    return true;
+}
+
+CassetteCore::Params ParamsFor(const Workbook& book, const CassetteCore::Params& base)
+{
+    CassetteCore::Params params = base;
+    if (book.hasFloorHeight) {
+        params.floorHeight = book.floorHeight;
+    }
+    return params;
+}
+
+} // namespace TsprgImport
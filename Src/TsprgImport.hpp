@@ -0,0 +1,40 @@
+#ifndef TSPRGIMPORT_HPP
+#define TSPRGIMPORT_HPP
+
+// =============================================================================
+// TsprgImport - Окна из книг Excel старых скриптов tsprg
+// =============================================================================
+// Раскладка книги (см. ANALYSIS_tsprg.md):
+//   Лист1 - окна типа 0: B - ширина, C - высота; I2 - высота этажа
+//   Лист2 - окна типа 1: B - ширина, C - высота, D - подоконник
+//   Лист3 - окна типа 2: B - ширина, C - высота, D - подоконник
+// Размеры в метрах. Если листов с такими именами нет, берутся первые три
+// листа по порядку. Строки без положительных B и C (заголовки, итоги,
+// пустые) пропускаются; старые скрипты читали 20 строк, здесь - все.
+// Модуль не зависит от Archicad API: книга передаётся блоком памяти.
+
+#include "CassetteCore.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace TsprgImport {
+
+struct Workbook {
+    CassetteCore::WindowBatch windows;
+    double floorHeight;         // I2 на Лист1
+    bool hasFloorHeight;        // I2 заполнена положительным числом
+    uint32_t windowsByType[3];  // Принято окон с Лист1, Лист2, Лист3
+    uint32_t skippedRows;       // Строки с данными в B-D, которые не удалось разобрать
+};
+
+// Разобрать книгу (.xlsx) из памяти. error - текст ошибки в UTF-8.
+bool Parse(const char* data, size_t size, Workbook& book, std::string& error);
+
+// Параметры расчёта книги: высота этажа из I2, если она есть
+CassetteCore::Params ParamsFor(const Workbook& book, const CassetteCore::Params& base);
+
+} // namespace TsprgImport
+
+#endif // TSPRGIMPORT_HPP
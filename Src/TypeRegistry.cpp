@@ -0,0 +1,385 @@
+// =============================================================================
+// TypeRegistry - Реестр типов проёмов: детали и формулы размеров
+// =============================================================================
+
+#include "TypeRegistry.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace TypeRegistry {
+
+// =============================================================================
+// Вспомогательные функции
+// =============================================================================
+
+static const char* const VarNames[VarCount] = {
+    "B", "C", "D", "I2", "offsetX", "offsetY", "offsetTop", "plankWidth", "slopeWidth"
+};
+
+static const char* const PartNames[] = { "cassette", "plank", "left", "right" };
+
+static std::string_view Trim(std::string_view text)
+{
+    while (!text.empty() && text.front() == ' ') {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && text.back() == ' ') {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// Целое без знака (до 9 цифр), вся строка
+static bool ParseNumber(std::string_view text, int32_t& value)
+{
+    if (text.empty() || text.size() > 9) {
+        return false;
+    }
+    value = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+// Запятая вне скобок (разделитель формул детали)
+static size_t FindTopLevelComma(std::string_view text)
+{
+    int depth = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '(') {
+            ++depth;
+        } else if (text[i] == ')') {
+            --depth;
+        } else if (text[i] == ',' && depth == 0) {
+            return i;
+        }
+    }
+    return std::string_view::npos;
+}
+
+static bool ParseFormula(std::string_view text, SizeExpr::Program& formula, std::string& error)
+{
+    return formula.Compile(text, VarNames, VarCount, error);
+}
+
+// Ширина профиля по умолчанию для вида детали
+static const char* DefaultWidth(PartKind kind)
+{
+    return kind == PartKind::Plank ? VarNames[VarPlankWidth] : VarNames[VarSlopeWidth];
+}
+
+// =============================================================================
+// Определение типа
+// =============================================================================
+
+// "plank 2: B + offsetY" -> деталь
+static bool ParsePart(std::string_view item, Part& part, std::string& error)
+{
+    const size_t colon = item.find(':');
+    if (colon == std::string_view::npos) {
+        error = "нет ':' в детали \"" + std::string(item) + "\"";
+        return false;
+    }
+
+    // Вид и количество
+    std::string_view head = Trim(item.substr(0, colon));
+    const size_t space = head.find(' ');
+    const std::string_view name = head.substr(0, space);
+    const std::string_view countText = space == std::string_view::npos ? std::string_view() : Trim(head.substr(space));
+    const auto kind = std::find_if(std::begin(PartNames), std::end(PartNames), [name](const char* n) {
+        return name == n;
+    });
+    if (kind == std::end(PartNames)) {
+        error = "неизвестная деталь \"" + std::string(name) + "\" (cassette, plank, left, right)";
+        return false;
+    }
+    part.kind = static_cast<PartKind>(kind - std::begin(PartNames));
+    part.count = 1;
+    if (!countText.empty()) {
+        if (!ParseNumber(countText, part.count) || part.count <= 0) {
+            error = "неверное количество \"" + std::string(countText) + "\"";
+            return false;
+        }
+    }
+
+    // Формулы: кассета - X, Y; планка/откос - длина[, ширина]
+    const std::string_view formulas = item.substr(colon + 1);
+    const size_t comma = FindTopLevelComma(formulas);
+    if (!ParseFormula(formulas.substr(0, comma), part.a, error)) {
+        return false;
+    }
+    if (comma != std::string_view::npos) {
+        if (!ParseFormula(formulas.substr(comma + 1), part.b, error)) {
+            return false;
+        }
+    } else if (part.kind == PartKind::Cassette) {
+        error = "у кассеты две формулы: X, Y";
+        return false;
+    } else {
+        ParseFormula(DefaultWidth(part.kind), part.b, error);
+    }
+    return true;
+}
+
+static bool ParseType(std::string_view definition, Type& type, std::string& error)
+{
+    Type parsed;
+    parsed.defined = true;
+
+    // Группа, затем детали через '|'
+    size_t bar = definition.find('|');
+    const std::string_view group = Trim(definition.substr(0, bar));
+    if (group != "0" && group != "1") {
+        error = "группа типа - 0 или 1";
+        return false;
+    }
+    parsed.group = group[0] - '0';
+
+    while (bar != std::string_view::npos) {
+        definition.remove_prefix(bar + 1);
+        bar = definition.find('|');
+        const std::string_view item = Trim(definition.substr(0, bar));
+        if (item.empty()) {
+            continue;
+        }
+        Part part;
+        if (!ParsePart(item, part, error)) {
+            return false;
+        }
+        parsed.parts.push_back(part);
+    }
+
+    type = parsed;
+    return true;
+}
+
+// =============================================================================
+// Registry
+// =============================================================================
+
+Registry::Registry()
+{
+    for (Type& type : types) {
+        type.defined = false;
+        type.group = 1;
+    }
+    types[0].defined = true;
+    Compile();
+}
+
+Registry Registry::Standard()
+{
+    // Тип 1 - верхняя кассета, тип 2 - нижняя и верхняя
+    static const char* const definitions[][2] = {
+        { "other", "1|plank 2: B + offsetY|left: C|right: C" },
+        { "0",     "0|plank 2: B + offsetY|left: C|right: C" },
+        { "1",     "1|plank 2: B + offsetY|left: C|right: C|cassette: I2 - (190 + C + D + 20) + offsetTop, B + offsetY" },
+        { "2",     "1|plank 2: B + offsetY|left: C|right: C|cassette: D + offsetX, B + offsetY"
+                   "|cassette: I2 - (190 + C + D + 20) + offsetTop, B + offsetY" }
+    };
+
+    Registry registry;
+    std::string error;
+    for (const auto& definition : definitions) {
+        registry.SetType(definition[0], definition[1], error);
+    }
+    return registry;
+}
+
+bool Registry::SetType(std::string_view key, std::string_view definition, std::string& error)
+{
+    key = Trim(key);
+    size_t slot = 0;
+    if (key != "other") {
+        int32_t calcType = 0;
+        if (!ParseNumber(key, calcType) || calcType >= IdClassifier::TypeCount) {
+            error = "неверный тип \"" + std::string(key) + "\" (0..." + std::to_string(IdClassifier::TypeCount - 1) + " или other)";
+            return false;
+        }
+        slot = 1 + static_cast<size_t>(calcType);
+    }
+
+    Type type;
+    if (Trim(definition).empty()) {
+        // Снять тип; other остаётся заданным, без деталей
+        type.defined = slot == 0;
+        type.group = 1;
+    } else if (!ParseType(definition, type, error)) {
+        error = "type." + std::string(key) + ": " + error;
+        return false;
+    }
+    types[slot] = type;
+    Compile();
+    return true;
+}
+
+std::string Registry::FormatType(int calcType) const
+{
+    if (calcType >= IdClassifier::TypeCount) {
+        return std::string();
+    }
+    const Type& type = types[calcType < 0 ? 0 : 1 + calcType];
+    if (!type.defined) {
+        return std::string();
+    }
+
+    std::string text = std::to_string(type.group);
+    for (const Part& part : type.parts) {
+        text += '|';
+        text += PartNames[static_cast<int>(part.kind)];
+        if (part.count != 1) {
+            text += ' ' + std::to_string(part.count);
+        }
+        text += ": " + part.a.GetSource();
+        if (part.kind == PartKind::Cassette || part.b.GetSource() != DefaultWidth(part.kind)) {
+            text += ", " + part.b.GetSource();
+        }
+    }
+    return text;
+}
+
+int Registry::GetGroup(int calcType) const
+{
+    return types[Slot(calcType)].group;
+}
+
+size_t Registry::Slot(int calcType) const
+{
+    return slotOf[static_cast<uint8_t>(calcType)];
+}
+
+void Registry::Compile()
+{
+    table.clear();
+    tableGroup.clear();
+    for (size_t slot = 0; slot < std::size(types); ++slot) {
+        start[slot] = static_cast<uint32_t>(table.size());
+        if (!types[slot].defined) {
+            continue;
+        }
+        for (const Part& part : types[slot].parts) {
+            table.push_back(part);
+            tableGroup.push_back(static_cast<uint8_t>(types[slot].group));
+        }
+    }
+    start[std::size(types)] = static_cast<uint32_t>(table.size());
+
+    // Тип int8 -> слот; незаданные и отрицательные типы - other
+    for (int value = 0; value < 256; ++value) {
+        const int calcType = static_cast<int8_t>(value);
+        const bool known = calcType >= 0 && calcType < IdClassifier::TypeCount && types[1 + calcType].defined;
+        slotOf[value] = static_cast<uint8_t>(known ? 1 + calcType : 0);
+    }
+}
+
+// Линейная формула - коэффициенты out, иначе программа ядра (номер)
+static int32_t BindFormula(const SizeExpr::Program& formula, const Values& values, int group,
+                           std::vector<SizeExpr::Program>& programs, int32_t out[WindowVarCount + 1])
+{
+    SizeExpr::Binding bindings[VarCount];
+    for (size_t v = 0; v < WindowVarCount; ++v) {
+        bindings[v] = { true, static_cast<int32_t>(v) };
+    }
+    bindings[VarI2] = { false, values.floorHeight };
+    bindings[VarOffsetX] = { false, values.offsetX };
+    bindings[VarOffsetY] = { false, values.offsetY };
+    bindings[VarOffsetTop] = { false, values.offsetTop };
+    bindings[VarPlankWidth] = { false, values.plankWidth[group] };
+    bindings[VarSlopeWidth] = { false, values.slopeWidth[group] };
+
+    SizeExpr::Program bound = formula.Bind(bindings);
+    if (bound.GetLinear(WindowVarCount, out)) {
+        return -1;
+    }
+    std::fill(out, out + WindowVarCount + 1, 0);
+    programs.push_back(std::move(bound));
+    return static_cast<int32_t>(programs.size() - 1);
+}
+
+void Registry::Bind(const Values& values, Kernel& kernel) const
+{
+    kernel.parts.resize(table.size());
+    kernel.programs.clear();
+    for (size_t i = 0; i < table.size(); ++i) {
+        const Part& part = table[i];
+        BoundPart& bound = kernel.parts[i];
+        const int group = tableGroup[i];
+        bound.target = static_cast<uint8_t>(part.kind == PartKind::Cassette ? 0 : 1 + 2 * (static_cast<int>(part.kind) - 1) + group);
+        bound.count = part.count;
+        bound.aProgram = BindFormula(part.a, values, group, kernel.programs, bound.a);
+        bound.bProgram = BindFormula(part.b, values, group, kernel.programs, bound.b);
+    }
+    kernel.start.assign(std::begin(start), std::end(start));
+    std::copy(std::begin(slotOf), std::end(slotOf), std::begin(kernel.slotOf));
+}
+
+// =============================================================================
+// Kernel
+// =============================================================================
+
+// Скалярное произведение по модулю 2^32, как в SizeExpr
+static void EvaluateLinear(const int32_t coeff[WindowVarCount + 1], const int32_t* const* window, size_t count, int32_t* out)
+{
+    const uint32_t c0 = static_cast<uint32_t>(coeff[0]);
+    const uint32_t cb = static_cast<uint32_t>(coeff[1]);
+    const uint32_t cc = static_cast<uint32_t>(coeff[2]);
+    const uint32_t cd = static_cast<uint32_t>(coeff[3]);
+    const int32_t* b = window[VarB];
+    const int32_t* c = window[VarC];
+    const int32_t* d = window[VarD];
+    for (size_t j = 0; j < count; ++j) {
+        const uint32_t value = c0 + cb * static_cast<uint32_t>(b[j]) + cc * static_cast<uint32_t>(c[j]) + cd * static_cast<uint32_t>(d[j]);
+        out[j] = static_cast<int32_t>(value);
+    }
+}
+
+void Kernel::Evaluate(const BoundPart& part, const int32_t* const* window, size_t count,
+                      int32_t* a, int32_t* b, std::vector<int32_t>& stack) const
+{
+    if (part.aProgram < 0) {
+        EvaluateLinear(part.a, window, count, a);
+    } else {
+        programs[part.aProgram].Evaluate(window, count, a, stack);
+    }
+    if (part.bProgram < 0) {
+        EvaluateLinear(part.b, window, count, b);
+    } else {
+        programs[part.bProgram].Evaluate(window, count, b, stack);
+    }
+}
+
+// =============================================================================
+// Текущий реестр
+// =============================================================================
+
+static Registry& Current()
+{
+    static Registry registry = Registry::Standard();
+    return registry;
+}
+
+static uint64_t s_revision = 0;
+
+const Registry& GetRegistry()
+{
+    return Current();
+}
+
+void SetRegistry(const Registry& registry)
+{
+    Current() = registry;
+    ++s_revision;
+}
+
+uint64_t GetRevision()
+{
+    return s_revision;
+}
+
+} // namespace TypeRegistry
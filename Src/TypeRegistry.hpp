@@ -0,0 +1,165 @@
+#ifndef TYPEREGISTRY_HPP
+#define TYPEREGISTRY_HPP
+
+// =============================================================================
+// TypeRegistry - Реестр типов проёмов: детали и формулы размеров
+// =============================================================================
+// Для каждого типа расчёта (код из ID, см. IdClassifier) реестр объявляет,
+// какие детали получает проём и по каким формулам считаются их размеры.
+// Определение типа - строка настроек (ключ type.N или type.other в
+// settings.csv):
+//   группа|деталь [штук]: формула[, формула]|...
+// группа 0 - профили и объекты типа 0, 1 - типов 1-2 (ширины plankWidth и
+// slopeWidth, объекты записи и колонка "Тип" выгрузок);
+// детали: cassette (формулы X и Y), plank, left, right (длина и, необязательно,
+// ширина профиля - по умолчанию plankWidth / slopeWidth группы).
+// Формула - выражение SizeExpr в мм (+ - * /, скобки, min, max, abs, round).
+// Переменные: B, C, D - ширина, высота и подоконник проёма; I2 - высота
+// этажа; offsetX, offsetY, offsetTop, plankWidth, slopeWidth - параметры.
+//
+// При загрузке реестр компилируется в таблицу деталей (ядро): детали всех
+// типов подряд, у типа - диапазон таблицы, тип окна -> диапазон - поиском
+// по массиву. Перед расчётом параметры подставляются в формулы (Bind):
+// линейные формулы становятся коэффициентами при (1, B, C, D), остальные -
+// байткодом над колонками B, C, D, который считается блоками окон одного
+// типа. Новый тип не замедляет цикл и не требует сборки.
+// Модуль не зависит от Archicad API (только стандартная библиотека).
+
+#include "IdClassifier.hpp"
+#include "SizeExpr.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace TypeRegistry {
+
+enum class PartKind : uint8_t {
+    Cassette = 0,
+    Plank,
+    LeftSlope,
+    RightSlope
+};
+
+// Переменные формул; колонки пакета окон - первые WindowVarCount
+enum Var : uint8_t {
+    VarB = 0,               // Ширина проёма, мм
+    VarC,                   // Высота проёма, мм
+    VarD,                   // Подоконник, мм
+    VarI2,                  // Высота этажа, мм
+    VarOffsetX,
+    VarOffsetY,
+    VarOffsetTop,
+    VarPlankWidth,          // Ширина планки группы типа
+    VarSlopeWidth,          // Ширина откоса группы типа
+    VarCount
+};
+
+const size_t WindowVarCount = 3;
+
+struct Part {
+    PartKind kind;
+    int32_t count;          // Штук на проём
+    SizeExpr::Program a;    // Кассета: X; планка/откос: длина
+    SizeExpr::Program b;    // Кассета: Y; планка/откос: ширина профиля
+};
+
+struct Type {
+    bool defined;           // false - проёмы типа считаются по type.other
+    int group;              // 0 - группа типа 0, 1 - группа типов 1-2
+    std::vector<Part> parts;
+};
+
+// Гистограммы результата: кассеты, затем планки, левые и правые откосы по группам
+const int TargetCount = 7;
+
+// Деталь ядра. Размер a - скалярное произведение a[] с (1, B, C, D), если
+// aProgram == -1, иначе программа ядра с этим номером (так же b).
+struct BoundPart {
+    uint8_t target;         // 0 - кассеты, 1 + 2 * (вид - 1) + группа
+    int32_t count;
+    int32_t a[WindowVarCount + 1];
+    int32_t b[WindowVarCount + 1];
+    int32_t aProgram;
+    int32_t bProgram;
+};
+
+// Параметры, подставляемые в формулы при расчёте (мм)
+struct Values {
+    int32_t floorHeight;
+    int32_t offsetX;
+    int32_t offsetY;
+    int32_t offsetTop;
+    int32_t plankWidth[2];  // По группам
+    int32_t slopeWidth[2];
+};
+
+// Ядро с подставленными параметрами (на один расчёт)
+class Kernel {
+public:
+    // Слоты: 0 - other, 1 + тип; слот любого значения int8 - без проверок
+    size_t SlotCount() const { return start.empty() ? 0 : start.size() - 1; }
+    size_t SlotOf(int calcType) const { return slotOf[static_cast<uint8_t>(calcType)]; }
+
+    // Детали проёма слота slot: [Begin, End)
+    const BoundPart* Begin(size_t slot) const { return parts.data() + start[slot]; }
+    const BoundPart* End(size_t slot) const { return parts.data() + start[slot + 1]; }
+
+    // Размеры детали для блока окон: window[k][j] - переменная k (B, C, D)
+    // окна j, count <= SizeExpr::BlockSize; stack - рабочая память
+    void Evaluate(const BoundPart& part, const int32_t* const* window, size_t count,
+                  int32_t* a, int32_t* b, std::vector<int32_t>& stack) const;
+
+private:
+    friend class Registry;
+
+    std::vector<BoundPart> parts;
+    std::vector<SizeExpr::Program> programs;
+    std::vector<uint32_t> start;            // IdClassifier::TypeCount + 2
+    uint8_t slotOf[256];
+};
+
+class Registry {
+public:
+    Registry();                             // Пустой: все проёмы - type.other без деталей
+
+    // Типы 0, 1, 2 и other, как считал аддон до реестра
+    static Registry Standard();
+
+    // Задать тип key ("0"...IdClassifier::TypeCount - 1 или "other"); пустое
+    // определение снимает тип. false - ошибка в error, реестр не меняется.
+    bool SetType(std::string_view key, std::string_view definition, std::string& error);
+
+    // Определение типа (-1 - other); пусто - тип не задан
+    std::string FormatType(int calcType) const;
+
+    // Группа типа (0 или 1) для проёма типа calcType
+    int GetGroup(int calcType) const;
+
+    // Подставить параметры в скомпилированную таблицу
+    void Bind(const Values& values, Kernel& kernel) const;
+
+private:
+    void Compile();
+    size_t Slot(int calcType) const;
+
+    Type types[IdClassifier::TypeCount + 1];            // [0] - other, [1 + t] - тип t
+    std::vector<Part> table;                            // Детали всех слотов подряд
+    std::vector<uint8_t> tableGroup;                    // Группа слота каждой детали
+    uint32_t start[IdClassifier::TypeCount + 2];
+    uint8_t slotOf[256];
+};
+
+// Реестр аддона (по умолчанию - Standard). SetRegistry вызывается из главного
+// потока при загрузке и сохранении настроек; cassette-batch передаёт свой
+// реестр проекта в CassetteCore::Calculate.
+const Registry& GetRegistry();
+void SetRegistry(const Registry& registry);
+
+// Номер версии реестра аддона: растёт при каждом SetRegistry (ключ кэша расчётов)
+uint64_t GetRevision();
+
+} // namespace TypeRegistry
+
+#endif // TYPEREGISTRY_HPP
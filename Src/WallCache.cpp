@@ -0,0 +1,135 @@
+// =============================================================================
+// WallCache - Стены и их проёмы между нажатиями кнопок
+// =============================================================================
+
+#include "WallCache.hpp"
+
+#include <algorithm>
+
+namespace WallCache {
+
+Cache::Cache()
+{
+    Clear();
+}
+
+const Wall* Cache::Find(const HostApi::Guid& wall) const
+{
+    std::map<HostApi::Guid, Wall>::const_iterator it = walls.find(wall);
+    if (it == walls.end()) {
+        ++misses;
+        return nullptr;
+    }
+    ++hits;
+    return &it->second;
+}
+
+const Wall& Cache::Put(const HostApi::Element& element)
+{
+    Wall& wall = walls[element.guid];
+    wall.guid = element.guid;
+    wall.storey = element.floorInd;
+    wall.height = element.wallHeight;
+    wall.begX = element.begX;
+    wall.begY = element.begY;
+    wall.endX = element.endX;
+    wall.endY = element.endY;
+    wall.arcAngle = element.arcAngle;
+    wall.flipped = element.flipped;
+    wall.idsKnown = false;
+    wall.ids.clear();
+    return wall;
+}
+
+void Cache::SetIds(const HostApi::Guid& wall, const std::vector<std::string>& ids)
+{
+    std::map<HostApi::Guid, Wall>::iterator it = walls.find(wall);
+    if (it != walls.end()) {
+        it->second.ids = ids;
+        it->second.idsKnown = true;
+    }
+}
+
+bool Cache::GetWallList(std::vector<HostApi::Guid>& list) const
+{
+    if (!wallListKnown) {
+        return false;
+    }
+    list = wallList;
+    return true;
+}
+
+void Cache::SetWallList(const std::vector<HostApi::Guid>& list)
+{
+    wallList = list;
+    wallListKnown = true;
+}
+
+// =============================================================================
+// Проёмы стен
+// =============================================================================
+
+static void RemoveOpening(std::vector<HostApi::Guid>& openings, const HostApi::Guid& opening)
+{
+    openings.erase(std::remove(openings.begin(), openings.end(), opening), openings.end());
+}
+
+bool Cache::AddOpening(const HostApi::Guid& wall, const HostApi::Guid& opening)
+{
+    std::map<HostApi::Guid, HostApi::Guid>::iterator it = openingWall.find(opening);
+    if (it != openingWall.end()) {
+        if (it->second == wall) {
+            return false;
+        }
+        RemoveOpening(hosted[it->second], opening);
+        it->second = wall;
+    } else {
+        openingWall[opening] = wall;
+    }
+    hosted[wall].push_back(opening);
+    return true;
+}
+
+const std::vector<HostApi::Guid>& Cache::GetOpenings(const HostApi::Guid& wall) const
+{
+    static const std::vector<HostApi::Guid> none;
+    std::map<HostApi::Guid, std::vector<HostApi::Guid>>::const_iterator it = hosted.find(wall);
+    return it != hosted.end() ? it->second : none;
+}
+
+// =============================================================================
+// Уведомления
+// =============================================================================
+
+void Cache::OnElementChanged(const HostApi::Guid& guid)
+{
+    // Стена: размеры, линия или ID могли измениться - прочитается заново.
+    // Её проёмы следят за собой сами (у каждого своё уведомление).
+    walls.erase(guid);
+
+    // Проём: мог переехать в другую стену или быть удалён
+    std::map<HostApi::Guid, HostApi::Guid>::iterator it = openingWall.find(guid);
+    if (it != openingWall.end()) {
+        RemoveOpening(hosted[it->second], guid);
+        openingWall.erase(it);
+    }
+}
+
+void Cache::OnWallListChanged()
+{
+    wallList.clear();
+    wallListKnown = false;
+}
+
+void Cache::Clear()
+{
+    walls.clear();
+    hosted.clear();
+    openingWall.clear();
+    wallList.clear();
+    wallListKnown = false;
+    hits = 0;
+    misses = 0;
+}
+
+} // namespace WallCache
@@ -0,0 +1,81 @@
+#ifndef WALLCACHE_HPP
+#define WALLCACHE_HPP
+
+// =============================================================================
+// WallCache - Стены и их проёмы между нажатиями кнопок
+// =============================================================================
+// Поиск высоты этажа по ID стены и координаты проёмов читают одни и те же
+// стены. Кэш хранит по GUID стены её высоту, этаж, линию привязки, значения
+// свойств ID и известные проёмы, поэтому повторные нажатия не читают стены
+// из модели заново.
+// Актуальность - по уведомлениям Archicad (AcHost): изменённая или удалённая
+// стена выбрасывается из кэша, новая, удалённая или восстановленная отменой
+// стена сбрасывает список стен, изменённый проём - его привязку к стене.
+// При открытии и закрытии проекта кэш очищается.
+// Модуль не зависит от Archicad API (только стандартная библиотека).
+
+#include "HostApi.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace WallCache {
+
+struct Wall {
+    HostApi::Guid guid;
+    int32_t storey;
+    double height;              // м
+    double begX;                // Линия привязки, м
+    double begY;
+    double endX;
+    double endY;
+    double arcAngle;            // Центральный угол дуги (0 - прямая), рад
+    bool flipped;               // Отражена относительно линии привязки
+    bool idsKnown;              // ids прочитаны
+    std::vector<std::string> ids;       // Строковые значения свойств ID (пользовательские, затем все)
+};
+
+class Cache {
+public:
+    Cache();
+
+    // Стена или nullptr, если её нет в кэше
+    const Wall* Find(const HostApi::Guid& wall) const;
+
+    // Запомнить стену, прочитанную GetElement (значения ID - отдельно, SetIds)
+    const Wall& Put(const HostApi::Element& element);
+    void SetIds(const HostApi::Guid& wall, const std::vector<std::string>& ids);
+
+    // Список всех стен проекта; false - не известен (не читался или сброшен)
+    bool GetWallList(std::vector<HostApi::Guid>& walls) const;
+    void SetWallList(const std::vector<HostApi::Guid>& walls);
+
+    // Проём стоит в стене wall (прежняя привязка проёма снимается);
+    // false - привязка уже была такой
+    bool AddOpening(const HostApi::Guid& wall, const HostApi::Guid& opening);
+    // Известные проёмы стены
+    const std::vector<HostApi::Guid>& GetOpenings(const HostApi::Guid& wall) const;
+
+    // Уведомления Archicad
+    void OnElementChanged(const HostApi::Guid& guid);      // Стена или проём изменены/удалены
+    void OnWallListChanged();                               // Стены добавлены, удалены или восстановлены
+    void Clear();                                           // Проект открыт или закрыт
+
+    size_t GetWallCount() const { return walls.size(); }
+    uint64_t GetHits() const { return hits; }
+    uint64_t GetMisses() const { return misses; }
+
+private:
+    std::map<HostApi::Guid, Wall> walls;
+    std::map<HostApi::Guid, std::vector<HostApi::Guid>> hosted;    // Стена -> проёмы
+    std::map<HostApi::Guid, HostApi::Guid> openingWall;             // Проём -> стена
+    std::vector<HostApi::Guid> wallList;
+    bool wallListKnown;
+    mutable uint64_t hits;
+    mutable uint64_t misses;
+};
+
+} // namespace WallCache
+
+#endif // WALLCACHE_HPP
@@ -0,0 +1,628 @@
+// =============================================================================
+// XlsxReader - Чтение книг Excel (.xlsx)
+// =============================================================================
+
+#include "XlsxReader.hpp"
+
+#include <charconv>
+#include <cstring>
+
+namespace Xlsx {
+
+// =============================================================================
+// Просмотр тегов XML
+// =============================================================================
+// Достаточно для частей SpreadsheetML: теги, атрибуты в кавычках, текст между
+// тегами. Объявления (<?...?>), комментарии и <!...> пропускаются. Префиксы
+// пространств имён отбрасываются (x:row и row - один тег).
+
+struct Tag {
+    const char* start;      // '<'
+    const char* name;       // Локальное имя (без префикса)
+    size_t nameLength;
+    const char* attrs;      // Атрибуты: от имени до '>' или '/>'
+    const char* attrsEnd;
+    bool closing;           // </name>
+    bool selfClosing;       // <name/>
+
+    bool Is(const char* local) const
+    {
+        return std::strlen(local) == nameLength && std::memcmp(name, local, nameLength) == 0;
+    }
+};
+
+class TagScanner {
+public:
+    TagScanner(const char* begin, const char* end) : pos(begin), end(end) {}
+
+    const char* Pos() const { return pos; }
+
+    bool Next(Tag& tag)
+    {
+        for (;;) {
+            const char* lt = static_cast<const char*>(std::memchr(pos, '<', end - pos));
+            if (lt == nullptr || lt + 1 >= end) {
+                pos = end;
+                return false;
+            }
+
+            if (lt[1] == '?' || lt[1] == '!') {
+                const char* close = (end - lt >= 4 && std::memcmp(lt, "<!--", 4) == 0) ? Find(lt + 4, "-->") : Find(lt + 2, ">");
+                if (close == nullptr) {
+                    pos = end;
+                    return false;
+                }
+                pos = close + 1;
+                continue;
+            }
+
+            const char* gt = static_cast<const char*>(std::memchr(lt, '>', end - lt));
+            if (gt == nullptr) {
+                pos = end;
+                return false;
+            }
+
+            tag.start = lt;
+            tag.closing = lt[1] == '/';
+            tag.selfClosing = gt[-1] == '/';
+
+            const char* n = lt + (tag.closing ? 2 : 1);
+            const char* nameEnd = n;
+            while (nameEnd < gt && !IsSpace(*nameEnd) && *nameEnd != '/') {
+                ++nameEnd;
+            }
+            const char* colon = static_cast<const char*>(std::memchr(n, ':', nameEnd - n));
+            tag.name = colon != nullptr ? colon + 1 : n;
+            tag.nameLength = nameEnd - tag.name;
+            tag.attrs = nameEnd;
+            tag.attrsEnd = tag.selfClosing ? gt - 1 : gt;
+
+            pos = gt + 1;
+            return true;
+        }
+    }
+
+    // Текст до следующего тега (сразу после открывающего тега)
+    void Text(const char*& begin, const char*& stop) const
+    {
+        begin = pos;
+        stop = static_cast<const char*>(std::memchr(pos, '<', end - pos));
+        if (stop == nullptr) {
+            stop = end;
+        }
+    }
+
+    static bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+private:
+    const char* Find(const char* from, const char* what) const
+    {
+        const size_t n = std::strlen(what);
+        for (const char* p = from; p + n <= end; ++p) {
+            if (std::memcmp(p, what, n) == 0) {
+                return p + n - 1;
+            }
+        }
+        return nullptr;
+    }
+
+    const char* pos;
+    const char* end;
+};
+
+// Значение атрибута по локальному имени (r:id -> "id"). Значение не раскодировано.
+static bool GetAttr(const Tag& tag, const char* local, const char*& valueBegin, const char*& valueEnd)
+{
+    const size_t localLength = std::strlen(local);
+    const char* p = tag.attrs;
+    while (p < tag.attrsEnd) {
+        while (p < tag.attrsEnd && TagScanner::IsSpace(*p)) {
+            ++p;
+        }
+        const char* nameBegin = p;
+        while (p < tag.attrsEnd && *p != '=' && !TagScanner::IsSpace(*p)) {
+            ++p;
+        }
+        const char* nameEnd = p;
+        while (p < tag.attrsEnd && (TagScanner::IsSpace(*p) || *p == '=')) {
+            ++p;
+        }
+        if (p >= tag.attrsEnd || (*p != '"' && *p != '\'')) {
+            return false;
+        }
+        const char quote = *p++;
+        const char* vb = p;
+        while (p < tag.attrsEnd && *p != quote) {
+            ++p;
+        }
+        const char* ve = p;
+        ++p;
+
+        const char* colon = static_cast<const char*>(std::memchr(nameBegin, ':', nameEnd - nameBegin));
+        const char* localName = colon != nullptr ? colon + 1 : nameBegin;
+        if (static_cast<size_t>(nameEnd - localName) == localLength && std::memcmp(localName, local, localLength) == 0) {
+            valueBegin = vb;
+            valueEnd = ve;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void AppendCodePoint(std::string& out, uint32_t cp)
+{
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x110000) {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+static bool ParseHex(const char* begin, const char* end, uint32_t& value)
+{
+    return begin < end && std::from_chars(begin, end, value, 16).ptr == end;
+}
+
+// Раскодировать сущности XML (&amp; &#1234; ...) и добавить к out.
+// excelEscapes - дополнительно _xHHHH_ (так Excel пишет управляющие символы в тексте).
+static void AppendDecoded(std::string& out, const char* begin, const char* end, bool excelEscapes)
+{
+    const char* p = begin;
+    while (p < end) {
+        const char c = *p;
+        if (c == '&') {
+            const char* semi = static_cast<const char*>(std::memchr(p, ';', end - p));
+            if (semi != nullptr) {
+                const char* name = p + 1;
+                const size_t length = semi - name;
+                uint32_t cp = 0;
+                bool known = true;
+                if (length == 2 && std::memcmp(name, "lt", 2) == 0) {
+                    out.push_back('<');
+                } else if (length == 2 && std::memcmp(name, "gt", 2) == 0) {
+                    out.push_back('>');
+                } else if (length == 3 && std::memcmp(name, "amp", 3) == 0) {
+                    out.push_back('&');
+                } else if (length == 4 && std::memcmp(name, "quot", 4) == 0) {
+                    out.push_back('"');
+                } else if (length == 4 && std::memcmp(name, "apos", 4) == 0) {
+                    out.push_back('\'');
+                } else if (length > 2 && name[0] == '#' && (name[1] == 'x' || name[1] == 'X') && ParseHex(name + 2, semi, cp)) {
+                    AppendCodePoint(out, cp);
+                } else if (length > 1 && name[0] == '#' && std::from_chars(name + 1, semi, cp).ptr == semi) {
+                    AppendCodePoint(out, cp);
+                } else {
+                    known = false;
+                }
+                if (known) {
+                    p = semi + 1;
+                    continue;
+                }
+            }
+        } else if (excelEscapes && c == '_' && end - p >= 7 && p[1] == 'x' && p[6] == '_') {
+            uint32_t cp = 0;
+            if (ParseHex(p + 2, p + 6, cp)) {
+                AppendCodePoint(out, cp);
+                p += 7;
+                continue;
+            }
+        }
+        out.push_back(c);
+        ++p;
+    }
+}
+
+// Число в записи XML (точка, возможна экспонента)
+static bool ParseNumber(const char* begin, const char* end, double& value)
+{
+    while (begin < end && TagScanner::IsSpace(*begin)) {
+        ++begin;
+    }
+    if (begin < end && *begin == '+') {
+        ++begin;
+    }
+    if (begin >= end) {
+        return false;
+    }
+    return std::from_chars(begin, end, value).ec == std::errc();
+}
+
+// =============================================================================
+// Cell
+// =============================================================================
+
+bool Cell::GetNumber(double& out) const
+{
+    if (type == CellType::Number || type == CellType::Bool) {
+        out = number;
+        return true;
+    }
+    if (type != CellType::Text) {
+        return false;
+    }
+
+    // Текст: десятичная запятая допускается, хвост после числа ("1,25 м") отбрасывается
+    char buffer[64];
+    size_t n = 0;
+    for (size_t i = 0; i < text.size() && n < sizeof(buffer); ++i) {
+        buffer[n++] = text[i] == ',' ? '.' : text[i];
+    }
+    return ParseNumber(buffer, buffer + n, out);
+}
+
+bool ParseCellRef(const char* begin, const char* end, uint32_t& row, uint32_t& column)
+{
+    const char* p = begin;
+    uint32_t col = 0;
+    while (p < end && *p >= 'A' && *p <= 'Z') {
+        col = col * 26 + static_cast<uint32_t>(*p - 'A' + 1);
+        ++p;
+    }
+    uint32_t r = 0;
+    if (col == 0 || p == end || std::from_chars(p, end, r).ptr != end || r == 0) {
+        return false;
+    }
+    row = r - 1;
+    column = col - 1;
+    return true;
+}
+
+// =============================================================================
+// Связи частей (.rels)
+// =============================================================================
+
+struct Relationship {
+    std::string id;
+    std::string type;
+    std::string target;     // Полный путь внутри архива
+};
+
+// Каталог части: "xl/workbook.xml" -> "xl/"
+static std::string PartDirectory(const std::string& part)
+{
+    const size_t slash = part.rfind('/');
+    return slash == std::string::npos ? std::string() : part.substr(0, slash + 1);
+}
+
+// Путь цели связи относительно каталога части ("worksheets/sheet1.xml", "/xl/...", "../...")
+static std::string ResolveTarget(const std::string& directory, const std::string& target)
+{
+    std::string path = !target.empty() && target[0] == '/' ? target.substr(1) : directory + target;
+
+    std::vector<std::string> segments;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t slash = path.find('/', start);
+        if (slash == std::string::npos) {
+            slash = path.size();
+        }
+        const std::string segment = path.substr(start, slash - start);
+        if (segment == "..") {
+            if (!segments.empty()) {
+                segments.pop_back();
+            }
+        } else if (!segment.empty() && segment != ".") {
+            segments.push_back(segment);
+        }
+        start = slash + 1;
+    }
+
+    std::string result;
+    for (const std::string& segment : segments) {
+        if (!result.empty()) {
+            result.push_back('/');
+        }
+        result += segment;
+    }
+    return result;
+}
+
+static void ParseRelationships(const std::string& xml, const std::string& directory, std::vector<Relationship>& out)
+{
+    TagScanner scanner(xml.data(), xml.data() + xml.size());
+    Tag tag;
+    while (scanner.Next(tag)) {
+        if (tag.closing || !tag.Is("Relationship")) {
+            continue;
+        }
+        const char* b;
+        const char* e;
+        Relationship rel;
+        if (GetAttr(tag, "Id", b, e)) {
+            AppendDecoded(rel.id, b, e, false);
+        }
+        if (GetAttr(tag, "Type", b, e)) {
+            AppendDecoded(rel.type, b, e, false);
+        }
+        if (GetAttr(tag, "Target", b, e)) {
+            std::string target;
+            AppendDecoded(target, b, e, false);
+            rel.target = ResolveTarget(directory, target);
+        }
+        out.push_back(rel);
+    }
+}
+
+static bool EndsWith(const std::string& s, const char* suffix)
+{
+    const size_t n = std::strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+// =============================================================================
+// Reader
+// =============================================================================
+
+Reader::Reader()
+{
+}
+
+bool Reader::Fail(const char* message)
+{
+    error = message;
+    return false;
+}
+
+bool Reader::Open(const char* data, size_t size)
+{
+    sheets.clear();
+    sharedStrings.clear();
+    error.clear();
+
+    if (!zip.Open(data, size)) {
+        return Fail("Файл не является книгой Excel (.xlsx)");
+    }
+
+    // Главная часть книги из корневых связей; обычно xl/workbook.xml
+    std::string workbookPart = "xl/workbook.xml";
+    if (zip.Extract("_rels/.rels", xml)) {
+        std::vector<Relationship> rels;
+        ParseRelationships(xml, std::string(), rels);
+        for (const Relationship& rel : rels) {
+            if (EndsWith(rel.type, "/officeDocument")) {
+                workbookPart = rel.target;
+                break;
+            }
+        }
+    }
+
+    return LoadSheets(workbookPart);
+}
+
+bool Reader::LoadSheets(const std::string& workbookPart)
+{
+    const std::string directory = PartDirectory(workbookPart);
+    const std::string relsPart = directory + "_rels/" + workbookPart.substr(directory.size()) + ".rels";
+
+    std::vector<Relationship> rels;
+    if (zip.Extract(relsPart, xml)) {
+        ParseRelationships(xml, directory, rels);
+    }
+
+    if (!zip.Extract(workbookPart, xml)) {
+        return Fail("В книге нет части workbook.xml");
+    }
+
+    TagScanner scanner(xml.data(), xml.data() + xml.size());
+    Tag tag;
+    while (scanner.Next(tag)) {
+        if (tag.closing || !tag.Is("sheet")) {
+            continue;
+        }
+        const char* b;
+        const char* e;
+        Sheet sheet;
+        if (GetAttr(tag, "name", b, e)) {
+            AppendDecoded(sheet.name, b, e, false);
+        }
+        if (GetAttr(tag, "id", b, e)) {
+            const std::string id(b, e);
+            for (const Relationship& rel : rels) {
+                if (rel.id == id) {
+                    sheet.part = rel.target;
+                    break;
+                }
+            }
+        }
+        // Без связей: листы по порядку, как их пишут все известные программы
+        if (sheet.part.empty()) {
+            sheet.part = directory + "worksheets/sheet" + std::to_string(sheets.size() + 1) + ".xml";
+        }
+        sheets.push_back(sheet);
+    }
+
+    if (sheets.empty()) {
+        return Fail("В книге нет листов");
+    }
+
+    for (const Relationship& rel : rels) {
+        if (EndsWith(rel.type, "/sharedStrings")) {
+            return LoadSharedStrings(rel.target);
+        }
+    }
+    return LoadSharedStrings(directory + "sharedStrings.xml");
+}
+
+bool Reader::LoadSharedStrings(const std::string& part)
+{
+    // Таблицы может не быть, если в книге только числа
+    if (!zip.Contains(part)) {
+        return true;
+    }
+    if (!zip.Extract(part, xml)) {
+        return Fail("Повреждена таблица строк книги");
+    }
+
+    TagScanner scanner(xml.data(), xml.data() + xml.size());
+    Tag tag;
+    std::string current;
+    int phonetic = 0;       // Внутри <rPh> (фонетическая подсказка, не часть текста)
+    while (scanner.Next(tag)) {
+        if (tag.Is("si")) {
+            if (tag.closing) {
+                sharedStrings.push_back(current);
+            } else {
+                current.clear();
+                if (tag.selfClosing) {
+                    sharedStrings.push_back(current);
+                }
+            }
+        } else if (tag.Is("rPh") && !tag.selfClosing) {
+            phonetic += tag.closing ? -1 : 1;
+        } else if (tag.Is("t") && !tag.closing && !tag.selfClosing && phonetic == 0) {
+            const char* b;
+            const char* e;
+            scanner.Text(b, e);
+            AppendDecoded(current, b, e, true);
+        }
+    }
+    return true;
+}
+
+int Reader::FindSheet(const std::string& name) const
+{
+    for (size_t i = 0; i < sheets.size(); ++i) {
+        if (sheets[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool Reader::ReadSheet(size_t index, const std::function<void(const Cell&)>& onCell)
+{
+    if (index >= sheets.size()) {
+        return Fail("Нет листа с таким номером");
+    }
+    if (!zip.Extract(sheets[index].part, xml)) {
+        return Fail("Лист книги повреждён или отсутствует");
+    }
+
+    TagScanner scanner(xml.data(), xml.data() + xml.size());
+    Tag tag;
+    Cell cell;
+    std::string value;
+    char type = 'n';            // Атрибут t: первая буква (s, inlineStr, b, e, d, n), str -> 'S'
+    uint32_t rowIndex = 0;
+    uint32_t nextRow = 0;
+    uint32_t nextColumn = 0;
+    bool inCell = false;
+    bool hasValue = false;
+    bool inInline = false;
+    int phonetic = 0;
+
+    while (scanner.Next(tag)) {
+        const char* b;
+        const char* e;
+
+        if (tag.Is("row")) {
+            if (tag.closing) {
+                continue;
+            }
+            uint32_t r = 0;
+            if (GetAttr(tag, "r", b, e) && std::from_chars(b, e, r).ptr == e && r > 0) {
+                rowIndex = r - 1;
+            } else {
+                rowIndex = nextRow;
+            }
+            nextRow = rowIndex + 1;
+            nextColumn = 0;
+        } else if (tag.Is("c")) {
+            if (tag.closing) {
+                if (inCell && hasValue) {
+                    cell.number = 0.0;
+                    cell.text.clear();
+                    switch (type) {
+                        case 's': {
+                            uint32_t shared = 0;
+                            if (std::from_chars(value.data(), value.data() + value.size(), shared).ec == std::errc() && shared < sharedStrings.size()) {
+                                cell.type = CellType::Text;
+                                cell.text = sharedStrings[shared];
+                            } else {
+                                cell.type = CellType::Error;
+                            }
+                            break;
+                        }
+                        case 'b':
+                            cell.type = CellType::Bool;
+                            cell.number = value == "1" ? 1.0 : 0.0;
+                            break;
+                        case 'e':
+                            cell.type = CellType::Error;
+                            cell.text = value;
+                            break;
+                        case 'S':       // Строковый результат формулы
+                        case 'i':       // inlineStr
+                        case 'd':       // Дата ISO 8601
+                            cell.type = CellType::Text;
+                            cell.text = value;
+                            break;
+                        default:
+                            if (ParseNumber(value.data(), value.data() + value.size(), cell.number)) {
+                                cell.type = CellType::Number;
+                            } else {
+                                cell.type = CellType::Text;
+                                cell.text = value;
+                            }
+                            break;
+                    }
+                    onCell(cell);
+                }
+                inCell = false;
+                continue;
+            }
+
+            if (!GetAttr(tag, "r", b, e) || !ParseCellRef(b, e, cell.row, cell.column)) {
+                cell.row = rowIndex;
+                cell.column = nextColumn;
+            }
+            nextColumn = cell.column + 1;
+
+            type = 'n';
+            if (GetAttr(tag, "t", b, e) && b < e) {
+                type = *b;
+                if (e - b == 3 && std::memcmp(b, "str", 3) == 0) {
+                    type = 'S';
+                }
+            }
+            value.clear();
+            hasValue = false;
+            inCell = !tag.selfClosing;
+        } else if (!inCell || tag.closing || tag.selfClosing) {
+            if (tag.Is("is")) {
+                inInline = false;
+            } else if (tag.Is("rPh") && tag.closing) {
+                phonetic--;
+            }
+        } else if (tag.Is("v") && !inInline) {
+            scanner.Text(b, e);
+            AppendDecoded(value, b, e, false);
+            hasValue = true;
+        } else if (tag.Is("is")) {
+            inInline = true;
+            hasValue = true;
+        } else if (tag.Is("rPh")) {
+            phonetic++;
+        } else if (tag.Is("t") && inInline && phonetic == 0) {
+            scanner.Text(b, e);
+            AppendDecoded(value, b, e, true);
+        }
+    }
+
+    return true;
+}
+
+} // namespace Xlsx
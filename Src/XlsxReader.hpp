@@ -0,0 +1,82 @@
+#ifndef XLSXREADER_HPP
+#define XLSXREADER_HPP
+
+// =============================================================================
+// XlsxReader - Чтение книг Excel (.xlsx)
+// =============================================================================
+// Книга лежит в памяти целиком (обычно отображённый файл, см. FileIO::MappedFile).
+// При открытии читаются только список листов и общие строки (sharedStrings).
+// Лист распаковывается по запросу и просматривается одним проходом по тегам
+// <row>/<c>, без построения дерева: ячейки передаются в обработчик по порядку.
+// Модуль не зависит от Archicad API (только стандартная библиотека).
+
+#include "Zip.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Xlsx {
+
+enum class CellType {
+    Empty,
+    Number,
+    Text,
+    Bool,
+    Error
+};
+
+struct Cell {
+    uint32_t row;           // С 0 (строка 1 в Excel)
+    uint32_t column;        // С 0 (колонка A)
+    CellType type;
+    double number;          // Number и Bool (0/1)
+    std::string text;       // Text и Error, UTF-8
+
+    // Число из ячейки; текст тоже разбирается ("1,25" и "1.25")
+    bool GetNumber(double& out) const;
+};
+
+// Разбор ссылки "B12" -> колонка 1, строка 11. false - неверный формат.
+bool ParseCellRef(const char* begin, const char* end, uint32_t& row, uint32_t& column);
+
+class Reader {
+public:
+    Reader();
+
+    // Разобрать книгу. Данные должны жить, пока жив Reader.
+    bool Open(const char* data, size_t size);
+
+    size_t GetSheetCount() const { return sheets.size(); }
+    const std::string& GetSheetName(size_t index) const { return sheets[index].name; }
+
+    // Номер листа по имени (UTF-8) или -1
+    int FindSheet(const std::string& name) const;
+
+    // Пройти по непустым ячейкам листа (строки сверху вниз, ячейки слева направо)
+    bool ReadSheet(size_t index, const std::function<void(const Cell&)>& onCell);
+
+    const std::string& GetError() const { return error; }
+
+private:
+    struct Sheet {
+        std::string name;
+        std::string part;   // Путь внутри архива, например xl/worksheets/sheet1.xml
+    };
+
+    bool LoadSheets(const std::string& workbookPart);
+    bool LoadSharedStrings(const std::string& part);
+    bool Fail(const char* message);
+
+    Zip::Reader zip;
+    std::vector<Sheet> sheets;
+    std::vector<std::string> sharedStrings;
+    std::string xml;        // Буфер распакованной части (переиспользуется)
+    std::string error;
+};
+
+} // namespace Xlsx
+
+#endif // XLSXREADER_HPP
@@ -0,0 +1,439 @@
+// =============================================================================
+// XlsxWriter - Потоковая запись книг Excel (.xlsx)
+// =============================================================================
+
+#include "XlsxWriter.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+namespace Xlsx {
+
+// =============================================================================
+// Вспомогательные функции
+// =============================================================================
+
+// Zip::Output поверх буферизованного файла
+class FileOutput : public Zip::Output {
+public:
+    explicit FileOutput(FileIO::Writer& writer) : file(writer) {}
+    void Write(const char* data, size_t size) override { file.Write(data, size); }
+
+private:
+    FileIO::Writer& file;
+};
+
+static const char XmlHeader[] = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n";
+static const char MainNs[] = "http://schemas.openxmlformats.org/spreadsheetml/2006/main";
+static const char RelNs[] = "http://schemas.openxmlformats.org/officeDocument/2006/relationships";
+
+// Экранирование UTF-8 текста для XML; управляющие символы (кроме \t \n \r) недопустимы в XML 1.0
+static void AppendEscaped(std::string& out, const char* text, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        const char c = text[i];
+        switch (c) {
+            case '&':  out += "&amp;";  break;
+            case '<':  out += "&lt;";   break;
+            case '>':  out += "&gt;";   break;
+            case '"':  out += "&quot;"; break;
+            default:
+                if (static_cast<unsigned char>(c) >= 0x20 || c == '\t' || c == '\n' || c == '\r') {
+                    out.push_back(c);
+                }
+                break;
+        }
+    }
+}
+
+static void AppendEscaped(std::string& out, const std::string& text)
+{
+    AppendEscaped(out, text.data(), text.size());
+}
+
+// <t> с сохранением пробелов по краям
+static void AppendTextElement(std::string& out, const std::string& text)
+{
+    const bool preserve = !text.empty() && (text.front() == ' ' || text.back() == ' ');
+    out += preserve ? "<t xml:space=\"preserve\">" : "<t>";
+    AppendEscaped(out, text);
+    out += "</t>";
+}
+
+// Буквенное имя колонки: 0 -> A, 25 -> Z, 26 -> AA
+static void AppendColumnName(std::string& out, UInt32 column)
+{
+    char letters[8];
+    int n = 0;
+    UInt32 c = column + 1;
+    while (c > 0 && n < 8) {
+        const UInt32 rem = (c - 1) % 26;
+        letters[n++] = static_cast<char>('A' + rem);
+        c = (c - 1) / 26;
+    }
+    while (n > 0) {
+        out.push_back(letters[--n]);
+    }
+}
+
+static void AppendUInt(std::string& out, UInt64 value)
+{
+    char digits[24];
+    int n = 0;
+    do {
+        digits[n++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    while (n > 0) {
+        out.push_back(digits[--n]);
+    }
+}
+
+// Имя листа: до 31 символа, без []:*?/\ (ограничения Excel)
+static GS::UniString SanitizeSheetName(const GS::UniString& name, size_t index)
+{
+    GS::UniString result;
+    for (UIndex i = 0; i < name.GetLength() && result.GetLength() < 31; ++i) {
+        const GS::UniChar c = name[i];
+        if (c == '[' || c == ']' || c == ':' || c == '*' || c == '?' || c == '/' || c == '\\') {
+            result += GS::UniChar('_');
+        } else {
+            result += c;
+        }
+    }
+    if (result.IsEmpty()) {
+        char fallback[16];
+        snprintf(fallback, sizeof(fallback), "Sheet%u", static_cast<unsigned>(index + 1));
+        result = GS::UniString(fallback);
+    }
+    return result;
+}
+
+// =============================================================================
+// Writer
+// =============================================================================
+
+Writer::Writer() :
+    sharedCount(0),
+    rowNumber(0),
+    column(0),
+    totalRows(0),
+    headerRow(false),
+    inSheet(false)
+{
+}
+
+Writer::~Writer()
+{
+    if (zip != nullptr) {
+        Close();
+    }
+}
+
+bool Writer::Open(const GS::UniString& path)
+{
+    if (!file.Open(path)) {
+        return false;
+    }
+
+    output.reset(new FileOutput(file));
+    zip.reset(new Zip::Writer(*output));
+    sheetNames.clear();
+    sharedIndex.clear();
+    sharedStrings.clear();
+    sharedCount = 0;
+    totalRows = 0;
+    inSheet = false;
+    return true;
+}
+
+void Writer::BeginSheet(const GS::UniString& name)
+{
+    if (zip == nullptr) {
+        return;
+    }
+    if (inSheet) {
+        EndSheet();
+    }
+
+    std::string escaped;
+    AppendEscaped(escaped, FileIO::ToUtf8(SanitizeSheetName(name, sheetNames.size())));
+    sheetNames.push_back(escaped);
+
+    std::string entry = "xl/worksheets/sheet";
+    AppendUInt(entry, sheetNames.size());
+    entry += ".xml";
+    zip->BeginEntry(entry);
+
+    std::string head = XmlHeader;
+    head += "<worksheet xmlns=\"";
+    head += MainNs;
+    head += "\"><sheetData>";
+    zip->Write(head);
+
+    rowNumber = 0;
+    inSheet = true;
+}
+
+void Writer::EndSheet()
+{
+    if (!inSheet) {
+        return;
+    }
+    zip->Write("</sheetData></worksheet>");
+    zip->EndEntry();
+    inSheet = false;
+}
+
+void Writer::BeginRow(bool header)
+{
+    rowNumber++;
+    column = 0;
+    headerRow = header;
+
+    row.clear();
+    row += "<row r=\"";
+    AppendUInt(row, rowNumber);
+    row += "\">";
+}
+
+void Writer::EndRow()
+{
+    if (!inSheet) {
+        return;
+    }
+    row += "</row>";
+    zip->Write(row);
+    totalRows++;
+}
+
+// Начало ячейки: <c r="B12" [s="1"] [t="..."]>
+void Writer::CellRef(const char* type)
+{
+    row += "<c r=\"";
+    AppendColumnName(row, column);
+    AppendUInt(row, rowNumber);
+    row += '"';
+    if (headerRow) {
+        row += " s=\"1\"";
+    }
+    if (type != nullptr) {
+        row += " t=\"";
+        row += type;
+        row += '"';
+    }
+    row += '>';
+    column++;
+}
+
+void Writer::Text(const GS::UniString& value)
+{
+    scratch.clear();
+    FileIO::AppendUtf8(scratch, value);
+
+    auto it = sharedIndex.find(scratch);
+    if (it == sharedIndex.end()) {
+        if (sharedStrings.size() >= MaxSharedStrings) {
+            // Таблица заполнена - новые значения в ячейку
+            CellRef("inlineStr");
+            row += "<is>";
+            AppendTextElement(row, scratch);
+            row += "</is></c>";
+            return;
+        }
+        it = sharedIndex.emplace(scratch, static_cast<UInt32>(sharedStrings.size())).first;
+        sharedStrings.push_back(&it->first);
+    }
+    sharedCount++;
+
+    CellRef("s");
+    row += "<v>";
+    AppendUInt(row, it->second);
+    row += "</v></c>";
+}
+
+void Writer::InlineText(const GS::UniString& value)
+{
+    scratch.clear();
+    FileIO::AppendUtf8(scratch, value);
+
+    CellRef("inlineStr");
+    row += "<is>";
+    AppendTextElement(row, scratch);
+    row += "</is></c>";
+}
+
+void Writer::Number(double value)
+{
+    // nan/inf в <v> делают книгу нечитаемой
+    if (!std::isfinite(value)) {
+        Skip();
+        return;
+    }
+
+    char text[32];
+    snprintf(text, sizeof(text), "%.15g", value);
+    // Десятичный разделитель в XML - всегда точка, независимо от локали
+    for (char* p = text; *p != '\0'; ++p) {
+        if (*p == ',') {
+            *p = '.';
+        }
+    }
+
+    CellRef(nullptr);
+    row += "<v>";
+    row += text;
+    row += "</v></c>";
+}
+
+void Writer::Integer(Int64 value)
+{
+    CellRef(nullptr);
+    row += "<v>";
+    if (value < 0) {
+        row += '-';
+        AppendUInt(row, static_cast<UInt64>(-(value + 1)) + 1);
+    } else {
+        AppendUInt(row, static_cast<UInt64>(value));
+    }
+    row += "</v></c>";
+}
+
+void Writer::Skip()
+{
+    column++;
+}
+
+// =============================================================================
+// Служебные части книги
+// =============================================================================
+
+void Writer::WritePackageParts()
+{
+    // Хотя бы один лист обязателен
+    if (sheetNames.empty()) {
+        BeginSheet("Sheet1");
+        EndSheet();
+    }
+
+    std::string xml;
+
+    // Общие строки
+    zip->BeginEntry("xl/sharedStrings.xml");
+    xml = XmlHeader;
+    xml += "<sst xmlns=\"";
+    xml += MainNs;
+    xml += "\" count=\"";
+    AppendUInt(xml, sharedCount);
+    xml += "\" uniqueCount=\"";
+    AppendUInt(xml, sharedStrings.size());
+    xml += "\">";
+    zip->Write(xml);
+    for (const std::string* text : sharedStrings) {
+        xml.clear();
+        xml += "<si>";
+        AppendTextElement(xml, *text);
+        xml += "</si>";
+        zip->Write(xml);
+    }
+    zip->Write("</sst>");
+
+    // Стили: 0 - обычный, 1 - жирный (заголовок)
+    zip->BeginEntry("xl/styles.xml");
+    xml = XmlHeader;
+    xml += "<styleSheet xmlns=\"";
+    xml += MainNs;
+    xml += "\">"
+        "<fonts count=\"2\"><font><sz val=\"11\"/><name val=\"Calibri\"/></font>"
+        "<font><b/><sz val=\"11\"/><name val=\"Calibri\"/></font></fonts>"
+        "<fills count=\"2\"><fill><patternFill patternType=\"none\"/></fill>"
+        "<fill><patternFill patternType=\"gray125\"/></fill></fills>"
+        "<borders count=\"1\"><border><left/><right/><top/><bottom/><diagonal/></border></borders>"
+        "<cellStyleXfs count=\"1\"><xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\"/></cellStyleXfs>"
+        "<cellXfs count=\"2\"><xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\"/>"
+        "<xf numFmtId=\"0\" fontId=\"1\" fillId=\"0\" borderId=\"0\" xfId=\"0\" applyFont=\"1\"/></cellXfs>"
+        "</styleSheet>";
+    zip->Write(xml);
+
+    // Книга и связи листов
+    zip->BeginEntry("xl/workbook.xml");
+    xml = XmlHeader;
+    xml += "<workbook xmlns=\"";
+    xml += MainNs;
+    xml += "\" xmlns:r=\"";
+    xml += RelNs;
+    xml += "\"><sheets>";
+    for (size_t i = 0; i < sheetNames.size(); ++i) {
+        xml += "<sheet name=\"";
+        xml += sheetNames[i];
+        xml += "\" sheetId=\"";
+        AppendUInt(xml, i + 1);
+        xml += "\" r:id=\"rId";
+        AppendUInt(xml, i + 1);
+        xml += "\"/>";
+    }
+    xml += "</sheets></workbook>";
+    zip->Write(xml);
+
+    zip->BeginEntry("xl/_rels/workbook.xml.rels");
+    xml = XmlHeader;
+    xml += "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">";
+    for (size_t i = 0; i < sheetNames.size(); ++i) {
+        xml += "<Relationship Id=\"rId";
+        AppendUInt(xml, i + 1);
+        xml += "\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/worksheet\" Target=\"worksheets/sheet";
+        AppendUInt(xml, i + 1);
+        xml += ".xml\"/>";
+    }
+    const size_t n = sheetNames.size();
+    xml += "<Relationship Id=\"rId";
+    AppendUInt(xml, n + 1);
+    xml += "\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/sharedStrings\" Target=\"sharedStrings.xml\"/>";
+    xml += "<Relationship Id=\"rId";
+    AppendUInt(xml, n + 2);
+    xml += "\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/styles\" Target=\"styles.xml\"/>";
+    xml += "</Relationships>";
+    zip->Write(xml);
+
+    zip->BeginEntry("_rels/.rels");
+    xml = XmlHeader;
+    xml += "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+        "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/officeDocument\" Target=\"xl/workbook.xml\"/>"
+        "</Relationships>";
+    zip->Write(xml);
+
+    zip->BeginEntry("[Content_Types].xml");
+    xml = XmlHeader;
+    xml += "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+        "<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+        "<Default Extension=\"xml\" ContentType=\"application/xml\"/>"
+        "<Override PartName=\"/xl/workbook.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml\"/>"
+        "<Override PartName=\"/xl/styles.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.styles+xml\"/>"
+        "<Override PartName=\"/xl/sharedStrings.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sharedStrings+xml\"/>";
+    for (size_t i = 0; i < sheetNames.size(); ++i) {
+        xml += "<Override PartName=\"/xl/worksheets/sheet";
+        AppendUInt(xml, i + 1);
+        xml += ".xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>";
+    }
+    xml += "</Types>";
+    zip->Write(xml);
+}
+
+bool Writer::Close()
+{
+    if (zip == nullptr) {
+        return file.Close();
+    }
+
+    EndSheet();
+    WritePackageParts();
+    zip->Finish();
+    zip.reset();
+    output.reset();
+
+    sharedIndex.clear();
+    sharedStrings.clear();
+    return file.Close();
+}
+
+} // namespace Xlsx
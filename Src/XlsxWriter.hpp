@@ -0,0 +1,85 @@
+#ifndef XLSXWRITER_HPP
+#define XLSXWRITER_HPP
+
+// =============================================================================
+// XlsxWriter - Потоковая запись книг Excel (.xlsx)
+// =============================================================================
+// Листы пишутся построчно прямо в ZIP (см. Zip.hpp), в памяти держится только
+// текущая строка и таблица общих строк (sharedStrings) для повторяющихся
+// значений (заголовки, виды, типы): каждая такая строка хранится один раз, в
+// ячейках - её номер. Таблица ограничена MaxSharedStrings; значения, свои
+// для каждой строки (GUID, ID), пишутся прямо в ячейку (InlineText), поэтому
+// память не растёт с числом строк. Листы записываются по очереди:
+// BeginSheet ... EndSheet, затем следующий.
+
+#include "GSRoot.hpp"
+#include "UniString.hpp"
+#include "FileIO.hpp"
+#include "Zip.hpp"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Xlsx {
+
+// Сколько разных строк держать в таблице общих строк; дальше - InlineText
+const size_t MaxSharedStrings = 4096;
+
+class Writer {
+public:
+    Writer();
+    ~Writer();
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    // Создать файл книги
+    bool Open(const GS::UniString& path);
+
+    // Лист; имя обрезается до 31 символа, недопустимые символы заменяются
+    void BeginSheet(const GS::UniString& name);
+    void EndSheet();
+
+    // Строка; header - жирный шрифт (для строки заголовка)
+    void BeginRow(bool header = false);
+    void EndRow();
+
+    // Ячейки текущей строки слева направо
+    void Text(const GS::UniString& value);          // Через общие строки
+    void InlineText(const GS::UniString& value);    // В ячейке (уникальные значения)
+    void Number(double value);                      // NaN и бесконечность - пустая ячейка
+    void Integer(Int64 value);
+    void Skip();                // Пустая ячейка
+
+    // Дописать служебные части книги и закрыть файл. false - ошибка записи.
+    bool Close();
+
+    UInt32 GetRowCount() const { return totalRows; }   // Строк на всех листах
+
+private:
+    void CellRef(const char* type);
+    void WritePackageParts();
+
+    FileIO::Writer file;
+    std::unique_ptr<Zip::Output> output;        // Адаптер file -> Zip::Writer
+    std::unique_ptr<Zip::Writer> zip;
+
+    std::vector<std::string> sheetNames;        // UTF-8, уже экранированные
+    std::unordered_map<std::string, UInt32> sharedIndex;
+    std::vector<const std::string*> sharedStrings;  // В порядке номеров (ключи sharedIndex)
+    UInt64 sharedCount;                         // Всего ссылок на общие строки
+
+    std::string row;                            // Буфер текущей строки
+    std::string scratch;                        // UTF-8 текущей ячейки
+    UInt32 rowNumber;                           // Номер строки на листе (с 1)
+    UInt32 column;                              // Номер следующей ячейки (с 0)
+    UInt32 totalRows;
+    bool headerRow;
+    bool inSheet;
+};
+
+} // namespace Xlsx
+
+#endif // XLSXWRITER_HPP
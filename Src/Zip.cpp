@@ -0,0 +1,899 @@
+// =============================================================================
+// Zip - Запись и чтение ZIP архивов (для XLSX)
+// =============================================================================
+
+#include "Zip.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+
+namespace Zip {
+
+// =============================================================================
+// CRC-32
+// =============================================================================
+
+struct CrcTable {
+    uint32_t value[256];
+};
+
+static CrcTable BuildCrcTable()
+{
+    CrcTable table;
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table.value[i] = c;
+    }
+    return table;
+}
+
+// Локальная статическая переменная инициализируется потокобезопасно:
+// cassette-batch читает книги из нескольких потоков
+static const uint32_t* GetCrcTable()
+{
+    static const CrcTable table = BuildCrcTable();
+    return table.value;
+}
+
+uint32_t Crc32(uint32_t crc, const void* data, size_t size)
+{
+    const uint32_t* table = GetCrcTable();
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// =============================================================================
+// Deflater - LZ77 + фиксированные коды Хаффмана (RFC 1951, BTYPE = 01)
+// =============================================================================
+
+static const size_t WindowSize = 32768;             // Максимальная дистанция
+static const size_t WindowMask = WindowSize - 1;
+static const size_t BufferSize = 2 * WindowSize;    // Окно + новые данные
+static const int HashBits = 15;
+static const size_t HashSize = size_t(1) << HashBits;
+static const size_t MinMatch = 3;
+static const size_t MaxMatch = 258;
+static const int MaxChain = 48;                     // Глубина поиска совпадений
+
+static const uint16_t LengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t LengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t DistanceBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t DistanceExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+class Deflater {
+public:
+    explicit Deflater(Output& output) :
+        out(output),
+        window(BufferSize),
+        head(HashSize, -1),
+        prev(WindowSize, -1)
+    {
+        Reset();
+    }
+
+    void Reset()
+    {
+        std::fill(head.begin(), head.end(), -1);
+        std::fill(prev.begin(), prev.end(), -1);
+        fill = 0;
+        pos = 0;
+        bitBuffer = 0;
+        bitCount = 0;
+        outSize = 0;
+        pending.clear();
+    }
+
+    void Write(const char* data, size_t size)
+    {
+        while (size > 0) {
+            const size_t n = std::min(size, BufferSize - fill);
+            memcpy(window.data() + fill, data, n);
+            fill += n;
+            data += n;
+            size -= n;
+
+            if (fill == BufferSize) {
+                CompressBlock(false);
+                Slide();
+            }
+        }
+    }
+
+    void Finish()
+    {
+        CompressBlock(true);
+        if (bitCount > 0) {
+            PutByte(static_cast<char>(bitBuffer & 0xFF));
+            bitBuffer = 0;
+            bitCount = 0;
+        }
+        FlushPending();
+    }
+
+    uint64_t GetOutputSize() const { return outSize; }
+
+private:
+    static uint32_t Hash(const unsigned char* p)
+    {
+        return ((uint32_t(p[0]) << 10) ^ (uint32_t(p[1]) << 5) ^ p[2]) & (HashSize - 1);
+    }
+
+    void Insert(size_t at)
+    {
+        const uint32_t h = Hash(window.data() + at);
+        prev[at & WindowMask] = head[h];
+        head[h] = static_cast<int32_t>(at);
+    }
+
+    // Сжать [pos, fill) одним блоком
+    void CompressBlock(bool final)
+    {
+        PutBits(final ? 1 : 0, 1);
+        PutBits(1, 2);      // BTYPE = 01: фиксированные коды
+
+        const unsigned char* w = window.data();
+        while (pos < fill) {
+            size_t bestLength = 0;
+            size_t bestDistance = 0;
+
+            if (fill - pos >= MinMatch) {
+                const size_t maxLength = std::min(MaxMatch, fill - pos);
+                int32_t candidate = head[Hash(w + pos)];
+                int chain = MaxChain;
+
+                while (candidate >= 0 && chain-- > 0 && pos - candidate <= WindowSize) {
+                    const unsigned char* a = w + candidate;
+                    const unsigned char* b = w + pos;
+                    if (a[bestLength] == b[bestLength] && a[0] == b[0]) {
+                        size_t length = 0;
+                        while (length < maxLength && a[length] == b[length]) {
+                            ++length;
+                        }
+                        if (length > bestLength) {
+                            bestLength = length;
+                            bestDistance = pos - candidate;
+                            if (length == maxLength) {
+                                break;
+                            }
+                        }
+                    }
+
+                    // Слот prev мог быть перезаписан более новой позицией - цепочка кончилась
+                    const int32_t next = prev[candidate & WindowMask];
+                    if (next >= candidate) {
+                        break;
+                    }
+                    candidate = next;
+                }
+                Insert(pos);
+            }
+
+            if (bestLength >= MinMatch) {
+                PutMatch(bestLength, bestDistance);
+                for (size_t i = 1; i < bestLength; ++i) {
+                    if (fill - (pos + i) >= MinMatch) {
+                        Insert(pos + i);
+                    }
+                }
+                pos += bestLength;
+            } else {
+                PutLiteral(w[pos]);
+                ++pos;
+            }
+        }
+
+        PutSymbol(256);     // Конец блока
+        FlushPending();
+    }
+
+    // Сдвинуть окно на WindowSize: вторая половина становится историей
+    void Slide()
+    {
+        memmove(window.data(), window.data() + WindowSize, WindowSize);
+        fill -= WindowSize;
+        pos -= WindowSize;
+
+        const int32_t shift = static_cast<int32_t>(WindowSize);
+        for (int32_t& h : head) {
+            h = h >= shift ? h - shift : -1;
+        }
+        for (int32_t& p : prev) {
+            p = p >= shift ? p - shift : -1;
+        }
+    }
+
+    // --- Вывод битов (младший бит первым) ---
+
+    void PutBits(uint32_t value, int count)
+    {
+        bitBuffer |= value << bitCount;
+        bitCount += count;
+        while (bitCount >= 8) {
+            PutByte(static_cast<char>(bitBuffer & 0xFF));
+            bitBuffer >>= 8;
+            bitCount -= 8;
+        }
+    }
+
+    // Коды Хаффмана пишутся старшим битом вперёд
+    void PutCode(uint32_t code, int length)
+    {
+        uint32_t reversed = 0;
+        for (int i = 0; i < length; ++i) {
+            reversed = (reversed << 1) | ((code >> i) & 1);
+        }
+        PutBits(reversed, length);
+    }
+
+    // Фиксированный код литерала/длины (RFC 1951, 3.2.6)
+    void PutSymbol(uint32_t symbol)
+    {
+        if (symbol < 144) {
+            PutCode(0x30 + symbol, 8);
+        } else if (symbol < 256) {
+            PutCode(0x190 + (symbol - 144), 9);
+        } else if (symbol < 280) {
+            PutCode(symbol - 256, 7);
+        } else {
+            PutCode(0xC0 + (symbol - 280), 8);
+        }
+    }
+
+    void PutLiteral(unsigned char c)
+    {
+        PutSymbol(c);
+    }
+
+    void PutMatch(size_t length, size_t distance)
+    {
+        int lc = 28;
+        while (LengthBase[lc] > length) {
+            --lc;
+        }
+        PutSymbol(257 + lc);
+        PutBits(static_cast<uint32_t>(length - LengthBase[lc]), LengthExtra[lc]);
+
+        int dc = 29;
+        while (DistanceBase[dc] > distance) {
+            --dc;
+        }
+        PutCode(dc, 5);
+        PutBits(static_cast<uint32_t>(distance - DistanceBase[dc]), DistanceExtra[dc]);
+    }
+
+    void PutByte(char c)
+    {
+        pending.push_back(c);
+        if (pending.size() >= 16384) {
+            FlushPending();
+        }
+    }
+
+    void FlushPending()
+    {
+        if (!pending.empty()) {
+            out.Write(pending.data(), pending.size());
+            outSize += pending.size();
+            pending.clear();
+        }
+    }
+
+    Output& out;
+    std::vector<unsigned char> window;
+    std::vector<int32_t> head;      // Последняя позиция по хешу 3 байт
+    std::vector<int32_t> prev;      // Предыдущая позиция с тем же хешем
+    size_t fill;                    // Заполнено байт окна
+    size_t pos;                     // Первый несжатый байт
+    uint32_t bitBuffer;
+    int bitCount;
+    uint64_t outSize;
+    std::vector<char> pending;      // Сжатые байты до передачи в Output
+};
+
+// =============================================================================
+// Writer
+// =============================================================================
+
+static const uint16_t VersionNeeded = 20;
+static const uint16_t FlagDataDescriptor = 0x0008;  // Размеры и CRC после данных
+static const uint16_t FlagUtf8 = 0x0800;            // Имена в UTF-8
+static const uint16_t MethodDeflate = 8;
+
+Writer::Writer(Output& output) :
+    out(output),
+    deflater(new Deflater(output)),
+    position(0),
+    inEntry(false),
+    entryCrc(0),
+    entrySize(0),
+    entryStart(0)
+{
+    // Время изменения в формате DOS
+    std::time_t now = std::time(nullptr);
+    std::tm local = {};
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    dosTime = static_cast<uint16_t>((local.tm_hour << 11) | (local.tm_min << 5) | (local.tm_sec / 2));
+    dosDate = static_cast<uint16_t>(((std::max(local.tm_year, 80) - 80) << 9) | ((local.tm_mon + 1) << 5) | local.tm_mday);
+}
+
+Writer::~Writer()
+{
+}
+
+void Writer::WriteRaw(const char* data, size_t size)
+{
+    out.Write(data, size);
+    position += size;
+}
+
+void Writer::Put16(uint16_t value)
+{
+    const char bytes[2] = { static_cast<char>(value & 0xFF), static_cast<char>(value >> 8) };
+    WriteRaw(bytes, 2);
+}
+
+void Writer::Put32(uint32_t value)
+{
+    const char bytes[4] = {
+        static_cast<char>(value & 0xFF), static_cast<char>((value >> 8) & 0xFF),
+        static_cast<char>((value >> 16) & 0xFF), static_cast<char>(value >> 24)
+    };
+    WriteRaw(bytes, 4);
+}
+
+void Writer::BeginEntry(const std::string& name)
+{
+    if (inEntry) {
+        EndEntry();
+    }
+
+    Entry entry;
+    entry.name = name;
+    entry.crc = 0;
+    entry.compressedSize = 0;
+    entry.size = 0;
+    entry.offset = static_cast<uint32_t>(position);
+    entries.push_back(entry);
+
+    // Локальный заголовок: CRC и размеры будут в дескрипторе данных
+    Put32(0x04034B50);
+    Put16(VersionNeeded);
+    Put16(FlagDataDescriptor | FlagUtf8);
+    Put16(MethodDeflate);
+    Put16(dosTime);
+    Put16(dosDate);
+    Put32(0);
+    Put32(0);
+    Put32(0);
+    Put16(static_cast<uint16_t>(name.size()));
+    Put16(0);
+    WriteRaw(name.data(), name.size());
+
+    deflater->Reset();
+    entryCrc = 0;
+    entrySize = 0;
+    entryStart = position;
+    inEntry = true;
+}
+
+void Writer::Write(const char* data, size_t size)
+{
+    if (!inEntry || size == 0) {
+        return;
+    }
+    entryCrc = Crc32(entryCrc, data, size);
+    entrySize += size;
+    deflater->Write(data, size);
+}
+
+void Writer::EndEntry()
+{
+    if (!inEntry) {
+        return;
+    }
+
+    deflater->Finish();
+    position = entryStart + deflater->GetOutputSize();
+
+    Entry& entry = entries.back();
+    entry.crc = entryCrc;
+    entry.compressedSize = static_cast<uint32_t>(deflater->GetOutputSize());
+    entry.size = static_cast<uint32_t>(entrySize);
+
+    Put32(0x08074B50);
+    Put32(entry.crc);
+    Put32(entry.compressedSize);
+    Put32(entry.size);
+
+    inEntry = false;
+}
+
+void Writer::Finish()
+{
+    EndEntry();
+
+    const uint64_t directoryStart = position;
+    for (const Entry& entry : entries) {
+        Put32(0x02014B50);
+        Put16(VersionNeeded);
+        Put16(VersionNeeded);
+        Put16(FlagDataDescriptor | FlagUtf8);
+        Put16(MethodDeflate);
+        Put16(dosTime);
+        Put16(dosDate);
+        Put32(entry.crc);
+        Put32(entry.compressedSize);
+        Put32(entry.size);
+        Put16(static_cast<uint16_t>(entry.name.size()));
+        Put16(0);   // extra
+        Put16(0);   // комментарий
+        Put16(0);   // диск
+        Put16(0);   // внутренние атрибуты
+        Put32(0);   // внешние атрибуты
+        Put32(entry.offset);
+        WriteRaw(entry.name.data(), entry.name.size());
+    }
+    const uint64_t directorySize = position - directoryStart;
+
+    Put32(0x06054B50);
+    Put16(0);
+    Put16(0);
+    Put16(static_cast<uint16_t>(entries.size()));
+    Put16(static_cast<uint16_t>(entries.size()));
+    Put32(static_cast<uint32_t>(directorySize));
+    Put32(static_cast<uint32_t>(directoryStart));
+    Put16(0);
+
+    entries.clear();
+}
+
+// =============================================================================
+// Inflate - распаковка (блоки stored, fixed и dynamic)
+// =============================================================================
+
+// Канонический код Хаффмана: число кодов каждой длины и символы по порядку
+struct Huffman {
+    uint16_t count[16];
+    std::vector<uint16_t> symbol;
+};
+
+class Inflater {
+public:
+    Inflater(const unsigned char* input, size_t inputSize, std::string& output, size_t outputLimit) :
+        in(input),
+        inSize(inputSize),
+        inPos(0),
+        bitBuffer(0),
+        bitCount(0),
+        out(output),
+        limit(outputLimit),
+        failed(false)
+    {
+    }
+
+    bool Run()
+    {
+        bool last = false;
+        while (!last && !failed) {
+            last = Bits(1) != 0;
+            const uint32_t type = Bits(2);
+            switch (type) {
+                case 0:  Stored(); break;
+                case 1:  Fixed(); break;
+                case 2:  Dynamic(); break;
+                default: failed = true; break;
+            }
+        }
+        return !failed;
+    }
+
+private:
+    uint32_t Bits(int need)
+    {
+        while (bitCount < need) {
+            if (inPos >= inSize) {
+                failed = true;
+                return 0;
+            }
+            bitBuffer |= uint32_t(in[inPos++]) << bitCount;
+            bitCount += 8;
+        }
+        const uint32_t value = bitBuffer & ((1u << need) - 1);
+        bitBuffer >>= need;
+        bitCount -= need;
+        return value;
+    }
+
+    void Stored()
+    {
+        bitBuffer = 0;
+        bitCount = 0;
+        if (inPos + 4 > inSize) {
+            failed = true;
+            return;
+        }
+        const uint32_t len = in[inPos] | (uint32_t(in[inPos + 1]) << 8);
+        const uint32_t nlen = in[inPos + 2] | (uint32_t(in[inPos + 3]) << 8);
+        inPos += 4;
+        if (len != (~nlen & 0xFFFF) || inPos + len > inSize || out.size() + len > limit) {
+            failed = true;
+            return;
+        }
+        out.append(reinterpret_cast<const char*>(in + inPos), len);
+        inPos += len;
+    }
+
+    // Построить таблицу; false - переподписанный набор длин
+    static bool Build(Huffman& h, const uint8_t* lengths, int n)
+    {
+        for (int len = 0; len < 16; ++len) {
+            h.count[len] = 0;
+        }
+        for (int i = 0; i < n; ++i) {
+            h.count[lengths[i]]++;
+        }
+        if (h.count[0] == n) {
+            h.symbol.clear();
+            return true;
+        }
+
+        int left = 1;
+        for (int len = 1; len < 16; ++len) {
+            left <<= 1;
+            left -= h.count[len];
+            if (left < 0) {
+                return false;
+            }
+        }
+
+        uint16_t offs[16];
+        offs[1] = 0;
+        for (int len = 1; len < 15; ++len) {
+            offs[len + 1] = offs[len] + h.count[len];
+        }
+        h.symbol.assign(n, 0);
+        for (int i = 0; i < n; ++i) {
+            if (lengths[i] != 0) {
+                h.symbol[offs[lengths[i]]++] = static_cast<uint16_t>(i);
+            }
+        }
+        return true;
+    }
+
+    int Decode(const Huffman& h)
+    {
+        int code = 0;
+        int first = 0;
+        int index = 0;
+        for (int len = 1; len < 16; ++len) {
+            code |= static_cast<int>(Bits(1));
+            const int count = h.count[len];
+            if (code - count < first) {
+                return h.symbol[index + (code - first)];
+            }
+            index += count;
+            first += count;
+            first <<= 1;
+            code <<= 1;
+        }
+        failed = true;
+        return -1;
+    }
+
+    void Codes(const Huffman& lengthCode, const Huffman& distanceCode)
+    {
+        for (;;) {
+            const int symbol = Decode(lengthCode);
+            if (failed || symbol < 0) {
+                failed = true;
+                return;
+            }
+            if (symbol < 256) {
+                if (out.size() >= limit) {
+                    failed = true;
+                    return;
+                }
+                out.push_back(static_cast<char>(symbol));
+                continue;
+            }
+            if (symbol == 256) {
+                return;
+            }
+
+            const int lc = symbol - 257;
+            if (lc >= 29) {
+                failed = true;
+                return;
+            }
+            const size_t length = LengthBase[lc] + Bits(LengthExtra[lc]);
+
+            const int dc = Decode(distanceCode);
+            if (failed || dc < 0 || dc >= 30) {
+                failed = true;
+                return;
+            }
+            const size_t distance = DistanceBase[dc] + Bits(DistanceExtra[dc]);
+            if (distance > out.size() || out.size() + length > limit) {
+                failed = true;
+                return;
+            }
+
+            // Копируем по байту: источник может перекрываться с приёмником
+            size_t from = out.size() - distance;
+            for (size_t i = 0; i < length; ++i) {
+                out.push_back(out[from + i]);
+            }
+        }
+    }
+
+    // Фиксированные коды (RFC 1951, 3.2.6)
+    struct FixedCodes {
+        Huffman lengthCode;
+        Huffman distanceCode;
+    };
+
+    static FixedCodes BuildFixed()
+    {
+        FixedCodes codes;
+        uint8_t lengths[288];
+        int i = 0;
+        for (; i < 144; ++i) lengths[i] = 8;
+        for (; i < 256; ++i) lengths[i] = 9;
+        for (; i < 280; ++i) lengths[i] = 7;
+        for (; i < 288; ++i) lengths[i] = 8;
+        Build(codes.lengthCode, lengths, 288);
+        for (i = 0; i < 30; ++i) lengths[i] = 5;
+        Build(codes.distanceCode, lengths, 30);
+        return codes;
+    }
+
+    void Fixed()
+    {
+        // Строится один раз, потокобезопасно (как таблица CRC)
+        static const FixedCodes codes = BuildFixed();
+        Codes(codes.lengthCode, codes.distanceCode);
+    }
+
+    void Dynamic()
+    {
+        static const uint8_t order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+        const int nlen = static_cast<int>(Bits(5)) + 257;
+        const int ndist = static_cast<int>(Bits(5)) + 1;
+        const int ncode = static_cast<int>(Bits(4)) + 4;
+        if (failed || nlen > 286 || ndist > 30) {
+            failed = true;
+            return;
+        }
+
+        uint8_t lengths[320] = {};
+        for (int i = 0; i < ncode; ++i) {
+            lengths[order[i]] = static_cast<uint8_t>(Bits(3));
+        }
+
+        Huffman lencode;
+        if (!Build(lencode, lengths, 19)) {
+            failed = true;
+            return;
+        }
+
+        int index = 0;
+        while (index < nlen + ndist && !failed) {
+            int symbol = Decode(lencode);
+            if (symbol < 0) {
+                failed = true;
+                return;
+            }
+            if (symbol < 16) {
+                lengths[index++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+
+            uint8_t value = 0;
+            int repeat = 0;
+            if (symbol == 16) {
+                if (index == 0) {
+                    failed = true;
+                    return;
+                }
+                value = lengths[index - 1];
+                repeat = 3 + static_cast<int>(Bits(2));
+            } else if (symbol == 17) {
+                repeat = 3 + static_cast<int>(Bits(3));
+            } else {
+                repeat = 11 + static_cast<int>(Bits(7));
+            }
+            if (index + repeat > nlen + ndist) {
+                failed = true;
+                return;
+            }
+            while (repeat-- > 0) {
+                lengths[index++] = value;
+            }
+        }
+
+        // Без кода конца блока распаковать нельзя
+        if (failed || lengths[256] == 0) {
+            failed = true;
+            return;
+        }
+
+        Huffman lengthCode;
+        Huffman distanceCode;
+        if (!Build(lengthCode, lengths, nlen) || !Build(distanceCode, lengths + nlen, ndist)) {
+            failed = true;
+            return;
+        }
+        Codes(lengthCode, distanceCode);
+    }
+
+    const unsigned char* in;
+    size_t inSize;
+    size_t inPos;
+    uint32_t bitBuffer;
+    int bitCount;
+    std::string& out;
+    size_t limit;               // Больше out не растёт (защита от ZIP-бомб)
+    bool failed;
+};
+
+bool Inflate(const unsigned char* data, size_t size, std::string& out, size_t limit)
+{
+    Inflater inflater(data, size, out, limit);
+    return inflater.Run();
+}
+
+// =============================================================================
+// Reader
+// =============================================================================
+
+static uint16_t Get16(const char* p)
+{
+    const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<uint16_t>(u[0] | (u[1] << 8));
+}
+
+static uint32_t Get32(const char* p)
+{
+    const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+    return u[0] | (uint32_t(u[1]) << 8) | (uint32_t(u[2]) << 16) | (uint32_t(u[3]) << 24);
+}
+
+Reader::Reader() :
+    data(nullptr),
+    size(0)
+{
+}
+
+bool Reader::Open(const char* archive, size_t archiveSize)
+{
+    data = archive;
+    size = archiveSize;
+    entries.clear();
+
+    // Конец центрального каталога: ищем сигнатуру с конца (после неё может быть комментарий)
+    if (size < 22) {
+        return false;
+    }
+    size_t eocd = size - 22;
+    const size_t limit = size > 22 + 65535 ? size - 22 - 65535 : 0;
+    while (Get32(data + eocd) != 0x06054B50) {
+        if (eocd == limit) {
+            return false;
+        }
+        --eocd;
+    }
+
+    const uint16_t count = Get16(data + eocd + 10);
+    const uint32_t directorySize = Get32(data + eocd + 12);
+    const uint32_t directoryOffset = Get32(data + eocd + 16);
+    if (static_cast<uint64_t>(directoryOffset) + directorySize > size) {
+        return false;
+    }
+
+    size_t p = directoryOffset;
+    entries.reserve(count);
+    for (uint16_t i = 0; i < count; ++i) {
+        if (p + 46 > size || Get32(data + p) != 0x02014B50) {
+            return false;
+        }
+        Entry entry;
+        entry.method = Get16(data + p + 10);
+        entry.crc = Get32(data + p + 16);
+        entry.compressedSize = Get32(data + p + 20);
+        entry.size = Get32(data + p + 24);
+        const uint16_t nameLength = Get16(data + p + 28);
+        const uint16_t extraLength = Get16(data + p + 30);
+        const uint16_t commentLength = Get16(data + p + 32);
+        entry.localOffset = Get32(data + p + 42);
+        if (p + 46 + nameLength > size) {
+            return false;
+        }
+        entry.name.assign(data + p + 46, nameLength);
+        entries.push_back(entry);
+        p += 46 + nameLength + extraLength + commentLength;
+    }
+    return true;
+}
+
+const Reader::Entry* Reader::Find(const std::string& name) const
+{
+    for (const Entry& entry : entries) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool Reader::Contains(const std::string& name) const
+{
+    return Find(name) != nullptr;
+}
+
+// Сколько памяти резервировать заранее под распакованную запись
+static const size_t MaxReserve = 16 * 1024 * 1024;
+
+bool Reader::Extract(const std::string& name, std::string& out) const
+{
+    out.clear();
+    const Entry* entry = Find(name);
+    if (entry == nullptr) {
+        return false;
+    }
+
+    // Локальный заголовок: длины имени и extra могут отличаться от центрального каталога
+    const size_t local = entry->localOffset;
+    if (local + 30 > size || Get32(data + local) != 0x04034B50) {
+        return false;
+    }
+    const size_t start = local + 30 + Get16(data + local + 26) + Get16(data + local + 28);
+    if (start + entry->compressedSize > size) {
+        return false;
+    }
+
+    // Размер из каталога не проверен: память резервируется не больше MaxReserve,
+    // а распаковка останавливается, как только данных больше заявленного
+    const unsigned char* compressed = reinterpret_cast<const unsigned char*>(data + start);
+    out.reserve(std::min<size_t>(entry->size, MaxReserve));
+    if (entry->method == 0) {
+        if (entry->compressedSize != entry->size) {
+            return false;
+        }
+        out.assign(reinterpret_cast<const char*>(compressed), entry->compressedSize);
+    } else if (entry->method == MethodDeflate) {
+        if (!Inflate(compressed, entry->compressedSize, out, entry->size)) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+
+    return out.size() == entry->size && Crc32(0, out.data(), out.size()) == entry->crc;
+}
+
+} // namespace Zip
@@ -0,0 +1,113 @@
+#ifndef ZIP_HPP
+#define ZIP_HPP
+
+// =============================================================================
+// Zip - Запись и чтение ZIP архивов (для XLSX)
+// =============================================================================
+// Writer: записи пишутся последовательно: локальный заголовок без размеров,
+// данные (deflate с фиксированными кодами Хаффмана) и дескриптор данных с CRC
+// и размерами. Память не зависит от объёма данных: окно сжатия 64 КБ и список
+// записей для центрального каталога.
+// Reader: архив целиком в памяти (например, отображённый файл), записи
+// распаковываются по имени (stored и deflate).
+// Модуль не зависит от Archicad API (только стандартная библиотека).
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Zip {
+
+// CRC-32 (полином 0xEDB88320); crc - результат предыдущего вызова или 0
+uint32_t Crc32(uint32_t crc, const void* data, size_t size);
+
+// Приёмник байтов архива
+class Output {
+public:
+    virtual ~Output() {}
+    virtual void Write(const char* data, size_t size) = 0;
+};
+
+class Deflater;
+
+class Writer {
+public:
+    explicit Writer(Output& output);
+    ~Writer();
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    // Начать запись (имя в UTF-8, с '/' в качестве разделителя)
+    void BeginEntry(const std::string& name);
+    void Write(const char* data, size_t size);
+    void Write(const std::string& text) { Write(text.data(), text.size()); }
+    void EndEntry();
+
+    // Записать центральный каталог. После Finish запись невозможна.
+    void Finish();
+
+private:
+    struct Entry {
+        std::string name;
+        uint32_t crc;
+        uint32_t compressedSize;
+        uint32_t size;
+        uint32_t offset;
+    };
+
+    void WriteRaw(const char* data, size_t size);
+    void Put16(uint16_t value);
+    void Put32(uint32_t value);
+
+    Output& out;
+    std::unique_ptr<Deflater> deflater;
+    std::vector<Entry> entries;
+    uint64_t position;          // Смещение в архиве
+    bool inEntry;
+    uint32_t entryCrc;
+    uint64_t entrySize;
+    uint64_t entryStart;        // Смещение начала сжатых данных записи
+    uint16_t dosTime;
+    uint16_t dosDate;
+};
+
+// Распаковать поток deflate (RFC 1951), дописывая в out. false - повреждённые
+// данные или out длиннее limit байт.
+bool Inflate(const unsigned char* data, size_t size, std::string& out, size_t limit = SIZE_MAX);
+
+class Reader {
+public:
+    Reader();
+
+    // Разобрать центральный каталог. Данные должны жить, пока жив Reader.
+    bool Open(const char* data, size_t size);
+
+    bool Contains(const std::string& name) const;
+
+    // Распаковать запись целиком: не длиннее размера из каталога, с проверкой
+    // размера и CRC
+    bool Extract(const std::string& name, std::string& out) const;
+
+private:
+    struct Entry {
+        std::string name;
+        uint16_t method;
+        uint32_t crc;
+        uint32_t compressedSize;
+        uint32_t size;
+        uint32_t localOffset;
+    };
+
+    const Entry* Find(const std::string& name) const;
+
+    const char* data;
+    size_t size;
+    std::vector<Entry> entries;
+};
+
+} // namespace Zip
+
+#endif // ZIP_HPP
@@ -0,0 +1,620 @@
+// =============================================================================
+// BatchProject - Снимки проектов для пакетного расчёта
+// =============================================================================
+
+#include "BatchProject.hpp"
+#include "CassetteSnapshot.hpp"
+#include "TsprgImport.hpp"
+#include "XlsxReader.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+
+namespace fs = std::filesystem;
+
+namespace BatchProject {
+
+// =============================================================================
+// Файлы
+// =============================================================================
+
+static const char SettingsFileName[] = "settings.csv";
+static const char FloorsFileName[] = "floors.csv";
+
+static std::string LowerExtension(const fs::path& path)
+{
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    });
+    return ext;
+}
+
+static bool IsServiceFile(const fs::path& path)
+{
+    const std::string name = path.filename().u8string();
+    return name == SettingsFileName || name == FloorsFileName || name.compare(0, 2, "~$") == 0;
+}
+
+static bool IsWindowFile(const fs::path& path)
+{
+    const std::string ext = LowerExtension(path);
+    return (ext == ".xlsx" || ext == ".csv" || ext == ".cassnap") && !IsServiceFile(path);
+}
+
+bool ReadFile(const fs::path& path, std::string& data)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    data.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0, std::ios::beg);
+    file.read(&data[0], static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file) || data.empty();
+}
+
+bool FindProjects(const fs::path& input, std::vector<Project>& projects, std::string& error)
+{
+    projects.clear();
+
+    std::error_code ec;
+    if (!fs::is_directory(input, ec)) {
+        error = "Входной каталог не найден: " + input.u8string();
+        return false;
+    }
+
+    const fs::path commonSettings = input / SettingsFileName;
+    const fs::path commonFloors = input / FloorsFileName;
+    const fs::path defaultSettings = fs::exists(commonSettings, ec) ? commonSettings : fs::path();
+    const fs::path defaultFloors = fs::exists(commonFloors, ec) ? commonFloors : fs::path();
+
+    std::vector<fs::path> entries;
+    for (const fs::directory_entry& entry : fs::directory_iterator(input, ec)) {
+        entries.push_back(entry.path());
+    }
+    std::sort(entries.begin(), entries.end());
+
+    for (const fs::path& entry : entries) {
+        Project project;
+        project.settingsFile = defaultSettings;
+        project.floorsFile = defaultFloors;
+
+        if (fs::is_directory(entry, ec)) {
+            project.name = entry.filename().u8string();
+            std::vector<fs::path> files;
+            for (const fs::directory_entry& file : fs::directory_iterator(entry, ec)) {
+                if (file.is_regular_file(ec) && IsWindowFile(file.path())) {
+                    files.push_back(file.path());
+                }
+            }
+            std::sort(files.begin(), files.end());
+            project.windowFiles = files;
+
+            if (fs::exists(entry / SettingsFileName, ec)) {
+                project.settingsFile = entry / SettingsFileName;
+            }
+            if (fs::exists(entry / FloorsFileName, ec)) {
+                project.floorsFile = entry / FloorsFileName;
+            }
+        } else if (IsWindowFile(entry)) {
+            project.name = entry.stem().u8string();
+            project.windowFiles.push_back(entry);
+        } else {
+            continue;
+        }
+
+        projects.push_back(project);
+    }
+
+    if (ec) {
+        error = "Ошибка чтения каталога: " + ec.message();
+        return false;
+    }
+    return true;
+}
+
+// =============================================================================
+// CSV (';', кавычки, "" внутри кавычек, BOM)
+// =============================================================================
+
+typedef std::vector<Xlsx::Cell> CellRow;
+
+// Ячейки строки передаются как текст (Cell::GetNumber разбирает "1,25")
+static void ParseCsv(const std::string& data, const std::function<void(const CellRow&)>& onRow)
+{
+    size_t pos = (data.compare(0, 3, "\xEF\xBB\xBF") == 0) ? 3 : 0;
+    const size_t size = data.size();
+
+    CellRow row;
+    Xlsx::Cell cell;
+    cell.type = Xlsx::CellType::Text;
+    cell.number = 0.0;
+    cell.row = 0;
+    cell.column = 0;
+
+    auto endCell = [&row, &cell]() {
+        if (!cell.text.empty()) {
+            row.push_back(cell);
+        }
+        cell.text.clear();
+        cell.column++;
+    };
+
+    while (pos < size) {
+        const char c = data[pos];
+        if (c == '"' && cell.text.empty()) {
+            // Поле в кавычках
+            ++pos;
+            while (pos < size) {
+                if (data[pos] == '"') {
+                    if (pos + 1 < size && data[pos + 1] == '"') {
+                        cell.text.push_back('"');
+                        pos += 2;
+                        continue;
+                    }
+                    ++pos;
+                    break;
+                }
+                cell.text.push_back(data[pos++]);
+            }
+            continue;
+        }
+        if (c == ';') {
+            endCell();
+        } else if (c == '\n' || c == '\r') {
+            endCell();
+            onRow(row);
+            row.clear();
+            cell.row++;
+            cell.column = 0;
+            if (c == '\r' && pos + 1 < size && data[pos + 1] == '\n') {
+                ++pos;
+            }
+        } else {
+            cell.text.push_back(c);
+        }
+        ++pos;
+    }
+    if (!cell.text.empty() || !row.empty()) {
+        endCell();
+        onRow(row);
+    }
+}
+
+static const Xlsx::Cell* FindCell(const CellRow& row, int column)
+{
+    if (column < 0) {
+        return nullptr;
+    }
+    for (const Xlsx::Cell& cell : row) {
+        if (cell.column == static_cast<uint32_t>(column)) {
+            return &cell;
+        }
+    }
+    return nullptr;
+}
+
+static bool CellNumber(const CellRow& row, int column, double& value)
+{
+    const Xlsx::Cell* cell = FindCell(row, column);
+    return cell != nullptr && cell->GetNumber(value);
+}
+
+static std::string CellText(const CellRow& row, int column)
+{
+    const Xlsx::Cell* cell = FindCell(row, column);
+    if (cell == nullptr) {
+        return std::string();
+    }
+    if (cell->type == Xlsx::CellType::Number) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%g", cell->number);
+        return buffer;
+    }
+    return cell->text;
+}
+
+// =============================================================================
+// settings.csv и floors.csv
+// =============================================================================
+
+static bool LoadSettings(const fs::path& path, CassetteCore::Params& params, IdClassifier::Table& idTypes,
+                         TypeRegistry::Registry& types, std::string& error)
+{
+    std::string data;
+    if (!ReadFile(path, data)) {
+        error = "Не удалось прочитать " + path.u8string();
+        return false;
+    }
+
+    // Те же ключи, что в CassetteSettings::ToCalcParams
+    struct Key {
+        const char* name;
+        int CassetteCore::Params::* field;
+    };
+    static const Key keys[] = {
+        { "type0.plankWidth",   &CassetteCore::Params::plankWidth0 },
+        { "type0.slopeWidth",   &CassetteCore::Params::slopeWidth0 },
+        { "type1_2.plankWidth", &CassetteCore::Params::plankWidth12 },
+        { "type1_2.slopeWidth", &CassetteCore::Params::slopeWidth12 },
+        { "type0.offsetX",      &CassetteCore::Params::offsetX },
+        { "type0.offsetY",      &CassetteCore::Params::offsetY },
+        { "type1_2.x2Coeff",    &CassetteCore::Params::offsetTop }
+    };
+
+    // Коды типов ID - как CassetteSettings::ApplyIdTypes
+    std::string idTypeCodes;
+    std::string idPrefixes;
+    bool hasCodes = false;
+    bool hasPrefixes = false;
+
+    // Определения типов - как CassetteSettings::ApplyTypeDefinitions
+    std::vector<std::pair<std::string, std::string>> typeDefinitions;
+
+    ParseCsv(data, [&](const CellRow& row) {
+        const std::string key = CellText(row, 0);
+        if (key.compare(0, 5, "type.") == 0) {
+            typeDefinitions.emplace_back(key.substr(5), CellText(row, 1));
+            return;
+        }
+        if (key == "idTypeCodes") {
+            idTypeCodes = CellText(row, 1);
+            hasCodes = true;
+            return;
+        }
+        if (key == "idPrefixes") {
+            idPrefixes = CellText(row, 1);
+            hasPrefixes = true;
+            return;
+        }
+        double value = 0.0;
+        if (!CellNumber(row, 1, value)) {
+            return;
+        }
+        for (const Key& k : keys) {
+            if (key == k.name) {
+                params.*k.field = static_cast<int>(value);
+                break;
+            }
+        }
+    });
+
+    // Ключа нет - стандартные коды/префиксы
+    if ((hasCodes && !idTypes.ParseCodes(idTypeCodes)) || (hasPrefixes && !idTypes.ParsePrefixes(idPrefixes))) {
+        error = path.filename().u8string() + ": неверные idTypeCodes или idPrefixes";
+        return false;
+    }
+    for (const auto& definition : typeDefinitions) {
+        std::string message;
+        if (!types.SetType(definition.first, definition.second, message)) {
+            error = path.filename().u8string() + ": " + message;
+            return false;
+        }
+    }
+    return true;
+}
+
+struct Floors {
+    std::map<std::string, double> heights;  // Этаж -> высота, м
+    double defaultHeight;
+    bool hasDefault;                        // Была строка "*"
+};
+
+static bool LoadFloors(const fs::path& path, Floors& floors, std::string& error)
+{
+    std::string data;
+    if (!ReadFile(path, data)) {
+        error = "Не удалось прочитать " + path.u8string();
+        return false;
+    }
+
+    ParseCsv(data, [&floors](const CellRow& row) {
+        double height = 0.0;
+        if (!CellNumber(row, 1, height) || height <= 0.0) {
+            return;     // Заголовок или пустая строка
+        }
+        const std::string storey = CellText(row, 0);
+        if (storey == "*") {
+            floors.defaultHeight = height;
+            floors.hasDefault = true;
+        } else {
+            floors.heights[storey] = height;
+        }
+    });
+    return true;
+}
+
+// =============================================================================
+// Таблица окон (выгрузка "Отправить в Excel" или CSV с теми же колонками)
+// =============================================================================
+
+class WindowTable {
+public:
+    // requireId - таблица только с колонкой ID (в книгах tsprg тоже бывают заголовки Ширина/Высота)
+    WindowTable(LoadedProject& target, const Floors& floorList, const std::string& fileLabel, bool requireId) :
+        loaded(target),
+        floors(floorList),
+        label(fileLabel),
+        idRequired(requireId),
+        idColumn(-1),
+        widthColumn(-1),
+        heightColumn(-1),
+        sillColumn(-1),
+        typeColumn(-1),
+        storeyColumn(-1),
+        state(State::WaitHeader)
+    {
+    }
+
+    void Row(const CellRow& row)
+    {
+        if (row.empty() || state == State::NotTable) {
+            return;
+        }
+        if (state == State::WaitHeader) {
+            state = Header(row) ? State::Rows : State::NotTable;
+            return;
+        }
+
+        double width = 0.0;
+        double height = 0.0;
+        if (!CellNumber(row, widthColumn, width) || !CellNumber(row, heightColumn, height) || width <= 0.0 || height <= 0.0) {
+            loaded.skippedRows++;
+            return;
+        }
+        double sill = 0.0;
+        CellNumber(row, sillColumn, sill);
+
+        // Тип из колонки, иначе из ID (как в аддоне)
+        int calcType = -1;
+        double typeValue = 0.0;
+        if (CellNumber(row, typeColumn, typeValue) && typeValue >= 0.0 && typeValue < IdClassifier::TypeCount) {
+            calcType = static_cast<int>(typeValue);
+        } else {
+            const std::string id = CellText(row, idColumn);
+            calcType = loaded.idTypes.Classify(id);
+        }
+
+        Group(CellText(row, storeyColumn)).windows.Add(Mm::FromMetres(width), Mm::FromMetres(height), Mm::FromMetres(sill), calcType);
+        loaded.windowsByType[calcType >= 0 && calcType <= 2 ? calcType : 3]++;
+    }
+
+    bool IsTable() const { return state == State::Rows; }
+
+private:
+    enum class State {
+        WaitHeader,
+        Rows,
+        NotTable
+    };
+
+    static bool StartsWith(const std::string& text, const char* prefix)
+    {
+        return text.compare(0, std::strlen(prefix), prefix) == 0;
+    }
+
+    bool Header(const CellRow& row)
+    {
+        for (const Xlsx::Cell& cell : row) {
+            const int column = static_cast<int>(cell.column);
+            const std::string& title = cell.text;
+            if (title == "ID") {
+                idColumn = column;
+            } else if (StartsWith(title, "Ширина")) {
+                widthColumn = column;
+            } else if (StartsWith(title, "Высота")) {
+                heightColumn = column;
+            } else if (StartsWith(title, "Подоконник")) {
+                sillColumn = column;
+            } else if (StartsWith(title, "Тип расчёта")) {
+                typeColumn = column;
+            } else if (StartsWith(title, "Этаж")) {
+                storeyColumn = column;
+            }
+        }
+        return widthColumn >= 0 && heightColumn >= 0 && (idColumn >= 0 || !idRequired);
+    }
+
+    WindowGroup& Group(const std::string& storey)
+    {
+        auto it = groupIndex.find(storey);
+        if (it != groupIndex.end()) {
+            return loaded.groups[it->second];
+        }
+
+        WindowGroup group;
+        group.label = storey.empty() ? label : label + " / " + storey;
+        auto floor = floors.heights.find(storey);
+        group.floorHeight = floor != floors.heights.end() ? floor->second : floors.defaultHeight;
+
+        groupIndex[storey] = loaded.groups.size();
+        loaded.groups.push_back(group);
+        return loaded.groups.back();
+    }
+
+    LoadedProject& loaded;
+    const Floors& floors;
+    std::string label;
+    bool idRequired;
+    int idColumn;
+    int widthColumn;
+    int heightColumn;
+    int sillColumn;
+    int typeColumn;
+    int storeyColumn;
+    State state;
+    std::map<std::string, size_t> groupIndex;   // Этаж -> loaded.groups
+};
+
+// Первый лист книги как таблица окон; false - это не выгрузка окон
+static bool LoadWindowSheet(const std::string& data, WindowTable& table, std::string& error)
+{
+    Xlsx::Reader reader;
+    if (!reader.Open(data.data(), data.size())) {
+        error = reader.GetError();
+        return false;
+    }
+
+    CellRow row;
+    bool ok = reader.ReadSheet(0, [&row, &table](const Xlsx::Cell& cell) {
+        if (!row.empty() && row.front().row != cell.row) {
+            table.Row(row);
+            row.clear();
+        }
+        row.push_back(cell);
+    });
+    if (!ok) {
+        error = reader.GetError();
+        return false;
+    }
+    table.Row(row);
+    return table.IsTable();
+}
+
+// =============================================================================
+// Снимок окон (.cassnap)
+// =============================================================================
+
+// Колонки снимка копируются в группы по этажам без разбора текста. Высота
+// этажа: floors.csv, затем высота из снимка, затем высота по умолчанию.
+static bool LoadSnapshot(const std::string& data, const Floors& floors, const std::string& fileLabel,
+                         LoadedProject& loaded, std::string& error)
+{
+    // View читает колонки на месте - нужен буфер, выровненный на 8 байт
+    std::vector<uint64_t> aligned((data.size() + 7) / 8);
+    std::memcpy(aligned.data(), data.data(), data.size());
+
+    CassetteSnapshot::View view;
+    if (!view.Open(reinterpret_cast<const char*>(aligned.data()), data.size(), error)) {
+        return false;
+    }
+
+    double snapshotHeight = floors.defaultHeight;
+    if (!floors.hasDefault && view.GetFloorHeight() > 0.0) {
+        snapshotHeight = view.GetFloorHeight();
+    }
+
+    const double* width = view.Width();
+    const double* height = view.Height();
+    const double* sill = view.Sill();
+    const int8_t* calcType = view.CalcType();
+
+    std::map<int32_t, size_t> groupIndex;   // Этаж -> loaded.groups
+    for (size_t i = 0; i < view.Size(); ++i) {
+        const int32_t storey = view.Storey(i);
+        auto it = groupIndex.find(storey);
+        if (it == groupIndex.end()) {
+            const std::string storeyName = std::to_string(storey);
+            auto floor = floors.heights.find(storeyName);
+
+            WindowGroup group;
+            group.label = fileLabel + " / " + storeyName;
+            group.floorHeight = floor != floors.heights.end() ? floor->second : snapshotHeight;
+            it = groupIndex.emplace(storey, loaded.groups.size()).first;
+            loaded.groups.push_back(group);
+        }
+
+        loaded.groups[it->second].windows.Add(Mm::FromMetres(width[i]), Mm::FromMetres(height[i]), Mm::FromMetres(sill[i]), calcType[i]);
+        loaded.windowsByType[calcType[i] >= 0 && calcType[i] <= 2 ? calcType[i] : 3]++;
+    }
+    return true;
+}
+
+// =============================================================================
+// Load
+// =============================================================================
+
+bool Load(const Project& project, const CassetteCore::Params& defaults, LoadedProject& loaded, std::string& error)
+{
+    loaded.params = defaults;
+    loaded.idTypes = IdClassifier::Table::Standard();
+    loaded.types = TypeRegistry::Registry::Standard();
+    loaded.groups.clear();
+    loaded.skippedRows = 0;
+    for (uint32_t& count : loaded.windowsByType) {
+        count = 0;
+    }
+
+    if (!project.settingsFile.empty() && !LoadSettings(project.settingsFile, loaded.params, loaded.idTypes, loaded.types, error)) {
+        return false;
+    }
+
+    Floors floors;
+    floors.defaultHeight = defaults.floorHeight;
+    floors.hasDefault = false;
+    if (!project.floorsFile.empty() && !LoadFloors(project.floorsFile, floors, error)) {
+        return false;
+    }
+    loaded.params.floorHeight = floors.defaultHeight;
+
+    if (project.windowFiles.empty()) {
+        error = "Нет файлов окон (.xlsx, .csv, .cassnap)";
+        return false;
+    }
+
+    std::string data;
+    for (const fs::path& path : project.windowFiles) {
+        const std::string fileName = path.filename().u8string();
+        if (!ReadFile(path, data)) {
+            error = "Не удалось прочитать " + fileName;
+            return false;
+        }
+
+        const std::string ext = LowerExtension(path);
+        if (ext == ".cassnap") {
+            if (!LoadSnapshot(data, floors, fileName, loaded, error)) {
+                error = fileName + ": " + error;
+                return false;
+            }
+            continue;
+        }
+
+        const bool csv = ext == ".csv";
+        WindowTable table(loaded, floors, fileName, !csv);
+        if (csv) {
+            ParseCsv(data, [&table](const CellRow& row) {
+                table.Row(row);
+            });
+            if (!table.IsTable()) {
+                error = fileName + ": нет колонок Ширина и Высота";
+                return false;
+            }
+            continue;
+        }
+
+        std::string sheetError;
+        if (LoadWindowSheet(data, table, sheetError)) {
+            continue;
+        }
+        if (!sheetError.empty()) {
+            error = fileName + ": " + sheetError;
+            return false;
+        }
+
+        // Не выгрузка окон - книга tsprg со своей высотой этажа
+        TsprgImport::Workbook book;
+        if (!TsprgImport::Parse(data.data(), data.size(), book, sheetError)) {
+            error = fileName + ": " + sheetError;
+            return false;
+        }
+        WindowGroup group;
+        group.label = fileName;
+        group.floorHeight = book.hasFloorHeight ? book.floorHeight : floors.defaultHeight;
+        group.windows = book.windows;
+        loaded.groups.push_back(group);
+        for (int type = 0; type < 3; ++type) {
+            loaded.windowsByType[type] += book.windowsByType[type];
+        }
+        loaded.skippedRows += book.skippedRows;
+    }
+
+    return true;
+}
+
+} // namespace BatchProject
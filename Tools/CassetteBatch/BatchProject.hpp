@@ -0,0 +1,69 @@
+#ifndef BATCHPROJECT_HPP
+#define BATCHPROJECT_HPP
+
+// =============================================================================
+// BatchProject - Снимки проектов для пакетного расчёта
+// =============================================================================
+// Входной каталог:
+//   <вход>/settings.csv, <вход>/floors.csv - общие для всех проектов (необязательно)
+//   <вход>/<проект>/                      - проект: все окна из файлов каталога
+//   <вход>/<книга>.xlsx|.csv|.cassnap     - отдельный проект из одного файла
+// Файлы окон:
+//   .xlsx - выгрузка "Отправить в Excel" (первый лист с колонками ID, Ширина,
+//           Высота, Подоконник, Тип расчёта) или книга старых скриптов tsprg
+//           (Лист1-Лист3, I2)
+//   .csv  - те же колонки, что в выгрузке (разделитель ';', размеры в метрах);
+//           необязательная колонка "Этаж" связывает окно с высотой из floors.csv
+//   .cassnap - двоичный снимок окон из аддона (CassetteSnapshot.hpp); окна
+//           группируются по индексу этажа, высота - из floors.csv или снимка
+// settings.csv - формат настроек аддона (key;value, в т.ч. idTypeCodes и
+// idPrefixes для типа по ID, type.N - определения типов), floors.csv -
+// "Этаж;Высота, м"
+// (строка "*" - высота по умолчанию). Файлы проекта заменяют общие.
+
+#include "CassetteCore.hpp"
+#include "IdClassifier.hpp"
+#include "TypeRegistry.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace BatchProject {
+
+struct Project {
+    std::string name;                               // UTF-8
+    std::vector<std::filesystem::path> windowFiles; // По имени
+    std::filesystem::path settingsFile;             // Пусто - параметры по умолчанию
+    std::filesystem::path floorsFile;               // Пусто - одна высота этажа
+};
+
+// Найти проекты во входном каталоге (по имени)
+bool FindProjects(const std::filesystem::path& input, std::vector<Project>& projects, std::string& error);
+
+// Окна одной высоты этажа (этаж таблицы или книга tsprg)
+struct WindowGroup {
+    std::string label;
+    double floorHeight;
+    CassetteCore::WindowBatch windows;
+};
+
+struct LoadedProject {
+    CassetteCore::Params params;    // Из settings.csv; floorHeight - по умолчанию
+    IdClassifier::Table idTypes;    // Коды типов ID из settings.csv (иначе стандартные)
+    TypeRegistry::Registry types;   // Типы из settings.csv (иначе стандартные)
+    std::vector<WindowGroup> groups;
+    uint32_t windowsByType[4];      // Типы 0, 1, 2 и другой или не определён
+    uint32_t skippedRows;
+};
+
+// Прочитать проект. defaults - параметры, если нет settings.csv.
+bool Load(const Project& project, const CassetteCore::Params& defaults, LoadedProject& loaded, std::string& error);
+
+// Прочитать файл целиком
+bool ReadFile(const std::filesystem::path& path, std::string& data);
+
+} // namespace BatchProject
+
+#endif // BATCHPROJECT_HPP
@@ -0,0 +1,263 @@
+// =============================================================================
+// cassette-batch - Пакетный расчёт кассет по снимкам проектов
+// =============================================================================
+// cassette-batch <входной каталог> <выходной каталог> [--jobs N] [--floor-height М]
+//
+// Проекты (см. BatchProject.hpp) считаются параллельно пулом потоков. В
+// выходной каталог пишутся:
+//   <проект>.csv  - результат проекта (формат экспорта палитры)
+//   _total.csv    - сводная ведомость по всем проектам (одинаковые размеры сложены)
+//   _summary.csv  - окна, пропущенные строки, время и ошибки по проектам
+
+#include "BatchProject.hpp"
+#include "ResultCsv.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+namespace fs = std::filesystem;
+
+struct Options {
+    fs::path input;
+    fs::path output;
+    unsigned jobs;
+    CassetteCore::Params params;
+};
+
+// Итог одного проекта (заполняет рабочий поток)
+struct Outcome {
+    CassetteCore::Result result;
+    ResultCsv::SummaryRow summary;
+    bool success;
+};
+
+static void PrintUsage()
+{
+    std::fprintf(stderr,
+        "Использование: cassette-batch <входной каталог> <выходной каталог> [--jobs N] [--floor-height М]\n"
+        "  --jobs N          число потоков (по умолчанию - число ядер)\n"
+        "  --floor-height М  высота этажа по умолчанию в метрах (если нет floors.csv и I2)\n");
+}
+
+static bool ParseOptions(int argc, char* argv[], Options& options)
+{
+    options.jobs = std::max(1u, std::thread::hardware_concurrency());
+    options.params = CassetteCore::GetDefaultParams();
+
+    std::vector<const char*> positional;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            const int jobs = std::atoi(argv[++i]);
+            if (jobs <= 0) {
+                return false;
+            }
+            options.jobs = static_cast<unsigned>(jobs);
+        } else if (std::strcmp(argv[i], "--floor-height") == 0 && i + 1 < argc) {
+            const double height = std::atof(argv[++i]);
+            if (height <= 0.0) {
+                return false;
+            }
+            options.params.floorHeight = height;
+        } else if (argv[i][0] == '-' && argv[i][1] == '-') {
+            return false;
+        } else {
+            positional.push_back(argv[i]);
+        }
+    }
+
+    if (positional.size() != 2) {
+        return false;
+    }
+    options.input = fs::path(positional[0]);
+    options.output = fs::path(positional[1]);
+    return true;
+}
+
+// Имя файла результата: без символов, недопустимых в именах файлов, и без повторов
+static std::string MakeOutputName(const std::string& project, std::set<std::string>& used)
+{
+    std::string base = project;
+    for (char& c : base) {
+        if (std::strchr("<>:\"/\\|?*", c) != nullptr) {
+            c = '_';
+        }
+    }
+    if (base.empty() || base[0] == '_') {
+        base = "project" + base;
+    }
+
+    std::string name = base;
+    for (int n = 2; used.count(name) != 0; ++n) {
+        name = base + " (" + std::to_string(n) + ")";
+    }
+    used.insert(name);
+    return name;
+}
+
+static void RunProject(const BatchProject::Project& project, const Options& options, const fs::path& resultPath, Outcome& outcome)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    ResultCsv::SummaryRow& summary = outcome.summary;
+    summary.project = project.name;
+    summary.windows = 0;
+    summary.skippedRows = 0;
+    summary.groups = 0;
+    for (uint32_t& count : summary.windowsByType) {
+        count = 0;
+    }
+
+    BatchProject::LoadedProject loaded;
+    std::string error;
+    outcome.success = BatchProject::Load(project, options.params, loaded, error);
+    if (outcome.success) {
+        // Каждая группа - своя высота этажа; результаты групп складываются
+        CassetteCore::Result groupResult;
+        for (const BatchProject::WindowGroup& group : loaded.groups) {
+            CassetteCore::Params params = loaded.params;
+            params.floorHeight = group.floorHeight;
+            CassetteCore::Calculate(group.windows, params, loaded.types, groupResult);
+            CassetteCore::Merge(outcome.result, groupResult);
+            summary.windows += static_cast<uint32_t>(group.windows.Size());
+        }
+        for (int type = 0; type < 4; ++type) {
+            summary.windowsByType[type] = loaded.windowsByType[type];
+        }
+        summary.skippedRows = loaded.skippedRows;
+        summary.groups = static_cast<uint32_t>(loaded.groups.size());
+
+        outcome.success = ResultCsv::WriteResult(resultPath, outcome.result, error);
+    }
+
+    summary.cassetteRows = outcome.result.cassettes.size();
+    summary.plankRows = outcome.result.planks.size();
+    summary.slopeRows = outcome.result.leftSlopes.size() + outcome.result.rightSlopes.size();
+    summary.error = outcome.success ? std::string() : error;
+    summary.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage();
+        return 2;
+    }
+
+    std::string error;
+    std::vector<BatchProject::Project> projects;
+    if (!BatchProject::FindProjects(options.input, projects, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 2;
+    }
+
+    std::error_code ec;
+    fs::create_directories(options.output, ec);
+    if (!fs::is_directory(options.output, ec)) {
+        std::fprintf(stderr, "Не удалось создать выходной каталог: %s\n", options.output.u8string().c_str());
+        return 2;
+    }
+
+    // Выходной каталог внутри входного - не проект
+    for (size_t i = 0; i < projects.size(); ++i) {
+        const fs::path candidate = options.input / fs::u8path(projects[i].name);
+        if (fs::equivalent(candidate, options.output, ec)) {
+            projects.erase(projects.begin() + static_cast<std::ptrdiff_t>(i));
+            break;
+        }
+    }
+
+    if (projects.empty()) {
+        std::fprintf(stderr, "Во входном каталоге нет проектов\n");
+        return 2;
+    }
+
+    std::set<std::string> usedNames = { "_total", "_summary" };
+    std::vector<fs::path> resultPaths;
+    for (const BatchProject::Project& project : projects) {
+        resultPaths.push_back(options.output / fs::u8path(MakeOutputName(project.name, usedNames) + ".csv"));
+    }
+
+    // Пул потоков: каждый берёт следующий проект по общему счётчику
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<Outcome> outcomes(projects.size());
+    std::atomic<size_t> next(0);
+    std::mutex printMutex;
+    size_t finished = 0;
+
+    auto worker = [&]() {
+        for (;;) {
+            const size_t index = next++;
+            if (index >= projects.size()) {
+                return;
+            }
+            RunProject(projects[index], options, resultPaths[index], outcomes[index]);
+
+            const ResultCsv::SummaryRow& summary = outcomes[index].summary;
+            std::lock_guard<std::mutex> lock(printMutex);
+            ++finished;
+            if (outcomes[index].success) {
+                std::printf("[%zu/%zu] %s: окон %u, %.1f мс\n", finished, projects.size(),
+                    summary.project.c_str(), summary.windows, summary.milliseconds);
+            } else {
+                std::printf("[%zu/%zu] %s: ОШИБКА %s\n", finished, projects.size(),
+                    summary.project.c_str(), summary.error.c_str());
+            }
+        }
+    };
+
+    const unsigned threadCount = static_cast<unsigned>(std::min<size_t>(options.jobs, projects.size()));
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Сводная ведомость - в порядке проектов, чтобы не зависеть от порядка потоков
+    CassetteCore::Result total;
+    std::vector<ResultCsv::SummaryRow> summary;
+    size_t failed = 0;
+    uint64_t windows = 0;
+    for (const Outcome& outcome : outcomes) {
+        if (outcome.success) {
+            CassetteCore::Merge(total, outcome.result);
+            windows += outcome.summary.windows;
+        } else {
+            ++failed;
+        }
+        summary.push_back(outcome.summary);
+    }
+
+    bool written = ResultCsv::WriteResult(options.output / "_total.csv", total, error);
+    written = written && ResultCsv::WriteSummary(options.output / "_summary.csv", summary, error);
+    if (!written) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("Проектов: %zu (ошибок: %zu), окон: %llu, потоков: %u, %.2f с\n",
+        projects.size(), failed, static_cast<unsigned long long>(windows), threadCount, seconds);
+
+    return failed == 0 ? 0 : 1;
+}
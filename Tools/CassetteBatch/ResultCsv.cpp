@@ -0,0 +1,181 @@
+// =============================================================================
+// ResultCsv - Запись результатов пакетного расчёта
+// =============================================================================
+
+#include "ResultCsv.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+namespace ResultCsv {
+
+// =============================================================================
+// CsvFile - строки CSV в буфере, запись одним вызовом
+// =============================================================================
+
+class CsvFile {
+public:
+    CsvFile() : firstInRow(true)
+    {
+        text = "\xEF\xBB\xBF";     // BOM - чтобы Excel открывал файл как UTF-8
+    }
+
+    void Field(const std::string& value)
+    {
+        Separator();
+        if (value.find_first_of(";\"\r\n") == std::string::npos) {
+            text += value;
+            return;
+        }
+        text.push_back('"');
+        for (char c : value) {
+            if (c == '"') {
+                text.push_back('"');
+            }
+            text.push_back(c);
+        }
+        text.push_back('"');
+    }
+
+    void Field(int64_t value)
+    {
+        Separator();
+        text += std::to_string(value);
+    }
+
+    void Field(double value, const char* format)
+    {
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), format, value);
+        Separator();
+        text += buffer;
+    }
+
+    void EndRow()
+    {
+        text += "\r\n";
+        firstInRow = true;
+    }
+
+    bool Save(const std::filesystem::path& path, std::string& error) const
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            error = "Не удалось создать файл: " + path.u8string();
+            return false;
+        }
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+        if (!file) {
+            error = "Ошибка записи файла: " + path.u8string();
+            return false;
+        }
+        return true;
+    }
+
+private:
+    void Separator()
+    {
+        if (!firstInRow) {
+            text.push_back(';');
+        }
+        firstInRow = false;
+    }
+
+    std::string text;
+    bool firstInRow;
+};
+
+// =============================================================================
+// Результат
+// =============================================================================
+
+static void WriteCassetteRow(CsvFile& csv, const CassetteCore::CassetteRow& c)
+{
+    csv.Field(std::string("Кассета"));
+    csv.Field(std::string("1-2"));
+    csv.Field(static_cast<int64_t>(c.x));
+    csv.Field(static_cast<int64_t>(c.y));
+    csv.Field(static_cast<int64_t>(c.count));
+    csv.Field("Размер: U x V : " + std::to_string(c.x) + "x" + std::to_string(c.y) + " мм; Количество: " +
+        std::to_string(c.count) + " шт.");
+    csv.EndRow();
+}
+
+// Планки: длина W для типов 1-2, Z для типа 0; откосы: всегда Z
+static void WritePlankRow(CsvFile& csv, const char* rowType, const CassetteCore::PlankRow& p, bool isPlank)
+{
+    csv.Field(std::string(rowType));
+    csv.Field(std::string(p.calcType == 0 ? "0" : "1-2"));
+    csv.Field(static_cast<int64_t>(p.width));
+    csv.Field(static_cast<int64_t>(p.length));
+    csv.Field(static_cast<int64_t>(p.count));
+    csv.Field("Размер: " + std::to_string(p.width) + "x" + std::to_string(p.length) + " мм" +
+        (isPlank && p.calcType != 0 ? "; Длина W = " : "; Длина Z = ") + std::to_string(p.length) +
+        " мм; Количество: " + std::to_string(p.count) + " шт.");
+    csv.EndRow();
+}
+
+bool WriteResult(const std::filesystem::path& path, const CassetteCore::Result& result, std::string& error)
+{
+    CsvFile csv;
+    csv.Field(std::string("Тип"));
+    csv.Field(std::string("Тип элемента"));
+    csv.Field(std::string("Размер X"));
+    csv.Field(std::string("Размер Y"));
+    csv.Field(std::string("Количество"));
+    csv.Field(std::string("Описание"));
+    csv.EndRow();
+
+    for (const CassetteCore::CassetteRow& c : result.cassettes) {
+        WriteCassetteRow(csv, c);
+    }
+    for (const CassetteCore::PlankRow& p : result.planks) {
+        WritePlankRow(csv, "Планка", p, true);
+    }
+    for (const CassetteCore::PlankRow& s : result.leftSlopes) {
+        WritePlankRow(csv, "Левый откос", s, false);
+    }
+    for (const CassetteCore::PlankRow& s : result.rightSlopes) {
+        WritePlankRow(csv, "Правый откос", s, false);
+    }
+
+    return csv.Save(path, error);
+}
+
+// =============================================================================
+// Сводка
+// =============================================================================
+
+bool WriteSummary(const std::filesystem::path& path, const std::vector<SummaryRow>& rows, std::string& error)
+{
+    static const char* const titles[] = {
+        "Проект", "Окон", "Тип 0", "Тип 1", "Тип 2", "Другой/без типа", "Пропущено строк", "Высот этажа",
+        "Строк кассет", "Строк планок", "Строк откосов", "Время, мс", "Ошибка"
+    };
+
+    CsvFile csv;
+    for (const char* title : titles) {
+        csv.Field(std::string(title));
+    }
+    csv.EndRow();
+
+    for (const SummaryRow& row : rows) {
+        csv.Field(row.project);
+        csv.Field(static_cast<int64_t>(row.windows));
+        for (uint32_t count : row.windowsByType) {
+            csv.Field(static_cast<int64_t>(count));
+        }
+        csv.Field(static_cast<int64_t>(row.skippedRows));
+        csv.Field(static_cast<int64_t>(row.groups));
+        csv.Field(static_cast<int64_t>(row.cassetteRows));
+        csv.Field(static_cast<int64_t>(row.plankRows));
+        csv.Field(static_cast<int64_t>(row.slopeRows));
+        csv.Field(row.milliseconds, "%.1f");
+        csv.Field(row.error);
+        csv.EndRow();
+    }
+
+    return csv.Save(path, error);
+}
+
+} // namespace ResultCsv
@@ -0,0 +1,40 @@
+#ifndef RESULTCSV_HPP
+#define RESULTCSV_HPP
+
+// =============================================================================
+// ResultCsv - Запись результатов пакетного расчёта
+// =============================================================================
+// Результат проекта пишется в формате экспорта палитры (см. CassetteCsv):
+//   Тип;Тип элемента;Размер X;Размер Y;Количество;Описание
+// поэтому его можно открыть кнопкой "Импорт CSV" и записать в объекты.
+
+#include "CassetteCore.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace ResultCsv {
+
+bool WriteResult(const std::filesystem::path& path, const CassetteCore::Result& result, std::string& error);
+
+// Строка сводки по проекту
+struct SummaryRow {
+    std::string project;
+    uint32_t windows;
+    uint32_t windowsByType[4];  // 0, 1, 2, другой или не определён
+    uint32_t skippedRows;
+    uint32_t groups;            // Групп с разной высотой этажа
+    size_t cassetteRows;
+    size_t plankRows;
+    size_t slopeRows;
+    double milliseconds;
+    std::string error;          // Пусто - успешно
+};
+
+bool WriteSummary(const std::filesystem::path& path, const std::vector<SummaryRow>& rows, std::string& error);
+
+} // namespace ResultCsv
+
+#endif // RESULTCSV_HPP
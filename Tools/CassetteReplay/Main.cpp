@@ -0,0 +1,160 @@
+// =============================================================================
+// cassette-replay - Повтор трассы вызовов Archicad без Archicad
+// =============================================================================
+// cassette-replay <трасса.castrace> [--repeat N] [--report]
+//
+// Трасса записывается в палитре (Диагностика -> "Записать трассу"). Операции
+// аддона (чтение выделения, поиск стены, запись в объекты) повторяются той же
+// логикой (HostWorkload), а Archicad отвечает записанными данными
+// (HostTrace::Player). Печатается время вызовов Archicad при записи и время
+// логики аддона при повторе - по операциям и по видам вызовов.
+// Код возврата: 0 - повтор совпал с трассой, 1 - расхождение, 2 - неверные аргументы.
+
+#include "HostTrace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+static void PrintUsage()
+{
+    std::fprintf(stderr,
+        "Использование: cassette-replay <трасса.castrace> [--repeat N] [--report]\n"
+        "  --repeat N  повторить N раз, время повтора - минимальное (по умолчанию 1)\n"
+        "  --report    печатать отчёт аддона (WriteReport) при первом повторе\n");
+}
+
+static bool ReadFile(const char* path, std::string& data)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    data.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0, std::ios::beg);
+    file.read(&data[0], static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file) || data.empty();
+}
+
+// Текст UTF-8, дополненный пробелами до width символов (printf считает байты)
+static std::string Pad(const char* text, size_t width)
+{
+    std::string result(text);
+    size_t length = 0;
+    for (const char* c = text; *c != '\0'; ++c) {
+        if ((static_cast<unsigned char>(*c) & 0xC0) != 0x80) {
+            ++length;
+        }
+    }
+    if (length < width) {
+        result.append(width - length, ' ');
+    }
+    return result;
+}
+
+static double ToMs(uint64_t nanoseconds)
+{
+    return static_cast<double>(nanoseconds) / 1e6;
+}
+
+int main(int argc, char* argv[])
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+
+    const char* path = nullptr;
+    int repeat = 1;
+    bool report = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = std::atoi(argv[++i]);
+            if (repeat <= 0) {
+                PrintUsage();
+                return 2;
+            }
+        } else if (std::strcmp(argv[i], "--report") == 0) {
+            report = true;
+        } else if (argv[i][0] != '-' && path == nullptr) {
+            path = argv[i];
+        } else {
+            PrintUsage();
+            return 2;
+        }
+    }
+    if (path == nullptr) {
+        PrintUsage();
+        return 2;
+    }
+
+    std::string data;
+    if (!ReadFile(path, data)) {
+        std::fprintf(stderr, "Не удалось прочитать %s\n", path);
+        return 2;
+    }
+
+    HostTrace::Player player;
+    std::string error;
+    if (!player.Open(data.data(), data.size(), error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 2;
+    }
+
+    // Первый повтор - статистика; остальные только уточняют время логики аддона
+    HostTrace::ReplayStats stats;
+    player.SetEchoReport(report);
+    if (!player.Replay(stats, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    player.SetEchoReport(false);
+    for (int pass = 1; pass < repeat; ++pass) {
+        HostTrace::ReplayStats again;
+        if (!player.Replay(again, error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        for (size_t i = 0; i < stats.runs.size(); ++i) {
+            stats.runs[i].replayMs = std::min(stats.runs[i].replayMs, again.runs[i].replayMs);
+        }
+    }
+
+    uint64_t totalCalls = 0;
+    uint64_t totalNs = 0;
+    double totalReplayMs = 0.0;
+    std::printf("Трасса: %s (%zu байт), операций: %zu\n\n", path, data.size(), stats.runs.size());
+    std::printf("%s %s %s %s %s %s\n", Pad("#", 4).c_str(), Pad("Операция", 16).c_str(), Pad("Вызовов", 10).c_str(),
+        Pad("Archicad, мс", 14).c_str(), Pad("Повтор, мс", 12).c_str(), "Итог");
+    for (size_t i = 0; i < stats.runs.size(); ++i) {
+        const HostTrace::WorkloadRun& run = stats.runs[i];
+        std::printf("%-4zu %-16s %-10llu %-14.2f %-12.3f %zu\n", i + 1, HostTrace::GetWorkloadName(run.workload),
+            static_cast<unsigned long long>(run.calls), ToMs(run.recordedNs), run.replayMs, run.outcome);
+        totalCalls += run.calls;
+        totalNs += run.recordedNs;
+        totalReplayMs += run.replayMs;
+    }
+    std::printf("%s %s %-10llu %-14.2f %-12.3f\n\n", Pad("", 4).c_str(), Pad("Всего", 16).c_str(),
+        static_cast<unsigned long long>(totalCalls), ToMs(totalNs), totalReplayMs);
+
+    std::printf("%s %s %s %s\n", Pad("Вызов Archicad", 24).c_str(), Pad("Вызовов", 10).c_str(),
+        Pad("Всего, мс", 14).c_str(), "Среднее, мкс");
+    for (size_t op = 1; op < static_cast<size_t>(HostTrace::Op::Count); ++op) {
+        const HostTrace::OpStats& opStats = stats.ops[op];
+        if (opStats.calls == 0) {
+            continue;
+        }
+        std::printf("%-24s %-10llu %-14.2f %.1f\n", HostTrace::GetOpName(static_cast<HostTrace::Op>(op)),
+            static_cast<unsigned long long>(opStats.calls), ToMs(opStats.recordedNs),
+            static_cast<double>(opStats.recordedNs) / 1e3 / static_cast<double>(opStats.calls));
+    }
+
+    return 0;
+}
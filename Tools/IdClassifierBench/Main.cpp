@@ -0,0 +1,335 @@
+// =============================================================================
+// id-classifier-bench - IdClassifier против прежнего определения типа по ID
+// =============================================================================
+// id-classifier-bench [ids.txt] [--count N] [--repeat N]
+//
+// ID берутся из файла (UTF-8, по одному в строке, например колонка ID выгрузки
+// "Отправить в Excel") или генерируются: суффиксы ":N" / ": N", ID с префиксом
+// ОК-/ДВ- без суффикса, пробелы в конце, чужие ID. Сравниваются:
+//   - GetCalcTypeFromId - прежняя функция аддона: копия ID в UTF-16,
+//     DeleteLast в цикле, индексы символов (перенос на std::u16string);
+//   - CalcTypeFromId    - прежнее правило CassetteCore по UTF-8;
+//   - IdClassifier      - стандартная таблица кодов (Table::Standard).
+// Печатается время на ID (минимум из --repeat проходов) по всем ID и по ID с
+// суффиксом типа, и расхождения. На ID без суффикса прежние функции сразу
+// возвращают -1, а IdClassifier проверяет ещё и префиксы, поэтому на смеси
+// он медленнее CalcTypeFromId; на ID с суффиксом - наравне (быстрый путь).
+// Код возврата: 0 - IdClassifier совпал с прежними функциями на всех ID с
+// суффиксом, 1 - расхождение, 2 - неверные аргументы.
+
+#include "IdClassifier.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+static void PrintUsage()
+{
+    std::fprintf(stderr,
+        "Использование: id-classifier-bench [ids.txt] [--count N] [--repeat N]\n"
+        "  ids.txt     ID по одному в строке (UTF-8); без файла ID генерируются\n"
+        "  --count N   число сгенерированных ID (по умолчанию 1000000)\n"
+        "  --repeat N  число проходов, время - минимальное (по умолчанию 5)\n");
+}
+
+// =============================================================================
+// Прежние функции
+// =============================================================================
+
+// CassetteHelper::GetCalcTypeFromId до IdClassifier (GS::UniString -> std::u16string)
+static int LegacyGetCalcTypeFromId(const std::u16string& id)
+{
+    // Убираем пробелы в конце строки для надёжности
+    std::u16string trimmedId = id;
+    while (trimmedId.length() > 0 && trimmedId[trimmedId.length() - 1] == u' ') {
+        trimmedId.pop_back();
+    }
+
+    if (trimmedId.length() < 2) {
+        return -1;
+    }
+
+    char16_t lastChar = trimmedId[trimmedId.length() - 1];
+    char16_t prevChar = trimmedId[trimmedId.length() - 2];
+    bool hasColon = (prevChar == u':');
+    if (!hasColon && prevChar == u' ' && trimmedId.length() >= 3) {
+        hasColon = (trimmedId[trimmedId.length() - 3] == u':');
+    }
+    if (!hasColon) {
+        return -1;
+    }
+
+    if (lastChar == u'0') {
+        return 0;
+    }
+    if (lastChar == u'1') {
+        return 1;
+    }
+    if (lastChar == u'2') {
+        return 2;
+    }
+    return -1;
+}
+
+// CassetteCore::CalcTypeFromId до IdClassifier
+static int LegacyCalcTypeFromId(const char* id, size_t length)
+{
+    while (length > 0 && id[length - 1] == ' ') {
+        --length;
+    }
+    if (length < 2) {
+        return -1;
+    }
+
+    const char last = id[length - 1];
+    bool hasColon = id[length - 2] == ':';
+    if (!hasColon && id[length - 2] == ' ' && length >= 3) {
+        hasColon = id[length - 3] == ':';
+    }
+    if (!hasColon || last < '0' || last > '2') {
+        return -1;
+    }
+    return last - '0';
+}
+
+// =============================================================================
+// Данные
+// =============================================================================
+
+// UTF-8 -> UTF-16 (как строка ID в GS::UniString); неверные байты - U+FFFD
+static std::u16string ToUtf16(const std::string& text)
+{
+    std::u16string result;
+    result.reserve(text.size());
+    for (size_t i = 0; i < text.size();) {
+        const unsigned char c = static_cast<unsigned char>(text[i]);
+        uint32_t code = 0xFFFD;
+        size_t length = 1;
+        if (c < 0x80) {
+            code = c;
+        } else if ((c & 0xE0) == 0xC0 && i + 1 < text.size()) {
+            code = ((c & 0x1Fu) << 6) | (text[i + 1] & 0x3Fu);
+            length = 2;
+        } else if ((c & 0xF0) == 0xE0 && i + 2 < text.size()) {
+            code = ((c & 0x0Fu) << 12) | ((text[i + 1] & 0x3Fu) << 6) | (text[i + 2] & 0x3Fu);
+            length = 3;
+        } else if ((c & 0xF8) == 0xF0 && i + 3 < text.size()) {
+            code = ((c & 0x07u) << 18) | ((text[i + 1] & 0x3Fu) << 12) | ((text[i + 2] & 0x3Fu) << 6) | (text[i + 3] & 0x3Fu);
+            length = 4;
+        }
+        if (code >= 0x10000) {
+            code -= 0x10000;
+            result.push_back(static_cast<char16_t>(0xD800 + (code >> 10)));
+            result.push_back(static_cast<char16_t>(0xDC00 + (code & 0x3FF)));
+        } else {
+            result.push_back(static_cast<char16_t>(code));
+        }
+        i += length;
+    }
+    return result;
+}
+
+static bool ReadIds(const char* path, std::vector<std::string>& ids)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (ids.empty() && line.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+            line.erase(0, 3);
+        }
+        if (!line.empty()) {
+            ids.push_back(line);
+        }
+    }
+    return true;
+}
+
+// Смесь ID, как в проектах: в основном с суффиксом типа
+static void GenerateIds(size_t count, std::vector<std::string>& ids)
+{
+    static const char* const prefixes[] = { "ОК-", "ДВ-" };
+    static const char* const foreign[] = { "СН-МД1", "OK-1_2_CASS", "Окно", "ОК-1.03", "ДВ-12" };
+    std::mt19937 random(12345);
+    ids.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const unsigned kind = random() % 10;
+        const std::string prefix = prefixes[random() % 2];
+        const std::string number = std::to_string(random() % 3) + "." + std::to_string(1 + random() % 40);
+        const char type = static_cast<char>('0' + random() % 3);
+        if (kind < 5) {
+            ids.push_back(prefix + number + ": " + type);                   // ОК-1.03: 2
+        } else if (kind < 7) {
+            ids.push_back(prefix + number + ":" + type + "  ");             // ДВ-0.12:0 (пробелы в конце)
+        } else if (kind < 9) {
+            ids.push_back(prefix + std::string(1, type));                   // ОК-2 (тип по префиксу)
+        } else {
+            ids.push_back(foreign[random() % (sizeof(foreign) / sizeof(foreign[0]))]);
+        }
+    }
+}
+
+// =============================================================================
+// Замер
+// =============================================================================
+
+// Текст UTF-8, дополненный пробелами до width символов (printf считает байты)
+static std::string Pad(const char* text, size_t width)
+{
+    std::string result(text);
+    size_t length = 0;
+    for (const char* c = text; *c != '\0'; ++c) {
+        if ((static_cast<unsigned char>(*c) & 0xC0) != 0x80) {
+            ++length;
+        }
+    }
+    if (length < width) {
+        result.append(width - length, ' ');
+    }
+    return result;
+}
+
+template <typename Function>
+static double MeasureNsPerId(size_t count, int repeat, long long& checksum, Function classify)
+{
+    double best = 0.0;
+    for (int pass = 0; pass < repeat; ++pass) {
+        long long sum = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            sum += classify(i);
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = pass == 0 ? ns : std::min(best, ns);
+        checksum = sum;
+    }
+    return count > 0 ? best / static_cast<double>(count) : 0.0;
+}
+
+// Время трёх функций на наборе ID; сравнение с CalcTypeFromId - в обе стороны
+static void MeasureSet(const char* title, const std::vector<std::string>& ids, const std::vector<std::u16string>& ids16,
+                       const IdClassifier::Table& table, int repeat)
+{
+    long long legacySum = 0;
+    long long coreSum = 0;
+    long long currentSum = 0;
+    const double legacyNs = MeasureNsPerId(ids.size(), repeat, legacySum, [&ids16](size_t i) {
+        return LegacyGetCalcTypeFromId(ids16[i]);
+    });
+    const double coreNs = MeasureNsPerId(ids.size(), repeat, coreSum, [&ids](size_t i) {
+        return LegacyCalcTypeFromId(ids[i].data(), ids[i].size());
+    });
+    const double currentNs = MeasureNsPerId(ids.size(), repeat, currentSum, [&ids, &table](size_t i) {
+        return table.Classify(ids[i]);
+    });
+
+    std::printf("\n%s: %zu\n", title, ids.size());
+    std::printf("%s %s %s\n", Pad("Функция", 20).c_str(), Pad("нс/ID", 10).c_str(), "Сумма типов");
+    std::printf("%-20s %-10.2f %lld\n", "GetCalcTypeFromId", legacyNs, legacySum);
+    std::printf("%-20s %-10.2f %lld\n", "CalcTypeFromId", coreNs, coreSum);
+    std::printf("%-20s %-10.2f %lld\n", "IdClassifier", currentNs, currentSum);
+    if (currentNs > 0.0 && coreNs > 0.0) {
+        std::printf("IdClassifier: быстрее GetCalcTypeFromId в %.1f раз; %s CalcTypeFromId на %.0f%%\n",
+            legacyNs / currentNs, currentNs <= coreNs ? "быстрее" : "МЕДЛЕННЕЕ",
+            100.0 * std::fabs(currentNs - coreNs) / coreNs);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+
+    const char* path = nullptr;
+    long long count = 1000000;
+    int repeat = 5;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            count = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = std::atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && path == nullptr) {
+            path = argv[i];
+        } else {
+            PrintUsage();
+            return 2;
+        }
+    }
+    if (count <= 0 || repeat <= 0) {
+        PrintUsage();
+        return 2;
+    }
+
+    std::vector<std::string> ids;
+    if (path != nullptr) {
+        if (!ReadIds(path, ids)) {
+            std::fprintf(stderr, "Не удалось прочитать %s\n", path);
+            return 2;
+        }
+    } else {
+        GenerateIds(static_cast<size_t>(count), ids);
+    }
+    std::vector<std::u16string> ids16;
+    ids16.reserve(ids.size());
+    for (const std::string& id : ids) {
+        ids16.push_back(ToUtf16(id));
+    }
+
+    // Совпадение: где прежние функции определили тип, IdClassifier даёт тот же
+    const IdClassifier::Table table = IdClassifier::Table::Standard();
+    size_t bySuffix = 0;
+    size_t byPrefixOnly = 0;
+    size_t mismatches = 0;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        const int legacy = LegacyGetCalcTypeFromId(ids16[i]);
+        const int core = LegacyCalcTypeFromId(ids[i].data(), ids[i].size());
+        const int current = table.Classify(ids[i]);
+        if (legacy != core || (legacy >= 0 && current != legacy)) {
+            if (mismatches < 10) {
+                std::printf("Расхождение: \"%s\": GetCalcTypeFromId %d, CalcTypeFromId %d, IdClassifier %d\n",
+                    ids[i].c_str(), legacy, core, current);
+            }
+            ++mismatches;
+        } else if (legacy >= 0) {
+            ++bySuffix;
+        } else if (current >= 0) {
+            ++byPrefixOnly;
+        }
+    }
+
+    std::printf("ID: %zu (%s), проходов: %d\n", ids.size(), path != nullptr ? path : "сгенерированы", repeat);
+    std::printf("Тип по суффиксу: %zu, только по префиксу (новое): %zu, расхождений: %zu\n",
+        bySuffix, byPrefixOnly, mismatches);
+
+    // Все ID и отдельно ID с суффиксом: на остальных прежние функции сразу
+    // возвращают -1, а IdClassifier ещё проверяет префиксы
+    std::vector<std::string> suffixed;
+    std::vector<std::u16string> suffixed16;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (LegacyCalcTypeFromId(ids[i].data(), ids[i].size()) >= 0) {
+            suffixed.push_back(ids[i]);
+            suffixed16.push_back(ids16[i]);
+        }
+    }
+    MeasureSet("Все ID", ids, ids16, table, repeat);
+    MeasureSet("ID с суффиксом типа", suffixed, suffixed16, table, repeat);
+
+    return mismatches == 0 ? 0 : 1;
+}